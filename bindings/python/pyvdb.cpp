@@ -56,6 +56,16 @@ py::array_t<float> vector_to_numpy(const Vector &vec)
     return result;
 }
 
+// Helper: Share a Python callable with worker threads. The last owner may
+// be a thread without the GIL, so release happens under it.
+std::shared_ptr<py::function> share_callback(py::function fn)
+{
+    return std::shared_ptr<py::function>(new py::function(std::move(fn)), [](py::function *f)
+                                         {
+        py::gil_scoped_acquire gil;
+        delete f; });
+}
+
 // ============================================================================
 // Module Definition
 // ============================================================================
@@ -94,6 +104,37 @@ PYBIND11_MODULE(pyvdb, m)
         .value("Unknown", DocumentType::Unknown)
         .export_values();
 
+    py::enum_<index::MarketField>(m, "MarketField")
+        .value("GoldPrice", index::MarketField::GoldPrice)
+        .value("SilverPrice", index::MarketField::SilverPrice)
+        .value("Gsr", index::MarketField::Gsr)
+        .value("Dxy", index::MarketField::Dxy)
+        .value("Vix", index::MarketField::Vix)
+        .value("Yield10y", index::MarketField::Yield10y);
+
+    py::enum_<index::NumericOp>(m, "NumericOp")
+        .value("Less", index::NumericOp::Less)
+        .value("LessOrEqual", index::NumericOp::LessOrEqual)
+        .value("Greater", index::NumericOp::Greater)
+        .value("GreaterOrEqual", index::NumericOp::GreaterOrEqual)
+        .value("Between", index::NumericOp::Between);
+
+    py::class_<index::NumericPredicate>(m, "NumericPredicate")
+        .def(py::init<>())
+        .def(py::init([](index::MarketField field, index::NumericOp op, float value, float value2)
+                      { return index::NumericPredicate{field, op, value, value2}; }),
+             py::arg("field"), py::arg("op"), py::arg("value"), py::arg("value2") = 0.0f)
+        .def_readwrite("field", &index::NumericPredicate::field)
+        .def_readwrite("op", &index::NumericPredicate::op)
+        .def_readwrite("value", &index::NumericPredicate::value)
+        .def_readwrite("value2", &index::NumericPredicate::value2);
+
+    py::enum_<QueryPlan>(m, "QueryPlan")
+        .value("Hnsw", QueryPlan::Hnsw)
+        .value("ExactScan", QueryPlan::ExactScan)
+        .value("FilteredHnsw", QueryPlan::FilteredHnsw)
+        .value("HnswPostFilter", QueryPlan::HnswPostFilter);
+
 #ifdef VDB_USE_ONNX_RUNTIME
     // Device enum for execution (CPU/CUDA/DirectML)
     py::enum_<embeddings::Device>(m, "Device")
@@ -130,6 +171,25 @@ PYBIND11_MODULE(pyvdb, m)
     // Query Options & Results
     // ========================================================================
 
+    py::class_<QueryProfile, std::shared_ptr<QueryProfile>>(m, "QueryProfile")
+        .def(py::init<>())
+        .def_readonly("plan", &QueryProfile::plan)
+        .def_readonly("cache_hit", &QueryProfile::cache_hit)
+        .def_readonly("partial", &QueryProfile::partial)
+        .def_readonly("candidates", &QueryProfile::candidates)
+        .def_readonly("levels_descended", &QueryProfile::levels_descended)
+        .def_readonly("nodes_visited", &QueryProfile::nodes_visited)
+        .def_readonly("distance_computations", &QueryProfile::distance_computations)
+        .def_readonly("heap_operations", &QueryProfile::heap_operations)
+        .def_readonly("results", &QueryProfile::results)
+        .def_readonly("encode_ns", &QueryProfile::encode_ns)
+        .def_readonly("lock_wait_ns", &QueryProfile::lock_wait_ns)
+        .def_readonly("filter_ns", &QueryProfile::filter_ns)
+        .def_readonly("search_ns", &QueryProfile::search_ns)
+        .def_readonly("metadata_ns", &QueryProfile::metadata_ns)
+        .def_readonly("total_ns", &QueryProfile::total_ns)
+        .def("__str__", &QueryProfile::to_string);
+
     py::class_<QueryOptions>(m, "QueryOptions")
         .def(py::init<>())
         .def_readwrite("k", &QueryOptions::k)
@@ -140,22 +200,105 @@ PYBIND11_MODULE(pyvdb, m)
         .def_readwrite("date_to", &QueryOptions::date_to)
         .def_readwrite("asset_filter", &QueryOptions::asset_filter)
         .def_readwrite("bias_filter", &QueryOptions::bias_filter)
+        .def_readwrite("numeric_filters", &QueryOptions::numeric_filters)
         .def_readwrite("include_metadata", &QueryOptions::include_metadata)
-        .def_readwrite("deduplicate_by_date", &QueryOptions::deduplicate_by_date);
+        .def_readwrite("deduplicate_by_date", &QueryOptions::deduplicate_by_date)
+        .def_readwrite("force_plan", &QueryOptions::force_plan)
+        .def_readwrite("max_distance_computations", &QueryOptions::max_distance_computations)
+        .def_readwrite("profile", &QueryOptions::profile)
+        // Relative timeout; sets the absolute deadline from now
+        .def_property("timeout_ms", [](const QueryOptions &o) -> std::optional<double>
+                      {
+            if (!o.deadline) return std::nullopt;
+            return std::chrono::duration<double, std::milli>(*o.deadline - std::chrono::steady_clock::now()).count(); }, [](QueryOptions &o, std::optional<double> ms)
+                      {
+            if (!ms) {
+                o.deadline.reset();
+                return;
+            }
+            o.deadline = std::chrono::steady_clock::now() +
+                         std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(*ms)); });
 
     py::class_<QueryResult>(m, "QueryResult")
         .def_readonly("id", &QueryResult::id)
         .def_readonly("distance", &QueryResult::distance)
         .def_readonly("score", &QueryResult::score)
         .def_readonly("metadata", &QueryResult::metadata)
+        .def_readonly("plan", &QueryResult::plan)
+        .def_readonly("partial", &QueryResult::partial)
         .def("__repr__", [](const QueryResult &r)
              { return "<QueryResult id=" + std::to_string(r.id) +
-                      " score=" + std::to_string(r.score) + ">"; });
+                      " score=" + std::to_string(r.score) +
+                      " plan=" + std::string(query_plan_name(r.plan)) + ">"; });
+
+    // ========================================================================
+    // Batch Operations
+    // ========================================================================
+
+    py::enum_<TaskPriority>(m, "TaskPriority")
+        .value("Low", TaskPriority::Low)
+        .value("Normal", TaskPriority::Normal)
+        .value("High", TaskPriority::High);
+
+    py::class_<BatchConfig>(m, "BatchConfig")
+        .def(py::init<>())
+        .def_readwrite("batch_size", &BatchConfig::batch_size)
+        .def_readwrite("num_threads", &BatchConfig::num_threads)
+        .def_readwrite("fail_fast", &BatchConfig::fail_fast)
+        .def_readwrite("transactional", &BatchConfig::transactional)
+        .def_readwrite("progress_callback", &BatchConfig::progress_callback);
+
+    py::class_<BatchInsertResult>(m, "BatchInsertResult")
+        .def_readonly("ids", &BatchInsertResult::ids)
+        .def_readonly("successful", &BatchInsertResult::successful)
+        .def_readonly("failed", &BatchInsertResult::failed)
+        .def_readonly("errors", &BatchInsertResult::errors);
 
     // ========================================================================
     // Database Config
     // ========================================================================
 
+    py::class_<QueryCacheConfig>(m, "QueryCacheConfig")
+        .def(py::init<>())
+        .def_readwrite("max_bytes", &QueryCacheConfig::max_bytes)
+        .def_readwrite("quantize_key", &QueryCacheConfig::quantize_key)
+        .def_readwrite("similarity_threshold", &QueryCacheConfig::similarity_threshold);
+
+    py::class_<QueryBudgetStats>(m, "QueryBudgetStats")
+        .def_readonly("budgeted_queries", &QueryBudgetStats::budgeted_queries)
+        .def_readonly("deadline_exceeded", &QueryBudgetStats::deadline_exceeded)
+        .def_readonly("computations_exceeded", &QueryBudgetStats::computations_exceeded);
+
+    py::class_<TierStats>(m, "TierStats")
+        .def_readonly("hot_hits", &TierStats::hot_hits)
+        .def_readonly("cold_hits", &TierStats::cold_hits)
+        .def_readonly("misses", &TierStats::misses)
+        .def_readonly("promotions", &TierStats::promotions)
+        .def_readonly("demotions", &TierStats::demotions)
+        .def_readonly("evictions", &TierStats::evictions)
+        .def_readonly("hot_count", &TierStats::hot_count)
+        .def_readonly("cold_count", &TierStats::cold_count)
+        .def_property_readonly("hit_rate", &TierStats::hit_rate);
+
+    py::class_<QueryCacheStats>(m, "QueryCacheStats")
+        .def_readonly("hits", &QueryCacheStats::hits)
+        .def_readonly("near_hits", &QueryCacheStats::near_hits)
+        .def_readonly("misses", &QueryCacheStats::misses)
+        .def_readonly("evictions", &QueryCacheStats::evictions)
+        .def_readonly("invalidations", &QueryCacheStats::invalidations)
+        .def_readonly("saved_ns", &QueryCacheStats::saved_ns)
+        .def_readonly("entries", &QueryCacheStats::entries)
+        .def_readonly("bytes", &QueryCacheStats::bytes)
+        .def_property_readonly("hit_rate", &QueryCacheStats::hit_rate);
+
+    py::class_<embeddings::EmbeddingCacheStats>(m, "EmbeddingCacheStats")
+        .def_readonly("hits", &embeddings::EmbeddingCacheStats::hits)
+        .def_readonly("misses", &embeddings::EmbeddingCacheStats::misses)
+        .def_readonly("store_hits", &embeddings::EmbeddingCacheStats::store_hits)
+        .def_readonly("evictions", &embeddings::EmbeddingCacheStats::evictions)
+        .def_readonly("entries", &embeddings::EmbeddingCacheStats::entries)
+        .def_property_readonly("hit_rate", &embeddings::EmbeddingCacheStats::hit_rate);
+
     py::class_<DatabaseConfig>(m, "DatabaseConfig")
         .def(py::init<>())
         .def_readwrite("path", &DatabaseConfig::path)
@@ -169,8 +312,15 @@ PYBIND11_MODULE(pyvdb, m)
         .def_readwrite("image_model_path", &DatabaseConfig::image_model_path)
         .def_readwrite("vocab_path", &DatabaseConfig::vocab_path)
         .def_readwrite("num_threads", &DatabaseConfig::num_threads)
+        .def_readwrite("async_threads", &DatabaseConfig::async_threads)
+        .def_readwrite("async_queue_limit", &DatabaseConfig::async_queue_limit)
         .def_readwrite("memory_only", &DatabaseConfig::memory_only)
-        .def_readwrite("auto_sync", &DatabaseConfig::auto_sync);
+        .def_readwrite("auto_sync", &DatabaseConfig::auto_sync)
+        .def_readwrite("hot_budget_bytes", &DatabaseConfig::hot_budget_bytes)
+        .def_readwrite("cold_cache_bytes", &DatabaseConfig::cold_cache_bytes)
+        .def_readwrite("promote_threshold", &DatabaseConfig::promote_threshold)
+        .def_readwrite("query_cache", &DatabaseConfig::query_cache)
+        .def_readwrite("embedding_cache_entries", &DatabaseConfig::embedding_cache_entries);
 
     // ========================================================================
     // Index Stats
@@ -280,6 +430,79 @@ PYBIND11_MODULE(pyvdb, m)
             }
             return *result; }, py::arg("vector"), py::arg("options") = QueryOptions())
 
+        // Async operations: callback(error, result) runs on an executor thread
+        .def("query_vector_async", [](VectorDatabase &self, py::array_t<float> vec, py::function callback, const QueryOptions &options, TaskPriority priority)
+             {
+            auto cb = share_callback(std::move(callback));
+            self.query_vector_async(numpy_to_view(vec), options, [cb](Result<QueryResults> result) {
+                py::gil_scoped_acquire gil;
+                try {
+                    if (result) {
+                        (*cb)(py::none(), *result);
+                    } else {
+                        (*cb)(result.error().message, py::none());
+                    }
+                } catch (py::error_already_set &e) {
+                    // Runs on an executor thread: report like an unraisable hook error
+                    e.discard_as_unraisable(*cb);
+                }
+            }, priority); }, py::arg("vector"), py::arg("callback"), py::arg("options") = QueryOptions(), py::arg("priority") = TaskPriority::Normal)
+
+        .def("add_vector_async", [](VectorDatabase &self, py::array_t<float> vec, const Metadata &meta, py::function callback, TaskPriority priority)
+             {
+            auto cb = share_callback(std::move(callback));
+            self.add_vector_async(numpy_to_view(vec), meta, [cb](Result<VectorId> result) {
+                py::gil_scoped_acquire gil;
+                try {
+                    if (result) {
+                        (*cb)(py::none(), *result);
+                    } else {
+                        (*cb)(result.error().message, py::none());
+                    }
+                } catch (py::error_already_set &e) {
+                    // Runs on an executor thread: report like an unraisable hook error
+                    e.discard_as_unraisable(*cb);
+                }
+            }, priority); }, py::arg("vector"), py::arg("metadata"), py::arg("callback"), py::arg("priority") = TaskPriority::Normal)
+
+        // Batch operations take an (n, dim) array; the GIL is released while they run
+        .def("query_batch", [](VectorDatabase &self, py::array_t<float, py::array::c_style | py::array::forcecast> queries, size_t k, const QueryOptions &options, const BatchConfig &config)
+             {
+            py::buffer_info buf = queries.request();
+            if (buf.ndim != 2) {
+                throw std::runtime_error("Expected 2D array of shape (n, dim)");
+            }
+            const auto *rows = static_cast<const float *>(buf.ptr);
+            BatchQueryRequest request;
+            request.reserve(static_cast<size_t>(buf.shape[0]));
+            for (py::ssize_t i = 0; i < buf.shape[0]; ++i) {
+                request.push_back({VectorView(rows + i * buf.shape[1], static_cast<Dim>(buf.shape[1])), k});
+            }
+            Result<BatchQueryResult> result;
+            {
+                py::gil_scoped_release release;
+                result = self.query_batch(request, options, config);
+            }
+            if (!result) {
+                throw std::runtime_error(result.error().message);
+            }
+            return *result; }, py::arg("queries"), py::arg("k") = 10, py::arg("options") = QueryOptions(), py::arg("config") = BatchConfig())
+
+        .def("insert_batch", [](VectorDatabase &self, py::array_t<float, py::array::c_style | py::array::forcecast> vectors, const std::vector<Metadata> &metadata, const BatchConfig &config)
+             {
+            py::buffer_info buf = vectors.request();
+            if (buf.ndim != 2 || static_cast<size_t>(buf.shape[0]) != metadata.size()) {
+                throw std::runtime_error("Expected (n, dim) array with n metadata entries");
+            }
+            const auto *rows = static_cast<const float *>(buf.ptr);
+            BatchInsertRequest request;
+            request.reserve(metadata.size());
+            for (size_t i = 0; i < metadata.size(); ++i) {
+                request.push_back({VectorView(rows + i * buf.shape[1], static_cast<Dim>(buf.shape[1])), metadata[i]});
+            }
+            py::gil_scoped_release release;
+            return self.insert_batch(request, config); }, py::arg("vectors"), py::arg("metadata"), py::arg("config") = BatchConfig())
+
         .def("get_vector", [](VectorDatabase &self, VectorId id) -> py::object
              {
             auto vec = self.get_vector(id);
@@ -294,6 +517,23 @@ PYBIND11_MODULE(pyvdb, m)
         .def("find_by_type", &VectorDatabase::find_by_type, py::arg("type"))
         .def("find_by_asset", &VectorDatabase::find_by_asset, py::arg("asset"))
 
+        // Sparse embeddings (third hybrid retriever)
+        .def("add_sparse", [](VectorDatabase &self, VectorId id, const SparseVector &vector)
+             {
+            auto result = self.add_sparse(id, vector);
+            if (!result) {
+                throw std::runtime_error(result.error().message);
+            } }, py::arg("id"), py::arg("vector"))
+
+        .def("query_sparse", [](const VectorDatabase &self, const SparseVector &query, size_t k)
+             {
+            py::gil_scoped_release release;
+            auto result = self.query_sparse(query, k);
+            if (!result) {
+                throw std::runtime_error(result.error().message);
+            }
+            return *result; }, py::arg("query"), py::arg("k") = 10)
+
         // Deletion
         .def("remove", [](VectorDatabase &self, VectorId id)
              {
@@ -316,6 +556,10 @@ PYBIND11_MODULE(pyvdb, m)
         .def("count_by_type", &VectorDatabase::count_by_type, py::arg("type"))
         .def("all_dates", &VectorDatabase::all_dates)
         .def("stats", &VectorDatabase::stats)
+        .def("query_cache_stats", &VectorDatabase::query_cache_stats)
+        .def("budget_stats", &VectorDatabase::budget_stats)
+        .def("embedding_cache_stats", &VectorDatabase::embedding_cache_stats)
+        .def("vector_tier_stats", &VectorDatabase::vector_tier_stats)
         .def("optimize", &VectorDatabase::optimize)
         .def("sync", [](VectorDatabase &self)
              {
@@ -540,7 +784,16 @@ PYBIND11_MODULE(pyvdb, m)
         .def_readwrite("b", &BM25Config::b, "Length normalization parameter (default: 0.75)")
         .def_readwrite("min_term_length", &BM25Config::min_term_length, "Minimum term length (default: 2)")
         .def_readwrite("use_stemming", &BM25Config::use_stemming, "Enable Porter stemming (default: true)")
-        .def_readwrite("case_sensitive", &BM25Config::case_sensitive, "Case sensitive search (default: false)");
+        .def_readwrite("case_sensitive", &BM25Config::case_sensitive, "Case sensitive search (default: false)")
+        .def_readwrite("store_content", &BM25Config::store_content, "Keep raw text in saved segments (default: false)")
+        .def_readwrite("delta_segment_docs", &BM25Config::delta_segment_docs, "Documents buffered before the delta segment is sealed (default: 4096)")
+        .def_readwrite("search_shards", &BM25Config::search_shards, "Doc-id shards scored in parallel per query, 0 = one per core (default: 1)")
+        .def_readwrite("min_shard_docs", &BM25Config::min_shard_docs, "Smallest shard worth a separate task (default: 16384)")
+        .def_readwrite("store_positions", &BM25Config::store_positions, "Index term positions for phrase/proximity scoring (default: false)")
+        .def_readwrite("proximity_candidates", &BM25Config::proximity_candidates, "BM25 top-N re-scored with positions, 0 disables (default: 100)")
+        .def_readwrite("proximity_window", &BM25Config::proximity_window, "Max token distance between adjacent query terms (default: 8)")
+        .def_readwrite("phrase_weight", &BM25Config::phrase_weight, "Scale of the exact-phrase bonus (default: 1.0)")
+        .def_readwrite("proximity_weight", &BM25Config::proximity_weight, "Scale of the window-proximity bonus (default: 0.5)");
     
     // BM25Result
     py::class_<BM25Result>(m, "BM25Result")
@@ -549,6 +802,30 @@ PYBIND11_MODULE(pyvdb, m)
         .def_readonly("score", &BM25Result::score, "BM25 score")
         .def_readonly("matched_terms", &BM25Result::matched_terms, "List of matched terms");
     
+    // WeightedTerm
+    py::class_<WeightedTerm>(m, "WeightedTerm")
+        .def(py::init<>())
+        .def(py::init([](std::string term, float weight) {
+            return WeightedTerm{std::move(term), weight};
+        }), py::arg("term"), py::arg("weight") = 1.0f)
+        .def_readwrite("term", &WeightedTerm::term, "Query term")
+        .def_readwrite("weight", &WeightedTerm::weight, "Scales the term's BM25 contribution");
+    
+    // SparseVector
+    py::class_<SparseVector>(m, "SparseVector")
+        .def(py::init<>())
+        .def(py::init([](std::vector<uint32_t> terms, std::vector<float> weights) {
+            return SparseVector{std::move(terms), std::move(weights)};
+        }), py::arg("terms"), py::arg("weights"))
+        .def_readwrite("terms", &SparseVector::terms, "Vocabulary ids of the non-zero entries")
+        .def_readwrite("weights", &SparseVector::weights, "Non-negative weights, parallel to terms");
+    
+    // SparseResult
+    py::class_<SparseResult>(m, "SparseResult")
+        .def(py::init<>())
+        .def_readonly("id", &SparseResult::id, "Document ID")
+        .def_readonly("score", &SparseResult::score, "Dot product with the query");
+    
     // BM25Engine - wrapped in shared_ptr to handle incomplete Impl type
     py::class_<BM25Engine, std::shared_ptr<BM25Engine>>(m, "BM25Engine")
         .def(py::init([]() { return std::make_shared<BM25Engine>(); }), "Create BM25 engine with default config")
@@ -578,9 +855,23 @@ PYBIND11_MODULE(pyvdb, m)
             }
             return *result;
         }, py::arg("query"), py::arg("k") = 10, py::arg("min_score") = 0.0f, "Search documents")
+        .def("search_terms", [](const BM25Engine& self, const std::vector<WeightedTerm>& terms, size_t k, float min_score) {
+            py::gil_scoped_release release;
+            auto result = self.search(terms, k, min_score);
+            if (!result) {
+                throw std::runtime_error(result.error().message);
+            }
+            return *result;
+        }, py::arg("terms"), py::arg("k") = 10, py::arg("min_score") = 0.0f,
+           "Search pre-split weighted terms, e.g. from QueryRewriter.expand")
         .def("document_count", &BM25Engine::document_count, "Get number of indexed documents")
         .def("term_count", &BM25Engine::term_count, "Get number of unique terms")
         .def("average_document_length", &BM25Engine::average_document_length, "Get average document length")
+        .def("segment_count", &BM25Engine::segment_count, "Get number of index segments")
+        .def("compact", [](BM25Engine& self) {
+            py::gil_scoped_release release;
+            self.compact();
+        }, "Merge all segments into one, dropping deleted documents")
         .def("save", [](const BM25Engine& self, const std::string& path) {
             auto result = self.save(path);
             if (!result) {
@@ -609,6 +900,7 @@ PYBIND11_MODULE(pyvdb, m)
         .def(py::init<>())
         .def_readwrite("vector_weight", &HybridSearchConfig::vector_weight, "Weight for vector search (default: 0.7)")
         .def_readwrite("lexical_weight", &HybridSearchConfig::lexical_weight, "Weight for lexical search (default: 0.3)")
+        .def_readwrite("sparse_weight", &HybridSearchConfig::sparse_weight, "Weight for sparse-vector search (default: 0.0)")
         .def_readwrite("fusion", &HybridSearchConfig::fusion, "Fusion method (default: RRF)")
         .def_readwrite("rrf_k", &HybridSearchConfig::rrf_k, "RRF constant (default: 60)")
         .def_readwrite("rerank", &HybridSearchConfig::rerank, "Apply reranking (default: true)");
@@ -620,8 +912,19 @@ PYBIND11_MODULE(pyvdb, m)
         .def_readonly("combined_score", &HybridResult::combined_score, "Combined score")
         .def_readonly("vector_score", &HybridResult::vector_score, "Vector similarity score")
         .def_readonly("lexical_score", &HybridResult::lexical_score, "Lexical (BM25) score")
+        .def_readonly("sparse_score", &HybridResult::sparse_score, "Sparse-vector dot product")
         .def_readonly("matched_keywords", &HybridResult::matched_keywords, "Matched keywords from lexical search");
     
+    // HybridQueryOptions
+    py::class_<HybridQueryOptions>(m, "HybridQueryOptions")
+        .def(py::init<>())
+        .def_readwrite("k", &HybridQueryOptions::k, "Number of fused results (default: 10)")
+        .def_readwrite("candidates", &HybridQueryOptions::candidates, "Depth of each retriever's list, at least k (default: 50)")
+        .def_readwrite("vector_options", &HybridQueryOptions::vector_options, "Filters and budgets for the vector search")
+        .def_readwrite("min_lexical_score", &HybridQueryOptions::min_lexical_score, "Minimum BM25 score (default: 0.0)")
+        .def_readwrite("sparse_query", &HybridQueryOptions::sparse_query, "Sparse query embedding; adds the database's sparse index as a third retriever")
+        .def_readwrite("include_metadata", &HybridQueryOptions::include_metadata, "Fetch metadata for the final results (default: true)");
+    
     // HybridSearchEngine
     py::class_<HybridSearchEngine>(m, "HybridSearchEngine")
         .def(py::init<>(), "Create hybrid search engine with default config")
@@ -637,6 +940,41 @@ PYBIND11_MODULE(pyvdb, m)
             return *result;
         }, py::arg("vector_results"), py::arg("lexical_results"), py::arg("k") = 10, 
            "Combine vector and lexical search results")
+        .def("combine_sparse", [](const HybridSearchEngine& self,
+                                  const std::vector<QueryResult>& vector_results,
+                                  const std::vector<BM25Result>& lexical_results,
+                                  const std::vector<SparseResult>& sparse_results,
+                                  size_t k) {
+            auto result = self.combine(vector_results, lexical_results, sparse_results, k);
+            if (!result) {
+                throw std::runtime_error(result.error().message);
+            }
+            return *result;
+        }, py::arg("vector_results"), py::arg("lexical_results"), py::arg("sparse_results"), py::arg("k") = 10,
+           "Combine vector, lexical and sparse-vector search results")
+        .def("search", [](const HybridSearchEngine& self, VectorDatabase& db, const BM25Engine& bm25,
+                          const std::string& query, const HybridQueryOptions& options) {
+            py::gil_scoped_release release;
+            auto result = self.search(db, bm25, query, options);
+            if (!result) {
+                throw std::runtime_error(result.error().message);
+            }
+            return *result;
+        }, py::arg("db"), py::arg("bm25"), py::arg("query"), py::arg("options") = HybridQueryOptions(),
+           "Run vector and BM25 search concurrently and fuse the rankings")
+        .def("search_vector", [](const HybridSearchEngine& self, VectorDatabase& db, const BM25Engine& bm25,
+                                 const std::string& query, py::array_t<float> vec,
+                                 const HybridQueryOptions& options) {
+            auto embedding = numpy_to_view(vec);
+            py::gil_scoped_release release;
+            auto result = self.search(db, bm25, query, embedding, options);
+            if (!result) {
+                throw std::runtime_error(result.error().message);
+            }
+            return *result;
+        }, py::arg("db"), py::arg("bm25"), py::arg("query"), py::arg("vector"),
+           py::arg("options") = HybridQueryOptions(),
+           "Hybrid search with a pre-computed query embedding")
         .def_static("weighted_sum", &HybridSearchEngine::weighted_sum,
                    py::arg("vec_score"), py::arg("lex_score"), py::arg("vec_weight"),
                    "Calculate weighted sum fusion")
@@ -649,4 +987,43 @@ PYBIND11_MODULE(pyvdb, m)
         .def_static("comb_mnz", &HybridSearchEngine::comb_mnz,
                    py::arg("vec_score"), py::arg("lex_score"), py::arg("num_systems"),
                    "Calculate CombMNZ fusion");
+    
+    // RewriteConfig
+    py::class_<RewriteConfig>(m, "RewriteConfig")
+        .def(py::init<>())
+        .def_readwrite("expand_synonyms", &RewriteConfig::expand_synonyms, "Expand synonyms (default: true)")
+        .def_readwrite("add_stemmed_terms", &RewriteConfig::add_stemmed_terms, "Append stems in rewrite() (default: true)")
+        .def_readwrite("max_expansions", &RewriteConfig::max_expansions, "Synonyms used per matched phrase (default: 5)")
+        .def_readwrite("synonym_weight", &RewriteConfig::synonym_weight, "Weight of synonym terms in expand() (default: 0.5)");
+    
+    // QueryRewriter - wrapped in shared_ptr to handle incomplete Impl type
+    py::class_<QueryRewriter, std::shared_ptr<QueryRewriter>>(m, "QueryRewriter")
+        .def(py::init([](const RewriteConfig& config) { return std::make_shared<QueryRewriter>(config); }),
+             py::arg("config") = RewriteConfig(), "Create query rewriter")
+        .def("rewrite", [](const QueryRewriter& self, const std::string& query) {
+            auto result = self.rewrite(query);
+            if (!result) {
+                throw std::runtime_error(result.error().message);
+            }
+            return *result;
+        }, py::arg("query"), "Rewrite query text with stems and synonyms")
+        .def("expand", [](const QueryRewriter& self, const std::string& query) {
+            auto result = self.expand(query);
+            if (!result) {
+                throw std::runtime_error(result.error().message);
+            }
+            return *result;
+        }, py::arg("query"), "Expand query into weighted terms for BM25Engine.search_terms")
+        .def("add_synonym", [](QueryRewriter& self, const std::string& term, const std::vector<std::string>& synonyms) {
+            auto result = self.add_synonym(term, synonyms);
+            if (!result) {
+                throw std::runtime_error(result.error().message);
+            }
+        }, py::arg("term"), py::arg("synonyms"), "Map a word or phrase to synonyms")
+        .def("load_synonyms", [](QueryRewriter& self, const std::string& path) {
+            auto result = self.load_synonyms(path);
+            if (!result) {
+                throw std::runtime_error(result.error().message);
+            }
+        }, py::arg("path"), "Load a synonym file");
 }
@@ -6,6 +6,7 @@
 
 #include "../core.hpp"
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <variant>
 #include <unordered_map>
@@ -182,6 +183,14 @@ class DataAdapterManager {
         const ChunkConfig& config = {},
         size_t max_parallel = 4
     );
+    
+    /// Parse files one at a time, yielding each chunk's content in order;
+    /// only the current file's chunks are held in memory. Suits
+    /// hybrid::DocumentSource. The manager must outlive the stream.
+    [[nodiscard]] std::function<Result<std::optional<std::string>>()> stream_chunks(
+        std::vector<fs::path> paths,
+        const ChunkConfig& config = {}
+    );
 
 private:
     std::vector<std::unique_ptr<IDataAdapter>> adapters_;
@@ -10,6 +10,8 @@
 
 namespace vdb {
 
+struct QueryResult;                         // Defined in database.hpp
+
 // ============================================================================
 // Batch Insert Request
 // ============================================================================
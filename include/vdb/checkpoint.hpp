@@ -0,0 +1,125 @@
+#pragma once
+// ============================================================================
+// VectorDB - Crash-Safe Checkpoint Files
+// ============================================================================
+
+#include "core.hpp"
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace vdb {
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Checkpoint Footer
+// ============================================================================
+
+/// Trailer appended to every checkpoint payload. Its presence distinguishes
+/// checkpoints from legacy files, which are accepted without verification.
+struct CheckpointFooter {
+    uint64_t payload_size;    // Bytes preceding the footer
+    uint32_t checksum;        // CRC-32C of the payload
+    uint32_t version;         // Footer format version
+    uint64_t magic;           // "VDBCKPT\0"
+
+    static constexpr uint64_t MAGIC = 0x0054504B43424456ULL;  // "VDBCKPT\0"
+    static constexpr uint32_t CURRENT_VERSION = 1;
+    static constexpr size_t SIZE = 24;
+};
+
+static_assert(sizeof(CheckpointFooter) == CheckpointFooter::SIZE,
+              "Checkpoint footer must be 24 bytes");
+
+// ============================================================================
+// Payload Encoding
+// ============================================================================
+
+/// Append the raw (host-endian) bytes of a trivially copyable value
+template<typename T>
+void put_raw(std::vector<uint8_t>& out, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+/// Read a value written by put_raw at offset and advance past it; false,
+/// leaving offset alone, if the payload is too short
+template<typename T>
+[[nodiscard]] bool get_raw(std::span<const uint8_t> data, size_t& offset, T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (offset > data.size() || data.size() - offset < sizeof(T)) return false;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+/// Bounds-checked cursor over an encoded payload; every read fails once the
+/// input is exhausted
+class ByteReader {
+public:
+    explicit ByteReader(std::span<const uint8_t> data, size_t offset = 0)
+        : data_(data), offset_(offset) {}
+
+    template<typename T>
+    [[nodiscard]] bool read(T& value) {
+        return get_raw(data_, offset_, value);
+    }
+
+    [[nodiscard]] bool read_bytes(void* dest, size_t size) {
+        if (size > remaining()) return false;
+        if (size > 0) std::memcpy(dest, data_.data() + offset_, size);
+        offset_ += size;
+        return true;
+    }
+
+    /// View the next length bytes without copying and advance past them
+    [[nodiscard]] bool take(size_t length, std::span<const uint8_t>& out) {
+        if (length > remaining()) return false;
+        out = data_.subspan(offset_, length);
+        offset_ += length;
+        return true;
+    }
+
+    [[nodiscard]] size_t remaining() const {
+        return offset_ < data_.size() ? data_.size() - offset_ : 0;
+    }
+    [[nodiscard]] size_t offset() const { return offset_; }
+
+private:
+    std::span<const uint8_t> data_;
+    size_t offset_;
+};
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+/// CRC-32C (Castagnoli); uses SSE4.2 when available
+[[nodiscard]] uint32_t crc32c(std::span<const uint8_t> data, uint32_t crc = 0);
+
+/// Path of the checkpoint kept for fallback when `path` is replaced
+[[nodiscard]] fs::path previous_checkpoint_path(const fs::path& path);
+
+/// Write data to a temp file, fsync it, and atomically rename it over `path`.
+/// With keep_previous, the replaced file is retained as previous_checkpoint_path().
+[[nodiscard]] Result<void> write_file_atomic(
+    const fs::path& path,
+    std::span<const uint8_t> data,
+    bool keep_previous = false
+);
+
+/// Atomically write payload followed by a checksum footer
+[[nodiscard]] Result<void> write_checkpoint(
+    const fs::path& path,
+    std::span<const uint8_t> payload
+);
+
+/// Read a single checkpoint file and verify its footer.
+/// Returns IndexCorrupted if the checksum does not match.
+[[nodiscard]] Result<std::vector<uint8_t>> read_checkpoint(const fs::path& path);
+
+} // namespace vdb
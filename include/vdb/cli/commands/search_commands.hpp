@@ -30,10 +30,12 @@ class SearchCommand : public CommandBase {
   --date-from DATE     Filter by date from (YYYY-MM-DD)
   --date-to DATE       Filter by date to (YYYY-MM-DD)
   --asset ASSET        Filter by asset
+  --profile            Print an execution breakdown (EXPLAIN ANALYZE)
 
 Examples:
   hektor search ./mydb "gold prices" -k 20
   hektor s ./mydb "outlook" --type journal
+  hektor search ./mydb "gold prices" --profile
 )";
     }
     
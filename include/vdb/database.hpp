@@ -4,14 +4,25 @@
 // ============================================================================
 
 #include "core.hpp"
+#include "batch.hpp"
 #include "index.hpp"
 #include "storage.hpp"
 #include "distance.hpp"
+#include "snapshot.hpp"
+#include "thread_pool.hpp"
+#include "index/metadata_index.hpp"
+#include "index/numeric_columns.hpp"
+#include "embeddings/embedding_cache.hpp"
+#include "hybrid/sparse_index.hpp"
 #ifdef VDB_USE_ONNX_RUNTIME
 #include "embeddings/text.hpp"
 #include "embeddings/image.hpp"
 #endif
 #include <filesystem>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
 
 namespace vdb {
 
@@ -28,6 +39,14 @@ using embeddings::Device;
 // Database Configuration
 // ============================================================================
 
+/// Result cache for repeated queries (disabled when max_bytes == 0)
+struct QueryCacheConfig {
+    size_t max_bytes = 0;                   // LRU byte budget
+    bool quantize_key = true;               // Hash SQ8 codes, not raw floats
+    float similarity_threshold = 0.0f;      // Near-duplicate hit threshold, cosine-like (0 = exact only)
+    size_t similarity_scan_limit = 64;      // Most recent entries checked for near-duplicates
+};
+
 struct DatabaseConfig {
     fs::path path;                          // Database directory
     Dim dimension = UNIFIED_DIM;            // 512 unified dimension
@@ -47,11 +66,78 @@ struct DatabaseConfig {
     
     // Execution
     int num_threads = 0;                    // 0 = auto
+    size_t async_threads = 0;               // Executor workers for *_async calls (0 = auto)
+    size_t async_queue_limit = 4096;        // Queued async requests before new ones are refused
     
     // Storage
     bool memory_only = false;               // For testing
     bool auto_sync = true;                  // Sync after each write
-    size_t sync_interval_ms = 5000;         // Batch sync interval
+    size_t sync_interval_ms = 5000;         // Background checkpoint interval (0 = disabled)
+    MmapOptions mmap;                       // Mapping behaviour for vectors.bin
+    
+    // Vector tiering: filtered exact scans read vectors through a hot/cold
+    // cache over vectors.bin instead of the index (both sizes zero = off).
+    // This bounds what exact scans pull through the page cache, not process
+    // memory: the HNSW index still keeps its own copy of every vector for
+    // graph traversal.
+    size_t hot_budget_bytes = 0;            // Pinned arena for frequently scanned vectors
+    size_t cold_cache_bytes = 0;            // LRU cache for vectors read from disk
+    uint32_t promote_threshold = 3;         // Cold hits before promotion to the hot arena
+    
+    // Caching
+    QueryCacheConfig query_cache;
+    size_t embedding_cache_entries = 0;     // Text embedding cache (0 = disabled)
+};
+
+// ============================================================================
+// Query Plan
+// ============================================================================
+
+/// Execution strategy chosen by the query planner
+enum class QueryPlan : uint8_t {
+    Hnsw,               // Unfiltered graph search
+    ExactScan,          // Brute-force distances over the filter's candidate IDs
+    FilteredHnsw,       // Graph search that only admits matching IDs
+    HnswPostFilter      // Over-fetching graph search, filtered afterwards
+};
+
+[[nodiscard]] constexpr std::string_view query_plan_name(QueryPlan plan) {
+    switch (plan) {
+        case QueryPlan::Hnsw: return "hnsw";
+        case QueryPlan::ExactScan: return "exact_scan";
+        case QueryPlan::FilteredHnsw: return "filtered_hnsw";
+        case QueryPlan::HnswPostFilter: return "hnsw_post_filter";
+        default: return "unknown";
+    }
+}
+
+// ============================================================================
+// Query Profile
+// ============================================================================
+
+/// Execution breakdown for one query ("EXPLAIN ANALYZE"), filled in when
+/// QueryOptions::profile is set. Each query overwrites it.
+struct QueryProfile {
+    QueryPlan plan = QueryPlan::Hnsw;       // Final plan, after any fallback
+    bool cache_hit = false;
+    bool partial = false;                   // Budget ran out, even if no results were found
+    size_t candidates = 0;                  // IDs passing the filters (0 = unfiltered)
+    size_t levels_descended = 0;            // HNSW layers above 0 routed through
+    size_t nodes_visited = 0;
+    size_t distance_computations = 0;
+    size_t heap_operations = 0;
+    size_t results = 0;
+    
+    // Wall time in nanoseconds
+    uint64_t encode_ns = 0;                 // query_text / query_image only
+    uint64_t lock_wait_ns = 0;
+    uint64_t filter_ns = 0;                 // Filter resolution and planning
+    uint64_t search_ns = 0;
+    uint64_t metadata_ns = 0;               // Metadata fetch and post-filtering
+    uint64_t total_ns = 0;
+    
+    /// Multi-line, human-readable breakdown
+    [[nodiscard]] std::string to_string() const;
 };
 
 // ============================================================================
@@ -69,10 +155,21 @@ struct QueryOptions {
     std::optional<std::string> date_to;          // Date range end
     std::optional<std::string> asset_filter;     // For charts
     std::optional<std::string> bias_filter;      // BULLISH, BEARISH, NEUTRAL
+    std::vector<index::NumericPredicate> numeric_filters;  // ANDed, e.g. vix > 20
     
     // Reranking
     bool include_metadata = true;
     bool deduplicate_by_date = false;       // One result per date
+    
+    // Planning
+    std::optional<QueryPlan> force_plan;    // Override the cost-based planner
+    
+    // Budget: when either limit is hit the best results so far are returned
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    size_t max_distance_computations = 0;   // 0 = unlimited
+    
+    // Diagnostics: when set, the query's execution profile is written here
+    std::shared_ptr<QueryProfile> profile;
 };
 
 // ============================================================================
@@ -84,6 +181,8 @@ struct QueryResult {
     Distance distance;
     float score;                            // 1.0 - distance (similarity)
     std::optional<Metadata> metadata;
+    QueryPlan plan = QueryPlan::Hnsw;       // How the query was executed
+    bool partial = false;                   // Budget ran out (QueryProfile::partial also covers no results)
     
     bool operator<(const QueryResult& other) const {
         return score > other.score;  // Higher score first
@@ -92,6 +191,88 @@ struct QueryResult {
 
 using QueryResults = std::vector<QueryResult>;
 
+/// How often query budgets cut searches short
+struct QueryBudgetStats {
+    uint64_t budgeted_queries = 0;          // Queries with a deadline or computation limit
+    uint64_t deadline_exceeded = 0;
+    uint64_t computations_exceeded = 0;
+};
+
+// ============================================================================
+// Query Result Cache
+// ============================================================================
+
+/// Stable hash of the options that affect a query's results. Predicate
+/// order is normalized, since filters are ANDed.
+[[nodiscard]] uint64_t query_options_hash(const QueryOptions& options);
+
+struct QueryCacheStats {
+    uint64_t hits = 0;                      // Exact key matches
+    uint64_t near_hits = 0;                 // Served by similarity threshold
+    uint64_t misses = 0;
+    uint64_t evictions = 0;                 // Dropped for the byte budget
+    uint64_t invalidations = 0;             // Dropped because a write happened
+    uint64_t saved_ns = 0;                  // Latency of the original queries served from cache
+    size_t entries = 0;
+    size_t bytes = 0;
+    
+    [[nodiscard]] double hit_rate() const {
+        uint64_t total = hits + near_hits + misses;
+        return total > 0 ? static_cast<double>(hits + near_hits) / total : 0.0;
+    }
+};
+
+/// LRU cache of query results under a byte budget. Entries are tagged with
+/// the database write epoch and are only served while the epoch matches.
+class QueryResultCache {
+public:
+    /// metric decides whether query magnitude is part of the key: cosine
+    /// results are scale-invariant, L2 and dot product results are not
+    explicit QueryResultCache(const QueryCacheConfig& config,
+                              DistanceMetric metric = DistanceMetric::Cosine);
+    
+    /// Cached results for query + options at the given epoch
+    [[nodiscard]] std::optional<QueryResults> lookup(
+        VectorView query, uint64_t options_hash, uint64_t epoch);
+    
+    /// Store results; latency_ns is credited to saved_ns on later hits
+    void insert(VectorView query, uint64_t options_hash, uint64_t epoch,
+                const QueryResults& results, uint64_t latency_ns);
+    
+    void clear();
+    
+    [[nodiscard]] QueryCacheStats stats() const;
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint64_t options_hash;
+        uint64_t epoch;
+        std::vector<int8_t> codes;          // SQ8 codes (+ scale unless cosine, when quantize_key)
+        Vector query;                       // For verification and similarity
+        QueryResults results;
+        uint64_t latency_ns;
+        size_t bytes;
+    };
+    using EntryList = std::list<Entry>;
+    
+    [[nodiscard]] std::vector<int8_t> quantize(VectorView query) const;
+    [[nodiscard]] uint64_t key_for(VectorView query, const std::vector<int8_t>& codes,
+                                   uint64_t options_hash) const;
+    [[nodiscard]] bool same_query(const Entry& entry, VectorView query,
+                                  const std::vector<int8_t>& codes) const;
+    [[nodiscard]] float similarity(VectorView query, VectorView cached) const;
+    void erase(EntryList::iterator it);
+    
+    QueryCacheConfig config_;
+    DistanceMetric metric_;
+    EntryList lru_;                         // Front = most recently used
+    std::unordered_multimap<uint64_t, EntryList::iterator> entries_;
+    size_t bytes_ = 0;
+    QueryCacheStats stats_;
+    mutable std::mutex mutex_;
+};
+
 // ============================================================================
 // Ingest Options
 // ============================================================================
@@ -200,6 +381,78 @@ class VectorDatabase {
     /// Get vector by ID
     [[nodiscard]] std::optional<Vector> get_vector(VectorId id) const;
     
+    // ========================================================================
+    // Sparse Vector Operations
+    // ========================================================================
+    
+    /// Attach a learned sparse (SPLADE-style) embedding to a stored vector.
+    /// Checkpointed next to the dense index by sync(); dropped on remove().
+    [[nodiscard]] Result<void> add_sparse(VectorId id, const hybrid::SparseVector& vector);
+    
+    /// Top-k stored vectors by sparse dot product (no filters, no metadata)
+    [[nodiscard]] Result<std::vector<hybrid::SparseResult>> query_sparse(
+        const hybrid::SparseVector& query,
+        size_t k = 10
+    ) const;
+    
+    // ========================================================================
+    // Asynchronous Operations
+    // ========================================================================
+    
+    /// Queue a query on the database's executor. The vector and options are
+    /// copied, so the caller's buffers may be released immediately. When the
+    /// queue is full the future is ready at once with an InvalidState error.
+    [[nodiscard]] std::future<Result<QueryResults>> query_vector_async(
+        VectorView query,
+        const QueryOptions& options = {},
+        TaskPriority priority = TaskPriority::Normal
+    );
+    
+    /// Callback form; on_complete runs on an executor thread, or inline on
+    /// the caller's thread if the request is refused
+    void query_vector_async(
+        VectorView query,
+        const QueryOptions& options,
+        std::function<void(Result<QueryResults>)> on_complete,
+        TaskPriority priority = TaskPriority::Normal
+    );
+    
+    /// Queue an insert on the database's executor
+    [[nodiscard]] std::future<Result<VectorId>> add_vector_async(
+        VectorView vector,
+        const Metadata& metadata,
+        TaskPriority priority = TaskPriority::Normal
+    );
+    
+    /// Callback form of add_vector_async
+    void add_vector_async(
+        VectorView vector,
+        const Metadata& metadata,
+        std::function<void(Result<VectorId>)> on_complete,
+        TaskPriority priority = TaskPriority::Normal
+    );
+    
+    // ========================================================================
+    // Batch Operations
+    // ========================================================================
+    
+    /// Run many queries under one read lock. Filters in `options` are
+    /// resolved and planned once; each item's k overrides options.k. Exact
+    /// scans compare a block of queries per candidate load. Batches bypass
+    /// the query result cache.
+    [[nodiscard]] Result<BatchQueryResult> query_batch(
+        const BatchQueryRequest& queries,
+        const QueryOptions& options = {},
+        const BatchConfig& config = {}
+    );
+    
+    /// Insert many vectors, taking the write lock once per config.batch_size
+    /// items (once overall when transactional). ids lists inserted IDs.
+    [[nodiscard]] BatchInsertResult insert_batch(
+        const BatchInsertRequest& items,
+        const BatchConfig& config = {}
+    );
+    
     // ========================================================================
     // Metadata Operations
     // ========================================================================
@@ -260,12 +513,38 @@ class VectorDatabase {
     /// Optimize index
     void optimize();
     
-    /// Sync to disk
+    /// Sync to disk (writes a crash-safe checkpoint)
     [[nodiscard]] Result<void> sync();
     
+    /// Counts of queries whose deadline or computation budget ran out
+    [[nodiscard]] QueryBudgetStats budget_stats() const;
+    
+    /// Query result cache statistics (nullopt when the cache is disabled)
+    [[nodiscard]] std::optional<QueryCacheStats> query_cache_stats() const;
+    
+    /// Text embedding cache statistics (nullopt when the cache is disabled)
+    [[nodiscard]] std::optional<embeddings::EmbeddingCacheStats> embedding_cache_stats() const;
+    
+    /// Vector tier counters (nullopt when tiering is disabled)
+    [[nodiscard]] std::optional<TierStats> vector_tier_stats() const;
+    
+    /// Write epoch covered by the most recent successful checkpoint
+    [[nodiscard]] uint64_t checkpoint_epoch() const;
+    
     /// Compact storage
     [[nodiscard]] Result<void> compact();
     
+    // ========================================================================
+    // Snapshots
+    // ========================================================================
+    
+    /// Take an immutable point-in-time view of vectors and metadata.
+    /// Cost is O(pages); writers copy a page only when they touch it.
+    [[nodiscard]] SnapshotPtr snapshot() const;
+    
+    /// Current write epoch (incremented on every mutation)
+    [[nodiscard]] uint64_t write_epoch() const;
+    
     // ========================================================================
     // Export
     // ========================================================================
@@ -283,16 +562,87 @@ class VectorDatabase {
         const QueryOptions& options
     ) const;
     
+    /// Resolve QueryOptions filters to matching IDs (nullopt if unfiltered)
+    [[nodiscard]] std::optional<index::RoaringBitmap> resolve_filters(
+        const QueryOptions& options
+    ) const;
+    
+    /// Pick an execution strategy from filter selectivity (caller holds lock)
+    [[nodiscard]] QueryPlan plan_query(
+        const std::optional<index::RoaringBitmap>& allowed,
+        const QueryOptions& options
+    ) const;
+    
+    /// Exact k-NN over candidate IDs (caller holds lock)
+    [[nodiscard]] SearchResults exact_scan(
+        VectorView query,
+        const index::RoaringBitmap& candidates,
+        size_t k,
+        SearchBudget* budget = nullptr
+    ) const;
+    
+    /// Exact k-NN for a block of queries in one pass over the candidates
+    [[nodiscard]] std::vector<SearchResults> exact_scan_block(
+        std::span<const VectorView> queries,
+        const index::RoaringBitmap& candidates,
+        size_t k,
+        SearchBudget* budget = nullptr
+    ) const;
+    
+    /// Run a planned search within budget and shape its results (caller holds lock)
+    [[nodiscard]] QueryResults execute_plan(
+        VectorView query,
+        const QueryOptions& options,
+        const std::optional<index::RoaringBitmap>& allowed,
+        QueryPlan plan,
+        SearchBudget& budget
+    ) const;
+    
+    /// Add a finished search's budget outcome to the counters
+    void record_budget(const SearchBudget& budget) const;
+    
+    /// Insert into index, stores and postings (caller holds unique lock)
+    [[nodiscard]] Result<VectorId> insert_locked(VectorView vector, const Metadata& metadata);
+    
+    /// Undo insert_locked (caller holds unique lock)
+    void erase_locked(VectorId id);
+    
+    /// Copy metadata for IDs from the record table (caller holds lock)
+    [[nodiscard]] std::vector<Metadata> collect_metadata(const index::RoaringBitmap& ids) const;
+    
+#ifdef VDB_USE_ONNX_RUNTIME
+    /// Encode text, consulting the embedding cache first
+    [[nodiscard]] Result<std::vector<float>> encode_text(std::string_view text);
+#endif
+    
+    /// Executor for *_async calls, created on first use
+    [[nodiscard]] BoundedExecutor& async_executor();
+    
+    /// Save the embedding cache if it changed since the last save
+    void persist_embedding_cache();
+    
     /// Project text embedding to unified dimension
     [[nodiscard]] Vector project_text_embedding(const Vector& text_emb);
     
     /// Ensure models are downloaded
     [[nodiscard]] Result<void> ensure_models();
     
+    /// Publish a record to the snapshot table and metadata postings (caller holds unique lock)
+    void publish_record(VectorId id, const Metadata& metadata);
+    
+    /// Start/stop the background checkpoint thread
+    void start_checkpointer();
+    void stop_checkpointer();
+    void checkpointer_loop();
+    /// Dense writes or sparse-index changes not yet in a checkpoint
+    [[nodiscard]] bool checkpoint_pending() const;
+    
     DatabaseConfig config_;
     DatabasePaths paths_;
     
     std::unique_ptr<HnswIndex> index_;
+    std::unique_ptr<hybrid::SparseIndex> sparse_index_;
+    uint64_t sparse_index_saved_ = 0;       // Generation last checkpointed
     std::unique_ptr<VectorStore> vectors_;
     std::unique_ptr<MetadataStore> metadata_;
 #ifdef VDB_USE_ONNX_RUNTIME
@@ -301,9 +651,34 @@ class VectorDatabase {
     std::unique_ptr<ProjectionMatrix> text_projection_;
 #endif
     
+    CowRecordTable records_;
+    index::MetadataIndex metadata_index_;   // Postings for type/date/asset/bias
+    index::NumericColumns numeric_columns_; // Market fields for numeric filters
+    uint64_t write_epoch_ = 0;
+    std::unique_ptr<QueryResultCache> query_cache_;
+    mutable std::atomic<uint64_t> budgeted_queries_{0};
+    mutable std::atomic<uint64_t> deadline_exceeded_{0};
+    mutable std::atomic<uint64_t> computations_exceeded_{0};
+    std::unique_ptr<embeddings::EmbeddingCache> embedding_cache_;
+    std::string text_model_id_;             // Embedding cache namespace
+    uint64_t embedding_cache_saved_ = 0;    // Generation last written to disk
+    
     VectorId next_id_ = 1;
     bool ready_ = false;
     mutable std::shared_mutex mutex_;
+    
+    // Checkpointing: sync_mutex_ serializes checkpoints, checkpointer_mutex_
+    // guards the background thread's stop flag
+    mutable std::mutex sync_mutex_;
+    uint64_t checkpoint_epoch_ = 0;
+    std::thread checkpointer_;
+    std::mutex checkpointer_mutex_;
+    std::condition_variable checkpointer_cv_;
+    bool checkpointer_stop_ = false;
+    
+    // Async executor; drained before the state its tasks touch is destroyed or moved
+    std::unique_ptr<BoundedExecutor> async_executor_;
+    std::mutex async_mutex_;
 };
 
 // ============================================================================
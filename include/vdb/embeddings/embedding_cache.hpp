@@ -0,0 +1,156 @@
+#pragma once
+// ============================================================================
+// VectorDB - Embedding Cache
+// Sharded LRU of text embeddings keyed by model id and content hash
+// ============================================================================
+
+#include "../core.hpp"
+#include <atomic>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace vdb {
+
+namespace storage {
+class SqliteStore;
+}
+
+namespace embeddings {
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Configuration & Statistics
+// ============================================================================
+
+struct EmbeddingCacheConfig {
+    size_t max_entries = 10000;             // Total across all shards
+    size_t num_shards = 16;                 // Independent locks
+};
+
+struct EmbeddingCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t store_hits = 0;                // Misses served by an attached SqliteStore
+    uint64_t evictions = 0;
+    size_t entries = 0;
+
+    [[nodiscard]] double hit_rate() const {
+        uint64_t total = hits + misses;
+        return total > 0 ? static_cast<double>(hits) / total : 0.0;
+    }
+};
+
+// ============================================================================
+// Embedding Cache
+// ============================================================================
+
+/// Caches encoder output so repeated texts (saved searches, re-ingested
+/// documents) skip inference. Keys combine a hash of the model id with a
+/// 96-bit content hash, so embeddings from different models never mix.
+class EmbeddingCache {
+public:
+    explicit EmbeddingCache(const EmbeddingCacheConfig& config = {});
+    ~EmbeddingCache();
+
+    EmbeddingCache(const EmbeddingCache&) = delete;
+    EmbeddingCache& operator=(const EmbeddingCache&) = delete;
+
+    /// Cached embedding for text under model_id
+    [[nodiscard]] std::optional<std::vector<float>> get(std::string_view model_id,
+                                                        std::string_view text);
+
+    /// Store an embedding (writes through to an attached store)
+    void put(std::string_view model_id, std::string_view text, std::span<const float> embedding);
+
+    /// Return the cached embedding or compute, cache and return it
+    template<typename Compute>
+    [[nodiscard]] Result<std::vector<float>> get_or_compute(std::string_view model_id,
+                                                            std::string_view text,
+                                                            Compute&& compute);
+
+    void clear();
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] EmbeddingCacheStats stats() const;
+
+    /// Incremented on every insert; lets owners skip saving an unchanged cache
+    [[nodiscard]] uint64_t generation() const { return generation_.load(std::memory_order_relaxed); }
+
+    // ========================================================================
+    // Persistence
+    // ========================================================================
+
+    /// Write all entries to a checksummed binary file (atomic replace)
+    [[nodiscard]] Result<void> save(const fs::path& path) const;
+
+    /// Merge entries from a file written by save()
+    [[nodiscard]] Result<size_t> load(const fs::path& path);
+
+#ifdef HAVE_SQLITE3
+    /// Read through to / write through to the store's query_cache table.
+    /// The store must outlive the cache (or be detached with nullptr).
+    void attach(storage::SqliteStore* store);
+#endif
+
+private:
+    struct Key {
+        uint64_t model;
+        uint64_t content;
+        uint32_t check;                     // Second, independent content hash
+
+        bool operator==(const Key&) const = default;
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept {
+            return static_cast<size_t>(key.content ^ (key.model * 0x9E3779B97F4A7C15ULL));
+        }
+    };
+    struct Entry {
+        Key key;
+        std::vector<float> embedding;
+    };
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> lru;               // Front = most recently used
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> map;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t store_hits = 0;
+        uint64_t evictions = 0;
+    };
+
+    [[nodiscard]] static Key make_key(std::string_view model_id, std::string_view text);
+    [[nodiscard]] Shard& shard_for(const Key& key) const;
+    void insert(Shard& shard, const Key& key, std::vector<float> embedding);
+
+    size_t shard_capacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<uint64_t> generation_{0};
+#ifdef HAVE_SQLITE3
+    storage::SqliteStore* store_ = nullptr;
+#endif
+};
+
+// ============================================================================
+// Template Implementation
+// ============================================================================
+
+template<typename Compute>
+Result<std::vector<float>> EmbeddingCache::get_or_compute(std::string_view model_id,
+                                                          std::string_view text,
+                                                          Compute&& compute) {
+    if (auto cached = get(model_id, text)) {
+        return std::move(*cached);
+    }
+
+    Result<std::vector<float>> computed = compute(text);
+    if (computed) {
+        put(model_id, text, *computed);
+    }
+    return computed;
+}
+
+}} // namespace vdb::embeddings
@@ -0,0 +1,328 @@
+#pragma once
+// ============================================================================
+// VectorDB - Posting List Primitives
+// Block-max cursors, MaxScore top-k, bit packing and varints shared by the
+// BM25 and sparse-vector indexes
+// ============================================================================
+
+#include "../core.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <limits>
+
+namespace vdb {
+namespace hybrid {
+
+// ============================================================================
+// Constants
+// ============================================================================
+
+inline constexpr size_t POSTING_BLOCK_SIZE = 128;
+inline constexpr uint32_t NO_MORE_DOCS = std::numeric_limits<uint32_t>::max();
+
+// ============================================================================
+// Block Cursor
+// ============================================================================
+
+/// Forward-only cursor with block skipping over any list exposing sorted
+/// `docs` and per-POSTING_BLOCK_SIZE `blocks` carrying `last_doc`. The
+/// Scorer supplies `score(list, pos)` and `bound(block)`.
+///
+/// `shallow` may run ahead of `pos` (it only ever moves to blocks whose
+/// docs are all >= a target the cursor will later seek to), so seeks start
+/// from whichever is further.
+template<typename List, typename Scorer>
+struct BlockCursor {
+    const List* list;
+    Scorer scorer;
+    double max_score;                   // Bound over the whole list
+    size_t pos = 0;
+    size_t shallow = 0;
+
+    [[nodiscard]] uint32_t doc() const {
+        return pos < list->docs.size() ? list->docs[pos] : NO_MORE_DOCS;
+    }
+
+    [[nodiscard]] double score() const { return scorer.score(*list, pos); }
+
+    void next() { ++pos; }
+
+    /// Bound for the block holding target; 0 once past the last block
+    [[nodiscard]] double block_bound(uint32_t target) {
+        const auto& blocks = list->blocks;
+        shallow = std::max(shallow, pos / POSTING_BLOCK_SIZE);
+        while (shallow < blocks.size() && blocks[shallow].last_doc < target) {
+            ++shallow;
+        }
+        return shallow < blocks.size() ? scorer.bound(blocks[shallow]) : 0.0;
+    }
+
+    void seek(uint32_t target) {
+        if (doc() >= target) return;
+        (void)block_bound(target);
+        if (shallow >= list->blocks.size()) {
+            pos = list->docs.size();
+            return;
+        }
+        auto begin = list->docs.begin() +
+            static_cast<std::ptrdiff_t>(std::max(pos, shallow * POSTING_BLOCK_SIZE));
+        auto end = list->docs.begin() + static_cast<std::ptrdiff_t>(
+            std::min(list->docs.size(), (shallow + 1) * POSTING_BLOCK_SIZE));
+        pos = static_cast<size_t>(std::lower_bound(begin, end, target) - list->docs.begin());
+    }
+};
+
+// ============================================================================
+// Top-k
+// ============================================================================
+
+/// Bounded min-heap of (score, key). Keys encode (partition, doc) in search
+/// order, and on equal scores the smaller key wins.
+///
+/// Heaps filled in parallel over disjoint partitions can share `threshold`:
+/// the best k-th score any of them has reached. A document strictly below
+/// it cannot be in the merged top-k; an equal score may still win on key,
+/// so the shared bound is exclusive where the heap's own is inclusive.
+struct TopK {
+    using Entry = std::pair<double, uint64_t>;
+
+    size_t k;
+    float min_score;
+    std::vector<Entry> entries;
+    std::atomic<double>* threshold = nullptr;
+
+    static bool better(const Entry& a, const Entry& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    }
+
+    /// Results report float scores, so min_score is applied after rounding
+    [[nodiscard]] bool cannot_qualify(double bound) const {
+        return static_cast<float>(bound) < min_score ||
+               (entries.size() == k && bound <= entries.front().first) ||
+               (threshold && bound < threshold->load(std::memory_order_relaxed));
+    }
+
+    void push(double score, uint64_t key) {
+        entries.emplace_back(score, key);
+        std::push_heap(entries.begin(), entries.end(), better);
+        if (entries.size() > k) {
+            std::pop_heap(entries.begin(), entries.end(), better);
+            entries.pop_back();
+        }
+        if (threshold && entries.size() == k) {
+            double kth = entries.front().first;
+            double current = threshold->load(std::memory_order_relaxed);
+            while (kth > current &&
+                   !threshold->compare_exchange_weak(current, kth, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    [[nodiscard]] std::vector<Entry> take_sorted() {
+        std::sort_heap(entries.begin(), entries.end(), better);
+        return std::move(entries);
+    }
+};
+
+/// Documents [begin, end) of a partition
+struct DocRange {
+    uint32_t begin = 0;
+    uint32_t end = NO_MORE_DOCS;
+};
+
+/// MaxScore with block-max bounds over one partition. Cursors are ordered
+/// by their list-wide bound; the low-bound prefix whose summed bound cannot
+/// beat the current k-th score is "non-essential" and only probed for
+/// documents the essential lists produce. Block bounds then reject most
+/// of those candidates without reading their postings. Scores must be
+/// non-negative for the bounds to hold. `range` restricts evaluation to a
+/// doc-id shard; cursors start by skipping to its first block.
+template<typename Cursor, typename IsDeleted>
+void max_score_top_k(std::vector<Cursor>& cursors, uint64_t key_base, TopK& top,
+                     IsDeleted&& is_deleted, DocRange range = {}) {
+    std::sort(cursors.begin(), cursors.end(),
+        [](const auto& a, const auto& b) { return a.max_score < b.max_score; });
+    if (range.begin > 0) {
+        for (auto& cursor : cursors) {
+            cursor.seek(range.begin);
+        }
+    }
+
+    // prefix_bound[i] = summed bound of cursors [0, i]
+    std::vector<double> prefix_bound(cursors.size());
+    double running = 0.0;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        running += cursors[i].max_score;
+        prefix_bound[i] = running;
+    }
+
+    size_t first_essential = 0;
+    auto update_essential = [&] {
+        while (first_essential < cursors.size() &&
+               top.cannot_qualify(prefix_bound[first_essential])) {
+            ++first_essential;
+        }
+    };
+    update_essential();
+
+    // Per-list contributions, summed in cursor order once a document is
+    // scored so the result doesn't depend on which lists were essential
+    std::vector<double> parts(cursors.size());
+
+    auto skip_essential = [&](uint32_t doc) {
+        for (size_t i = first_essential; i < cursors.size(); ++i) {
+            if (cursors[i].doc() == doc) cursors[i].next();
+        }
+    };
+
+    while (first_essential < cursors.size()) {
+        // Other shards raise a shared threshold between our own pushes
+        if (top.threshold) {
+            update_essential();
+            if (first_essential == cursors.size()) break;
+        }
+        uint32_t doc = NO_MORE_DOCS;
+        for (size_t i = first_essential; i < cursors.size(); ++i) {
+            doc = std::min(doc, cursors[i].doc());
+        }
+        if (doc >= range.end) {
+            break;
+        }
+        if (is_deleted(doc)) {
+            skip_essential(doc);
+            continue;
+        }
+
+        double non_essential = first_essential > 0 ? prefix_bound[first_essential - 1] : 0.0;
+
+        // Block-level bound before touching any posting value
+        double bound = non_essential;
+        for (size_t i = first_essential; i < cursors.size(); ++i) {
+            if (cursors[i].doc() == doc) {
+                bound += cursors[i].block_bound(doc);
+            }
+        }
+        if (top.cannot_qualify(bound)) {
+            skip_essential(doc);
+            continue;
+        }
+
+        double score = 0.0;
+        std::fill(parts.begin(), parts.end(), 0.0);
+        for (size_t i = first_essential; i < cursors.size(); ++i) {
+            if (cursors[i].doc() == doc) {
+                parts[i] = cursors[i].score();
+                score += parts[i];
+                cursors[i].next();
+            }
+        }
+
+        // Probe non-essential lists from the largest bound down
+        bool pruned = false;
+        for (size_t i = first_essential; i-- > 0;) {
+            double rest = i > 0 ? prefix_bound[i - 1] : 0.0;
+            if (top.cannot_qualify(score + rest + cursors[i].max_score) ||
+                top.cannot_qualify(score + rest + cursors[i].block_bound(doc))) {
+                pruned = true;
+                break;
+            }
+            cursors[i].seek(doc);
+            if (cursors[i].doc() == doc) {
+                parts[i] = cursors[i].score();
+                score += parts[i];
+            }
+        }
+        if (pruned) {
+            continue;
+        }
+        score = 0.0;
+        for (double part : parts) {
+            score += part;
+        }
+        if (top.cannot_qualify(score)) {
+            continue;
+        }
+
+        top.push(score, key_base | doc);
+        update_essential();
+    }
+}
+
+// ============================================================================
+// Bit Packing
+// ============================================================================
+
+[[nodiscard]] inline uint8_t bit_width(uint32_t max_value) {
+    return static_cast<uint8_t>(32 - std::countl_zero(max_value));
+}
+
+[[nodiscard]] inline size_t packed_bytes(size_t count, uint8_t width) {
+    return (count * width + 7) / 8;
+}
+
+/// Append values using `width` bits each, least significant bit first
+inline void pack_bits(std::vector<uint8_t>& out, std::span<const uint32_t> values, uint8_t width) {
+    uint64_t buffer = 0;
+    unsigned filled = 0;
+    for (uint32_t value : values) {
+        buffer |= static_cast<uint64_t>(value) << filled;
+        filled += width;
+        while (filled >= 8) {
+            out.push_back(static_cast<uint8_t>(buffer));
+            buffer >>= 8;
+            filled -= 8;
+        }
+    }
+    if (filled > 0) {
+        out.push_back(static_cast<uint8_t>(buffer));
+    }
+}
+
+/// Inverse of pack_bits; `in` must hold packed_bytes(count, width) bytes
+inline void unpack_bits(const uint8_t* in, size_t count, uint8_t width, uint32_t* out) {
+    uint64_t mask = (uint64_t{1} << width) - 1;
+    uint64_t buffer = 0;
+    unsigned filled = 0;
+    for (size_t i = 0; i < count; ++i) {
+        while (filled < width) {
+            buffer |= static_cast<uint64_t>(*in++) << filled;
+            filled += 8;
+        }
+        out[i] = static_cast<uint32_t>(buffer & mask);
+        buffer >>= width;
+        filled -= width;
+    }
+}
+
+// ============================================================================
+// Variable-Byte Coding
+// ============================================================================
+
+/// Append value as 7-bit groups, least significant first, high bit = more
+inline void put_varint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+/// Decode one varint from [in, end); false if truncated or over 32 bits
+[[nodiscard]] inline bool get_varint(const uint8_t*& in, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 35 && in < end; shift += 7) {
+        uint8_t byte = *in++;
+        if (shift == 28 && byte > 0x0F) {
+            return false;
+        }
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace hybrid
+} // namespace vdb
@@ -0,0 +1,94 @@
+#pragma once
+// ============================================================================
+// VectorDB - Sparse Vector Index
+// Inverted index over learned sparse (SPLADE-style) embeddings
+// ============================================================================
+
+#include "../core.hpp"
+#include <filesystem>
+
+namespace vdb {
+namespace hybrid {
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Sparse Vectors
+// ============================================================================
+
+/// Non-zero entries of a sparse embedding: parallel (term id, weight)
+/// arrays over the encoder's vocabulary. Weights must be non-negative,
+/// which holds for SPLADE's log(1 + ReLU) activations.
+struct SparseVector {
+    std::vector<uint32_t> terms;
+    std::vector<float> weights;
+};
+
+struct SparseResult {
+    VectorId id;
+    float score;                            // Dot product with the query
+
+    bool operator<(const SparseResult& other) const {
+        return score > other.score;
+    }
+};
+
+// ============================================================================
+// Sparse Index
+// ============================================================================
+
+/// Postings keyed by term id with float weights, laid out in blocks like
+/// the BM25 index so dot-product top-k uses the same block-max MaxScore
+/// evaluation. Removal sets a deletion bit; deleted postings are dropped
+/// by compact(), which also runs once they outnumber live documents.
+/// Thread-safe: searches share a lock, writers take it exclusively.
+class SparseIndex {
+public:
+    SparseIndex();
+    ~SparseIndex();
+
+    SparseIndex(SparseIndex&&) noexcept;
+    SparseIndex& operator=(SparseIndex&&) noexcept;
+
+    SparseIndex(const SparseIndex&) = delete;
+    SparseIndex& operator=(const SparseIndex&) = delete;
+
+    /// Index a document's sparse embedding; zero weights are dropped
+    [[nodiscard]] Result<void> add(VectorId id, const SparseVector& vector);
+    [[nodiscard]] Result<void> remove(VectorId id);
+    [[nodiscard]] bool contains(VectorId id) const;
+
+    /// Top-k documents by dot product with query (duplicate query terms add up)
+    [[nodiscard]] Result<std::vector<SparseResult>> search(
+        const SparseVector& query,
+        size_t k = 10,
+        float min_score = 0.0f
+    ) const;
+
+    /// Drop deleted documents from the postings
+    void compact();
+
+    [[nodiscard]] size_t size() const;
+
+    /// Incremented on every change; lets owners skip saving an unchanged index
+    [[nodiscard]] uint64_t generation() const;
+
+    // ========================================================================
+    // Persistence
+    // ========================================================================
+
+    /// Live documents only, with bit-packed doc gaps
+    [[nodiscard]] std::vector<uint8_t> serialize() const;
+    [[nodiscard]] static Result<SparseIndex> deserialize(std::span<const uint8_t> data);
+
+    /// Write a checksummed file (atomic replace)
+    [[nodiscard]] Result<void> save(const fs::path& path) const;
+    [[nodiscard]] static Result<SparseIndex> load(const fs::path& path);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace hybrid
+} // namespace vdb
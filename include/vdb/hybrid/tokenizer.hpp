@@ -0,0 +1,110 @@
+#pragma once
+// ============================================================================
+// VectorDB - Text Tokenizer
+// Term pipeline shared by BM25, keyword extraction and query rewriting
+// ============================================================================
+
+#include "../core.hpp"
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace vdb {
+namespace hybrid {
+
+// ============================================================================
+// Tokens
+// ============================================================================
+
+struct TokenizerOptions {
+    bool lowercase = true;
+    bool remove_stop_words = true;
+    bool stem = false;
+    size_t min_length = 2;                  // Checked after lowercasing, before stemming
+};
+
+/// One term produced by Tokenizer. Views point into the TokenBuffer or the
+/// input and stay valid until the buffer is reused or the input released.
+struct Token {
+    std::string_view text;                  // Normalized term
+    std::string_view raw;                   // Original slice of the input
+    uint32_t position;                      // Index among all raw tokens, kept or not
+};
+
+/// Scratch space reused across calls. Once it has grown to the largest
+/// input seen, tokenizing allocates nothing. Not shareable between threads.
+class TokenBuffer {
+public:
+    [[nodiscard]] const std::vector<Token>& tokens() const { return tokens_; }
+    [[nodiscard]] auto begin() const { return tokens_.begin(); }
+    [[nodiscard]] auto end() const { return tokens_.end(); }
+    [[nodiscard]] size_t size() const { return tokens_.size(); }
+    [[nodiscard]] bool empty() const { return tokens_.empty(); }
+    [[nodiscard]] const Token& operator[](size_t i) const { return tokens_[i]; }
+
+private:
+    friend class Tokenizer;
+
+    std::string lowered_;                   // Lowercased copy of the input
+    std::vector<uint64_t> token_bits_;      // 1 = token character, one bit per input byte
+    std::vector<Token> tokens_;
+};
+
+// ============================================================================
+// Tokenizer
+// ============================================================================
+
+/// Splits on anything but ASCII letters, digits, '-' and '_', then
+/// lowercases, filters and stems as configured. Byte classification and
+/// lowercasing are vectorized; the tokenizer itself is immutable and can
+/// be shared between threads, each using its own TokenBuffer.
+class Tokenizer {
+public:
+    explicit Tokenizer(const TokenizerOptions& options = {}) : options_(options) {}
+
+    /// Replace the buffer's tokens with the terms of text
+    void tokenize(std::string_view text, TokenBuffer& buffer) const;
+
+    [[nodiscard]] const TokenizerOptions& options() const { return options_; }
+
+    /// Length filter, stop-word filter and stemming for one token that is
+    /// already split and case-normalized; nullopt if tokenize() would drop it
+    [[nodiscard]] std::optional<std::string_view> normalize(std::string_view term) const;
+
+    /// Strip one "-ing", "-ed" or "-s" (not "-ss") suffix from words longer than 3
+    [[nodiscard]] static std::string_view stem(std::string_view word);
+
+    /// Lookup in a precomputed perfect-hash table of English stop words
+    [[nodiscard]] static bool is_stop_word(std::string_view word);
+
+    /// ASCII-lowercased copy
+    [[nodiscard]] static std::string lowercase(std::string_view text);
+
+private:
+    TokenizerOptions options_;
+};
+
+// ============================================================================
+// Term Dictionary
+// ============================================================================
+
+/// Interns terms to dense integer ids. Not synchronized.
+class TermDictionary {
+public:
+    /// Id of term, assigning the next id if it is new
+    uint32_t intern(std::string_view term);
+
+    [[nodiscard]] std::optional<uint32_t> find(std::string_view term) const;
+    [[nodiscard]] std::string_view term(uint32_t id) const { return terms_[id]; }
+    [[nodiscard]] size_t size() const { return terms_.size(); }
+
+    void clear();
+
+private:
+    std::deque<std::string> terms_;         // Stable addresses back the ids_ keys
+    std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+} // namespace hybrid
+} // namespace vdb
@@ -5,6 +5,8 @@
 
 #include "core.hpp"
 #include "database.hpp"
+#include <functional>
+#include <iterator>
 #include <string>
 #include <vector>
 #include <map>
@@ -23,6 +25,19 @@ struct BM25Config {
     size_t min_term_length = 2;
     bool use_stemming = true;
     bool case_sensitive = false;
+    bool store_content = false;  // Keep raw text in memory and in saved segments
+    size_t delta_segment_docs = 4096;  // Docs buffered in the mutable delta before it is sealed
+    size_t search_shards = 1;          // Doc-id shards scored in parallel per query (0 = one per core)
+    size_t min_shard_docs = 16384;     // Smallest shard worth a task; smaller indexes score inline
+    
+    // Phrase and proximity scoring: a second pass over the BM25 top
+    // proximity_candidates adds bonuses from positional postings. Queries
+    // with fewer than two distinct terms skip it.
+    bool store_positions = false;      // Index term positions (delta-varint, saved with segments)
+    size_t proximity_candidates = 100; // First-pass depth re-scored (0 disables the pass)
+    size_t proximity_window = 8;       // Max token distance between adjacent query terms
+    float phrase_weight = 1.0f;        // Scale of the exact-phrase bonus
+    float proximity_weight = 0.5f;     // Scale of the window-proximity bonus
 };
 
 struct Term {
@@ -48,6 +63,18 @@ struct BM25Result {
     }
 };
 
+/// One term of a pre-split query, such as QueryRewriter::expand produces.
+/// BM25 applies its own case, stop-word, length and stemming rules to the
+/// term but never re-tokenizes it.
+struct WeightedTerm {
+    std::string term;
+    float weight = 1.0f;            // Scales the term's BM25 contribution
+};
+
+/// Thread-safe: searches run concurrently with each other and with writers.
+/// New documents go to a small mutable delta segment; sealed segments are
+/// immutable and read without locks, and removals only set a deletion bit
+/// until segments are merged.
 class BM25Engine {
 public:
     explicit BM25Engine(const BM25Config& config = {});
@@ -73,13 +100,27 @@ class BM25Engine {
         float min_score = 0.0f
     ) const;
     
+    /// Search pre-split terms; a weight acts like query-term multiplicity
+    /// and repeated terms add up. No phrase or proximity pass.
+    Result<std::vector<BM25Result>> search(
+        std::span<const WeightedTerm> terms,
+        size_t k = 10,
+        float min_score = 0.0f
+    ) const;
+    
+    /// Merge all segments into one, dropping deleted documents
+    void compact();
+    
     // Statistics
     size_t document_count() const;
     size_t term_count() const;
     float average_document_length() const;
+    size_t segment_count() const;
     
     // Persistence
+    /// Write a binary segment (term dictionary, bit-packed postings, norms)
     Result<void> save(const std::string& path) const;
+    /// Map and decode a segment; legacy text files are re-indexed
     static Result<BM25Engine> load(const std::string& path);
     
     /// Load from file, returning shared_ptr (safe across pImpl boundary)
@@ -99,8 +140,28 @@ struct KeywordConfig {
     float min_score = 0.1f;
     bool use_tfidf = true;
     bool use_position_weight = true;
+    size_t train_threads = 0;       // Tokenizing workers for train/update (0 = one per core)
+    size_t train_batch_docs = 256;  // Documents handed to a worker at a time
 };
 
+/// Pulls the next training document: its text, std::nullopt once the
+/// corpus is exhausted, or an error that aborts training. Called from the
+/// training thread only, so it need not be thread-safe.
+using DocumentSource = std::function<Result<std::optional<std::string>>()>;
+
+/// DocumentSource over [first, last); the range must outlive the source
+template<std::input_iterator It, std::sentinel_for<It> Sentinel>
+[[nodiscard]] DocumentSource document_source(It first, Sentinel last) {
+    return [first, last]() mutable -> Result<std::optional<std::string>> {
+        if (first == last) {
+            return std::nullopt;
+        }
+        std::string document(*first);
+        ++first;
+        return document;
+    };
+}
+
 struct Keyword {
     std::string term;
     float score;
@@ -128,10 +189,27 @@ class KeywordExtractor {
     // Extract keywords from text
     Result<std::vector<Keyword>> extract(const std::string& text) const;
     
-    // Train on corpus for TF-IDF
+    // Train on corpus for TF-IDF (replaces earlier statistics)
     Result<void> train(const std::vector<std::string>& documents);
     
+    /// Stream a corpus that need not fit in memory, replacing earlier
+    /// statistics. Workers count document frequencies into tables of their
+    /// own, merged once the source is exhausted; on error nothing changes.
+    Result<void> train(const DocumentSource& source);
+    
+    /// Add documents to the current statistics (e.g. archive files written
+    /// since the last save) without revisiting the rest of the corpus
+    Result<void> update(const std::vector<std::string>& documents);
+    Result<void> update(const DocumentSource& source);
+    
+    /// Documents the statistics were computed over
+    size_t document_count() const;
+    /// Trained documents containing term (lowercased, as extracted)
+    uint32_t document_frequency(std::string_view term) const;
+    
     // Persistence
+    /// Write config and document frequencies as a checksummed binary table
+    /// with front-coded terms; load() also reads the older text format
     Result<void> save(const std::string& path) const;
     static Result<KeywordExtractor> load(const std::string& path);
     
@@ -155,6 +233,7 @@ enum class FusionMethod {
 struct HybridSearchConfig {
     float vector_weight = 0.7f;     // Weight for vector search
     float lexical_weight = 0.3f;    // Weight for lexical search
+    float sparse_weight = 0.0f;     // Weight for sparse-vector search
     FusionMethod fusion = FusionMethod::RRF;
     size_t rrf_k = 60;              // RRF constant
     bool rerank = true;             // Apply reranking
@@ -165,6 +244,7 @@ struct HybridResult {
     float combined_score;
     float vector_score;
     float lexical_score;
+    float sparse_score = 0.0f;      // 0 unless a sparse ranking was fused
     std::optional<Metadata> metadata;
     std::vector<std::string> matched_keywords;
     
@@ -173,6 +253,16 @@ struct HybridResult {
     }
 };
 
+/// Options for HybridSearchEngine::search
+struct HybridQueryOptions {
+    size_t k = 10;
+    size_t candidates = 50;             // Depth of each retriever's list (at least k)
+    QueryOptions vector_options;        // Filters and budgets; k and include_metadata are overridden
+    float min_lexical_score = 0.0f;
+    std::optional<SparseVector> sparse_query;   // Adds VectorDatabase::query_sparse as a third retriever
+    bool include_metadata = true;       // Fetched for the final k results only
+};
+
 class HybridSearchEngine {
 public:
     explicit HybridSearchEngine(const HybridSearchConfig& config = {});
@@ -185,6 +275,36 @@ class HybridSearchEngine {
         size_t k = 10
     ) const;
     
+    /// Three-way fusion with a sparse-vector (SPLADE) ranking
+    Result<std::vector<HybridResult>> combine(
+        const std::vector<QueryResult>& vector_results,
+        const std::vector<BM25Result>& lexical_results,
+        const std::vector<SparseResult>& sparse_results,
+        size_t k = 10
+    ) const;
+    
+    /// One-shot hybrid query: the vector search (embedding query with the
+    /// database's text encoder) and the BM25 search run concurrently, so
+    /// latency is the slower of the two rather than their sum. A query with
+    /// no lexical terms is ranked by the vector side alone. Setting
+    /// options.sparse_query adds the database's sparse index as a third,
+    /// equally concurrent retriever.
+    Result<std::vector<HybridResult>> search(
+        VectorDatabase& db,
+        const BM25Engine& bm25,
+        std::string_view query,
+        const HybridQueryOptions& options = {}
+    ) const;
+    
+    /// As above, with a pre-computed query embedding
+    Result<std::vector<HybridResult>> search(
+        VectorDatabase& db,
+        const BM25Engine& bm25,
+        std::string_view query,
+        VectorView embedding,
+        const HybridQueryOptions& options = {}
+    ) const;
+    
     // Score fusion methods
     static float weighted_sum(float vec_score, float lex_score, float vec_weight);
     static float reciprocal_rank_fusion(size_t vec_rank, size_t lex_rank, size_t k);
@@ -204,7 +324,8 @@ struct RewriteConfig {
     bool expand_synonyms = true;
     bool correct_spelling = false;
     bool add_stemmed_terms = true;
-    size_t max_expansions = 5;
+    size_t max_expansions = 5;      // Synonyms used per matched phrase
+    float synonym_weight = 0.5f;    // Weight of synonym terms in expand()
 };
 
 class QueryRewriter {
@@ -223,10 +344,17 @@ class QueryRewriter {
     // Rewrite query for better results
     Result<std::string> rewrite(const std::string& query) const;
     
-    // Add synonyms
+    /// Expand in one pass into weighted terms for BM25Engine::search: query
+    /// terms at weight 1, synonym terms at config.synonym_weight (repeated
+    /// terms add up)
+    Result<std::vector<WeightedTerm>> expand(const std::string& query) const;
+    
+    /// Map a word or phrase (e.g. "fed funds") to synonyms, each of which
+    /// may itself be a phrase; replaces earlier synonyms for the same source
     Result<void> add_synonym(const std::string& term, const std::vector<std::string>& synonyms);
     
-    // Load synonym dictionary
+    /// One entry per line: "term syn1 syn2 ..." for single words, or
+    /// "source phrase => synonym one, synonym two" for phrases
     Result<void> load_synonyms(const std::string& path);
     
 private:
@@ -8,6 +8,7 @@
 #include <shared_mutex>
 #include <random>
 #include <functional>
+#include <chrono>
 
 namespace vdb {
 
@@ -27,6 +28,51 @@ struct HnswConfig {
     size_t num_threads = 0;                      // 0 = auto-detect
 };
 
+// ============================================================================
+// Search Budget
+// ============================================================================
+
+/// Limits and work counters for a single search. Every distance
+/// computation is charged and the clock is read every few expansions; once
+/// a limit is hit the search stops and returns the best results so far.
+struct SearchBudget {
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    size_t max_distance_computations = 0;       // 0 = unlimited
+    
+    // Filled in by the search
+    size_t distance_computations = 0;
+    size_t nodes_visited = 0;
+    size_t heap_operations = 0;
+    size_t levels_descended = 0;                // Upper layers routed through
+    bool deadline_exceeded = false;
+    bool computations_exceeded = false;
+    
+    [[nodiscard]] bool limited() const {
+        return deadline.has_value() || max_distance_computations > 0;
+    }
+    
+    [[nodiscard]] bool exhausted() const {
+        return deadline_exceeded || computations_exceeded;
+    }
+    
+    /// Account for n distance computations; false once the budget is spent
+    bool charge(size_t n = 1) {
+        distance_computations += n;
+        if (max_distance_computations > 0 && distance_computations > max_distance_computations) {
+            computations_exceeded = true;
+        }
+        return !exhausted();
+    }
+    
+    /// Read the clock; false once the deadline has passed
+    bool check_deadline() {
+        if (deadline && std::chrono::steady_clock::now() >= *deadline) {
+            deadline_exceeded = true;
+        }
+        return !exhausted();
+    }
+};
+
 // ============================================================================
 // HNSW Index
 // ============================================================================
@@ -55,14 +101,23 @@ class HnswIndex {
         std::span<const Vector> vectors
     );
     
-    /// Search for k nearest neighbors
-    [[nodiscard]] SearchResults search(VectorView query, size_t k) const;
+    /// Search for k nearest neighbors; a budget may end the search early.
+    /// ef_search overrides the configured value for this search only (0 = configured).
+    [[nodiscard]] SearchResults search(
+        VectorView query,
+        size_t k,
+        SearchBudget* budget = nullptr,
+        size_t ef_search = 0
+    ) const;
     
-    /// Search with filter function
+    /// Search with filter function. Rejected nodes are still traversed, so
+    /// recall holds for broad filters; cost grows as the filter narrows.
     [[nodiscard]] SearchResults search_filtered(
         VectorView query,
         size_t k,
-        std::function<bool(VectorId)> filter
+        std::function<bool(VectorId)> filter,
+        SearchBudget* budget = nullptr,
+        size_t ef_search = 0
     ) const;
     
     /// Remove a vector by ID
@@ -74,6 +129,10 @@ class HnswIndex {
     /// Get vector by ID (if stored)
     [[nodiscard]] std::optional<Vector> get_vector(VectorId id) const;
     
+    /// Get shared handle to the stored vector data (no copy).
+    /// Stored vectors are immutable, so the handle stays valid after removal.
+    [[nodiscard]] std::shared_ptr<const Scalar[]> vector_data(VectorId id) const;
+    
     // ========================================================================
     // Index Management
     // ========================================================================
@@ -96,7 +155,8 @@ class HnswIndex {
     /// Get statistics
     [[nodiscard]] IndexStats stats() const;
     
-    /// Set search ef parameter (trade accuracy for speed)
+    /// Set the default search ef (trade accuracy for speed); waits for
+    /// running searches. Per-query values go to search() instead.
     void set_ef_search(size_t ef);
     
     /// Resize index (expensive, rebuilds)
@@ -127,19 +187,24 @@ class HnswIndex {
         VectorId id;
         int level;
         std::vector<std::vector<VectorId>> connections;  // Per-level connections
-        Vector vector;  // Store vector for distance computation
+        std::shared_ptr<const Scalar[]> vector;  // Immutable, shared with snapshots
         bool deleted = false;  // Lazy deletion flag
+        
+        [[nodiscard]] VectorView view(Dim dim) const { return {vector.get(), dim}; }
     };
     
     // Select random level for new node (exponential distribution)
     [[nodiscard]] int random_level();
     
-    // Search layer for closest nodes
+    // Search layer for closest nodes (only IDs passing filter are returned).
+    // Stops early, keeping the best found so far, when the budget runs out.
     [[nodiscard]] std::vector<VectorId> search_layer(
         VectorView query,
         VectorId entry_point,
         size_t ef,
-        int layer
+        int layer,
+        const std::function<bool(VectorId)>* filter = nullptr,
+        SearchBudget* budget = nullptr
     ) const;
     
     // Select neighbors using heuristic
@@ -6,9 +6,9 @@
 
 #include "../core.hpp"
 #include "../storage.hpp"
+#include "roaring_bitmap.hpp"
 #include <unordered_map>
 #include <map>
-#include <set>
 #include <string>
 #include <functional>
 
@@ -63,16 +63,27 @@ class MetadataIndex {
     [[nodiscard]] Result<void> remove(VectorId id, const Metadata& metadata);
     
     // Querying
-    [[nodiscard]] std::set<VectorId> query(const FilterCondition& condition) const;
-    [[nodiscard]] std::set<VectorId> query_and(
+    [[nodiscard]] RoaringBitmap query(const FilterCondition& condition) const;
+    [[nodiscard]] RoaringBitmap query_and(
         const std::vector<FilterCondition>& conditions) const;
-    [[nodiscard]] std::set<VectorId> query_or(
+    [[nodiscard]] RoaringBitmap query_or(
         const std::vector<FilterCondition>& conditions) const;
     
-    // Filtering function (for HNSW search_filtered)
+    // Filtering function (for HNSW search_filtered); tests bitmap membership
     [[nodiscard]] std::function<bool(VectorId)> create_filter(
         const std::vector<FilterCondition>& conditions) const;
     
+    // Posting inspection
+    [[nodiscard]] std::vector<std::string> values(const std::string& field) const;  // Sorted
+    [[nodiscard]] size_t count(const std::string& field, const std::string& value) const;
+    
+    // Remove all entries, keeping the index definitions
+    void clear();
+    
+    // Run-encode postings where that is smaller (after bulk builds; later
+    // writes decode the containers they touch)
+    void optimize();
+    
     // Statistics
     [[nodiscard]] size_t size(const std::string& field) const;
     [[nodiscard]] size_t total_entries() const;
@@ -84,20 +95,24 @@ class MetadataIndex {
 
 private:
     struct InvertedIndex {
-        std::unordered_map<std::string, std::set<VectorId>> postings;
+        std::unordered_map<std::string, RoaringBitmap> postings;
         bool is_numeric = false;
-        std::map<double, std::set<VectorId>> numeric_index;
+        std::map<double, RoaringBitmap> numeric_index;
     };
     
     std::unordered_map<std::string, InvertedIndex> indices_;
     
     std::string get_field_value(const Metadata& metadata,
         const std::string& field) const;
-    std::set<VectorId> query_exact(const std::string& field,
+    RoaringBitmap query_exact(const std::string& field,
         const std::string& value) const;
-    std::set<VectorId> query_range(const std::string& field,
+    RoaringBitmap query_range(const std::string& field,
         double min_val, double max_val, bool min_inclusive,
         bool max_inclusive) const;
+    RoaringBitmap query_lexical_range(const std::string& field,
+        const std::optional<std::string>& min_val,
+        const std::optional<std::string>& max_val,
+        bool min_inclusive, bool max_inclusive) const;
 };
 
 }} // namespace vdb::index
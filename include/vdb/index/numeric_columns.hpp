@@ -0,0 +1,100 @@
+#pragma once
+// ============================================================================
+// VectorDB - Columnar Numeric Filters
+// Market metadata as contiguous float columns, scanned with SIMD compares
+// ============================================================================
+
+#include "../core.hpp"
+#include "roaring_bitmap.hpp"
+#include <array>
+
+namespace vdb {
+namespace index {
+
+// ============================================================================
+// Numeric Predicate
+// ============================================================================
+
+enum class MarketField : uint8_t {
+    GoldPrice,
+    SilverPrice,
+    Gsr,
+    Dxy,
+    Vix,
+    Yield10y
+};
+
+inline constexpr size_t MARKET_FIELD_COUNT = 6;
+
+[[nodiscard]] constexpr std::string_view market_field_name(MarketField field) {
+    switch (field) {
+        case MarketField::GoldPrice: return "gold_price";
+        case MarketField::SilverPrice: return "silver_price";
+        case MarketField::Gsr: return "gsr";
+        case MarketField::Dxy: return "dxy";
+        case MarketField::Vix: return "vix";
+        case MarketField::Yield10y: return "yield_10y";
+        default: return "unknown";
+    }
+}
+
+enum class NumericOp : uint8_t {
+    Less,
+    LessOrEqual,
+    Greater,
+    GreaterOrEqual,
+    Between            // Inclusive [value, value2]
+};
+
+/// Predicate on one market field. Rows missing the field never match.
+struct NumericPredicate {
+    MarketField field = MarketField::GoldPrice;
+    NumericOp op = NumericOp::Greater;
+    float value = 0.0f;
+    float value2 = 0.0f;              // Upper bound for Between
+
+    [[nodiscard]] static NumericPredicate less(MarketField f, float v) {
+        return {f, NumericOp::Less, v, 0.0f};
+    }
+    [[nodiscard]] static NumericPredicate greater(MarketField f, float v) {
+        return {f, NumericOp::Greater, v, 0.0f};
+    }
+    [[nodiscard]] static NumericPredicate between(MarketField f, float lo, float hi) {
+        return {f, NumericOp::Between, lo, hi};
+    }
+};
+
+// ============================================================================
+// Numeric Columns
+// ============================================================================
+
+/// One float column per market field, indexed directly by VectorId.
+/// Missing values are stored as NaN, which fails every ordered comparison.
+class NumericColumns {
+public:
+    NumericColumns() = default;
+
+    /// Store (or overwrite) the market fields of a record
+    void set(VectorId id, const Metadata& metadata);
+
+    /// Mark a record's fields as missing
+    void erase(VectorId id);
+
+    void clear();
+
+    /// IDs whose row satisfies every predicate (AND)
+    [[nodiscard]] RoaringBitmap evaluate(std::span<const NumericPredicate> predicates) const;
+
+    /// Number of rows allocated (highest ID + 1, rounded up)
+    [[nodiscard]] size_t rows() const { return rows_; }
+
+    [[nodiscard]] size_t memory_usage() const;
+
+private:
+    void grow(size_t min_rows);
+
+    std::array<std::vector<float>, MARKET_FIELD_COUNT> columns_;
+    size_t rows_ = 0;                   // Always a multiple of 64
+};
+
+}} // namespace vdb::index
@@ -0,0 +1,129 @@
+#pragma once
+// ============================================================================
+// VectorDB - Compressed Bitmap (Roaring-style)
+// Array / bitmap / run containers over 16-bit chunks of the ID space
+// ============================================================================
+
+#include "../core.hpp"
+#include <bit>
+#include <variant>
+
+namespace vdb {
+namespace index {
+
+// ============================================================================
+// Roaring Bitmap
+// ============================================================================
+
+/// Set of 64-bit IDs split into 2^16-wide chunks. Each chunk uses whichever
+/// container is smallest: a sorted array (sparse), a 1024-word bitmap
+/// (dense), or a list of runs (clustered). Dense sequential IDs, as issued
+/// by VectorDatabase, compress to a handful of containers.
+class RoaringBitmap {
+public:
+    RoaringBitmap() = default;
+
+    /// Build from ascending or unordered IDs
+    [[nodiscard]] static RoaringBitmap from_ids(std::span<const VectorId> ids);
+    
+    /// Build from a dense bit mask where bit i of words[i / 64] marks ID i
+    [[nodiscard]] static RoaringBitmap from_words(std::span<const uint64_t> words);
+
+    // Mutation
+    void add(VectorId id);
+    bool remove(VectorId id);  // Returns true if the ID was present
+    void clear();
+
+    // Queries
+    [[nodiscard]] bool contains(VectorId id) const;
+    [[nodiscard]] uint64_t cardinality() const;
+    [[nodiscard]] bool empty() const { return keys_.empty(); }
+
+    // Set algebra (bitmap containers use SIMD word operations)
+    [[nodiscard]] RoaringBitmap operator&(const RoaringBitmap& other) const;
+    [[nodiscard]] RoaringBitmap operator|(const RoaringBitmap& other) const;
+    [[nodiscard]] RoaringBitmap operator-(const RoaringBitmap& other) const;  // AND NOT
+    RoaringBitmap& operator&=(const RoaringBitmap& other);
+    RoaringBitmap& operator|=(const RoaringBitmap& other);
+    RoaringBitmap& operator-=(const RoaringBitmap& other);
+    [[nodiscard]] bool operator==(const RoaringBitmap& other) const;
+
+    /// Visit IDs in ascending order
+    template<typename F>
+    void for_each(F&& fn) const;
+
+    /// All IDs in ascending order
+    [[nodiscard]] std::vector<VectorId> to_vector() const;
+
+    /// Convert containers to run encoding where that is smaller
+    void run_optimize();
+
+    /// Approximate heap bytes used
+    [[nodiscard]] size_t memory_usage() const;
+
+    // Serialization
+    void serialize(std::vector<uint8_t>& out) const;
+    [[nodiscard]] static Result<RoaringBitmap> deserialize(std::span<const uint8_t> data,
+                                                           size_t& offset);
+
+    // Container types (public so the implementation's free helpers can use them)
+    static constexpr size_t ARRAY_MAX = 4096;        // Array -> bitmap threshold
+    static constexpr size_t BITMAP_WORDS = 1024;     // 65536 bits
+    static constexpr size_t RUN_MAX = 32768;         // Disjoint runs in 65536 values
+
+    struct ArrayContainer {
+        std::vector<uint16_t> values;                // Sorted, unique
+    };
+    struct BitmapContainer {
+        std::vector<uint64_t> words = std::vector<uint64_t>(BITMAP_WORDS);
+        uint32_t cardinality = 0;
+    };
+    struct Run {
+        uint16_t start;
+        uint16_t length;                             // Values in run - 1
+    };
+    struct RunContainer {
+        std::vector<Run> runs;                       // Sorted, non-overlapping
+    };
+    using Container = std::variant<ArrayContainer, BitmapContainer, RunContainer>;
+
+private:
+    [[nodiscard]] size_t find_key(uint64_t key) const;  // Index or keys_.size()
+
+    std::vector<uint64_t> keys_;                     // High 48 bits, ascending
+    std::vector<Container> containers_;
+};
+
+// ============================================================================
+// Template Implementation
+// ============================================================================
+
+template<typename F>
+void RoaringBitmap::for_each(F&& fn) const {
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        const VectorId base = keys_[i] << 16;
+        std::visit([&](const auto& c) {
+            using T = std::decay_t<decltype(c)>;
+            if constexpr (std::is_same_v<T, ArrayContainer>) {
+                for (uint16_t v : c.values) fn(base | v);
+            } else if constexpr (std::is_same_v<T, BitmapContainer>) {
+                for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+                    uint64_t word = c.words[w];
+                    while (word != 0) {
+                        int bit = std::countr_zero(word);
+                        fn(base | (w * 64 + bit));
+                        word &= word - 1;
+                    }
+                }
+            } else {
+                for (const Run& run : c.runs) {
+                    for (uint32_t v = run.start; v <= uint32_t(run.start) + run.length; ++v) {
+                        fn(base | v);
+                    }
+                }
+            }
+        }, containers_[i]);
+    }
+}
+
+}} // namespace vdb::index
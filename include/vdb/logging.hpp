@@ -297,7 +297,7 @@ class Logger {
             std::string new_name = base_path + "." + std::to_string(i + 1);
             
             if (fs::exists(old_name)) {
-                if (i == config_.max_backup_files - 1) {
+                if (i == static_cast<int>(config_.max_backup_files) - 1) {
                     fs::remove(new_name);
                 }
                 fs::rename(old_name, new_name);
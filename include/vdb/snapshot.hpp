@@ -0,0 +1,124 @@
+#pragma once
+// ============================================================================
+// VectorDB - Copy-on-Write Snapshots (Point-in-Time Read Views)
+// ============================================================================
+
+#include "core.hpp"
+#include <array>
+#include <filesystem>
+#include <functional>
+
+namespace vdb {
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Snapshot Record
+// ============================================================================
+
+/// Per-ID record shared between the live database and its snapshots.
+/// Both members point to immutable data; writers replace, never mutate.
+struct SnapshotRecord {
+    std::shared_ptr<const Metadata> metadata;
+    std::shared_ptr<const Scalar[]> vector;
+
+    [[nodiscard]] bool empty() const { return metadata == nullptr; }
+};
+
+// ============================================================================
+// Copy-on-Write Record Table
+// ============================================================================
+
+/// Page table of records indexed by VectorId. Cloning copies only the page
+/// pointers; a page is duplicated the first time it is written while shared.
+class CowRecordTable {
+public:
+    static constexpr size_t RECORDS_PER_PAGE = 256;
+
+    /// Insert or replace the record for an ID
+    void put(VectorId id, SnapshotRecord record);
+
+    /// Remove the record for an ID (no-op if absent)
+    void erase(VectorId id);
+
+    /// Find record by ID (nullptr if absent)
+    [[nodiscard]] const SnapshotRecord* find(VectorId id) const;
+
+    /// Number of live records
+    [[nodiscard]] size_t size() const { return count_; }
+
+    /// Number of allocated pages
+    [[nodiscard]] size_t page_count() const { return pages_.size(); }
+
+    /// Visit every live record in ID order
+    void for_each(const std::function<void(VectorId, const SnapshotRecord&)>& fn) const;
+
+    /// Remove all records
+    void clear();
+
+private:
+    using Page = std::array<SnapshotRecord, RECORDS_PER_PAGE>;
+
+    /// Get page for writing, copying it first if a snapshot shares it
+    [[nodiscard]] Page& writable_page(size_t page_index);
+
+    std::vector<std::shared_ptr<Page>> pages_;
+    size_t count_ = 0;
+};
+
+// ============================================================================
+// Database Snapshot
+// ============================================================================
+
+/// Immutable, consistent view of vectors and metadata at one point in time.
+/// Holds no database locks, so long-running readers never block writers.
+class DatabaseSnapshot {
+public:
+    DatabaseSnapshot(CowRecordTable records, uint64_t epoch,
+                     Dim dimension, DistanceMetric metric);
+
+    /// Write epoch the snapshot was taken at
+    [[nodiscard]] uint64_t epoch() const { return epoch_; }
+
+    /// Wall-clock creation time
+    [[nodiscard]] Timestamp created_at() const { return created_at_; }
+
+    [[nodiscard]] Dim dimension() const { return dimension_; }
+    [[nodiscard]] DistanceMetric metric() const { return metric_; }
+
+    /// Number of vectors visible in the snapshot
+    [[nodiscard]] size_t size() const { return records_.size(); }
+    [[nodiscard]] bool empty() const { return records_.size() == 0; }
+
+    /// Check if ID is visible in the snapshot
+    [[nodiscard]] bool contains(VectorId id) const { return records_.find(id) != nullptr; }
+
+    /// All visible IDs in ascending order
+    [[nodiscard]] std::vector<VectorId> ids() const;
+
+    /// Get metadata by ID
+    [[nodiscard]] std::optional<Metadata> get_metadata(VectorId id) const;
+
+    /// Get vector by ID (view stays valid for the lifetime of the snapshot)
+    [[nodiscard]] std::optional<VectorView> get_vector(VectorId id) const;
+
+    /// Visit every record in ID order
+    void for_each(const std::function<void(const Metadata&, VectorView)>& fn) const;
+
+    /// Exact k-NN scan over the snapshot contents
+    [[nodiscard]] SearchResults search(VectorView query, size_t k) const;
+
+    /// Export all metadata as JSONL (same format as VectorDatabase)
+    [[nodiscard]] Result<void> export_training_data(const fs::path& output_path) const;
+
+private:
+    CowRecordTable records_;
+    uint64_t epoch_;
+    Timestamp created_at_;
+    Dim dimension_;
+    DistanceMetric metric_;
+};
+
+using SnapshotPtr = std::shared_ptr<const DatabaseSnapshot>;
+
+} // namespace vdb
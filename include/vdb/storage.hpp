@@ -6,13 +6,46 @@
 #include "core.hpp"
 #include <fstream>
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <unordered_map>
+#include <list>
+#include <mutex>
 #include <shared_mutex>
 
 namespace vdb {
 
 namespace fs = std::filesystem;
 
+// ============================================================================
+// Memory-Mapping Options
+// ============================================================================
+
+/// Kernel read-ahead hint for a mapping
+enum class MmapAccessPattern : uint8_t {
+    Normal,      // No advice
+    Random,      // MADV_RANDOM: disable read-ahead (graph traversal)
+    Sequential   // MADV_SEQUENTIAL: aggressive read-ahead (scans, loading)
+};
+
+/// Trade startup time against tail latency for mapped files.
+/// Options the platform does not support are ignored.
+struct MmapOptions {
+    MmapAccessPattern access = MmapAccessPattern::Sequential;
+    bool populate = false;        // MAP_POPULATE: prefault every page at map time
+    bool huge_pages = false;      // MADV_HUGEPAGE: transparent huge pages (honoured for tmpfs;
+                                  // a no-op for shared mappings of regular files)
+    size_t lock_bytes = 0;        // mlock the first N bytes (SIZE_MAX = whole file)
+    bool prefetch = false;        // Warm the page cache on a background thread after open
+};
+
+/// One positioned read for MemoryMappedFile::read_many
+struct ReadRequest {
+    size_t offset;
+    size_t length;
+    void* dest;
+};
+
 // ============================================================================
 // Memory-Mapped File (Cross-Platform)
 // ============================================================================
@@ -31,13 +64,14 @@ class MemoryMappedFile {
     MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept;
     
     /// Open file for reading
-    [[nodiscard]] Result<void> open_read(const fs::path& path);
+    [[nodiscard]] Result<void> open_read(const fs::path& path, const MmapOptions& options = {});
     
     /// Open existing file for read/write (preserves contents, no truncation)
-    [[nodiscard]] Result<void> open_readwrite(const fs::path& path);
+    [[nodiscard]] Result<void> open_readwrite(const fs::path& path, const MmapOptions& options = {});
     
     /// Open file for read/write (creates if not exists)
-    [[nodiscard]] Result<void> open_write(const fs::path& path, size_t initial_size = 0);
+    [[nodiscard]] Result<void> open_write(const fs::path& path, size_t initial_size = 0,
+                                          const MmapOptions& options = {});
     
     /// Close the file
     void close();
@@ -57,15 +91,62 @@ class MemoryMappedFile {
     
     /// Sync to disk
     [[nodiscard]] Result<void> sync();
+    
+    /// Copy bytes at a file offset with pread, bypassing the mapping
+    [[nodiscard]] Result<void> read_at(size_t offset, void* dest, size_t length) const;
+    
+    /// Issue all reads at once (io_uring when available, else a pread pool).
+    /// on_complete(index) runs on the calling thread, in completion order.
+    /// Returns an error if any read failed; successful reads are still delivered.
+    [[nodiscard]] Result<void> read_many(
+        std::span<const ReadRequest> requests,
+        const std::function<void(size_t)>& on_complete
+    ) const;
+    
+    /// Change the read-ahead hint for the whole mapping
+    [[nodiscard]] Result<void> advise(MmapAccessPattern pattern);
+    
+    /// Pin a byte range in RAM (clamped to the mapping), replacing the
+    /// previous one; on failure the previous range stays pinned
+    [[nodiscard]] Result<void> lock(size_t offset, size_t length);
+    
+    /// Release all pinned ranges
+    void unlock();
+    
+    /// Bytes currently pinned via lock()
+    [[nodiscard]] size_t locked_bytes() const { return locked_bytes_; }
+    
+    /// Fault a byte range into the page cache on a background thread.
+    /// The mapping is kept alive (close/resize wait) until warmup finishes.
+    void prefetch_async(size_t offset = 0, size_t length = SIZE_MAX);
+    
+    /// Block until an outstanding prefetch completes
+    void wait_prefetch();
+    
+    /// True while a prefetch is still running
+    [[nodiscard]] bool prefetch_pending() const;
+    
+    /// Options the file was opened with
+    [[nodiscard]] const MmapOptions& options() const { return options_; }
 
 private:
     void unmap();
     
+    /// munlock/VirtualUnlock without touching the recorded range
+    void unlock_range(size_t offset, size_t length);
+    
+    /// Apply advice, huge pages and locking after (re)mapping
+    void apply_options();
+    
     uint8_t* data_ = nullptr;
     size_t size_ = 0;
     size_t capacity_ = 0;
     fs::path path_;
     bool writable_ = false;
+    MmapOptions options_;
+    size_t locked_offset_ = 0;
+    size_t locked_bytes_ = 0;
+    std::future<void> prefetch_;
     
 #ifdef VDB_PLATFORM_WINDOWS
     void* file_handle_ = nullptr;
@@ -75,6 +156,85 @@ class MemoryMappedFile {
 #endif
 };
 
+// ============================================================================
+// Tiered Vector Cache (Hot Arena + Cold LRU)
+// ============================================================================
+
+struct TierStats {
+    uint64_t hot_hits = 0;        // Served from the pinned hot arena
+    uint64_t cold_hits = 0;       // Served from the cold LRU cache
+    uint64_t misses = 0;          // Read from disk
+    uint64_t promotions = 0;      // Cold -> hot
+    uint64_t demotions = 0;       // Hot -> cold
+    uint64_t evictions = 0;       // Dropped from the cold cache
+    size_t hot_count = 0;
+    size_t cold_count = 0;
+    
+    [[nodiscard]] double hit_rate() const {
+        uint64_t total = hot_hits + cold_hits + misses;
+        return total > 0 ? static_cast<double>(hot_hits + cold_hits) / total : 0.0;
+    }
+};
+
+/// Segmented LRU over two fixed arenas. New vectors enter the cold segment;
+/// after promote_threshold hits they move to the hot segment, whose LRU
+/// tail is demoted back to cold when it fills. Memory never exceeds the
+/// configured budgets, so the cache cannot thrash the page cache.
+class TieredVectorCache {
+public:
+    TieredVectorCache(Dim dimension, size_t hot_budget_bytes,
+                      size_t cold_budget_bytes, uint32_t promote_threshold);
+    
+    /// Copy a cached vector into out; returns false (and counts a miss) if absent
+    [[nodiscard]] bool lookup(VectorId id, std::span<Scalar> out);
+    
+    /// Insert a vector read from disk after a miss
+    void insert(VectorId id, std::span<const Scalar> data);
+    
+    /// Drop a vector from both tiers
+    void erase(VectorId id);
+    
+    /// Drop everything (statistics are kept)
+    void clear();
+    
+    [[nodiscard]] TierStats stats() const;
+    [[nodiscard]] size_t memory_usage() const;
+
+private:
+    struct Entry {
+        VectorId id;
+        size_t slot;       // Slot in the arena of the entry's tier
+        uint32_t hits;
+        bool hot;
+    };
+    using EntryList = std::list<Entry>;
+    
+    [[nodiscard]] Scalar* slot_ptr(bool hot, size_t slot);
+    [[nodiscard]] size_t take_slot(bool hot);
+    void release_slot(bool hot, size_t slot);
+    
+    /// Make room in the cold segment by evicting its LRU tail
+    void evict_cold();
+    
+    /// Move a cold entry into the hot segment, demoting if full
+    void promote(EntryList::iterator it);
+    
+    Dim dimension_;
+    size_t hot_slots_;
+    size_t cold_slots_;
+    uint32_t promote_threshold_;
+    
+    std::vector<Scalar> hot_arena_;
+    std::vector<Scalar> cold_arena_;
+    std::vector<size_t> hot_free_;
+    std::vector<size_t> cold_free_;
+    EntryList hot_lru_;    // Front = most recently used
+    EntryList cold_lru_;
+    std::unordered_map<VectorId, EntryList::iterator> entries_;
+    TierStats stats_;
+    mutable std::mutex mutex_;
+};
+
 // ============================================================================
 // Vector Storage (Persistent)
 // ============================================================================
@@ -84,6 +244,14 @@ struct VectorStoreConfig {
     Dim dimension = UNIFIED_DIM;
     size_t initial_capacity = 10000;
     bool memory_only = false;   // For testing
+    MmapOptions mmap;           // Mapping behaviour for vectors.bin
+    
+    // Tiering for read() and get_many(): both zero disables the cache.
+    // Only reads through this store are tiered; an HNSW index built over
+    // the same vectors holds its own in-RAM copies.
+    size_t hot_budget_bytes = 0;        // Pinned in-RAM arena for frequently read vectors
+    size_t cold_cache_bytes = 0;        // LRU cache for vectors read from disk
+    uint32_t promote_threshold = 3;     // Cold hits before promotion to the hot arena
 };
 
 class VectorStore {
@@ -106,6 +274,22 @@ class VectorStore {
     /// Get vector by ID
     [[nodiscard]] std::optional<VectorView> get(VectorId id) const;
     
+    /// Copy vector into out through the hot/cold tiers (falls back to the
+    /// mapping when tiering is disabled). Safe against concurrent resize.
+    [[nodiscard]] bool read(VectorId id, std::span<Scalar> out) const;
+    
+    /// Callback for get_many; the view is valid only for the duration of the call
+    using FetchCallback = std::function<void(VectorId, VectorView)>;
+    
+    /// Batched fetch for re-ranking: cached vectors are delivered first, the
+    /// rest are read with one batch of I/O and delivered as reads complete.
+    /// Callbacks run on the calling thread and must not modify the store.
+    /// Unknown IDs are skipped. Returns the number of vectors delivered.
+    [[nodiscard]] Result<size_t> get_many(
+        std::span<const VectorId> ids,
+        const FetchCallback& callback
+    ) const;
+    
     /// Check if vector exists
     [[nodiscard]] bool contains(VectorId id) const;
     
@@ -129,6 +313,12 @@ class VectorStore {
     
     /// Get storage stats
     [[nodiscard]] size_t memory_usage() const;
+    
+    /// Start warming the vector file into the page cache in the background
+    void warmup();
+    
+    /// Hot/cold tier counters (all zero when tiering is disabled)
+    [[nodiscard]] TierStats tier_stats() const;
 
 private:
     /// Allocate a slot for a new vector
@@ -144,6 +334,7 @@ class VectorStore {
     std::vector<size_t> free_slots_;
     size_t capacity_ = 0;
     size_t vector_size_bytes_ = 0;
+    std::unique_ptr<TieredVectorCache> tier_cache_;  // Null when tiering is disabled
     
     // CRITICAL: Mutex for thread-safe concurrent access during resize
     mutable std::shared_mutex mutex_;
@@ -190,6 +381,22 @@ class MetadataStore {
     
     /// Sync to disk
     [[nodiscard]] Result<void> sync();
+    
+    /// File contents captured for a sync whose write runs outside the
+    /// owner's lock
+    struct SyncSnapshot {
+        std::string bytes;
+        uint64_t generation = 0;
+        bool dirty = false;
+    };
+    
+    /// Split sync: capture (no I/O) and finish need the owner's exclusion
+    /// from writers; write_snapshot needs none. Records added between
+    /// capture and finish are re-appended to the new file, so no append
+    /// is lost to the replaced one.
+    [[nodiscard]] SyncSnapshot snapshot_for_sync();
+    [[nodiscard]] Result<void> write_snapshot(const SyncSnapshot& snapshot) const;
+    [[nodiscard]] Result<void> finish_sync(const SyncSnapshot& snapshot, bool written);
 
 private:
     [[nodiscard]] Result<void> load();
@@ -199,6 +406,9 @@ class MetadataStore {
     std::unordered_map<VectorId, Metadata> metadata_;
     std::ofstream append_stream_;
     bool dirty_ = false;
+    uint64_t generation_ = 0;               // Bumped by every change
+    bool syncing_ = false;                  // Between snapshot_for_sync and finish_sync
+    std::vector<VectorId> appended_;        // Added while syncing_
 };
 
 // ============================================================================
@@ -215,6 +425,8 @@ struct DatabasePaths {
     fs::path text_model;    // models/text_encoder.onnx
     fs::path image_model;   // models/image_encoder.onnx
     fs::path projection;    // models/projection.bin
+    fs::path embedding_cache;  // embeddings.cache
+    fs::path sparse_index;  // index.sparse
     
     explicit DatabasePaths(const fs::path& root_path);
     
@@ -0,0 +1,336 @@
+#pragma once
+// ============================================================================
+// VectorDB - Thread Pool
+// ============================================================================
+
+#include <algorithm>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <atomic>
+#include <stdexcept>
+
+namespace vdb {
+
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t num_threads = 0) {
+        if (num_threads == 0) {
+            num_threads = std::thread::hardware_concurrency();
+            if (num_threads == 0) num_threads = 4;
+        }
+        
+        workers_.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers_.emplace_back([this] { worker_loop(); });
+        }
+    }
+    
+    ~ThreadPool() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+    
+    // Non-copyable
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    /// Submit a task and get a future for the result
+    template<typename F, typename... Args>
+    auto submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
+        using ReturnType = std::invoke_result_t<F, Args...>;
+        
+        auto task = std::make_shared<std::packaged_task<ReturnType()>>(
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+        );
+        
+        std::future<ReturnType> result = task->get_future();
+        
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (stop_) {
+                throw std::runtime_error("ThreadPool is stopped");
+            }
+            tasks_.emplace([task]() { (*task)(); });
+        }
+        
+        cv_.notify_one();
+        return result;
+    }
+    
+    /// Execute function in parallel over range [0, count)
+    template<typename F>
+    void parallel_for(size_t count, F&& func) {
+        if (count == 0) return;
+        
+        size_t num_threads = workers_.size();
+        size_t chunk_size = (count + num_threads - 1) / num_threads;
+        
+        std::vector<std::future<void>> futures;
+        futures.reserve(num_threads);
+        
+        for (size_t t = 0; t < num_threads; ++t) {
+            size_t start = t * chunk_size;
+            size_t end = std::min(start + chunk_size, count);
+            
+            if (start >= count) break;
+            
+            futures.push_back(submit([&func, start, end]() {
+                for (size_t i = start; i < end; ++i) {
+                    func(i);
+                }
+            }));
+        }
+        
+        for (auto& f : futures) {
+            f.get();
+        }
+    }
+    
+    /// Execute func(i) for every i in [0, count) on the pool and the calling
+    /// thread. Indices are claimed one at a time and the caller keeps
+    /// claiming until none are left, so it only ever waits on work a worker
+    /// has already started. Unlike parallel_for this is safe to call from a
+    /// task running on the same pool, and a busy pool degrades to running
+    /// everything inline. Index 0 always runs on the calling thread. The
+    /// first exception thrown by func is rethrown.
+    template<typename F>
+    void cooperative_for(size_t count, F&& func) {
+        if (count == 0) return;
+        
+        // Helpers may be dequeued after the caller has returned; they then
+        // claim nothing, and touch only this shared state
+        struct State {
+            std::atomic<size_t> next{0};
+            size_t finished = 0;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable cv;
+        };
+        auto state = std::make_shared<State>();
+        
+        auto claim = [state] { return state->next.fetch_add(1, std::memory_order_relaxed); };
+        auto work = [state, count, claim, &func](size_t i) {
+            size_t finished = 0;
+            std::exception_ptr error;
+            for (; i < count; i = claim()) {
+                try {
+                    func(i);
+                } catch (...) {
+                    if (!error) error = std::current_exception();
+                }
+                ++finished;
+            }
+            if (finished > 0) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished += finished;
+                if (error && !state->error) state->error = error;
+                state->cv.notify_all();
+            }
+        };
+        
+        state->next.store(1, std::memory_order_relaxed);
+        size_t helpers = std::min(count - 1, workers_.size());
+        for (size_t t = 0; t < helpers; ++t) {
+            (void)submit([work, claim] { work(claim()); });
+        }
+        work(0);
+        
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cv.wait(lock, [&] { return state->finished == count; });
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+    }
+        
+    /// Get number of threads
+    [[nodiscard]] size_t size() const { return workers_.size(); }
+    
+    /// Get pending task count
+    [[nodiscard]] size_t pending() const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return tasks_.size();
+    }
+    
+    /// Wait for all tasks to complete
+    void wait_all() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] {
+            return tasks_.empty() && active_tasks_ == 0;
+        });
+    }
+
+private:
+    void worker_loop() {
+        while (true) {
+            std::function<void()> task;
+            
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                
+                if (stop_ && tasks_.empty()) {
+                    return;
+                }
+                
+                task = std::move(tasks_.front());
+                tasks_.pop();
+                ++active_tasks_;
+            }
+            
+            task();
+            
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                --active_tasks_;
+                if (tasks_.empty() && active_tasks_ == 0) {
+                    done_cv_.notify_all();
+                }
+            }
+        }
+    }
+    
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable done_cv_;
+    
+    std::atomic<size_t> active_tasks_{0};
+    bool stop_ = false;
+};
+
+// ============================================================================
+// Bounded Priority Executor
+// ============================================================================
+
+/// Scheduling class for BoundedExecutor; higher runs first
+enum class TaskPriority : uint8_t {
+    Low = 0,
+    Normal = 1,
+    High = 2
+};
+
+/// Fixed worker set over a bounded priority queue. Submissions beyond
+/// max_queued are refused instead of blocking, so front-ends can shed load
+/// rather than pile up threads. Equal priorities run in submission order.
+class BoundedExecutor {
+public:
+    explicit BoundedExecutor(size_t num_threads = 0, size_t max_queued = 4096)
+        : max_queued_(std::max<size_t>(max_queued, 1))
+    {
+        if (num_threads == 0) {
+            num_threads = std::thread::hardware_concurrency();
+            if (num_threads == 0) num_threads = 4;
+        }
+        
+        workers_.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers_.emplace_back([this] { worker_loop(); });
+        }
+    }
+    
+    /// Runs every queued task, then joins the workers
+    ~BoundedExecutor() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+    
+    BoundedExecutor(const BoundedExecutor&) = delete;
+    BoundedExecutor& operator=(const BoundedExecutor&) = delete;
+    
+    /// Queue a task; false when the queue is full or shutting down
+    [[nodiscard]] bool try_submit(std::function<void()> task,
+                                  TaskPriority priority = TaskPriority::Normal) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (stop_ || tasks_.size() >= max_queued_) {
+                return false;
+            }
+            tasks_.push_back({priority, next_seq_++, std::move(task)});
+            std::push_heap(tasks_.begin(), tasks_.end(), RunsLater{});
+        }
+        cv_.notify_one();
+        return true;
+    }
+    
+    [[nodiscard]] size_t size() const { return workers_.size(); }
+    [[nodiscard]] size_t max_queued() const { return max_queued_; }
+    
+    /// Tasks waiting for a worker
+    [[nodiscard]] size_t pending() const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return tasks_.size();
+    }
+
+private:
+    struct Task {
+        TaskPriority priority;
+        uint64_t seq;
+        std::function<void()> fn;
+    };
+    
+    /// Heap order: lower priority, then later submission, sinks
+    struct RunsLater {
+        bool operator()(const Task& a, const Task& b) const {
+            if (a.priority != b.priority) return a.priority < b.priority;
+            return a.seq > b.seq;
+        }
+    };
+    
+    void worker_loop() {
+        while (true) {
+            std::function<void()> task;
+            
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                
+                if (stop_ && tasks_.empty()) {
+                    return;
+                }
+                
+                std::pop_heap(tasks_.begin(), tasks_.end(), RunsLater{});
+                task = std::move(tasks_.back().fn);
+                tasks_.pop_back();
+            }
+            
+            task();
+        }
+    }
+    
+    std::vector<std::thread> workers_;
+    std::vector<Task> tasks_;               // Binary heap ordered by RunsLater
+    size_t max_queued_;
+    uint64_t next_seq_ = 0;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+};
+
+/// Global thread pool for parallel operations
+ThreadPool& global_thread_pool();
+
+} // namespace vdb
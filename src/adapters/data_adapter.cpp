@@ -126,6 +126,37 @@ Result<std::vector<NormalizedData>> DataAdapterManager::parse_batch(
     return results;
 }
 
+std::function<Result<std::optional<std::string>>()> DataAdapterManager::stream_chunks(
+    std::vector<fs::path> paths,
+    const ChunkConfig& config
+) {
+    struct StreamState {
+        std::vector<fs::path> paths;
+        ChunkConfig config;
+        size_t next_path = 0;
+        std::vector<DataChunk> chunks;
+        size_t next_chunk = 0;
+    };
+    auto state = std::make_shared<StreamState>();
+    state->paths = std::move(paths);
+    state->config = config;
+    
+    return [this, state]() -> Result<std::optional<std::string>> {
+        while (state->next_chunk == state->chunks.size()) {
+            if (state->next_path == state->paths.size()) {
+                return std::nullopt;
+            }
+            auto parsed = auto_parse(state->paths[state->next_path++], state->config);
+            if (!parsed) {
+                return std::unexpected(parsed.error());
+            }
+            state->chunks = std::move(parsed->chunks);
+            state->next_chunk = 0;
+        }
+        return std::move(state->chunks[state->next_chunk++].content);
+    };
+}
+
 IDataAdapter* DataAdapterManager::find_adapter(const fs::path& path) const {
     for (const auto& adapter : adapters_) {
         if (adapter->can_handle(path)) {
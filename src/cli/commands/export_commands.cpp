@@ -1,7 +1,9 @@
 #include "vdb/cli/commands/export_commands.hpp"
 #include "vdb/cli/output_formatter.hpp"
+#include "vdb/database.hpp"
 #include <iostream>
 #include <fstream>
+#include <nlohmann/json.hpp>
 
 namespace vdb::cli {
 
@@ -61,21 +63,76 @@ int ExportPairsCommand::execute(
     std::string output = args[1];
     
     double min_score = 0.7;
-    auto score_it = options.find("--min-score");
-    if (score_it != options.end()) {
-        min_score = std::stod(score_it->second);
+    size_t limit = SIZE_MAX;
+    try {
+        auto score_it = options.find("--min-score");
+        if (score_it != options.end()) {
+            min_score = std::stod(score_it->second);
+        }
+        
+        auto limit_it = options.find("--limit");
+        if (limit_it != options.end()) {
+            limit = std::stoul(limit_it->second);
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Error: --min-score and --limit must be numbers\n";
+        std::cerr << usage() << "\n";
+        return 1;
     }
     
     OutputFormatter formatter;
     
+    auto db = open_database(db_path);
+    if (!db) {
+        std::cerr << formatter.format_error(db.error().message);
+        return 1;
+    }
+    
+    // Work from a snapshot so ingest is not blocked while pairs are generated
+    SnapshotPtr snap = db->snapshot();
+    
+    std::ofstream file(output);
+    if (!file) {
+        std::cerr << formatter.format_error("Failed to create " + output);
+        return 1;
+    }
+    
     std::cout << "Generating training pairs...\n";
     std::cout << "Min similarity: " << min_score << "\n";
+    std::cout << "Snapshot: " << snap->size() << " vectors (epoch " << snap->epoch() << ")\n";
     std::cout << "\n";
     
-    std::cout << "Finding similar pairs...\n";
-    std::cout << "Progress: [##########] 100%\n\n";
+    // Neighbors come from the snapshot as well, never the live database, so
+    // every pair reflects the same point in time (self + 5 nearest)
+    constexpr size_t NEIGHBORS = 6;
+    
+    size_t pairs = 0;
+    for (VectorId id : snap->ids()) {
+        if (pairs >= limit) break;
+        
+        auto vec = snap->get_vector(id);
+        auto anchor = snap->get_metadata(id);
+        if (!vec || !anchor) continue;
+        
+        for (const auto& n : snap->search(*vec, NEIGHBORS)) {
+            // Emit each unordered pair once
+            if (n.id <= id || n.score < min_score) continue;
+            auto positive = snap->get_metadata(n.id);
+            if (!positive) continue;
+            
+            nlohmann::json pair;
+            pair["anchor_id"] = id;
+            pair["positive_id"] = n.id;
+            pair["anchor_source"] = anchor->source_file;
+            pair["positive_source"] = positive->source_file;
+            pair["score"] = n.score;
+            file << pair.dump() << "\n";
+            
+            if (++pairs >= limit) break;
+        }
+    }
     
-    std::cout << formatter.format_success("Generated 523 training pairs");
+    std::cout << formatter.format_success("Generated " + std::to_string(pairs) + " training pairs");
     std::cout << "Saved to: " << output << "\n";
     
     return 0;
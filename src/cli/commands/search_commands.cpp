@@ -1,5 +1,7 @@
 #include "vdb/cli/commands/search_commands.hpp"
 #include "vdb/cli/output_formatter.hpp"
+#include "vdb/database.hpp"
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
 
@@ -34,16 +36,53 @@ int SearchCommand::execute(
     
     OutputFormatter formatter;
     
-    // Create sample results
-    std::vector<std::string> headers = {"ID", "Score", "Preview"};
-    std::vector<std::vector<std::string>> rows;
+    QueryOptions query_opts;
+    query_opts.k = static_cast<size_t>(std::max(k, 1));
+    if (auto it = options.find("--type"); it != options.end()) {
+        for (uint8_t t = 0; t < static_cast<uint8_t>(DocumentType::Unknown); ++t) {
+            if (document_type_name(static_cast<DocumentType>(t)) == it->second) {
+                query_opts.type_filter = static_cast<DocumentType>(t);
+            }
+        }
+        if (!query_opts.type_filter) {
+            std::cerr << formatter.format_error("Unknown document type: " + it->second);
+            return 1;
+        }
+    }
+    if (auto it = options.find("--date-from"); it != options.end()) {
+        query_opts.date_from = it->second;
+    }
+    if (auto it = options.find("--date-to"); it != options.end()) {
+        query_opts.date_to = it->second;
+    }
+    if (auto it = options.find("--asset"); it != options.end()) {
+        query_opts.asset_filter = it->second;
+    }
+    if (options.contains("--profile")) {
+        query_opts.profile = std::make_shared<QueryProfile>();
+    }
     
-    // Add sample results (in real implementation, this would query the database)
-    for (int i = 1; i <= std::min(k, 5); ++i) {
+    auto db = open_database(db_path);
+    if (!db) {
+        std::cerr << formatter.format_error(db.error().message);
+        return 1;
+    }
+    
+    auto results = db->query_text(query, query_opts);
+    if (!results) {
+        std::cerr << formatter.format_error(results.error().message);
+        return 1;
+    }
+    
+    std::vector<std::string> headers = {"ID", "Score", "Date", "Type", "Source"};
+    std::vector<std::vector<std::string>> rows;
+    for (const auto& r : *results) {
         rows.push_back({
-            std::to_string(10000 + i),
-            std::to_string(0.95 - i * 0.05),
-            "Sample document matching '" + query + "'..."
+            std::to_string(r.id),
+            std::to_string(r.score),
+            r.metadata ? r.metadata->date : "",
+            r.metadata ? std::string(document_type_name(r.metadata->type)) : "",
+            r.metadata ? r.metadata->source_file : ""
         });
     }
     
@@ -52,7 +91,10 @@ int SearchCommand::execute(
     } else {
         std::cout << "Search Results (top " << k << "):\n\n";
         std::cout << formatter.format_table(headers, rows);
-        std::cout << "\n(Full search requires database engine integration)\n";
+    }
+    
+    if (query_opts.profile) {
+        std::cout << "\nQuery Profile:\n" << query_opts.profile->to_string();
     }
     
     return 0;
@@ -3,6 +3,12 @@
 // ============================================================================
 
 #include "vdb/database.hpp"
+#include "vdb/checkpoint.hpp"
+#include "vdb/logging.hpp"
+#include "vdb/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <fstream>
 #include <mutex>
 #include <unordered_set>
@@ -16,6 +22,95 @@ using embeddings::TextEncoderConfig;
 using embeddings::ImageEncoderConfig;
 #endif
 
+namespace {
+
+// Post-filter plans fetch k * OVERFETCH / selectivity graph results
+constexpr size_t POST_FILTER_OVERFETCH = 2;
+
+// Queries scored together per pass over exact-scan candidates; a block of
+// 512-d queries stays resident in L1 while candidate vectors stream past
+constexpr size_t EXACT_SCAN_QUERY_BLOCK = 8;
+
+// Candidates scored between deadline checks during exact scans
+constexpr size_t EXACT_SCAN_DEADLINE_INTERVAL = 256;
+
+uint64_t nanos_since(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+SearchBudget budget_for(const QueryOptions& options) {
+    SearchBudget budget;
+    budget.deadline = options.deadline;
+    budget.max_distance_computations = options.max_distance_computations;
+    return budget;
+}
+
+#ifdef VDB_USE_ONNX_RUNTIME
+/// Embedding cache namespace for a model: its file name plus the CRC-32C
+/// and total size of the model and vocab contents, so replacing either
+/// file under the same name never serves embeddings from the old one
+std::string model_cache_id(const fs::path& model, const fs::path& vocab) {
+    uint32_t crc = 0;
+    uint64_t total = 0;
+    std::vector<char> buffer(1 << 20);
+    for (const fs::path& path : {model, vocab}) {
+        if (path.empty()) continue;
+        std::ifstream in(path, std::ios::binary);
+        while (in.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || in.gcount() > 0) {
+            auto n = static_cast<size_t>(in.gcount());
+            crc = crc32c({reinterpret_cast<const uint8_t*>(buffer.data()), n}, crc);
+            total += n;
+        }
+    }
+    char digest[32];
+    std::snprintf(digest, sizeof(digest), "@%08x-%llx", crc, static_cast<unsigned long long>(total));
+    return model.filename().string() + digest;
+}
+#endif
+
+/// Run work on the executor and hand its result to done. A refused
+/// submission completes immediately with an error on the caller's thread.
+template<typename T, typename Work>
+void dispatch_async(BoundedExecutor& executor, TaskPriority priority, Work work,
+                    std::function<void(Result<T>)> done) {
+    auto task = [work = std::move(work), done]() mutable {
+        Result<T> result = std::unexpected(Error{ErrorCode::Unknown, "Async task failed"});
+        try {
+            result = work();
+        } catch (const std::exception& e) {
+            result = std::unexpected(Error{ErrorCode::SystemError, e.what()});
+        } catch (...) {
+            result = std::unexpected(Error{ErrorCode::SystemError,
+                "Async task threw a non-standard exception"});
+        }
+        // A throwing callback must not escape the worker and terminate
+        try {
+            done(std::move(result));
+        } catch (const std::exception& e) {
+            LOG_ERROR(std::string("Async completion callback threw: ") + e.what());
+        } catch (...) {
+            LOG_ERROR("Async completion callback threw a non-standard exception");
+        }
+    };
+    if (!executor.try_submit(std::move(task), priority)) {
+        done(std::unexpected(Error{ErrorCode::InvalidState,
+            "Async queue full (" + std::to_string(executor.max_queued()) + " requests)"}));
+    }
+}
+
+/// Future-returning wrapper over dispatch_async
+template<typename T, typename Work>
+std::future<Result<T>> submit_async(BoundedExecutor& executor, TaskPriority priority, Work work) {
+    auto promise = std::make_shared<std::promise<Result<T>>>();
+    auto future = promise->get_future();
+    dispatch_async<T>(executor, priority, std::move(work),
+        [promise](Result<T> result) { promise->set_value(std::move(result)); });
+    return future;
+}
+
+}  // anonymous namespace
+
 // ============================================================================
 // Database Paths
 // ============================================================================
@@ -30,6 +125,8 @@ DatabasePaths::DatabasePaths(const fs::path& root_path)
     , text_model(models / "all-MiniLM-L6-v2.onnx")
     , image_model(models / "clip-vit-b32.onnx")
     , projection(models / "projection.bin")
+    , embedding_cache(root / "embeddings.cache")
+    , sparse_index(root / "index.sparse")
 {}
 
 Result<void> DatabasePaths::ensure_dirs() const {
@@ -53,35 +150,48 @@ bool DatabasePaths::exists() const {
 VectorDatabase::VectorDatabase(const DatabaseConfig& config)
     : config_(config)
     , paths_(config.path)
-{}
+    , sparse_index_(std::make_unique<hybrid::SparseIndex>())
+{
+    // Postings for every field QueryOptions can filter on
+    for (const char* field : {"type", "date", "asset", "bias"}) {
+        (void)metadata_index_.create_index(field);
+    }
+    
+    if (config_.query_cache.max_bytes > 0) {
+        query_cache_ = std::make_unique<QueryResultCache>(config_.query_cache, config_.metric);
+    }
+    if (config_.embedding_cache_entries > 0) {
+        embeddings::EmbeddingCacheConfig cache_config;
+        cache_config.max_entries = config_.embedding_cache_entries;
+        embedding_cache_ = std::make_unique<embeddings::EmbeddingCache>(cache_config);
+    }
+}
 
 VectorDatabase::~VectorDatabase() {
+    async_executor_.reset();  // Finish queued requests while state is intact
+    stop_checkpointer();
     if (ready_) {
         (void)sync();  // Ignore result in destructor
+        persist_embedding_cache();
     }
 }
 
 VectorDatabase::VectorDatabase(VectorDatabase&& other) noexcept
-    : config_(std::move(other.config_))
-    , paths_(std::move(other.paths_))
-    , index_(std::move(other.index_))
-    , vectors_(std::move(other.vectors_))
-    , metadata_(std::move(other.metadata_))
-#ifdef VDB_USE_ONNX_RUNTIME
-    , text_encoder_(std::move(other.text_encoder_))
-    , image_encoder_(std::move(other.image_encoder_))
-    , text_projection_(std::move(other.text_projection_))
-#endif
-    , next_id_(other.next_id_)
-    , ready_(other.ready_)
-    // mutex_ is default-constructed (not moved, as mutexes aren't moveable)
+    : paths_(fs::path{})
 {
-    other.ready_ = false;
-    other.next_id_ = 1;
+    *this = std::move(other);
 }
 
 VectorDatabase& VectorDatabase::operator=(VectorDatabase&& other) noexcept {
     if (this != &other) {
+        // Neither object may have async requests or checkpoints in flight
+        // while its state is moved
+        async_executor_.reset();
+        other.async_executor_.reset();
+        bool restart_checkpointer = other.checkpointer_.joinable();
+        other.stop_checkpointer();
+        stop_checkpointer();
+        
         // Sync current state before overwriting
         if (ready_) {
             (void)sync();
@@ -90,6 +200,8 @@ VectorDatabase& VectorDatabase::operator=(VectorDatabase&& other) noexcept {
         config_ = std::move(other.config_);
         paths_ = std::move(other.paths_);
         index_ = std::move(other.index_);
+        sparse_index_ = std::move(other.sparse_index_);
+        sparse_index_saved_ = other.sparse_index_saved_;
         vectors_ = std::move(other.vectors_);
         metadata_ = std::move(other.metadata_);
 #ifdef VDB_USE_ONNX_RUNTIME
@@ -97,12 +209,28 @@ VectorDatabase& VectorDatabase::operator=(VectorDatabase&& other) noexcept {
         image_encoder_ = std::move(other.image_encoder_);
         text_projection_ = std::move(other.text_projection_);
 #endif
+        records_ = std::move(other.records_);
+        metadata_index_ = std::move(other.metadata_index_);
+        numeric_columns_ = std::move(other.numeric_columns_);
+        query_cache_ = std::move(other.query_cache_);
+        embedding_cache_ = std::move(other.embedding_cache_);
+        text_model_id_ = std::move(other.text_model_id_);
+        embedding_cache_saved_ = other.embedding_cache_saved_;
+        budgeted_queries_.store(other.budgeted_queries_.load());
+        deadline_exceeded_.store(other.deadline_exceeded_.load());
+        computations_exceeded_.store(other.computations_exceeded_.load());
+        write_epoch_ = other.write_epoch_;
+        checkpoint_epoch_ = other.checkpoint_epoch_;
         next_id_ = other.next_id_;
         ready_ = other.ready_;
-        // mutex_ remains in place (not moved)
+        // Mutexes remain in place (not moved)
         
         other.ready_ = false;
         other.next_id_ = 1;
+        
+        if (restart_checkpointer) {
+            start_checkpointer();
+        }
     }
     return *this;
 }
@@ -119,8 +247,8 @@ Result<void> VectorDatabase::init() {
         return dir_result;
     }
     
-    // Initialize or load index
-    if (fs::exists(paths_.index)) {
+    // Initialize or load index (a crash mid-checkpoint may leave only the previous file)
+    if (fs::exists(paths_.index) || fs::exists(previous_checkpoint_path(paths_.index))) {
         auto index_result = HnswIndex::load(paths_.index.string());
         if (!index_result) {
             return std::unexpected(index_result.error());
@@ -137,11 +265,29 @@ Result<void> VectorDatabase::init() {
         index_ = std::make_unique<HnswIndex>(hnsw_config);
     }
     
+    // Sparse embeddings are checkpointed alongside the dense index
+    fs::path previous_sparse = previous_checkpoint_path(paths_.sparse_index);
+    if (fs::exists(paths_.sparse_index) || fs::exists(previous_sparse)) {
+        auto sparse_result = hybrid::SparseIndex::load(paths_.sparse_index);
+        if (!sparse_result && fs::exists(previous_sparse)) {
+            sparse_result = hybrid::SparseIndex::load(previous_sparse);
+        }
+        if (!sparse_result) {
+            return std::unexpected(sparse_result.error());
+        }
+        *sparse_index_ = std::move(*sparse_result);
+    }
+    sparse_index_saved_ = sparse_index_->generation();
+    
     // Initialize vector storage
     VectorStoreConfig store_config;
     store_config.path = paths_.root;
     store_config.dimension = config_.dimension;
     store_config.memory_only = config_.memory_only;
+    store_config.mmap = config_.mmap;
+    store_config.hot_budget_bytes = config_.hot_budget_bytes;
+    store_config.cold_cache_bytes = config_.cold_cache_bytes;
+    store_config.promote_threshold = config_.promote_threshold;
     vectors_ = std::make_unique<VectorStore>(store_config);
     auto store_result = vectors_->init();
     if (!store_result) {
@@ -158,6 +304,24 @@ Result<void> VectorDatabase::init() {
     // Load next ID from metadata count
     next_id_ = metadata_->size() + 1;
     
+    // Seed the snapshot table from persisted state
+    records_.clear();
+    metadata_index_.clear();
+    numeric_columns_.clear();
+    for (const auto& meta : metadata_->all()) {
+        if (index_->contains(meta.id)) {
+            publish_record(meta.id, meta);
+        }
+    }
+    metadata_index_.optimize();
+    checkpoint_epoch_ = write_epoch_;
+    
+    // A missing or corrupt cache file only costs re-encoding
+    if (embedding_cache_ && !config_.memory_only && fs::exists(paths_.embedding_cache)) {
+        (void)embedding_cache_->load(paths_.embedding_cache);
+        embedding_cache_saved_ = embedding_cache_->generation();
+    }
+    
 #ifdef VDB_USE_ONNX_RUNTIME
     // Initialize embeddings if models are available
     if (!config_.text_model_path.empty() || fs::exists(paths_.text_model)) {
@@ -169,6 +333,7 @@ Result<void> VectorDatabase::init() {
         text_config.device = Device::CPU;  // Default to CPU
         
         text_encoder_ = std::make_unique<TextEncoder>();
+        text_model_id_ = model_cache_id(text_config.model_path, text_config.vocab_path);
         if (fs::exists(text_config.model_path)) {
             auto text_result = text_encoder_->init(text_config);
             if (!text_result) {
@@ -213,6 +378,10 @@ Result<void> VectorDatabase::init() {
     config_file << config_json.dump(2);
     
     ready_ = true;
+    
+    if (!config_.memory_only && config_.sync_interval_ms > 0) {
+        start_checkpointer();
+    }
     return {};
 }
 
@@ -237,7 +406,7 @@ Result<VectorId> VectorDatabase::add_text(
     std::unique_lock<std::shared_mutex> lock(mutex_);
     
     // Generate embedding
-    auto embed_result = text_encoder_->encode(text);
+    auto embed_result = encode_text(text);
     if (!embed_result) {
         return std::unexpected(embed_result.error());
     }
@@ -260,7 +429,8 @@ Result<VectorId> VectorDatabase::add_text(
     // Add to storage
     auto store_result = vectors_->add(id, embedding.view());
     if (!store_result) {
-        index_->remove(id);
+        // Rolling back an add made just above; remove only fails on a missing ID
+        (void)index_->remove(id);
         return std::unexpected(store_result.error());
     }
     
@@ -271,13 +441,17 @@ Result<VectorId> VectorDatabase::add_text(
     
     auto meta_result = metadata_->add(meta);
     if (!meta_result) {
-        index_->remove(id);
-        vectors_->remove(id);
+        // Rolling back adds made just above; remove only fails on a missing ID
+        (void)index_->remove(id);
+        (void)vectors_->remove(id);
         return std::unexpected(meta_result.error());
     }
     
+    publish_record(id, meta);
+    
     if (config_.auto_sync) {
-        sync();
+        lock.unlock();  // sync() takes its own lock
+        (void)sync();
     }
     
     return id;
@@ -318,7 +492,9 @@ Result<QueryResults> VectorDatabase::query_text(
     }
     
     // Generate query embedding
-    auto embed_result = text_encoder_->encode(query);
+    auto encode_started = options.profile ? std::chrono::steady_clock::now()
+                                          : std::chrono::steady_clock::time_point{};
+    auto embed_result = encode_text(query);
     if (!embed_result) {
         return std::unexpected(embed_result.error());
     }
@@ -327,8 +503,22 @@ Result<QueryResults> VectorDatabase::query_text(
     if (text_projection_) {
         embedding = text_projection_->project(embedding.view());
     }
+    uint64_t encode_ns = options.profile ? nanos_since(encode_started) : 0;
     
-    return query_vector(embedding.view(), options);
+    auto results = query_vector(embedding.view(), options);
+    if (options.profile) {
+        options.profile->encode_ns = encode_ns;
+        options.profile->total_ns += encode_ns;
+    }
+    return results;
+}
+
+Result<std::vector<float>> VectorDatabase::encode_text(std::string_view text) {
+    if (!embedding_cache_) {
+        return text_encoder_->encode(text);
+    }
+    return embedding_cache_->get_or_compute(text_model_id_, text,
+        [this](std::string_view uncached) { return text_encoder_->encode(uncached); });
 }
 #else
 Result<QueryResults> VectorDatabase::query_text(
@@ -374,7 +564,8 @@ Result<VectorId> VectorDatabase::add_image(
     // Add to storage
     auto store_result = vectors_->add(id, embedding.view());
     if (!store_result) {
-        index_->remove(id);
+        // Rolling back an add made just above; remove only fails on a missing ID
+        (void)index_->remove(id);
         return std::unexpected(store_result.error());
     }
     
@@ -386,13 +577,17 @@ Result<VectorId> VectorDatabase::add_image(
     
     auto meta_result = metadata_->add(meta);
     if (!meta_result) {
-        index_->remove(id);
-        vectors_->remove(id);
+        // Rolling back adds made just above; remove only fails on a missing ID
+        (void)index_->remove(id);
+        (void)vectors_->remove(id);
         return std::unexpected(meta_result.error());
     }
     
+    publish_record(id, meta);
+    
     if (config_.auto_sync) {
-        sync();
+        lock.unlock();  // sync() takes its own lock
+        (void)sync();
     }
     
     return id;
@@ -438,13 +633,21 @@ Result<QueryResults> VectorDatabase::query_image(
         return std::unexpected(Error{ErrorCode::ModelLoadError, "Image encoder not initialized"});
     }
     
+    auto encode_started = options.profile ? std::chrono::steady_clock::now()
+                                          : std::chrono::steady_clock::time_point{};
     auto embed_result = image_encoder_->encode(image_path);
     if (!embed_result) {
         return std::unexpected(embed_result.error());
     }
+    uint64_t encode_ns = options.profile ? nanos_since(encode_started) : 0;
     
     Vector embedding(std::move(*embed_result));
-    return query_vector(embedding.view(), options);
+    auto results = query_vector(embedding.view(), options);
+    if (options.profile) {
+        options.profile->encode_ns = encode_ns;
+        options.profile->total_ns += encode_ns;
+    }
+    return results;
 }
 #else
 Result<QueryResults> VectorDatabase::query_image(
@@ -469,7 +672,10 @@ Result<VectorId> VectorDatabase::add_vector(
     }
     
     std::unique_lock<std::shared_mutex> lock(mutex_);
-    
+    return insert_locked(vector, metadata);
+}
+
+Result<VectorId> VectorDatabase::insert_locked(VectorView vector, const Metadata& metadata) {
     VectorId id = next_id();
     
     auto index_result = index_->add(id, vector);
@@ -479,7 +685,8 @@ Result<VectorId> VectorDatabase::add_vector(
     
     auto store_result = vectors_->add(id, vector);
     if (!store_result) {
-        index_->remove(id);
+        // Rolling back an add made just above; remove only fails on a missing ID
+        (void)index_->remove(id);
         return std::unexpected(store_result.error());
     }
     
@@ -488,11 +695,14 @@ Result<VectorId> VectorDatabase::add_vector(
     
     auto meta_result = metadata_->add(meta);
     if (!meta_result) {
-        index_->remove(id);
-        vectors_->remove(id);
+        // Rolling back adds made just above; remove only fails on a missing ID
+        (void)index_->remove(id);
+        (void)vectors_->remove(id);
         return std::unexpected(meta_result.error());
     }
     
+    publish_record(id, meta);
+    
     return id;
 }
 
@@ -504,40 +714,327 @@ Result<QueryResults> VectorDatabase::query_vector(
         return std::unexpected(Error{ErrorCode::InvalidDimension, "Query dimension mismatch"});
     }
     
+    // The clock is read only for a requested profile or the cache's cost
+    QueryProfile* profile = options.profile.get();
+    auto started = profile ? std::chrono::steady_clock::now()
+                           : std::chrono::steady_clock::time_point{};
+    
     std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (profile) {
+        *profile = QueryProfile{};
+        profile->lock_wait_ns = nanos_since(started);
+    }
+    
+    // Served from cache only while no write has happened since it was stored
+    uint64_t options_hash = 0;
+    if (query_cache_) {
+        options_hash = query_options_hash(options);
+        if (auto cached = query_cache_->lookup(query, options_hash, write_epoch_)) {
+            if (profile) {
+                profile->cache_hit = true;
+                profile->results = cached->size();
+                profile->total_ns = nanos_since(started);
+            }
+            return std::move(*cached);
+        }
+    }
+    auto search_started = profile || query_cache_ ? std::chrono::steady_clock::now()
+                                                  : std::chrono::steady_clock::time_point{};
+    
+    // Resolve metadata filters to an ID set from the postings before searching
+    auto allowed = resolve_filters(options);
+    QueryPlan plan = allowed && allowed->empty() ? QueryPlan::ExactScan
+                                                 : plan_query(allowed, options);
+    if (profile) {
+        profile->filter_ns = nanos_since(search_started);
+        profile->candidates = allowed ? allowed->cardinality() : 0;
+        profile->plan = plan;
+    }
+    if (allowed && allowed->empty()) {
+        if (profile) profile->total_ns = nanos_since(started);
+        return QueryResults{};
+    }
+    
+    SearchBudget budget = budget_for(options);
+    QueryResults results = execute_plan(query, options, allowed, plan, budget);
+    record_budget(budget);
     
-    // Set search ef if specified
-    if (options.ef_search > 0) {
-        index_->set_ef_search(options.ef_search);
+    // Partial results depend on timing, so only complete ones are cached
+    if (query_cache_ && !budget.exhausted()) {
+        query_cache_->insert(query, options_hash, write_epoch_, results,
+                             nanos_since(search_started));
     }
+    if (profile) {
+        profile->total_ns = nanos_since(started);
+    }
+    return results;
+}
+
+QueryResults VectorDatabase::execute_plan(
+    VectorView query,
+    const QueryOptions& options,
+    const std::optional<index::RoaringBitmap>& allowed,
+    QueryPlan plan,
+    SearchBudget& budget
+) const {
+    QueryProfile* profile = options.profile.get();
+    auto search_started = profile ? std::chrono::steady_clock::now()
+                                  : std::chrono::steady_clock::time_point{};
     
-    // Search
     SearchResults raw_results;
+    SearchBudget* limits = budget.limited() || profile ? &budget : nullptr;
     
-    if (options.type_filter || options.date_filter || options.asset_filter) {
-        // Use filtered search
-        raw_results = index_->search_filtered(query, options.k * 2, 
-            [this, &options](VectorId id) {
-                auto meta = metadata_->get(id);
-                if (!meta) return false;
-                
-                if (options.type_filter && meta->type != *options.type_filter) {
-                    return false;
-                }
-                if (options.date_filter && meta->date != *options.date_filter) {
-                    return false;
-                }
-                if (options.asset_filter && meta->asset != *options.asset_filter) {
-                    return false;
+    switch (plan) {
+        case QueryPlan::Hnsw:
+            raw_results = index_->search(query, options.k, limits, options.ef_search);
+            break;
+        
+        case QueryPlan::ExactScan:
+            raw_results = exact_scan(query, *allowed, options.k * 2, limits);
+            break;
+        
+        case QueryPlan::HnswPostFilter: {
+            // Over-fetch by the inverse selectivity, then drop non-matching IDs
+            double selectivity = static_cast<double>(allowed->cardinality()) /
+                                 static_cast<double>(std::max<size_t>(index_->size(), 1));
+            size_t fetch = static_cast<size_t>(
+                std::ceil(static_cast<double>(options.k * POST_FILTER_OVERFETCH) / selectivity));
+            for (const auto& result : index_->search(query, fetch, limits, options.ef_search)) {
+                if (allowed->contains(result.id)) {
+                    raw_results.push_back(result);
                 }
-                
-                return true;
-            });
+            }
+            if (raw_results.size() >= options.k || budget.exhausted()) {
+                break;
+            }
+            // Too few survivors: fall back to the filter-aware traversal
+            plan = QueryPlan::FilteredHnsw;
+            [[fallthrough]];
+        }
+        
+        case QueryPlan::FilteredHnsw:
+            raw_results = index_->search_filtered(query, options.k * 2,
+                [&allowed](VectorId id) { return allowed->contains(id); }, limits,
+                options.ef_search);
+            break;
+    }
+    
+    auto fetch_started = profile ? std::chrono::steady_clock::now()
+                                 : std::chrono::steady_clock::time_point{};
+    QueryResults results = apply_filters(raw_results, options);
+    for (auto& result : results) {
+        result.plan = plan;
+        result.partial = budget.exhausted();
+    }
+    
+    if (profile) {
+        profile->search_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(fetch_started - search_started)
+                .count());
+        profile->metadata_ns = nanos_since(fetch_started);
+        profile->plan = plan;
+        profile->partial = budget.exhausted();
+        profile->levels_descended = budget.levels_descended;
+        profile->nodes_visited = budget.nodes_visited;
+        profile->distance_computations = budget.distance_computations;
+        profile->heap_operations = budget.heap_operations;
+        profile->results = results.size();
+    }
+    return results;
+}
+
+void VectorDatabase::record_budget(const SearchBudget& budget) const {
+    if (!budget.limited()) {
+        return;
+    }
+    budgeted_queries_.fetch_add(1, std::memory_order_relaxed);
+    if (budget.deadline_exceeded) {
+        deadline_exceeded_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (budget.computations_exceeded) {
+        computations_exceeded_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+QueryPlan VectorDatabase::plan_query(
+    const std::optional<index::RoaringBitmap>& allowed,
+    const QueryOptions& options
+) const {
+    if (!allowed) {
+        return QueryPlan::Hnsw;  // Nothing to filter
+    }
+    if (options.force_plan && *options.force_plan != QueryPlan::Hnsw) {
+        return *options.force_plan;
+    }
+    
+    // Costs are in distance computations. A level-0 graph search touches
+    // roughly ef * 2M nodes; a filter of selectivity s stretches that by 1/s.
+    const double n = static_cast<double>(std::max<size_t>(index_->size(), 1));
+    const double candidates = static_cast<double>(allowed->cardinality());
+    const double selectivity = std::min(candidates / n, 1.0);
+    const size_t ef_search = options.ef_search > 0 ? options.ef_search : index_->config().ef_search;
+    const double ef = static_cast<double>(std::max(ef_search, options.k));
+    const double degree = static_cast<double>(2 * index_->config().M);
+    
+    const double exact_cost = candidates;
+    const double filtered_cost = ef * degree / selectivity;
+    const double post_fetch = static_cast<double>(options.k * POST_FILTER_OVERFETCH) / selectivity;
+    const double post_cost = std::max(ef, post_fetch) * degree;
+    
+    if (exact_cost <= filtered_cost && exact_cost <= post_cost) {
+        return QueryPlan::ExactScan;
+    }
+    return post_cost < filtered_cost ? QueryPlan::HnswPostFilter : QueryPlan::FilteredHnsw;
+}
+
+SearchResults VectorDatabase::exact_scan(
+    VectorView query,
+    const index::RoaringBitmap& candidates,
+    size_t k,
+    SearchBudget* budget
+) const {
+    return std::move(
+        exact_scan_block(std::span<const VectorView>(&query, 1), candidates, k, budget)[0]);
+}
+
+std::vector<SearchResults> VectorDatabase::exact_scan_block(
+    std::span<const VectorView> queries,
+    const index::RoaringBitmap& candidates,
+    size_t k,
+    SearchBudget* budget
+) const {
+    // Max-heaps on distance keep the k closest seen so far for each query
+    auto farther = [](const SearchResult& a, const SearchResult& b) {
+        return a.distance < b.distance;
+    };
+    std::vector<SearchResults> heaps(queries.size());
+    for (auto& heap : heaps) {
+        heap.reserve(k + 1);
+    }
+    
+    // Candidate-major: each stored vector is fetched once for the whole block
+    size_t scanned = 0;
+    size_t heap_ops = 0;
+    auto admit = [&]() {
+        if (budget) {
+            if (budget->exhausted() || !budget->charge(queries.size()) ||
+                (scanned++ % EXACT_SCAN_DEADLINE_INTERVAL == 0 && !budget->check_deadline())) {
+                return false;  // Out of budget: skip the remaining candidates
+            }
+        }
+        return true;
+    };
+    auto score = [&](VectorId id, VectorView candidate) {
+        for (size_t q = 0; q < queries.size(); ++q) {
+            Distance dist = compute_distance(queries[q], candidate, config_.metric);
+            SearchResults& heap = heaps[q];
+            if (heap.size() < k) {
+                heap.push_back({id, dist, 1.0f - dist});
+                std::push_heap(heap.begin(), heap.end(), farther);
+                heap_ops++;
+            } else if (dist < heap.front().distance) {
+                std::pop_heap(heap.begin(), heap.end(), farther);
+                heap.back() = {id, dist, 1.0f - dist};
+                std::push_heap(heap.begin(), heap.end(), farther);
+                heap_ops += 2;
+            }
+        }
+    };
+    
+    if (config_.hot_budget_bytes == 0 && config_.cold_cache_bytes == 0) {
+        candidates.for_each([&](VectorId id) {
+            if (!admit()) {
+                return;
+            }
+            if (auto data = index_->vector_data(id)) {
+                score(id, VectorView{data.get(), config_.dimension});
+            }
+        });
     } else {
-        raw_results = index_->search(query, options.k);
+        // Tiered: read through the store's hot/cold cache, batching the
+        // cache misses into one round of I/O per deadline interval
+        std::vector<VectorId> batch;
+        batch.reserve(EXACT_SCAN_DEADLINE_INTERVAL);
+        auto fetch = [&]() {
+            auto fetched = vectors_->get_many(batch, score);
+            if (!fetched) {
+                LOG_WARN("Exact scan fetch failed: " + fetched.error().message);
+            }
+            batch.clear();
+        };
+        candidates.for_each([&](VectorId id) {
+            if (!admit()) {
+                return;
+            }
+            batch.push_back(id);
+            if (batch.size() == EXACT_SCAN_DEADLINE_INTERVAL) {
+                fetch();
+            }
+        });
+        if (!batch.empty()) {
+            fetch();
+        }
+    }
+    
+    if (budget) {
+        budget->nodes_visited += scanned;
+        budget->heap_operations += heap_ops;
+    }
+    
+    for (auto& heap : heaps) {
+        std::sort_heap(heap.begin(), heap.end(), farther);
+    }
+    return heaps;
+}
+
+std::optional<index::RoaringBitmap> VectorDatabase::resolve_filters(
+    const QueryOptions& options
+) const {
+    using index::FilterCondition;
+    using index::FilterOp;
+    
+    std::vector<FilterCondition> conditions;
+    if (options.type_filter) {
+        conditions.push_back({"type", FilterOp::Equal,
+            std::to_string(static_cast<int>(*options.type_filter)), {}, {}});
+    }
+    if (options.date_filter) {
+        conditions.push_back({"date", FilterOp::Equal, *options.date_filter, {}, {}});
+    }
+    if (options.date_from || options.date_to) {
+        conditions.push_back({"date", FilterOp::Range,
+            options.date_from.value_or(""), options.date_to.value_or(""), {}});
+    }
+    if (options.asset_filter) {
+        conditions.push_back({"asset", FilterOp::Equal, *options.asset_filter, {}, {}});
+    }
+    if (options.bias_filter) {
+        conditions.push_back({"bias", FilterOp::Equal, *options.bias_filter, {}, {}});
     }
     
-    return apply_filters(raw_results, options);
+    if (conditions.empty() && options.numeric_filters.empty()) {
+        return std::nullopt;
+    }
+    if (options.numeric_filters.empty()) {
+        return metadata_index_.query_and(conditions);
+    }
+    
+    index::RoaringBitmap numeric = numeric_columns_.evaluate(options.numeric_filters);
+    if (conditions.empty()) {
+        return numeric;
+    }
+    return metadata_index_.query_and(conditions) & numeric;
+}
+
+std::vector<Metadata> VectorDatabase::collect_metadata(const index::RoaringBitmap& ids) const {
+    std::vector<Metadata> result;
+    result.reserve(ids.cardinality());
+    ids.for_each([&](VectorId id) {
+        if (const SnapshotRecord* record = records_.find(id)) {
+            result.push_back(*record->metadata);
+        }
+    });
+    return result;
 }
 
 std::optional<Vector> VectorDatabase::get_vector(VectorId id) const {
@@ -545,6 +1042,27 @@ std::optional<Vector> VectorDatabase::get_vector(VectorId id) const {
     return index_->get_vector(id);
 }
 
+// ============================================================================
+// Sparse Vector Operations
+// ============================================================================
+
+Result<void> VectorDatabase::add_sparse(VectorId id, const hybrid::SparseVector& vector) {
+    // Shared lock: remove() cannot drop the vector between the check and the insert
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!index_->contains(id)) {
+        return std::unexpected(Error{ErrorCode::VectorNotFound,
+            "Vector not found: " + std::to_string(id)});
+    }
+    return sparse_index_->add(id, vector);
+}
+
+Result<std::vector<hybrid::SparseResult>> VectorDatabase::query_sparse(
+    const hybrid::SparseVector& query,
+    size_t k
+) const {
+    return sparse_index_->search(query, k);
+}
+
 QueryResults VectorDatabase::apply_filters(
     const SearchResults& raw_results,
     const QueryOptions& options
@@ -606,22 +1124,35 @@ std::optional<Metadata> VectorDatabase::get_metadata(VectorId id) const {
 
 Result<void> VectorDatabase::update_metadata(VectorId id, const Metadata& metadata) {
     std::unique_lock<std::shared_mutex> lock(mutex_);
-    return metadata_->update(metadata);
+    
+    Metadata meta = metadata;
+    meta.id = id;
+    
+    auto result = metadata_->update(meta);
+    if (!result) {
+        return result;
+    }
+    
+    publish_record(id, meta);
+    return {};
 }
 
 std::vector<Metadata> VectorDatabase::find_by_date(std::string_view date) const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
-    return metadata_->find_by_date(date);
+    return collect_metadata(metadata_index_.query(
+        {"date", index::FilterOp::Equal, std::string(date), {}, {}}));
 }
 
 std::vector<Metadata> VectorDatabase::find_by_type(DocumentType type) const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
-    return metadata_->find_by_type(type);
+    return collect_metadata(metadata_index_.query(
+        {"type", index::FilterOp::Equal, std::to_string(static_cast<int>(type)), {}, {}}));
 }
 
 std::vector<Metadata> VectorDatabase::find_by_asset(std::string_view asset) const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
-    return metadata_->find_by_asset(asset);
+    return collect_metadata(metadata_index_.query(
+        {"asset", index::FilterOp::Equal, std::string(asset), {}, {}}));
 }
 
 // ============================================================================
@@ -636,12 +1167,24 @@ Result<void> VectorDatabase::remove(VectorId id) {
         return index_result;
     }
     
-    vectors_->remove(id);
-    metadata_->remove(id);
-    
+    erase_locked(id);
     return {};
 }
 
+void VectorDatabase::erase_locked(VectorId id) {
+    (void)index_->remove(id);  // Already gone when called from remove()
+    (void)sparse_index_->remove(id);  // Most vectors have no sparse embedding
+    // Both only fail when the ID is absent, in which case nothing is left to erase
+    (void)vectors_->remove(id);
+    (void)metadata_->remove(id);
+    if (const SnapshotRecord* record = records_.find(id)) {
+        (void)metadata_index_.remove(id, *record->metadata);
+    }
+    numeric_columns_.erase(id);
+    records_.erase(id);
+    write_epoch_++;
+}
+
 Result<size_t> VectorDatabase::remove_by_date(std::string_view date) {
     auto metas = find_by_date(date);
     size_t count = 0;
@@ -709,6 +1252,239 @@ Result<std::vector<VectorId>> VectorDatabase::add_images(
     return ids;
 }
 
+// ============================================================================
+// Asynchronous Operations
+// ============================================================================
+
+BoundedExecutor& VectorDatabase::async_executor() {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    if (!async_executor_) {
+        async_executor_ = std::make_unique<BoundedExecutor>(
+            config_.async_threads, config_.async_queue_limit);
+    }
+    return *async_executor_;
+}
+
+std::future<Result<QueryResults>> VectorDatabase::query_vector_async(
+    VectorView query,
+    const QueryOptions& options,
+    TaskPriority priority
+) {
+    return submit_async<QueryResults>(async_executor(), priority,
+        [this, query = std::vector<Scalar>(query.begin(), query.end()), options] {
+            return query_vector(query, options);
+        });
+}
+
+void VectorDatabase::query_vector_async(
+    VectorView query,
+    const QueryOptions& options,
+    std::function<void(Result<QueryResults>)> on_complete,
+    TaskPriority priority
+) {
+    dispatch_async<QueryResults>(async_executor(), priority,
+        [this, query = std::vector<Scalar>(query.begin(), query.end()), options] {
+            return query_vector(query, options);
+        },
+        std::move(on_complete));
+}
+
+std::future<Result<VectorId>> VectorDatabase::add_vector_async(
+    VectorView vector,
+    const Metadata& metadata,
+    TaskPriority priority
+) {
+    return submit_async<VectorId>(async_executor(), priority,
+        [this, vector = std::vector<Scalar>(vector.begin(), vector.end()), metadata] {
+            return add_vector(vector, metadata);
+        });
+}
+
+void VectorDatabase::add_vector_async(
+    VectorView vector,
+    const Metadata& metadata,
+    std::function<void(Result<VectorId>)> on_complete,
+    TaskPriority priority
+) {
+    dispatch_async<VectorId>(async_executor(), priority,
+        [this, vector = std::vector<Scalar>(vector.begin(), vector.end()), metadata] {
+            return add_vector(vector, metadata);
+        },
+        std::move(on_complete));
+}
+
+// ============================================================================
+// Batch Operations
+// ============================================================================
+
+Result<BatchQueryResult> VectorDatabase::query_batch(
+    const BatchQueryRequest& queries,
+    const QueryOptions& options,
+    const BatchConfig& config
+) {
+    for (size_t i = 0; i < queries.size(); ++i) {
+        if (queries[i].query.dim() != config_.dimension) {
+            return std::unexpected(Error{ErrorCode::InvalidDimension,
+                "Query " + std::to_string(i) + " dimension mismatch"});
+        }
+    }
+    
+    BatchQueryResult results(queries.size());
+    if (queries.empty()) {
+        return results;
+    }
+    
+    std::optional<ThreadPool> local_pool;
+    ThreadPool& pool = config.num_threads > 0 ? local_pool.emplace(config.num_threads)
+                                              : global_thread_pool();
+    
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    
+    // Filters and plan are shared by every query in the batch
+    auto allowed = resolve_filters(options);
+    if (allowed && allowed->empty()) {
+        if (config.progress_callback) {
+            config.progress_callback(queries.size(), queries.size());
+        }
+        return results;
+    }
+    
+    QueryOptions planned = options;
+    planned.k = 0;
+    for (const auto& item : queries) {
+        planned.k = std::max(planned.k, item.k);
+    }
+    QueryPlan plan = plan_query(allowed, planned);
+    
+    // Profiles describe a single query, so batch items never collect one
+    auto item_options = [&options](const BatchQueryItem& item) {
+        QueryOptions item_opts = options;
+        item_opts.k = item.k;
+        item_opts.profile.reset();
+        return item_opts;
+    };
+    
+    // Exact scans share candidate loads across a block; graph searches run
+    // one query per task
+    const size_t block = plan == QueryPlan::ExactScan ? EXACT_SCAN_QUERY_BLOCK : 1;
+    const size_t chunk = std::max<size_t>(config.batch_size, 1);
+    
+    for (size_t chunk_start = 0; chunk_start < queries.size(); chunk_start += chunk) {
+        size_t chunk_end = std::min(chunk_start + chunk, queries.size());
+        size_t num_blocks = (chunk_end - chunk_start + block - 1) / block;
+        
+        pool.parallel_for(num_blocks, [&](size_t b) {
+            size_t begin = chunk_start + b * block;
+            size_t end = std::min(begin + block, chunk_end);
+            
+            if (plan != QueryPlan::ExactScan) {
+                SearchBudget budget = budget_for(options);
+                results[begin] = execute_plan(queries[begin].query, item_options(queries[begin]),
+                                              allowed, plan, budget);
+                record_budget(budget);
+                return;
+            }
+            
+            std::vector<VectorView> views;
+            size_t block_k = 0;
+            for (size_t i = begin; i < end; ++i) {
+                views.push_back(queries[i].query);
+                block_k = std::max(block_k, queries[i].k);
+            }
+            
+            // A block shares one budget sized for all of its queries
+            SearchBudget budget = budget_for(options);
+            budget.max_distance_computations *= views.size();
+            auto raw = exact_scan_block(views, *allowed, block_k * 2,
+                                        budget.limited() ? &budget : nullptr);
+            record_budget(budget);
+            
+            for (size_t i = begin; i < end; ++i) {
+                results[i] = apply_filters(raw[i - begin], item_options(queries[i]));
+                for (auto& result : results[i]) {
+                    result.plan = plan;
+                    result.partial = budget.exhausted();
+                }
+            }
+        });
+        
+        if (config.progress_callback) {
+            config.progress_callback(chunk_end, queries.size());
+        }
+    }
+    
+    return results;
+}
+
+BatchInsertResult VectorDatabase::insert_batch(
+    const BatchInsertRequest& items,
+    const BatchConfig& config
+) {
+    BatchInsertResult result;
+    result.ids.reserve(items.size());
+    
+    auto fail = [&result](size_t i, const std::string& message) {
+        result.failed++;
+        result.errors.push_back("Item " + std::to_string(i) + ": " + message);
+    };
+    
+    // Reject malformed items before any lock is taken
+    std::vector<bool> valid(items.size(), true);
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (items[i].vector.dim() != config_.dimension) {
+            valid[i] = false;
+            fail(i, "Dimension mismatch");
+            if (config.fail_fast || config.transactional) {
+                result.failed = items.size();
+                return result;
+            }
+        }
+    }
+    
+    // A transaction holds the lock throughout so readers never see part of it
+    const size_t chunk = config.transactional ? std::max<size_t>(items.size(), 1)
+                                              : std::max<size_t>(config.batch_size, 1);
+    
+    for (size_t chunk_start = 0; chunk_start < items.size(); chunk_start += chunk) {
+        size_t chunk_end = std::min(chunk_start + chunk, items.size());
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            for (size_t i = chunk_start; i < chunk_end; ++i) {
+                if (!valid[i]) {
+                    continue;
+                }
+                
+                auto id = insert_locked(items[i].vector, items[i].metadata);
+                if (id) {
+                    result.ids.push_back(*id);
+                    result.successful++;
+                    continue;
+                }
+                
+                fail(i, id.error().message);
+                if (config.transactional) {
+                    for (VectorId inserted : result.ids) {
+                        erase_locked(inserted);
+                    }
+                    result.ids.clear();
+                    result.successful = 0;
+                    result.failed = items.size();
+                    return result;
+                }
+                if (config.fail_fast) {
+                    return result;
+                }
+            }
+        }
+        
+        if (config.progress_callback) {
+            config.progress_callback(chunk_end, items.size());
+        }
+    }
+    
+    return result;
+}
+
 // ============================================================================
 // Statistics & Management
 // ============================================================================
@@ -719,22 +1495,13 @@ size_t VectorDatabase::size() const {
 }
 
 size_t VectorDatabase::count_by_type(DocumentType type) const {
-    return find_by_type(type).size();
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return metadata_index_.count("type", std::to_string(static_cast<int>(type)));
 }
 
 std::vector<std::string> VectorDatabase::all_dates() const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
-    
-    std::unordered_set<std::string> unique_dates;
-    for (const auto& meta : metadata_->all()) {
-        if (!meta.date.empty()) {
-            unique_dates.insert(meta.date);
-        }
-    }
-    
-    std::vector<std::string> dates(unique_dates.begin(), unique_dates.end());
-    std::sort(dates.begin(), dates.end());
-    return dates;
+    return metadata_index_.values("date");
 }
 
 IndexStats VectorDatabase::stats() const {
@@ -745,22 +1512,138 @@ IndexStats VectorDatabase::stats() const {
 void VectorDatabase::optimize() {
     std::unique_lock<std::shared_mutex> lock(mutex_);
     index_->optimize();
+    metadata_index_.optimize();
 }
 
 Result<void> VectorDatabase::sync() {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+    std::lock_guard<std::mutex> sync_lock(sync_mutex_);
+    
+    std::vector<uint8_t> index_bytes;
+    std::vector<uint8_t> sparse_bytes;
+    MetadataStore::SyncSnapshot metadata_snapshot;
+    uint64_t sparse_generation;
+    uint64_t epoch;
+    {
+        // Writers are blocked only while state is captured; readers continue
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        
+        index_bytes = index_->serialize();
+        sparse_generation = sparse_index_->generation();
+        if (sparse_generation != sparse_index_saved_) {
+            sparse_bytes = sparse_index_->serialize();
+        }
+        metadata_snapshot = metadata_->snapshot_for_sync();
+        epoch = write_epoch_;
+    }
+    
+    // msync and the metadata rewrite run unlocked; the vector store guards
+    // its mapping against a concurrent resize itself
+    Result<void> flushed = vectors_->sync();
+    if (flushed) {
+        flushed = metadata_->write_snapshot(metadata_snapshot);
+    }
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto finished = metadata_->finish_sync(metadata_snapshot, flushed.has_value());
+        if (flushed && !finished) {
+            flushed = finished;
+        }
+    }
+    if (!flushed) {
+        return flushed;
+    }
     
-    auto index_result = index_->save(paths_.index.string());
+    // Temp file + fsync + rename, keeping the previous checkpoint for fallback
+    auto index_result = write_checkpoint(paths_.index, index_bytes);
     if (!index_result) {
         return index_result;
     }
     
-    auto vector_result = vectors_->sync();
-    if (!vector_result) {
-        return vector_result;
+    if (sparse_generation != sparse_index_saved_) {
+        auto sparse_result = write_checkpoint(paths_.sparse_index, sparse_bytes);
+        if (!sparse_result) {
+            return sparse_result;
+        }
+        sparse_index_saved_ = sparse_generation;
     }
     
-    return metadata_->sync();
+    checkpoint_epoch_ = epoch;
+    return {};
+}
+
+uint64_t VectorDatabase::checkpoint_epoch() const {
+    std::lock_guard<std::mutex> sync_lock(sync_mutex_);
+    return checkpoint_epoch_;
+}
+
+std::optional<QueryCacheStats> VectorDatabase::query_cache_stats() const {
+    if (!query_cache_) {
+        return std::nullopt;
+    }
+    return query_cache_->stats();
+}
+
+std::string QueryProfile::to_string() const {
+    std::string out;
+    auto line = [&out](const char* label, const std::string& value) {
+        char buffer[128];
+        std::snprintf(buffer, sizeof(buffer), "%-24s%s\n", label, value.c_str());
+        out += buffer;
+    };
+    auto ms = [](uint64_t ns) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.3f ms", static_cast<double>(ns) / 1e6);
+        return std::string(buffer);
+    };
+    
+    std::string plan_text(query_plan_name(plan));
+    if (cache_hit) plan_text += " (cache hit)";
+    if (partial) plan_text += " (partial: budget exhausted)";
+    
+    line("plan:", plan_text);
+    line("encode:", ms(encode_ns));
+    line("lock wait:", ms(lock_wait_ns));
+    line("filter resolution:", ms(filter_ns) + " (" + std::to_string(candidates) + " candidates)");
+    line("search:", ms(search_ns));
+    line("  levels descended:", std::to_string(levels_descended));
+    line("  nodes visited:", std::to_string(nodes_visited));
+    line("  distances computed:", std::to_string(distance_computations));
+    line("  heap operations:", std::to_string(heap_operations));
+    line("metadata fetch:", ms(metadata_ns) + " (" + std::to_string(results) + " results)");
+    line("total:", ms(total_ns));
+    return out;
+}
+
+QueryBudgetStats VectorDatabase::budget_stats() const {
+    QueryBudgetStats stats;
+    stats.budgeted_queries = budgeted_queries_.load(std::memory_order_relaxed);
+    stats.deadline_exceeded = deadline_exceeded_.load(std::memory_order_relaxed);
+    stats.computations_exceeded = computations_exceeded_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::optional<embeddings::EmbeddingCacheStats> VectorDatabase::embedding_cache_stats() const {
+    if (!embedding_cache_) {
+        return std::nullopt;
+    }
+    return embedding_cache_->stats();
+}
+
+std::optional<TierStats> VectorDatabase::vector_tier_stats() const {
+    if (!vectors_ || (config_.hot_budget_bytes == 0 && config_.cold_cache_bytes == 0)) {
+        return std::nullopt;
+    }
+    return vectors_->tier_stats();
+}
+
+void VectorDatabase::persist_embedding_cache() {
+    if (!embedding_cache_ || config_.memory_only) {
+        return;
+    }
+    uint64_t generation = embedding_cache_->generation();
+    if (generation != embedding_cache_saved_ && embedding_cache_->save(paths_.embedding_cache)) {
+        embedding_cache_saved_ = generation;
+    }
 }
 
 Result<void> VectorDatabase::compact() {
@@ -769,37 +1652,91 @@ Result<void> VectorDatabase::compact() {
 }
 
 // ============================================================================
-// Export
+// Snapshots
 // ============================================================================
 
-Result<void> VectorDatabase::export_training_data(const fs::path& output_path) const {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
+void VectorDatabase::publish_record(VectorId id, const Metadata& metadata) {
+    // The previous record holds the metadata the postings were built from
+    if (const SnapshotRecord* previous = records_.find(id)) {
+        (void)metadata_index_.update(id, *previous->metadata, metadata);
+    } else {
+        (void)metadata_index_.insert(id, metadata);
+    }
+    numeric_columns_.set(id, metadata);
     
-    std::ofstream file(output_path);
-    if (!file) {
-        return std::unexpected(Error{ErrorCode::IoError, "Failed to create output file"});
+    SnapshotRecord record;
+    record.metadata = std::make_shared<const Metadata>(metadata);
+    record.vector = index_->vector_data(id);
+    records_.put(id, std::move(record));
+    write_epoch_++;
+}
+
+SnapshotPtr VectorDatabase::snapshot() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return std::make_shared<const DatabaseSnapshot>(
+        records_, write_epoch_, config_.dimension, config_.metric);
+}
+
+uint64_t VectorDatabase::write_epoch() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return write_epoch_;
+}
+
+// ============================================================================
+// Background Checkpointing
+// ============================================================================
+
+void VectorDatabase::start_checkpointer() {
+    {
+        std::lock_guard<std::mutex> guard(checkpointer_mutex_);
+        checkpointer_stop_ = false;
     }
+    checkpointer_ = std::thread(&VectorDatabase::checkpointer_loop, this);
+}
+
+void VectorDatabase::stop_checkpointer() {
+    if (!checkpointer_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(checkpointer_mutex_);
+        checkpointer_stop_ = true;
+    }
+    checkpointer_cv_.notify_all();
+    checkpointer_.join();
+}
+
+bool VectorDatabase::checkpoint_pending() const {
+    // Sparse updates take only a shared lock and do not advance write_epoch_
+    uint64_t epoch = write_epoch();
+    std::lock_guard<std::mutex> sync_lock(sync_mutex_);
+    return epoch != checkpoint_epoch_ || sparse_index_->generation() != sparse_index_saved_;
+}
+
+void VectorDatabase::checkpointer_loop() {
+    const auto interval = std::chrono::milliseconds(config_.sync_interval_ms);
     
-    for (const auto& meta : metadata_->all()) {
-        json entry;
-        entry["id"] = meta.id;
-        entry["type"] = std::string(document_type_name(meta.type));
-        entry["date"] = meta.date;
-        entry["source"] = meta.source_file;
-        entry["asset"] = meta.asset;
-        entry["bias"] = meta.bias;
+    std::unique_lock<std::mutex> guard(checkpointer_mutex_);
+    while (!checkpointer_cv_.wait_for(guard, interval, [this] { return checkpointer_stop_; })) {
+        guard.unlock();
         
-        if (meta.gold_price) entry["gold_price"] = *meta.gold_price;
-        if (meta.silver_price) entry["silver_price"] = *meta.silver_price;
-        if (meta.gsr) entry["gsr"] = *meta.gsr;
-        if (meta.dxy) entry["dxy"] = *meta.dxy;
-        if (meta.vix) entry["vix"] = *meta.vix;
-        if (meta.yield_10y) entry["yield_10y"] = *meta.yield_10y;
+        // Skip the checkpoint when nothing changed since the last one
+        if (checkpoint_pending()) {
+            (void)sync();  // A failed checkpoint is retried on the next tick
+        }
+        persist_embedding_cache();
         
-        file << entry.dump() << "\n";
+        guard.lock();
     }
-    
-    return {};
+}
+
+// ============================================================================
+// Export
+// ============================================================================
+
+Result<void> VectorDatabase::export_training_data(const fs::path& output_path) const {
+    // Export from a snapshot so writers are not blocked for the whole export
+    return snapshot()->export_training_data(output_path);
 }
 
 // ============================================================================
@@ -0,0 +1,281 @@
+// ============================================================================
+// VectorDB - Embedding Cache Implementation
+// ============================================================================
+
+#include "vdb/embeddings/embedding_cache.hpp"
+#include "vdb/checkpoint.hpp"
+#include <algorithm>
+#include <cstring>
+
+#ifdef HAVE_SQLITE3
+    #include "vdb/storage/sqlite_store.hpp"
+#endif
+
+namespace vdb::embeddings {
+
+namespace {
+
+constexpr uint32_t CACHE_FILE_VERSION = 1;
+constexpr uint64_t CACHE_FILE_MAGIC = 0x3143424D45424456ULL;  // "VDBEMBC1"
+
+uint64_t fnv1a(std::string_view data) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : data) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+#ifdef HAVE_SQLITE3
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+std::string to_hex(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    std::string out(size * 2, '0');
+    for (size_t i = 0; i < size; ++i) {
+        out[2 * i] = HEX_DIGITS[bytes[i] >> 4];
+        out[2 * i + 1] = HEX_DIGITS[bytes[i] & 0xF];
+    }
+    return out;
+}
+
+bool from_hex(std::string_view hex, void* data, size_t size) {
+    if (hex.size() != size * 2) return false;
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    };
+    auto* bytes = static_cast<uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        int hi = nibble(hex[2 * i]);
+        int lo = nibble(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) return false;
+        bytes[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+/// query_cache key; fields are encoded separately so struct padding is excluded
+std::string store_key(uint64_t model, uint64_t content, uint32_t check) {
+    return "emb:" + to_hex(&model, sizeof(model)) + to_hex(&content, sizeof(content)) +
+           to_hex(&check, sizeof(check));
+}
+#endif
+
+}  // anonymous namespace
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+EmbeddingCache::EmbeddingCache(const EmbeddingCacheConfig& config) {
+    size_t shards = std::max<size_t>(config.num_shards, 1);
+    shard_capacity_ = std::max<size_t>(config.max_entries / shards, 1);
+    shards_.reserve(shards);
+    for (size_t i = 0; i < shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+EmbeddingCache::~EmbeddingCache() = default;
+
+EmbeddingCache::Key EmbeddingCache::make_key(std::string_view model_id, std::string_view text) {
+    auto bytes = std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(text.data()),
+                                          text.size());
+    return Key{fnv1a(model_id), fnv1a(text), crc32c(bytes)};
+}
+
+EmbeddingCache::Shard& EmbeddingCache::shard_for(const Key& key) const {
+    // High bits: the low bits already pick the bucket inside the shard's map
+    return *shards_[(key.content >> 48) % shards_.size()];
+}
+
+// ============================================================================
+// Lookup & Insert
+// ============================================================================
+
+std::optional<std::vector<float>> EmbeddingCache::get(std::string_view model_id,
+                                                      std::string_view text) {
+    Key key = make_key(model_id, text);
+    Shard& shard = shard_for(key);
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.map.find(key);
+        if (found != shard.map.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+            shard.hits++;
+            return found->second->embedding;
+        }
+        shard.misses++;
+    }
+
+#ifdef HAVE_SQLITE3
+    if (store_) {
+        auto value = store_->cache_get(store_key(key.model, key.content, key.check));
+        if (value && value->size() % (2 * sizeof(float)) == 0) {
+            std::vector<float> embedding(value->size() / (2 * sizeof(float)));
+            if (from_hex(*value, embedding.data(), embedding.size() * sizeof(float))) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.store_hits++;
+                insert(shard, key, embedding);
+                return embedding;
+            }
+        }
+    }
+#endif
+
+    return std::nullopt;
+}
+
+void EmbeddingCache::put(std::string_view model_id, std::string_view text,
+                         std::span<const float> embedding) {
+    Key key = make_key(model_id, text);
+    Shard& shard = shard_for(key);
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        insert(shard, key, std::vector<float>(embedding.begin(), embedding.end()));
+    }
+
+#ifdef HAVE_SQLITE3
+    if (store_) {
+        (void)store_->cache_put(store_key(key.model, key.content, key.check),
+                                to_hex(embedding.data(), embedding.size_bytes()));
+    }
+#endif
+}
+
+void EmbeddingCache::insert(Shard& shard, const Key& key, std::vector<float> embedding) {
+    generation_.fetch_add(1, std::memory_order_relaxed);
+
+    auto found = shard.map.find(key);
+    if (found != shard.map.end()) {
+        found->second->embedding = std::move(embedding);
+        shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+        return;
+    }
+
+    if (shard.lru.size() >= shard_capacity_) {
+        shard.map.erase(shard.lru.back().key);
+        shard.lru.pop_back();
+        shard.evictions++;
+    }
+
+    shard.lru.push_front(Entry{key, std::move(embedding)});
+    shard.map.emplace(key, shard.lru.begin());
+}
+
+void EmbeddingCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->lru.clear();
+        shard->map.clear();
+    }
+}
+
+size_t EmbeddingCache::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total += shard->lru.size();
+    }
+    return total;
+}
+
+EmbeddingCacheStats EmbeddingCache::stats() const {
+    EmbeddingCacheStats result;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        result.hits += shard->hits;
+        result.misses += shard->misses;
+        result.store_hits += shard->store_hits;
+        result.evictions += shard->evictions;
+        result.entries += shard->lru.size();
+    }
+    return result;
+}
+
+#ifdef HAVE_SQLITE3
+void EmbeddingCache::attach(storage::SqliteStore* store) {
+    store_ = store;
+}
+#endif
+
+// ============================================================================
+// Binary Persistence
+// ============================================================================
+
+Result<void> EmbeddingCache::save(const fs::path& path) const {
+    std::vector<uint8_t> payload;
+    put_raw(payload, CACHE_FILE_MAGIC);
+    put_raw(payload, CACHE_FILE_VERSION);
+
+    size_t count_offset = payload.size();
+    put_raw(payload, uint64_t{0});
+
+    uint64_t count = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        // Least recently used first, so load() leaves the hottest entries at the front
+        for (auto it = shard->lru.rbegin(); it != shard->lru.rend(); ++it) {
+            put_raw(payload, it->key.model);
+            put_raw(payload, it->key.content);
+            put_raw(payload, it->key.check);
+            put_raw(payload, static_cast<uint32_t>(it->embedding.size()));
+            const auto* bytes = reinterpret_cast<const uint8_t*>(it->embedding.data());
+            payload.insert(payload.end(), bytes, bytes + it->embedding.size() * sizeof(float));
+            count++;
+        }
+    }
+    std::memcpy(payload.data() + count_offset, &count, sizeof(count));
+
+    return write_checkpoint(path, payload);
+}
+
+Result<size_t> EmbeddingCache::load(const fs::path& path) {
+    auto data = read_checkpoint(path);
+    if (!data) {
+        return std::unexpected(data.error());
+    }
+
+    auto corrupted = [&path] {
+        return std::unexpected(Error{ErrorCode::IndexCorrupted,
+            "Invalid embedding cache file: " + path.string()});
+    };
+
+    std::span<const uint8_t> bytes(*data);
+    size_t offset = 0;
+    uint64_t magic = 0;
+    uint32_t version = 0;
+    uint64_t count = 0;
+    if (!get_raw(bytes, offset, magic) || magic != CACHE_FILE_MAGIC ||
+        !get_raw(bytes, offset, version) || version != CACHE_FILE_VERSION ||
+        !get_raw(bytes, offset, count)) {
+        return corrupted();
+    }
+
+    for (uint64_t i = 0; i < count; ++i) {
+        Key key{};
+        uint32_t dim = 0;
+        if (!get_raw(bytes, offset, key.model) || !get_raw(bytes, offset, key.content) ||
+            !get_raw(bytes, offset, key.check) || !get_raw(bytes, offset, dim) ||
+            bytes.size() - offset < dim * sizeof(float)) {
+            return corrupted();
+        }
+
+        std::vector<float> embedding(dim);
+        std::memcpy(embedding.data(), bytes.data() + offset, dim * sizeof(float));
+        offset += dim * sizeof(float);
+
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        insert(shard, key, std::move(embedding));
+    }
+
+    return static_cast<size_t>(count);
+}
+
+} // namespace vdb::embeddings
@@ -3,14 +3,28 @@
 // ============================================================================
 
 #include "vdb/hybrid_search.hpp"
+#include "vdb/hybrid/postings.hpp"
+#include "vdb/hybrid/tokenizer.hpp"
 #include "vdb/logging.hpp"
+#include "vdb/checkpoint.hpp"
+#include "vdb/storage.hpp"
+#include "vdb/thread_pool.hpp"
 #include <algorithm>
+#include <bit>
 #include <cmath>
+#include <cstring>
 #include <sstream>
 #include <unordered_map>
-#include <unordered_set>
-#include <cctype>
+#include <deque>
 #include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <shared_mutex>
+#include <limits>
+#include <string_view>
+#include <thread>
 
 namespace vdb {
 namespace hybrid {
@@ -21,87 +35,809 @@ namespace hybrid {
 
 namespace {
 
-std::string to_lower(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(),
-        [](unsigned char c) { return std::tolower(c); });
-    return result;
+/// Per-thread tokenizer scratch. Views into it are valid until the calling
+/// thread tokenizes again.
+TokenBuffer& scratch_tokens() {
+    thread_local TokenBuffer buffer;
+    return buffer;
 }
 
-std::vector<std::string> tokenize(const std::string& text) {
-    std::vector<std::string> tokens;
-    std::string token;
-    
-    for (char c : text) {
-        if (std::isalnum(c) || c == '-' || c == '_') {
-            token += c;
-        } else if (!token.empty()) {
-            tokens.push_back(token);
-            token.clear();
+TokenizerOptions bm25_tokenizer_options(const BM25Config& config) {
+    TokenizerOptions options;
+    options.lowercase = !config.case_sensitive;
+    options.remove_stop_words = true;
+    options.stem = config.use_stemming;
+    options.min_length = config.min_term_length;
+    return options;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Posting Lists
+// ============================================================================
+
+namespace {
+
+/// Upper-bound inputs for one block. BM25 grows with tf and shrinks with
+/// document length, so (max_tf, min_length) bounds every posting in the
+/// block without depending on avg_doc_length, which changes on each insert.
+struct PostingBlock {
+    uint32_t last_doc = 0;
+    uint32_t max_tf = 0;
+    uint32_t min_length = std::numeric_limits<uint32_t>::max();
+};
+
+/// Postings for one term, sorted by dense document number
+struct PostingList {
+    std::vector<uint32_t> docs;
+    std::vector<uint32_t> tfs;
+    std::vector<PostingBlock> blocks;   // One per POSTING_BLOCK_SIZE postings
+    PostingBlock bound;                 // Whole-list bound
+
+    // With store_positions, posting i's tf positions are delta-varint coded
+    // in position_bytes[position_offsets[i], position_offsets[i + 1])
+    std::vector<uint32_t> position_offsets;
+    std::vector<uint8_t> position_bytes;
+
+    [[nodiscard]] bool has_positions() const { return !position_offsets.empty(); }
+
+    [[nodiscard]] std::span<const uint8_t> positions(size_t pos) const {
+        return std::span(position_bytes).subspan(
+            position_offsets[pos], position_offsets[pos + 1] - position_offsets[pos]);
+    }
+
+    /// Positions for the posting just appended
+    void append_positions(std::span<const uint8_t> encoded) {
+        if (position_offsets.empty()) {
+            position_offsets.push_back(0);
         }
+        position_bytes.insert(position_bytes.end(), encoded.begin(), encoded.end());
+        position_offsets.push_back(static_cast<uint32_t>(position_bytes.size()));
     }
-    
-    if (!token.empty()) {
-        tokens.push_back(token);
+
+    void append(uint32_t doc, uint32_t tf, uint32_t length) {
+        if (docs.size() % POSTING_BLOCK_SIZE == 0) {
+            blocks.emplace_back();
+        }
+        docs.push_back(doc);
+        tfs.push_back(tf);
+        for (PostingBlock* block : {&blocks.back(), &bound}) {
+            block->last_doc = doc;
+            block->max_tf = std::max(block->max_tf, tf);
+            block->min_length = std::min(block->min_length, length);
+        }
+    }
+};
+
+/// BM25 term weight with the length norm folded in at query time
+struct TermScorer {
+    double idf;                         // Scaled by the query term's weight
+    double k1;
+    double b;
+    double avg_doc_length;
+
+    [[nodiscard]] double score(uint32_t tf, uint32_t length) const {
+        double norm = k1 * (1.0 - b + b * length / avg_doc_length);
+        return idf * (tf * (k1 + 1.0)) / (tf + norm);
+    }
+
+    [[nodiscard]] double bound(const PostingBlock& block) const {
+        return score(block.max_tf, block.min_length);
+    }
+};
+
+/// Scores one term's postings within a segment
+struct SegmentScorer {
+    TermScorer term;
+    const std::vector<uint32_t>* doc_lengths;
+
+    [[nodiscard]] double score(const PostingList& list, size_t pos) const {
+        return term.score(list.tfs[pos], (*doc_lengths)[list.docs[pos]]);
+    }
+
+    [[nodiscard]] double bound(const PostingBlock& block) const {
+        return term.bound(block);
+    }
+};
+
+using PostingCursor = BlockCursor<PostingList, SegmentScorer>;
+
+/// Distinct terms of one tokenized document, sorted by term id
+struct DocumentTerms {
+    std::vector<std::pair<uint32_t, uint32_t>> counts;  // (term id, tf)
+    std::vector<uint8_t> positions;                     // With store_positions: delta-varint, per term
+    std::vector<uint32_t> position_offsets;             // counts.size() + 1 offsets into positions
+    size_t length = 0;
+
+    [[nodiscard]] std::span<const uint8_t> term_positions(size_t i) const {
+        return std::span(positions).subspan(position_offsets[i],
+                                            position_offsets[i + 1] - position_offsets[i]);
+    }
+};
+
+/// Decode one posting's positions (validated when the segment was built)
+void decode_positions(std::span<const uint8_t> encoded, std::vector<uint32_t>& out) {
+    out.clear();
+    const uint8_t* in = encoded.data();
+    const uint8_t* end = in + encoded.size();
+    uint32_t position = 0;
+    uint32_t gap = 0;
+    while (in < end && get_varint(in, end, gap)) {
+        position += gap;
+        out.push_back(position);
     }
-    
-    return tokens;
 }
 
-// Simple stemming
-std::string stem(const std::string& word) {
-    std::string result = word;
-    
-    if (result.length() > 3) {
-        if (result.size() >= 3 && result.substr(result.size() - 3) == "ing") {
-            result = result.substr(0, result.length() - 3);
-        } else if (result.size() >= 2 && result.substr(result.size() - 2) == "ed") {
-            result = result.substr(0, result.length() - 2);
-        } else if (result.size() >= 1 && result.back() == 's' && 
-                   !(result.size() >= 2 && result.substr(result.size() - 2) == "ss")) {
-            result = result.substr(0, result.length() - 1);
+// ============================================================================
+// Segments
+// ============================================================================
+
+/// A run of documents with its own dense numbering. The engine appends only
+/// to the delta segment, under the segment's mutex; once sealed, postings
+/// never change and searches read them without locking. Deletion sets a bit
+/// and decrements per-term live counts, both atomic, so it applies to sealed
+/// segments in place and the space is reclaimed when segments merge.
+/// Terms are the engine's dictionary ids, mapped to dense local ids here.
+struct Segment {
+    std::vector<VectorId> doc_ids;
+    std::vector<uint32_t> doc_lengths;
+    std::vector<std::string> contents;              // Parallel to doc_ids with store_content
+
+    std::vector<uint32_t> terms;                    // By local id: dictionary term id
+    std::unordered_map<uint32_t, uint32_t> local_ids;
+    std::vector<PostingList> postings;              // By local id
+    std::deque<std::atomic<uint32_t>> live_df;      // By local id, excluding deleted docs
+
+    // Forward index: doc d holds local ids doc_terms[term_offsets[d], term_offsets[d + 1])
+    std::vector<uint32_t> term_offsets{0};
+    std::vector<uint32_t> doc_terms;
+
+    std::deque<std::atomic<uint64_t>> deleted;      // One bit per document
+    std::atomic<size_t> live_docs{0};
+
+    mutable std::shared_mutex mutex;                // Only taken while this is the delta
+
+    [[nodiscard]] size_t size() const { return doc_ids.size(); }
+
+    [[nodiscard]] const PostingList* find(uint32_t term) const {
+        auto it = local_ids.find(term);
+        return it != local_ids.end() ? &postings[it->second] : nullptr;
+    }
+
+    [[nodiscard]] uint32_t live_document_frequency(uint32_t term) const {
+        auto it = local_ids.find(term);
+        return it != local_ids.end() ? live_df[it->second].load(std::memory_order_relaxed) : 0;
+    }
+
+    [[nodiscard]] bool is_deleted(uint32_t doc) const {
+        return (deleted[doc / 64].load(std::memory_order_acquire) >> (doc % 64)) & 1;
+    }
+
+    uint32_t intern(uint32_t term) {
+        auto [it, inserted] = local_ids.try_emplace(term, static_cast<uint32_t>(terms.size()));
+        if (!inserted) {
+            return it->second;
         }
+        terms.push_back(term);
+        postings.emplace_back();
+        live_df.emplace_back(0);
+        return it->second;
     }
-    
-    return result;
+
+    /// Add a document slot; postings and the forward index are filled by the caller
+    uint32_t push_document(VectorId id, uint32_t length) {
+        auto doc = static_cast<uint32_t>(doc_ids.size());
+        doc_ids.push_back(id);
+        doc_lengths.push_back(length);
+        if (deleted.size() * 64 <= doc) {
+            deleted.emplace_back(0);
+        }
+        live_docs.fetch_add(1, std::memory_order_relaxed);
+        return doc;
+    }
+
+    /// Append a tokenized document
+    uint32_t append(VectorId id, const DocumentTerms& document, const std::string* content) {
+        auto length = static_cast<uint32_t>(document.length);
+        uint32_t doc = push_document(id, length);
+        if (content) {
+            contents.push_back(*content);
+        }
+        bool positional = !document.position_offsets.empty();
+        for (size_t i = 0; i < document.counts.size(); ++i) {
+            auto [term, tf] = document.counts[i];
+            uint32_t local = intern(term);
+            postings[local].append(doc, tf, length);
+            if (positional) {
+                postings[local].append_positions(document.term_positions(i));
+            }
+            live_df[local].fetch_add(1, std::memory_order_relaxed);
+            doc_terms.push_back(local);
+        }
+        term_offsets.push_back(static_cast<uint32_t>(doc_terms.size()));
+        return doc;
+    }
+
+    /// Mark a document deleted; on_term sees each of its dictionary term ids
+    template<typename OnTerm>
+    void erase(uint32_t doc, OnTerm&& on_term) {
+        deleted[doc / 64].fetch_or(uint64_t{1} << (doc % 64), std::memory_order_release);
+        for (uint32_t i = term_offsets[doc]; i < term_offsets[doc + 1]; ++i) {
+            live_df[doc_terms[i]].fetch_sub(1, std::memory_order_relaxed);
+            on_term(terms[doc_terms[i]]);
+        }
+        live_docs.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// Derive the forward index from postings (after merge or decode)
+    void build_forward_index() {
+        term_offsets.assign(size() + 1, 0);
+        for (const auto& list : postings) {
+            for (uint32_t doc : list.docs) {
+                term_offsets[doc + 1]++;
+            }
+        }
+        for (size_t doc = 0; doc < size(); ++doc) {
+            term_offsets[doc + 1] += term_offsets[doc];
+        }
+        doc_terms.resize(term_offsets.back());
+        std::vector<uint32_t> fill(term_offsets.begin(), term_offsets.end() - 1);
+        for (uint32_t local = 0; local < postings.size(); ++local) {
+            for (uint32_t doc : postings[local].docs) {
+                doc_terms[fill[doc]++] = local;
+            }
+        }
+    }
+};
+
+/// A newly sealed segment is merged into its older neighbour while the
+/// neighbour holds at most this many times its live documents, so sealed
+/// segments grow geometrically and stay O(log n) in number
+constexpr size_t SEGMENT_MERGE_RATIO = 2;
+
+/// The published view searches load: sealed segments plus the current delta
+struct SegmentSet {
+    std::vector<std::shared_ptr<Segment>> sealed;
+    std::shared_ptr<Segment> delta;
+};
+
+/// Copy the live documents of `sources`, in order, into one new segment.
+/// Order is preserved, so renumbered postings stay sorted.
+std::shared_ptr<Segment> merge_segments(std::span<const std::shared_ptr<Segment>> sources,
+                                        bool store_content) {
+    auto merged = std::make_shared<Segment>();
+    std::vector<uint32_t> renumber;
+    for (const auto& source : sources) {
+        renumber.assign(source->size(), NO_MORE_DOCS);
+        for (uint32_t doc = 0; doc < source->size(); ++doc) {
+            if (source->is_deleted(doc)) continue;
+            renumber[doc] = merged->push_document(source->doc_ids[doc], source->doc_lengths[doc]);
+            if (store_content) {
+                merged->contents.push_back(source->contents[doc]);
+            }
+        }
+
+        for (uint32_t local = 0; local < source->terms.size(); ++local) {
+            if (source->live_df[local].load(std::memory_order_relaxed) == 0) continue;
+
+            const auto& list = source->postings[local];
+            uint32_t target = merged->intern(source->terms[local]);
+            auto& out = merged->postings[target];
+            for (size_t i = 0; i < list.docs.size(); ++i) {
+                uint32_t doc = renumber[list.docs[i]];
+                if (doc == NO_MORE_DOCS) continue;
+                out.append(doc, list.tfs[i], merged->doc_lengths[doc]);
+                if (list.has_positions()) {
+                    out.append_positions(list.positions(i));
+                }
+                merged->live_df[target].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    merged->build_forward_index();
+    return merged;
 }
 
-const std::unordered_set<std::string> STOP_WORDS = {
-    "a", "an", "and", "are", "as", "at", "be", "by", "for", "from",
-    "has", "he", "in", "is", "it", "its", "of", "on", "that", "the",
-    "to", "was", "were", "will", "with", "this", "but", "they", "have"
+/// A doc-id range of one sealed segment, scored as one task
+struct Shard {
+    size_t segment;
+    DocRange range;
 };
 
-bool is_stop_word(const std::string& word) {
-    return STOP_WORDS.find(word) != STOP_WORDS.end();
+/// Split sealed segments into about config.search_shards ranges of at least
+/// config.min_shard_docs documents. Empty when parallel scoring is off or
+/// the index is too small for it to pay, in which case segments are scored
+/// sequentially into one heap.
+std::vector<Shard> plan_shards(std::span<const std::shared_ptr<Segment>> sealed,
+                               const BM25Config& config) {
+    size_t wanted = config.search_shards;
+    if (wanted == 0) {
+        wanted = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t total = 0;
+    for (const auto& segment : sealed) {
+        total += segment->size();
+    }
+    size_t min_docs = std::max<size_t>(config.min_shard_docs, 1);
+    if (wanted <= 1 || total < 2 * min_docs) {
+        return {};
+    }
+
+    size_t target = std::max(min_docs, (total + wanted - 1) / wanted);
+    std::vector<Shard> shards;
+    for (size_t s = 0; s < sealed.size(); ++s) {
+        size_t size = sealed[s]->size();
+        if (size == 0) continue;
+        size_t parts = std::max<size_t>(1, (size + target / 2) / target);
+        for (size_t p = 0; p < parts; ++p) {
+            shards.push_back(Shard{s, DocRange{static_cast<uint32_t>(size * p / parts),
+                                               static_cast<uint32_t>(size * (p + 1) / parts)}});
+        }
+    }
+    return shards;
 }
 
-std::vector<std::string> process_text(const std::string& text, 
-                                      const BM25Config& config) {
-    std::vector<std::string> processed;
-    auto tokens = tokenize(text);
-    
-    for (auto& token : tokens) {
-        if (!config.case_sensitive) {
-            token = to_lower(token);
+// ============================================================================
+// Query Evaluation
+// ============================================================================
+
+/// A query resolved to dictionary ids
+struct ParsedQuery {
+    std::vector<uint32_t> terms;                                    // Distinct ids
+    std::vector<double> weights;                                    // By distinct id: multiplicity or expansion weight
+    std::vector<std::pair<uint32_t, std::string_view>> reported;    // Listed in matched_terms when the doc has them
+    std::vector<std::pair<uint32_t, uint32_t>> positions;           // (id, query position); empty skips the positional pass
+
+    void add(uint32_t term, double weight) {
+        size_t i = index_of(term);
+        if (i == terms.size()) {
+            terms.push_back(term);
+            weights.push_back(0.0);
         }
-        
-        if (token.length() < config.min_term_length) {
+        weights[i] += weight;
+    }
+
+    [[nodiscard]] size_t index_of(uint32_t term) const {
+        return static_cast<size_t>(std::find(terms.begin(), terms.end(), term) - terms.begin());
+    }
+};
+
+// ============================================================================
+// Phrase and Proximity Scoring
+// ============================================================================
+
+/// A resolved query token for the positional second pass
+struct QueryTerm {
+    uint32_t term;                      // Dictionary id
+    uint32_t position;                  // Raw token index in the query
+    double idf;
+};
+
+/// Positional bonus for one first-pass candidate. An exact phrase places
+/// every query term at its query offset from the first; proximity lets each
+/// occurrence of a query term count its nearest occurrence of the next term
+/// within config.proximity_window as 1/d^2, where d is 1 at the query's own
+/// spacing and grows with displacement or reversed order. Both are
+/// saturated like tf and weighted by idf.
+double proximity_bonus(const Segment& segment, uint32_t doc,
+                       std::span<const QueryTerm> query, const BM25Config& config) {
+    thread_local std::vector<std::vector<uint32_t>> positions;
+    positions.resize(query.size());
+    bool all_present = true;
+    for (size_t i = 0; i < query.size(); ++i) {
+        positions[i].clear();
+        const PostingList* list = segment.find(query[i].term);
+        auto it = list ? std::lower_bound(list->docs.begin(), list->docs.end(), doc)
+                       : std::vector<uint32_t>::const_iterator{};
+        if (!list || !list->has_positions() || it == list->docs.end() || *it != doc) {
+            all_present = false;
             continue;
         }
-        
-        if (is_stop_word(token)) {
-            continue;
+        decode_positions(list->positions(static_cast<size_t>(it - list->docs.begin())), positions[i]);
+    }
+
+    double k1 = config.k1;
+    auto saturate = [k1](double x) { return x * (k1 + 1.0) / (x + k1); };
+    double bonus = 0.0;
+
+    if (all_present) {
+        uint32_t matches = 0;
+        for (uint32_t start : positions[0]) {
+            bool match = true;
+            for (size_t i = 1; i < query.size() && match; ++i) {
+                uint64_t expected = uint64_t{start} + (query[i].position - query[0].position);
+                match = std::binary_search(positions[i].begin(), positions[i].end(), expected);
+            }
+            matches += match ? 1 : 0;
         }
-        
-        if (config.use_stemming) {
-            token = stem(token);
+        if (matches > 0) {
+            double idf = 0.0;
+            for (const auto& term : query) {
+                idf += term.idf;
+            }
+            bonus += config.phrase_weight * idf * saturate(matches);
         }
-        
-        processed.push_back(token);
     }
-    
-    return processed;
+
+    auto window = static_cast<int64_t>(config.proximity_window);
+    for (size_t i = 0; i + 1 < query.size(); ++i) {
+        const auto& first = positions[i];
+        const auto& second = positions[i + 1];
+        if (query[i].term == query[i + 1].term || first.empty() || second.empty()) continue;
+
+        int64_t offset = int64_t{query[i + 1].position} - query[i].position;
+        double accumulated = 0.0;
+        auto next = second.begin();
+        for (uint32_t position : first) {
+            int64_t target = position + offset;
+            while (next != second.end() && *next < target) ++next;
+
+            int64_t partner = -1;
+            int64_t displacement = std::numeric_limits<int64_t>::max();
+            if (next != second.end()) {
+                partner = *next;
+                displacement = partner - target;
+            }
+            if (next != second.begin() && target - *(next - 1) < displacement) {
+                partner = *(next - 1);
+                displacement = target - partner;
+            }
+            if (partner >= 0 && std::abs(partner - int64_t{position}) <= window) {
+                double d = static_cast<double>(displacement + 1);
+                accumulated += 1.0 / (d * d);
+            }
+        }
+        if (accumulated > 0.0) {
+            bonus += config.proximity_weight * std::min(query[i].idf, query[i + 1].idf) *
+                     saturate(accumulated);
+        }
+    }
+    return bonus;
+}
+
+// ============================================================================
+// Segment Encoding
+// ============================================================================
+//
+// A saved engine is one segment written through write_checkpoint (atomic,
+// CRC-32C footer) and read back with read_checkpoint. Loading is a single
+// sequential decode into heap-resident postings with no tokenization:
+//
+//   header      magic, version, flags, config, counts
+//   norms       doc_ids[num_docs] (u64), doc_lengths[num_docs] (u32)
+//   dictionary  sorted by term: blob offset, length, df, postings offset
+//   term blob   concatenated term bytes
+//   postings    per block: last_doc, max_tf, min_length, bit widths, then
+//               bit-packed doc gaps and bit-packed (tf - 1); with
+//               SEGMENT_FLAG_POSITIONS the list ends with a u64 byte count
+//               and each posting's positions as delta varints
+//   contents    only with SEGMENT_FLAG_CONTENT: u32 length + bytes per doc
+
+constexpr uint64_t SEGMENT_MAGIC = 0x5335324D42424456ULL;  // "VDBBM25S"
+constexpr uint32_t SEGMENT_VERSION = 1;
+constexpr uint32_t SEGMENT_FLAG_CONTENT = 1u << 0;
+constexpr uint32_t SEGMENT_FLAG_POSITIONS = 1u << 1;
+constexpr std::string_view LEGACY_HEADER = "BM25_ENGINE_V1";
+
+void encode_postings(std::vector<uint8_t>& out, const PostingList& list, bool positions) {
+    std::vector<uint32_t> gaps;
+    std::vector<uint32_t> tfs;
+    uint32_t previous = 0;
+
+    for (size_t b = 0; b < list.blocks.size(); ++b) {
+        const auto& block = list.blocks[b];
+        size_t begin = b * POSTING_BLOCK_SIZE;
+        size_t end = std::min(list.docs.size(), begin + POSTING_BLOCK_SIZE);
+
+        gaps.clear();
+        tfs.clear();
+        uint32_t max_gap = 0;
+        uint32_t max_tf = 0;
+        for (size_t i = begin; i < end; ++i) {
+            gaps.push_back(list.docs[i] - previous);
+            tfs.push_back(list.tfs[i] - 1);
+            max_gap = std::max(max_gap, gaps.back());
+            max_tf = std::max(max_tf, tfs.back());
+            previous = list.docs[i];
+        }
+
+        uint8_t gap_width = bit_width(max_gap);
+        uint8_t tf_width = bit_width(max_tf);
+        put_raw(out, block.last_doc);
+        put_raw(out, block.max_tf);
+        put_raw(out, block.min_length);
+        put_raw(out, gap_width);
+        put_raw(out, tf_width);
+        pack_bits(out, gaps, gap_width);
+        pack_bits(out, tfs, tf_width);
+    }
+
+    if (positions) {
+        put_raw(out, static_cast<uint64_t>(list.position_bytes.size()));
+        out.insert(out.end(), list.position_bytes.begin(), list.position_bytes.end());
+    }
+}
+
+/// Rebuild position offsets from the tfs; rejects truncated, trailing or
+/// non-increasing positions
+[[nodiscard]] bool index_positions(PostingList& list) {
+    const uint8_t* begin = list.position_bytes.data();
+    const uint8_t* in = begin;
+    const uint8_t* end = begin + list.position_bytes.size();
+    list.position_offsets.assign(1, 0);
+    for (uint32_t tf : list.tfs) {
+        uint64_t position = 0;
+        for (uint32_t j = 0; j < tf; ++j) {
+            uint32_t gap = 0;
+            if (!get_varint(in, end, gap) || (j > 0 && gap == 0)) {
+                return false;
+            }
+            position += gap;
+        }
+        if (position > std::numeric_limits<uint32_t>::max()) {
+            return false;
+        }
+        list.position_offsets.push_back(static_cast<uint32_t>(in - begin));
+    }
+    return in == end;
+}
+
+/// Decode `df` postings; rejects lists that are unsorted or out of range,
+/// and blocks whose (max_tf, min_length) do not bound their postings
+[[nodiscard]] bool decode_postings(ByteReader& reader, std::span<const uint32_t> doc_lengths,
+                                   uint32_t df, bool positions, PostingList& list) {
+    auto num_docs = static_cast<uint32_t>(doc_lengths.size());
+    if (df > num_docs) {
+        return false;
+    }
+    list.docs.resize(df);
+    list.tfs.resize(df);
+    list.blocks.resize((df + POSTING_BLOCK_SIZE - 1) / POSTING_BLOCK_SIZE);
+
+    uint32_t previous = 0;
+    for (size_t b = 0; b < list.blocks.size(); ++b) {
+        auto& block = list.blocks[b];
+        size_t begin = b * POSTING_BLOCK_SIZE;
+        size_t count = std::min<size_t>(df - begin, POSTING_BLOCK_SIZE);
+        uint8_t gap_width = 0;
+        uint8_t tf_width = 0;
+        std::span<const uint8_t> gaps;
+        std::span<const uint8_t> tfs;
+        if (!reader.read(block.last_doc) || !reader.read(block.max_tf) ||
+            !reader.read(block.min_length) || !reader.read(gap_width) ||
+            !reader.read(tf_width) || gap_width > 32 || tf_width > 32 ||
+            !reader.take(packed_bytes(count, gap_width), gaps) ||
+            !reader.take(packed_bytes(count, tf_width), tfs)) {
+            return false;
+        }
+
+        uint32_t* docs = list.docs.data() + begin;
+        uint32_t* freqs = list.tfs.data() + begin;
+        unpack_bits(gaps.data(), count, gap_width, docs);
+        unpack_bits(tfs.data(), count, tf_width, freqs);
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t doc = static_cast<uint64_t>(previous) + docs[i];
+            if (doc >= num_docs || (begin + i > 0 && docs[i] == 0)) {
+                return false;
+            }
+            docs[i] = previous = static_cast<uint32_t>(doc);
+            freqs[i] += 1;
+            // MaxScore skips blocks by these bounds, so an understated one
+            // would silently drop matches
+            if (freqs[i] > block.max_tf || doc_lengths[previous] < block.min_length) {
+                return false;
+            }
+        }
+        if (block.last_doc != previous) {
+            return false;
+        }
+
+        list.bound.last_doc = block.last_doc;
+        list.bound.max_tf = std::max(list.bound.max_tf, block.max_tf);
+        list.bound.min_length = std::min(list.bound.min_length, block.min_length);
+    }
+
+    if (positions) {
+        uint64_t size = 0;
+        std::span<const uint8_t> bytes;
+        if (!reader.read(size) || size > std::numeric_limits<uint32_t>::max() ||
+            !reader.take(size, bytes)) {
+            return false;
+        }
+        list.position_bytes.assign(bytes.begin(), bytes.end());
+        return index_positions(list);
+    }
+    return true;
+}
+
+
+/// Serialize a segment without deletions (as produced by merge_segments);
+/// term ids are written as the dictionary's strings
+std::vector<uint8_t> encode_segment(const Segment& segment, const BM25Config& config,
+                                    const TermDictionary& dictionary) {
+    auto text = [&](uint32_t local) { return dictionary.term(segment.terms[local]); };
+    std::vector<uint32_t> order;
+    order.reserve(segment.terms.size());
+    for (uint32_t local = 0; local < segment.terms.size(); ++local) {
+        if (!segment.postings[local].docs.empty()) {
+            order.push_back(local);
+        }
+    }
+    std::sort(order.begin(), order.end(),
+        [&](uint32_t a, uint32_t b) { return text(a) < text(b); });
+
+    uint64_t total_terms = 0;
+    for (uint32_t length : segment.doc_lengths) {
+        total_terms += length;
+    }
+
+    uint32_t flags = (config.store_content ? SEGMENT_FLAG_CONTENT : 0) |
+                     (config.store_positions ? SEGMENT_FLAG_POSITIONS : 0);
+    std::vector<uint8_t> out;
+    put_raw(out, SEGMENT_MAGIC);
+    put_raw(out, SEGMENT_VERSION);
+    put_raw(out, flags);
+    put_raw(out, config.k1);
+    put_raw(out, config.b);
+    put_raw(out, static_cast<uint32_t>(config.min_term_length));
+    put_raw(out, static_cast<uint8_t>(config.use_stemming));
+    put_raw(out, static_cast<uint8_t>(config.case_sensitive));
+    put_raw(out, static_cast<uint64_t>(segment.size()));
+    put_raw(out, static_cast<uint64_t>(order.size()));
+    put_raw(out, total_terms);
+
+    for (VectorId id : segment.doc_ids) put_raw(out, static_cast<uint64_t>(id));
+    for (uint32_t length : segment.doc_lengths) put_raw(out, length);
+
+    // Postings are encoded first so the dictionary can record offsets
+    std::vector<uint8_t> postings_bytes;
+    std::vector<uint64_t> postings_offsets;
+    postings_offsets.reserve(order.size());
+    for (uint32_t local : order) {
+        postings_offsets.push_back(postings_bytes.size());
+        encode_postings(postings_bytes, segment.postings[local], config.store_positions);
+    }
+
+    uint32_t blob_offset = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        std::string_view term = text(order[i]);
+        put_raw(out, blob_offset);
+        put_raw(out, static_cast<uint32_t>(term.size()));
+        put_raw(out, static_cast<uint32_t>(segment.postings[order[i]].docs.size()));
+        put_raw(out, postings_offsets[i]);
+        blob_offset += static_cast<uint32_t>(term.size());
+    }
+    put_raw(out, static_cast<uint64_t>(blob_offset));
+    for (uint32_t local : order) {
+        std::string_view term = text(local);
+        out.insert(out.end(), term.begin(), term.end());
+    }
+    put_raw(out, static_cast<uint64_t>(postings_bytes.size()));
+    out.insert(out.end(), postings_bytes.begin(), postings_bytes.end());
+
+    if (flags & SEGMENT_FLAG_CONTENT) {
+        for (const auto& content : segment.contents) {
+            put_raw(out, static_cast<uint32_t>(content.size()));
+            out.insert(out.end(), content.begin(), content.end());
+        }
+    }
+    return out;
+}
+
+/// Decode a segment payload (footer already verified); fills in config and
+/// interns the segment's terms into dictionary
+Result<std::shared_ptr<Segment>> decode_segment(std::span<const uint8_t> payload,
+                                                BM25Config& config,
+                                                TermDictionary& dictionary) {
+    auto corrupted = [] {
+        return std::unexpected(Error(ErrorCode::IndexCorrupted, "Invalid BM25 segment"));
+    };
+
+    ByteReader reader{payload};
+    uint64_t magic = 0;
+    uint32_t version = 0;
+    uint32_t flags = 0;
+    uint32_t min_term_length = 0;
+    uint8_t use_stemming = 0;
+    uint8_t case_sensitive = 0;
+    uint64_t num_docs = 0;
+    uint64_t num_terms = 0;
+    uint64_t total_terms = 0;
+    if (!reader.read(magic) || magic != SEGMENT_MAGIC ||
+        !reader.read(version) || version != SEGMENT_VERSION ||
+        !reader.read(flags) || !reader.read(config.k1) || !reader.read(config.b) ||
+        !reader.read(min_term_length) || !reader.read(use_stemming) ||
+        !reader.read(case_sensitive) || !reader.read(num_docs) ||
+        !reader.read(num_terms) || !reader.read(total_terms) ||
+        num_docs >= NO_MORE_DOCS || num_terms > payload.size()) {
+        return corrupted();
+    }
+    config.min_term_length = min_term_length;
+    config.use_stemming = use_stemming != 0;
+    config.case_sensitive = case_sensitive != 0;
+    config.store_content = (flags & SEGMENT_FLAG_CONTENT) != 0;
+    config.store_positions = (flags & SEGMENT_FLAG_POSITIONS) != 0;
+
+    std::span<const uint8_t> ids_bytes;
+    std::span<const uint8_t> lengths_bytes;
+    if (!reader.take(num_docs * sizeof(uint64_t), ids_bytes) ||
+        !reader.take(num_docs * sizeof(uint32_t), lengths_bytes)) {
+        return corrupted();
+    }
+
+    auto segment = std::make_shared<Segment>();
+    for (size_t doc = 0; doc < num_docs; ++doc) {
+        uint64_t id = 0;
+        uint32_t length = 0;
+        std::memcpy(&id, ids_bytes.data() + doc * sizeof(id), sizeof(id));
+        std::memcpy(&length, lengths_bytes.data() + doc * sizeof(length), sizeof(length));
+        segment->push_document(static_cast<VectorId>(id), length);
+    }
+
+    struct DictionaryEntry {
+        uint32_t blob_offset;
+        uint32_t length;
+        uint32_t df;
+        uint64_t postings_offset;
+    };
+    std::vector<DictionaryEntry> entries(num_terms);
+    for (auto& entry : entries) {
+        if (!reader.read(entry.blob_offset) || !reader.read(entry.length) ||
+            !reader.read(entry.df) || !reader.read(entry.postings_offset)) {
+            return corrupted();
+        }
+    }
+
+    uint64_t blob_size = 0;
+    uint64_t postings_size = 0;
+    std::span<const uint8_t> blob;
+    std::span<const uint8_t> postings;
+    if (!reader.read(blob_size) || !reader.take(blob_size, blob) ||
+        !reader.read(postings_size) || !reader.take(postings_size, postings)) {
+        return corrupted();
+    }
+
+    // Decode every list before interning anything, so a corrupt payload
+    // leaves the dictionary untouched. Terms are written sorted and unique.
+    std::vector<std::string_view> terms(entries.size());
+    std::vector<PostingList> lists(entries.size());
+    for (size_t e = 0; e < entries.size(); ++e) {
+        const auto& entry = entries[e];
+        if (entry.df == 0 || entry.df > num_docs || entry.blob_offset > blob.size() ||
+            entry.length > blob.size() - entry.blob_offset ||
+            entry.postings_offset > postings.size()) {
+            return corrupted();
+        }
+        terms[e] = std::string_view(reinterpret_cast<const char*>(blob.data() + entry.blob_offset),
+                                    entry.length);
+        ByteReader list_reader{postings, static_cast<size_t>(entry.postings_offset)};
+        if ((e > 0 && terms[e] <= terms[e - 1]) ||
+            !decode_postings(list_reader, segment->doc_lengths, entry.df,
+                             config.store_positions, lists[e])) {
+            return corrupted();
+        }
+    }
+
+    if (config.store_content) {
+        segment->contents.reserve(num_docs);
+        for (size_t doc = 0; doc < num_docs; ++doc) {
+            uint32_t length = 0;
+            std::span<const uint8_t> text;
+            if (!reader.read(length) || !reader.take(length, text)) {
+                return corrupted();
+            }
+            segment->contents.emplace_back(reinterpret_cast<const char*>(text.data()), length);
+        }
+    }
+
+    for (size_t e = 0; e < entries.size(); ++e) {
+        uint32_t local = segment->intern(dictionary.intern(terms[e]));
+        segment->postings[local] = std::move(lists[e]);
+        segment->live_df[local].store(entries[e].df, std::memory_order_relaxed);
+    }
+    segment->build_forward_index();
+    return segment;
 }
 
 } // anonymous namespace
@@ -111,112 +847,487 @@ std::vector<std::string> process_text(const std::string& text,
 // ============================================================================
 
 struct BM25Engine::Impl {
+    struct Location {
+        Segment* segment;
+        uint32_t doc;
+    };
+
     BM25Config config;
-    std::unordered_map<VectorId, Document> documents;
-    std::unordered_map<std::string, std::vector<std::pair<VectorId, uint32_t>>> inverted_index;
-    std::unordered_map<std::string, uint32_t> document_frequency;
-    size_t total_documents = 0;
-    size_t total_terms = 0;
-    double avg_doc_length = 0.0;
+    Tokenizer tokenizer;
+
+    // Searches copy this pointer and never take write_mutex; state_mutex is
+    // held only for the copy or the swap
+    mutable std::mutex state_mutex;
+    std::shared_ptr<const SegmentSet> segments;
+
+    // Writers are serialized; everything below is guarded by write_mutex
+    // (the counters are atomic only so statistics can be read lock-free)
+    mutable std::mutex write_mutex;
+    std::unordered_map<VectorId, Location> locations;
+    std::vector<uint32_t> document_frequency;       // Live df by term id
+    size_t live_terms = 0;                          // Term ids with live df > 0
+    std::atomic<size_t> total_documents{0};
+    std::atomic<size_t> total_terms{0};
+
+    // Term ids are assigned before write_mutex is taken; searches resolve
+    // query terms under the shared side
+    mutable std::shared_mutex dictionary_mutex;
+    TermDictionary dictionary;
     
-    Impl(const BM25Config& cfg) : config(cfg) {}
+    Impl(const BM25Config& cfg) : config(cfg), tokenizer(bm25_tokenizer_options(cfg)) {
+        segments = std::make_shared<const SegmentSet>(SegmentSet{{}, std::make_shared<Segment>()});
+    }
+
+    [[nodiscard]] std::shared_ptr<const SegmentSet> load_segments() const {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        return segments;
+    }
+
+    void publish_segments(std::shared_ptr<const SegmentSet> next) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        segments.swap(next);
+    }
     
+    /// Tokenize and intern outside write_mutex. Sorting (term id, position)
+    /// pairs groups each term's occurrences with positions ascending.
+    void count_terms(const std::string& content, DocumentTerms& document) {
+        TokenBuffer& tokens = scratch_tokens();
+        tokenizer.tokenize(content, tokens);
+
+        thread_local std::vector<std::pair<uint32_t, uint32_t>> occurrences;
+        occurrences.clear();
+        {
+            std::unique_lock<std::shared_mutex> lock(dictionary_mutex);
+            for (const auto& token : tokens) {
+                occurrences.emplace_back(dictionary.intern(token.text), token.position);
+            }
+        }
+
+        std::sort(occurrences.begin(), occurrences.end());
+        bool positional = config.store_positions;
+        uint32_t previous = 0;
+        for (auto [id, position] : occurrences) {
+            if (document.counts.empty() || document.counts.back().first != id) {
+                document.counts.emplace_back(id, 0);
+                if (positional) {
+                    document.position_offsets.push_back(static_cast<uint32_t>(document.positions.size()));
+                }
+                previous = 0;
+            }
+            document.counts.back().second++;
+            if (positional) {
+                put_varint(document.positions, position - previous);
+                previous = position;
+            }
+        }
+        if (positional) {
+            document.position_offsets.push_back(static_cast<uint32_t>(document.positions.size()));
+        }
+        document.length = occurrences.size();
+    }
+
     Result<void> add_document(VectorId id, const std::string& content) {
-        if (documents.find(id) != documents.end()) {
+        DocumentTerms document;
+        count_terms(content, document);
+
+        std::lock_guard<std::mutex> lock(write_mutex);
+        return add_locked(id, content, document);
+    }
+
+    Result<void> remove_document(VectorId id) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        return remove_locked(id);
+    }
+
+    Result<void> update_document(VectorId id, const std::string& content) {
+        DocumentTerms document;
+        count_terms(content, document);
+
+        // Replace under one lock so other writers never see the id missing;
+        // a document that doesn't exist yet is just added
+        std::lock_guard<std::mutex> lock(write_mutex);
+        if (locations.count(id)) {
+            (void)remove_locked(id);
+        }
+        return add_locked(id, content, document);
+    }
+
+    Result<void> add_locked(VectorId id, const std::string& content, const DocumentTerms& document) {
+        if (locations.count(id)) {
             return std::unexpected(Error(ErrorCode::InvalidData, "Document already exists"));
         }
-        
-        auto terms = process_text(content, config);
-        if (terms.empty()) {
+        if (document.length == 0) {
             return std::unexpected(Error(ErrorCode::InvalidData, "No valid terms in document"));
         }
-        
-        Document doc;
-        doc.id = id;
-        doc.content = content;
-        doc.length = terms.size();
-        
-        std::unordered_map<std::string, uint32_t> term_counts;
-        for (size_t pos = 0; pos < terms.size(); ++pos) {
-            const auto& term = terms[pos];
-            term_counts[term]++;
-            doc.terms[term].positions.push_back(pos);
+
+        auto state = load_segments();
+        if (state->delta->size() >= std::max<size_t>(config.delta_segment_docs, 1)) {
+            seal_delta_locked();
+            state = load_segments();
         }
-        
-        for (const auto& [term, count] : term_counts) {
-            doc.terms[term].text = term;
-            doc.terms[term].frequency = count;
+
+        Segment& delta = *state->delta;
+        uint32_t doc;
+        {
+            std::unique_lock<std::shared_mutex> guard(delta.mutex);
+            doc = delta.append(id, document, config.store_content ? &content : nullptr);
         }
-        
-        for (const auto& [term, term_data] : doc.terms) {
-            inverted_index[term].push_back({id, term_data.frequency});
-            if (term_data.frequency > 0) {
-                document_frequency[term]++;
+        locations[id] = Location{&delta, doc};
+
+        for (const auto& [term, tf] : document.counts) {
+            if (term >= document_frequency.size()) {
+                document_frequency.resize(term + 1, 0);
+            }
+            if (document_frequency[term]++ == 0) {
+                live_terms++;
             }
         }
-        
-        documents[id] = std::move(doc);
-        total_documents++;
-        total_terms += terms.size();
-        avg_doc_length = static_cast<double>(total_terms) / total_documents;
-        
+        total_terms.fetch_add(document.length, std::memory_order_relaxed);
+        total_documents.fetch_add(1, std::memory_order_relaxed);
         return {};
     }
+
+    Result<void> remove_locked(VectorId id) {
+        auto it = locations.find(id);
+        if (it == locations.end()) {
+            return std::unexpected(Error(ErrorCode::VectorNotFound, "Document not found: " + std::to_string(id)));
+        }
+
+        auto [segment, doc] = it->second;
+        segment->erase(doc, [&](uint32_t term) {
+            if (--document_frequency[term] == 0) {
+                live_terms--;
+            }
+        });
+        locations.erase(it);
+
+        total_terms.fetch_sub(segment->doc_lengths[doc], std::memory_order_relaxed);
+        total_documents.fetch_sub(1, std::memory_order_relaxed);
+        return {};
+    }
+
+    /// Point locations at a freshly merged segment
+    void relocate_locked(Segment& segment) {
+        for (uint32_t doc = 0; doc < segment.size(); ++doc) {
+            locations[segment.doc_ids[doc]] = Location{&segment, doc};
+        }
+    }
+
+    /// Freeze the delta, start a new one, and merge the tail of the sealed
+    /// list while the newest segment is comparable in size to its neighbour
+    void seal_delta_locked() {
+        auto state = load_segments();
+        auto next = std::make_shared<SegmentSet>();
+        next->sealed = state->sealed;
+        next->sealed.push_back(state->delta);
+        next->delta = std::make_shared<Segment>();
+
+        auto& sealed = next->sealed;
+        while (sealed.size() >= 2) {
+            size_t older = sealed[sealed.size() - 2]->live_docs.load(std::memory_order_relaxed);
+            size_t newer = sealed.back()->live_docs.load(std::memory_order_relaxed);
+            if (older > newer * SEGMENT_MERGE_RATIO) break;
+
+            auto merged = merge_segments(std::span(sealed).last(2), config.store_content);
+            relocate_locked(*merged);
+            sealed.resize(sealed.size() - 2);
+            sealed.push_back(std::move(merged));
+        }
+        publish_segments(std::move(next));
+    }
+
+    void compact() {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        auto state = load_segments();
+        std::vector<std::shared_ptr<Segment>> all = state->sealed;
+        all.push_back(state->delta);
+
+        auto next = std::make_shared<SegmentSet>();
+        auto merged = merge_segments(all, config.store_content);
+        if (merged->size() > 0) {
+            relocate_locked(*merged);
+            next->sealed.push_back(std::move(merged));
+        }
+        next->delta = std::make_shared<Segment>();
+        publish_segments(std::move(next));
+    }
+
+    /// Serialize every live document as one segment, without changing the
+    /// published segments
+    std::vector<uint8_t> encode() const {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        auto state = load_segments();
+        std::vector<std::shared_ptr<Segment>> all = state->sealed;
+        all.push_back(state->delta);
+        auto merged = merge_segments(all, config.store_content);
+        std::shared_lock<std::shared_mutex> terms(dictionary_mutex);
+        return encode_segment(*merged, config, dictionary);
+    }
+
+    /// Install a decoded segment into an empty engine
+    void install(std::shared_ptr<Segment> segment) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        relocate_locked(*segment);
+        size_t terms = 0;
+        for (uint32_t length : segment->doc_lengths) {
+            terms += length;
+        }
+        document_frequency.assign(dictionary.size(), 0);
+        for (uint32_t local = 0; local < segment->terms.size(); ++local) {
+            document_frequency[segment->terms[local]] =
+                static_cast<uint32_t>(segment->postings[local].docs.size());
+        }
+        live_terms = segment->terms.size();
+        total_documents.store(segment->size(), std::memory_order_relaxed);
+        total_terms.store(terms, std::memory_order_relaxed);
+
+        auto next = std::make_shared<SegmentSet>();
+        next->sealed.push_back(std::move(segment));
+        next->delta = std::make_shared<Segment>();
+        publish_segments(std::move(next));
+    }
+
+    [[nodiscard]] size_t segment_count() const {
+        auto state = load_segments();
+        std::shared_lock<std::shared_mutex> guard(state->delta->mutex);
+        return state->sealed.size() + (state->delta->size() > 0 ? 1 : 0);
+    }
     
+    /// Sealed segments are read without locks; the delta is read under a
+    /// shared lock, taken once for statistics and once for scoring so an
+    /// ingesting writer is only ever blocked briefly.
     Result<std::vector<BM25Result>> search(const std::string& query,
                                            size_t k,
                                            float min_score) const {
-        if (total_documents == 0) {
+        if (total_documents.load(std::memory_order_relaxed) == 0) {
             return std::vector<BM25Result>();
         }
         
-        auto query_terms = process_text(query, config);
+        TokenBuffer& query_terms = scratch_tokens();
+        tokenizer.tokenize(query, query_terms);
         if (query_terms.empty()) {
             return std::unexpected(Error(ErrorCode::InvalidInput, "No valid terms in query"));
         }
-        
-        std::unordered_map<VectorId, float> scores;
-        std::unordered_map<VectorId, std::vector<std::string>> matched_terms;
-        
-        for (const auto& term : query_terms) {
-            auto it = inverted_index.find(term);
-            if (it == inverted_index.end()) {
-                continue;
+
+        // Terms the dictionary has never seen match nothing; a term repeated
+        // in the query contributes once per occurrence
+        ParsedQuery parsed;
+        {
+            std::shared_lock<std::shared_mutex> lock(dictionary_mutex);
+            for (const auto& token : query_terms) {
+                if (auto id = dictionary.find(token.text)) {
+                    parsed.add(*id, 1.0);
+                    parsed.reported.emplace_back(*id, token.text);
+                    parsed.positions.emplace_back(*id, token.position);
+                }
             }
-            
-            const auto& postings = it->second;
-            uint32_t df = document_frequency.at(term);
-            double idf = std::log((total_documents - df + 0.5) / (df + 0.5) + 1.0);
-            
-            for (const auto& [doc_id, tf] : postings) {
-                const auto& doc = documents.at(doc_id);
-                double numerator = tf * (config.k1 + 1.0);
-                double denominator = tf + config.k1 * (1.0 - config.b + 
-                    config.b * doc.length / avg_doc_length);
-                double score = idf * (numerator / denominator);
+        }
+        return evaluate(parsed, k, min_score);
+    }
+    
+    Result<std::vector<BM25Result>> search(std::span<const WeightedTerm> terms,
+                                           size_t k,
+                                           float min_score) const {
+        if (total_documents.load(std::memory_order_relaxed) == 0) {
+            return std::vector<BM25Result>();
+        }
+        
+        ParsedQuery parsed;
+        bool any_valid = false;
+        std::string lowered;
+        {
+            std::shared_lock<std::shared_mutex> lock(dictionary_mutex);
+            for (const auto& term : terms) {
+                if (!std::isfinite(term.weight) || term.weight < 0.0f) {
+                    return std::unexpected(Error(ErrorCode::InvalidInput,
+                        "Query term weights must be finite and non-negative"));
+                }
+                std::string_view text = term.term;
+                if (tokenizer.options().lowercase &&
+                    std::any_of(text.begin(), text.end(), [](char c) { return c >= 'A' && c <= 'Z'; })) {
+                    lowered = Tokenizer::lowercase(text);
+                    text = lowered;
+                }
+                auto normalized = tokenizer.normalize(text);
+                if (!normalized) continue;
+                any_valid = true;
                 
-                scores[doc_id] += score;
-                matched_terms[doc_id].push_back(term);
+                auto id = dictionary.find(*normalized);
+                if (id && term.weight > 0.0f) {
+                    parsed.add(*id, term.weight);
+                    parsed.reported.emplace_back(*id, term.term);
+                }
             }
         }
-        
-        std::vector<BM25Result> results;
-        results.reserve(scores.size());
-        
-        for (const auto& [doc_id, score] : scores) {
-            if (score >= min_score) {
-                BM25Result result;
-                result.id = doc_id;
-                result.score = score;
-                result.matched_terms = std::move(matched_terms[doc_id]);
-                results.push_back(std::move(result));
+        if (!any_valid) {
+            return std::unexpected(Error(ErrorCode::InvalidInput, "No valid terms in query"));
+        }
+        return evaluate(parsed, k, min_score);
+    }
+    
+    /// Score a resolved query over every segment
+    Result<std::vector<BM25Result>> evaluate(const ParsedQuery& query,
+                                             size_t k,
+                                             float min_score) const {
+        auto state = load_segments();
+        size_t num_docs = total_documents.load(std::memory_order_relaxed);
+        size_t num_terms = total_terms.load(std::memory_order_relaxed);
+        if (num_docs == 0 || k == 0) {
+            return std::vector<BM25Result>();
+        }
+        const auto& unique_terms = query.terms;
+
+        // Writers keep updating the per-segment counts while we read them, so
+        // take N from the same counts as df (not total_documents, which may be
+        // older) and clamp: df > N would give a negative idf
+        std::vector<double> df(unique_terms.size(), 0.0);
+        size_t live_docs = 0;
+        auto add_df = [&](const Segment& segment) {
+            live_docs += segment.live_docs.load(std::memory_order_relaxed);
+            for (size_t t = 0; t < unique_terms.size(); ++t) {
+                df[t] += segment.live_document_frequency(unique_terms[t]);
             }
+        };
+        for (const auto& segment : state->sealed) {
+            add_df(*segment);
         }
-        
-        std::sort(results.begin(), results.end());
-        
-        if (results.size() > k) {
-            results.resize(k);
+        {
+            std::shared_lock<std::shared_mutex> guard(state->delta->mutex);
+            add_df(*state->delta);
+        }
+        if (live_docs == 0) {
+            return std::vector<BM25Result>();
+        }
+        num_docs = live_docs;
+        for (double& count : df) {
+            count = std::min(count, static_cast<double>(num_docs));
+        }
+
+        double avg_length = static_cast<double>(num_terms) / num_docs;
+        std::vector<TermScorer> scorers;
+        std::vector<double> idfs;
+        for (size_t t = 0; t < unique_terms.size(); ++t) {
+            double idf = std::log((num_docs - df[t] + 0.5) / (df[t] + 0.5) + 1.0);
+            idfs.push_back(idf);
+            scorers.push_back(TermScorer{idf * query.weights[t], config.k1, config.b, avg_length});
+        }
+
+        // Phrase and proximity need positions and two distinct query terms;
+        // other queries rank exactly k by BM25 alone. An unknown query term
+        // rules out a phrase but not proximity among the others.
+        std::vector<QueryTerm> positional_terms;
+        if (config.store_positions && config.proximity_candidates > 0 && unique_terms.size() >= 2) {
+            for (const auto& [term, position] : query.positions) {
+                positional_terms.push_back(QueryTerm{term, position, idfs[query.index_of(term)]});
+            }
+        }
+        bool positional = positional_terms.size() >= 2;
+        size_t depth = positional ? std::max(k, config.proximity_candidates) : k;
+
+        auto evaluate = [&](const Segment& segment, uint64_t index, DocRange range, TopK& into) {
+            std::vector<PostingCursor> cursors;
+            for (size_t t = 0; t < unique_terms.size(); ++t) {
+                if (df[t] == 0.0) continue;
+                const PostingList* list = segment.find(unique_terms[t]);
+                if (list && !list->docs.empty()) {
+                    cursors.push_back(PostingCursor{list, SegmentScorer{scorers[t], &segment.doc_lengths},
+                                                    scorers[t].bound(list->bound)});
+                }
+            }
+            max_score_top_k(cursors, index << 32, into,
+                            [&](uint32_t doc) { return segment.is_deleted(doc); }, range);
+        };
+
+        // Score the delta and copy out what the second pass and the results
+        // need from its candidates while its lock is held, so the lock is
+        // never kept across shard scoring or the second pass
+        const auto& sealed = state->sealed;
+        TopK top{depth, min_score, {}};
+        top.entries.reserve(depth + 1);
+        auto describe = [&](const Segment& segment, uint32_t doc) {
+            BM25Result result;
+            result.id = segment.doc_ids[doc];
+            for (const auto& [term, text] : query.reported) {
+                const PostingList* list = segment.find(term);
+                if (list && std::binary_search(list->docs.begin(), list->docs.end(), doc)) {
+                    result.matched_terms.emplace_back(text);
+                }
+            }
+            return result;
+        };
+        struct DeltaHit {
+            BM25Result result;
+            double bonus = 0.0;
+        };
+        std::unordered_map<uint64_t, DeltaHit> delta_hits;
+        auto score_delta = [&] {
+            std::shared_lock<std::shared_mutex> guard(state->delta->mutex);
+            evaluate(*state->delta, sealed.size(), {}, top);
+
+            // Later merges only evict, so these are all delta docs that can rank
+            for (const auto& [score, key] : top.entries) {
+                if ((key >> 32) != sealed.size()) continue;
+                auto doc = static_cast<uint32_t>(key);
+                DeltaHit hit{describe(*state->delta, doc)};
+                if (positional) {
+                    hit.bonus = proximity_bonus(*state->delta, doc, positional_terms, config);
+                }
+                delta_hits.emplace(key, std::move(hit));
+            }
+        };
+
+        // Sealed shards each score into their own heap, pruning against the
+        // best k-th score any of them has published, alongside the delta;
+        // the heaps are merged at the end. The calling thread takes part, so
+        // searches issued from pool tasks cannot starve the pool.
+        auto shards = plan_shards(sealed, config);
+        if (shards.empty()) {
+            for (size_t s = 0; s < sealed.size(); ++s) {
+                evaluate(*sealed[s], s, {}, top);
+            }
+            score_delta();
+        } else {
+            std::atomic<double> threshold{-std::numeric_limits<double>::infinity()};
+            top.threshold = &threshold;
+            std::vector<TopK> shard_tops(shards.size(), TopK{depth, min_score, {}, &threshold});
+            global_thread_pool().cooperative_for(shards.size() + 1, [&](size_t i) {
+                if (i == 0) {
+                    score_delta();
+                    return;
+                }
+                const Shard& shard = shards[i - 1];
+                evaluate(*sealed[shard.segment], shard.segment, shard.range, shard_tops[i - 1]);
+            });
+            top.threshold = nullptr;
+            for (const auto& shard_top : shard_tops) {
+                for (const auto& [score, key] : shard_top.entries) {
+                    top.push(score, key);
+                }
+            }
+        }
+
+        // Second pass: positional features for the first-pass top-N only
+        auto ranked = top.take_sorted();
+        if (positional) {
+            for (auto& [score, key] : ranked) {
+                size_t index = key >> 32;
+                score += index < sealed.size()
+                    ? proximity_bonus(*sealed[index], static_cast<uint32_t>(key), positional_terms, config)
+                    : delta_hits.at(key).bonus;
+            }
+            std::sort(ranked.begin(), ranked.end(), TopK::better);
+        }
+        ranked.resize(std::min(ranked.size(), k));
+
+        std::vector<BM25Result> results;
+        results.reserve(ranked.size());
+        for (const auto& [score, key] : ranked) {
+            size_t index = key >> 32;
+            BM25Result result = index < sealed.size()
+                ? describe(*sealed[index], static_cast<uint32_t>(key))
+                : std::move(delta_hits.at(key).result);
+            result.score = static_cast<float>(score);
+            results.push_back(std::move(result));
         }
         
         return results;
@@ -232,55 +1343,12 @@ Result<void> BM25Engine::add_document(VectorId id, const std::string& content) {
     return impl_->add_document(id, content);
 }
 
-Result<void> BM25Engine::remove_document(VectorId id) {
-    auto it = impl_->documents.find(id);
-    if (it == impl_->documents.end()) {
-        return std::unexpected(Error(ErrorCode::VectorNotFound, "Document not found: " + std::to_string(id)));
-    }
-    
-    const auto& doc = it->second;
-    
-    // Update inverted index
-    for (const auto& [term, term_data] : doc.terms) {
-        auto& postings = impl_->inverted_index[term];
-        postings.erase(
-            std::remove_if(postings.begin(), postings.end(),
-                [id](const auto& p) { return p.first == id; }),
-            postings.end()
-        );
-        
-        // Update document frequency
-        impl_->document_frequency[term]--;
-        if (impl_->document_frequency[term] == 0) {
-            impl_->document_frequency.erase(term);
-            impl_->inverted_index.erase(term);
-        }
-    }
-    
-    // Update statistics
-    impl_->total_terms -= doc.length;
-    impl_->documents.erase(it);
-    impl_->total_documents--;
-    
-    if (impl_->total_documents > 0) {
-        impl_->avg_doc_length = static_cast<double>(impl_->total_terms) / impl_->total_documents;
-    } else {
-        impl_->avg_doc_length = 0.0;
-    }
-    
-    return {};
-}
-
+Result<void> BM25Engine::remove_document(VectorId id) {
+    return impl_->remove_document(id);
+}
+
 Result<void> BM25Engine::update_document(VectorId id, const std::string& content) {
-    // Remove old document
-    auto remove_result = remove_document(id);
-    if (!remove_result) {
-        // Document doesn't exist, just add it
-        return impl_->add_document(id, content);
-    }
-    
-    // Add new document
-    return impl_->add_document(id, content);
+    return impl_->update_document(id, content);
 }
 
 Result<std::vector<BM25Result>> BM25Engine::search(const std::string& query,
@@ -289,72 +1357,56 @@ Result<std::vector<BM25Result>> BM25Engine::search(const std::string& query,
     return impl_->search(query, k, min_score);
 }
 
+Result<std::vector<BM25Result>> BM25Engine::search(std::span<const WeightedTerm> terms,
+                                                     size_t k,
+                                                     float min_score) const {
+    return impl_->search(terms, k, min_score);
+}
+
+void BM25Engine::compact() {
+    impl_->compact();
+}
+
 size_t BM25Engine::document_count() const {
-    return impl_->total_documents;
+    return impl_->total_documents.load(std::memory_order_relaxed);
 }
 
 size_t BM25Engine::term_count() const {
-    return impl_->inverted_index.size();
+    std::lock_guard<std::mutex> lock(impl_->write_mutex);
+    return impl_->live_terms;
 }
 
 float BM25Engine::average_document_length() const {
-    return static_cast<float>(impl_->avg_doc_length);
+    size_t docs = impl_->total_documents.load(std::memory_order_relaxed);
+    size_t terms = impl_->total_terms.load(std::memory_order_relaxed);
+    return docs > 0 ? static_cast<float>(static_cast<double>(terms) / docs) : 0.0f;
+}
+
+size_t BM25Engine::segment_count() const {
+    return impl_->segment_count();
 }
 
 Result<void> BM25Engine::save(const std::string& path) const {
-    std::ofstream file(path, std::ios::binary);
-    if (!file) {
-        return std::unexpected(Error(ErrorCode::IoError, "Failed to open file for writing: " + path));
-    }
-    
-    // Write header
-    file << "BM25_ENGINE_V1\n";
-    
-    // Write configuration
-    file << "k1=" << impl_->config.k1 << "\n";
-    file << "b=" << impl_->config.b << "\n";
-    file << "min_term_length=" << impl_->config.min_term_length << "\n";
-    file << "use_stemming=" << (impl_->config.use_stemming ? "1" : "0") << "\n";
-    file << "case_sensitive=" << (impl_->config.case_sensitive ? "1" : "0") << "\n";
-    
-    // Write statistics
-    file << "total_documents=" << impl_->total_documents << "\n";
-    file << "total_terms=" << impl_->total_terms << "\n";
-    file << "avg_doc_length=" << impl_->avg_doc_length << "\n";
-    
-    // Write documents
-    file << "DOCUMENTS_START\n";
-    for (const auto& [id, doc] : impl_->documents) {
-        // Escape newlines in content
-        std::string escaped_content = doc.content;
-        size_t pos = 0;
-        while ((pos = escaped_content.find('\n', pos)) != std::string::npos) {
-            escaped_content.replace(pos, 1, "\\n");
-            pos += 2;
-        }
-        file << id << "\t" << doc.length << "\t" << escaped_content << "\n";
+    auto result = write_checkpoint(fs::path(path), impl_->encode());
+    if (!result) {
+        return result;
     }
-    file << "DOCUMENTS_END\n";
-    
-    file.close();
     
     LOG_INFO("Saved BM25 engine to: " + path);
     return {};
 }
 
-Result<BM25Engine> BM25Engine::load(const std::string& path) {
+namespace {
+
+/// Re-index a BM25_ENGINE_V1 text file (written before binary segments)
+Result<BM25Engine> load_legacy(const std::string& path) {
     std::ifstream file(path);
     if (!file) {
         return std::unexpected(Error(ErrorCode::IoError, "Failed to open file for reading: " + path));
     }
     
     std::string line;
-    
-    // Read header
     std::getline(file, line);
-    if (line != "BM25_ENGINE_V1") {
-        return std::unexpected(Error(ErrorCode::InvalidData, "Invalid BM25 engine file format"));
-    }
     
     // Read configuration
     BM25Config config;
@@ -423,7 +1475,35 @@ Result<BM25Engine> BM25Engine::load(const std::string& path) {
         }
     }
     
-    file.close();
+    return engine;
+}
+
+} // anonymous namespace
+
+Result<BM25Engine> BM25Engine::load(const std::string& path) {
+    auto bytes = read_checkpoint(fs::path(path));
+    if (!bytes) {
+        return std::unexpected(bytes.error());
+    }
+    
+    if (bytes->size() >= LEGACY_HEADER.size() &&
+        std::memcmp(bytes->data(), LEGACY_HEADER.data(), LEGACY_HEADER.size()) == 0) {
+        auto engine = load_legacy(path);
+        if (engine) {
+            LOG_INFO("Loaded legacy BM25 engine from: " + path);
+        }
+        return engine;
+    }
+    
+    BM25Config config;
+    TermDictionary dictionary;
+    auto segment = decode_segment(*bytes, config, dictionary);
+    if (!segment) {
+        return std::unexpected(segment.error());
+    }
+    BM25Engine engine(config);
+    engine.impl_->dictionary = std::move(dictionary);
+    engine.impl_->install(std::move(*segment));
     
     LOG_INFO("Loaded BM25 engine from: " + path);
     return engine;
@@ -441,31 +1521,138 @@ Result<std::shared_ptr<BM25Engine>> BM25Engine::load_shared(const std::string& p
 // ============================================================================
 // KeywordExtractor Implementation
 // ============================================================================
+//
+// Saved statistics are one checkpoint payload (atomic, CRC-32C footer):
+//
+//   header      magic, version, config, total documents, trained, term count
+//   terms       sorted; per term: varint shared prefix length with the
+//               previous term, varint suffix length, suffix bytes, varint df
+//
+// Sorted front-coded terms keep a large archive's table a fraction of its
+// text size, so refreshes can reload and extend it instead of retraining.
+
+namespace {
+
+constexpr uint64_t KEYWORD_MAGIC = 0x314644574B424456ULL;   // "VDBKWDF1"
+constexpr uint32_t KEYWORD_VERSION = 1;
+constexpr std::string_view KEYWORD_LEGACY_HEADER = "KEYWORD_EXTRACTOR_V1";
+
+/// Document and collection frequencies by term id
+struct FrequencyTable {
+    TermDictionary dictionary;
+    std::vector<uint32_t> document_frequency;
+    std::vector<uint32_t> term_frequency;
+    std::vector<uint64_t> last_seen;            // 1 + index of the last counted document
+    uint64_t documents = 0;
+
+    [[nodiscard]] uint32_t frequency_of(std::string_view term) const {
+        auto id = dictionary.find(term);
+        return id && *id < document_frequency.size() ? document_frequency[*id] : 0;
+    }
+
+    void grow(uint32_t id) {
+        if (id >= document_frequency.size()) {
+            document_frequency.resize(id + 1, 0);
+            term_frequency.resize(id + 1, 0);
+        }
+    }
+
+    /// Count one tokenized document
+    void count(const TokenBuffer& tokens) {
+        ++documents;
+        for (const auto& token : tokens) {
+            uint32_t id = dictionary.intern(token.text);
+            grow(id);
+            if (id >= last_seen.size()) {
+                last_seen.resize(id + 1, 0);
+            }
+            term_frequency[id]++;
+            if (last_seen[id] != documents) {
+                document_frequency[id]++;
+                last_seen[id] = documents;
+            }
+        }
+    }
+
+    /// Add another table's counts; its documents are disjoint from ours
+    void merge(const FrequencyTable& other) {
+        for (uint32_t local = 0; local < other.dictionary.size(); ++local) {
+            uint32_t id = dictionary.intern(other.dictionary.term(local));
+            grow(id);
+            document_frequency[id] += other.document_frequency[local];
+            term_frequency[id] += other.term_frequency[local];
+        }
+        documents += other.documents;
+    }
+};
+
+/// Blocking FIFO of document batches. Its capacity bounds how far a fast
+/// source can run ahead of the workers, and so the memory held in flight.
+class BatchQueue {
+public:
+    explicit BatchQueue(size_t capacity) : capacity_(capacity) {}
+
+    void push(std::vector<std::string> batch) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || batches_.size() < capacity_; });
+        if (closed_) return;
+        batches_.push_back(std::move(batch));
+        not_empty_.notify_one();
+    }
+
+    /// Next batch; std::nullopt once closed and drained
+    std::optional<std::vector<std::string>> pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !batches_.empty(); });
+        if (batches_.empty()) return std::nullopt;
+        auto batch = std::move(batches_.front());
+        batches_.pop_front();
+        not_full_.notify_one();
+        return batch;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+private:
+    size_t capacity_;
+    std::deque<std::vector<std::string>> batches_;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
+
+} // anonymous namespace
 
 struct KeywordExtractor::Impl {
     KeywordConfig config;
-    std::unordered_map<std::string, uint32_t> document_frequency;
-    std::unordered_map<std::string, uint32_t> term_frequency;
-    size_t total_documents = 0;
+    Tokenizer tokenizer{TokenizerOptions{.lowercase = true, .remove_stop_words = true,
+                                          .stem = false, .min_length = 2}};
+    FrequencyTable table;
     bool trained = false;
     
     Impl(const KeywordConfig& cfg) : config(cfg) {}
     
     Result<std::vector<Keyword>> extract(const std::string& text) const {
-        auto tokens = tokenize(text);
+        TokenBuffer& tokens = scratch_tokens();
+        tokenizer.tokenize(text, tokens);
         if (tokens.empty()) {
             return std::vector<Keyword>();
         }
         
-        // Count term frequencies and positions
-        std::unordered_map<std::string, std::pair<uint32_t, std::vector<size_t>>> term_data;
-        for (size_t pos = 0; pos < tokens.size(); ++pos) {
-            std::string term = to_lower(tokens[pos]);
-            if (term.length() < 2 || is_stop_word(term)) {
-                continue;
-            }
-            term_data[term].first++;
-            term_data[term].second.push_back(pos);
+        // Count term frequencies and positions (indices among all raw tokens)
+        std::unordered_map<std::string_view, std::pair<uint32_t, std::vector<size_t>>> term_data;
+        for (const auto& token : tokens) {
+            auto& data = term_data[token.text];
+            data.first++;
+            data.second.push_back(token.position);
         }
         
         // Calculate scores
@@ -474,7 +1661,7 @@ struct KeywordExtractor::Impl {
         
         for (const auto& [term, data] : term_data) {
             Keyword kw;
-            kw.term = term;
+            kw.term = std::string(term);
             kw.frequency = data.first;
             kw.positions = data.second;
             
@@ -482,9 +1669,9 @@ struct KeywordExtractor::Impl {
             float tf = static_cast<float>(data.first);
             float idf = 1.0f;
             
-            if (config.use_tfidf && trained && document_frequency.count(term)) {
-                uint32_t df = document_frequency.at(term);
-                idf = std::log(static_cast<float>(total_documents + 1) / (df + 1)) + 1.0f;
+            uint32_t df = table.frequency_of(term);
+            if (config.use_tfidf && trained && df > 0) {
+                idf = std::log(static_cast<float>(table.documents + 1) / (df + 1)) + 1.0f;
             }
             
             kw.score = tf * idf;
@@ -511,33 +1698,202 @@ struct KeywordExtractor::Impl {
         return keywords;
     }
     
-    Result<void> train(const std::vector<std::string>& documents) {
-        document_frequency.clear();
-        term_frequency.clear();
-        total_documents = documents.size();
+    [[nodiscard]] size_t worker_count() const {
+        if (config.train_threads > 0) {
+            return config.train_threads;
+        }
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    /// Count an in-memory corpus: contiguous ranges, one table per worker
+    void accumulate(const std::vector<std::string>& documents, FrequencyTable& into) const {
+        size_t workers = std::min(worker_count(), documents.size() / std::max<size_t>(1, config.train_batch_docs));
+        if (workers <= 1) {
+            TokenBuffer& tokens = scratch_tokens();
+            for (const auto& document : documents) {
+                tokenizer.tokenize(document, tokens);
+                into.count(tokens);
+            }
+            return;
+        }
         
-        for (const auto& doc : documents) {
-            auto tokens = tokenize(doc);
-            std::unordered_set<std::string> seen_in_doc;
-            
-            for (const auto& token : tokens) {
-                std::string term = to_lower(token);
-                if (term.length() < 2 || is_stop_word(term)) {
-                    continue;
+        std::vector<FrequencyTable> locals(workers);
+        ThreadPool pool(workers);
+        size_t per_worker = (documents.size() + workers - 1) / workers;
+        std::vector<std::future<void>> pending;
+        for (size_t w = 0; w < workers; ++w) {
+            size_t begin = std::min(documents.size(), w * per_worker);
+            size_t end = std::min(documents.size(), begin + per_worker);
+            pending.push_back(pool.submit([&, w, begin, end] {
+                TokenBuffer& tokens = scratch_tokens();
+                for (size_t d = begin; d < end; ++d) {
+                    tokenizer.tokenize(documents[d], tokens);
+                    locals[w].count(tokens);
                 }
-                
-                term_frequency[term]++;
-                
-                if (!seen_in_doc.count(term)) {
-                    document_frequency[term]++;
-                    seen_in_doc.insert(term);
+            }));
+        }
+        for (auto& task : pending) {
+            task.get();
+        }
+        for (const auto& local : locals) {
+            into.merge(local);
+        }
+    }
+    
+    /// Count a streamed corpus. The calling thread pulls batches from the
+    /// source while workers tokenize them into tables of their own, so the
+    /// only shared state is the bounded batch queue.
+    Result<void> accumulate(const DocumentSource& source, FrequencyTable& into) const {
+        size_t workers = worker_count();
+        if (workers == 1) {
+            TokenBuffer& tokens = scratch_tokens();
+            while (true) {
+                auto next = source();
+                if (!next) {
+                    return std::unexpected(next.error());
+                }
+                if (!*next) {
+                    return {};
+                }
+                tokenizer.tokenize(**next, tokens);
+                into.count(tokens);
+            }
+        }
+        
+        size_t batch_docs = std::max<size_t>(1, config.train_batch_docs);
+        BatchQueue queue(2 * workers);
+        std::vector<FrequencyTable> locals(workers);
+        ThreadPool pool(workers);
+        std::vector<std::future<void>> pending;
+        for (size_t w = 0; w < workers; ++w) {
+            pending.push_back(pool.submit([&, w] {
+                TokenBuffer& tokens = scratch_tokens();
+                while (auto batch = queue.pop()) {
+                    for (const auto& document : *batch) {
+                        tokenizer.tokenize(document, tokens);
+                        locals[w].count(tokens);
+                    }
                 }
+            }));
+        }
+        // Release the workers even if the source throws
+        struct CloseOnExit {
+            BatchQueue& queue;
+            ~CloseOnExit() { queue.close(); }
+        } close_on_exit{queue};
+        
+        Result<void> status;
+        std::vector<std::string> batch;
+        batch.reserve(batch_docs);
+        while (true) {
+            auto next = source();
+            if (!next) {
+                status = std::unexpected(next.error());
+                break;
+            }
+            if (!*next) {
+                break;
             }
+            batch.push_back(std::move(**next));
+            if (batch.size() == batch_docs) {
+                queue.push(std::move(batch));
+                batch = {};
+                batch.reserve(batch_docs);
+            }
+        }
+        if (status && !batch.empty()) {
+            queue.push(std::move(batch));
+        }
+        queue.close();
+        for (auto& task : pending) {
+            task.get();
+        }
+        if (!status) {
+            return status;
         }
         
+        for (const auto& local : locals) {
+            into.merge(local);
+        }
+        return {};
+    }
+    
+    Result<void> train(const std::vector<std::string>& documents) {
+        FrequencyTable fresh;
+        accumulate(documents, fresh);
+        install(std::move(fresh));
+        return {};
+    }
+    
+    Result<void> train(const DocumentSource& source) {
+        FrequencyTable fresh;
+        if (auto result = accumulate(source, fresh); !result) {
+            return result;
+        }
+        install(std::move(fresh));
+        return {};
+    }
+    
+    Result<void> update(const std::vector<std::string>& documents) {
+        FrequencyTable delta;
+        accumulate(documents, delta);
+        table.merge(delta);
+        trained = true;
+        return {};
+    }
+    
+    Result<void> update(const DocumentSource& source) {
+        FrequencyTable delta;
+        if (auto result = accumulate(source, delta); !result) {
+            return result;
+        }
+        table.merge(delta);
         trained = true;
         return {};
     }
+    
+    void install(FrequencyTable&& fresh) {
+        table = std::move(fresh);
+        table.last_seen = {};
+        trained = true;
+    }
+    
+    [[nodiscard]] std::vector<uint8_t> encode() const {
+        std::vector<uint32_t> order;
+        order.reserve(table.dictionary.size());
+        for (uint32_t id = 0; id < table.document_frequency.size(); ++id) {
+            if (table.document_frequency[id] > 0) {
+                order.push_back(id);
+            }
+        }
+        std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return table.dictionary.term(a) < table.dictionary.term(b);
+        });
+        
+        std::vector<uint8_t> out;
+        put_raw(out, KEYWORD_MAGIC);
+        put_raw(out, KEYWORD_VERSION);
+        put_raw(out, static_cast<uint64_t>(config.max_keywords));
+        put_raw(out, config.min_score);
+        put_raw(out, static_cast<uint8_t>(config.use_tfidf));
+        put_raw(out, static_cast<uint8_t>(config.use_position_weight));
+        put_raw(out, table.documents);
+        put_raw(out, static_cast<uint8_t>(trained));
+        put_raw(out, static_cast<uint64_t>(order.size()));
+        
+        std::string_view previous;
+        for (uint32_t id : order) {
+            std::string_view term = table.dictionary.term(id);
+            auto mismatch = std::mismatch(previous.begin(), previous.end(), term.begin(), term.end());
+            auto shared = static_cast<uint32_t>(mismatch.first - previous.begin());
+            put_varint(out, shared);
+            put_varint(out, static_cast<uint32_t>(term.size() - shared));
+            out.insert(out.end(), term.begin() + shared, term.end());
+            put_varint(out, table.document_frequency[id]);
+            previous = term;
+        }
+        return out;
+    }
 };
 
 KeywordExtractor::KeywordExtractor(const KeywordConfig& config)
@@ -553,31 +1909,41 @@ Result<void> KeywordExtractor::train(const std::vector<std::string>& documents)
     return impl_->train(documents);
 }
 
+Result<void> KeywordExtractor::train(const DocumentSource& source) {
+    return impl_->train(source);
+}
+
+Result<void> KeywordExtractor::update(const std::vector<std::string>& documents) {
+    return impl_->update(documents);
+}
+
+Result<void> KeywordExtractor::update(const DocumentSource& source) {
+    return impl_->update(source);
+}
+
+size_t KeywordExtractor::document_count() const {
+    return impl_->table.documents;
+}
+
+uint32_t KeywordExtractor::document_frequency(std::string_view term) const {
+    return impl_->table.frequency_of(term);
+}
+
 Result<void> KeywordExtractor::save(const std::string& path) const {
-    std::ofstream file(path, std::ios::binary);
-    if (!file) {
-        return std::unexpected(Error(ErrorCode::IoError, "Failed to open file for writing: " + path));
-    }
-    
-    file << "KEYWORD_EXTRACTOR_V1\n";
-    file << "max_keywords=" << impl_->config.max_keywords << "\n";
-    file << "min_score=" << impl_->config.min_score << "\n";
-    file << "use_tfidf=" << (impl_->config.use_tfidf ? "1" : "0") << "\n";
-    file << "use_position_weight=" << (impl_->config.use_position_weight ? "1" : "0") << "\n";
-    file << "total_documents=" << impl_->total_documents << "\n";
-    file << "trained=" << (impl_->trained ? "1" : "0") << "\n";
-    
-    file << "DOCUMENT_FREQUENCY_START\n";
-    for (const auto& [term, freq] : impl_->document_frequency) {
-        file << term << "\t" << freq << "\n";
-    }
-    file << "DOCUMENT_FREQUENCY_END\n";
-    
-    file.close();
-    return {};
+    return write_checkpoint(fs::path(path), impl_->encode());
 }
 
-Result<KeywordExtractor> KeywordExtractor::load(const std::string& path) {
+namespace {
+
+/// Decoded contents of a saved KeywordExtractor
+struct KeywordState {
+    KeywordConfig config;
+    FrequencyTable table;
+    bool trained = false;
+};
+
+/// Parse a KEYWORD_EXTRACTOR_V1 text file (written before binary tables)
+Result<KeywordState> load_legacy_keywords(const std::string& path) {
     std::ifstream file(path);
     if (!file) {
         return std::unexpected(Error(ErrorCode::IoError, "Failed to open file for reading: " + path));
@@ -585,11 +1951,8 @@ Result<KeywordExtractor> KeywordExtractor::load(const std::string& path) {
     
     std::string line;
     std::getline(file, line);
-    if (line != "KEYWORD_EXTRACTOR_V1") {
-        return std::unexpected(Error(ErrorCode::InvalidData, "Invalid keyword extractor file format"));
-    }
     
-    KeywordConfig config;
+    KeywordState state;
     std::unordered_map<std::string, std::string> values;
     
     while (std::getline(file, line)) {
@@ -600,19 +1963,13 @@ Result<KeywordExtractor> KeywordExtractor::load(const std::string& path) {
         }
     }
     
+    KeywordConfig& config = state.config;
     if (values.count("max_keywords")) config.max_keywords = std::stoul(values["max_keywords"]);
     if (values.count("min_score")) config.min_score = std::stof(values["min_score"]);
     if (values.count("use_tfidf")) config.use_tfidf = (values["use_tfidf"] == "1");
     if (values.count("use_position_weight")) config.use_position_weight = (values["use_position_weight"] == "1");
-    
-    KeywordExtractor extractor(config);
-    
-    if (values.count("total_documents")) {
-        extractor.impl_->total_documents = std::stoul(values["total_documents"]);
-    }
-    if (values.count("trained")) {
-        extractor.impl_->trained = (values["trained"] == "1");
-    }
+    if (values.count("total_documents")) state.table.documents = std::stoul(values["total_documents"]);
+    if (values.count("trained")) state.trained = (values["trained"] == "1");
     
     // Load document frequencies
     while (std::getline(file, line)) {
@@ -621,11 +1978,95 @@ Result<KeywordExtractor> KeywordExtractor::load(const std::string& path) {
         std::string term;
         uint32_t freq;
         if (iss >> term >> freq) {
-            extractor.impl_->document_frequency[term] = freq;
+            uint32_t id = state.table.dictionary.intern(term);
+            state.table.grow(id);
+            state.table.document_frequency[id] = freq;
+        }
+    }
+    
+    return state;
+}
+
+/// Decode a binary table payload (footer already verified)
+Result<KeywordState> decode_keywords(std::span<const uint8_t> payload) {
+    auto corrupted = [] {
+        return std::unexpected(Error(ErrorCode::IndexCorrupted, "Invalid keyword extractor table"));
+    };
+    
+    ByteReader reader{payload};
+    uint64_t magic = 0;
+    uint32_t version = 0;
+    uint64_t max_keywords = 0;
+    uint8_t use_tfidf = 0;
+    uint8_t use_position_weight = 0;
+    uint8_t trained = 0;
+    uint64_t num_terms = 0;
+    KeywordState state;
+    if (!reader.read(magic) || magic != KEYWORD_MAGIC) {
+        return std::unexpected(Error(ErrorCode::InvalidData, "Invalid keyword extractor file format"));
+    }
+    if (!reader.read(version) || version != KEYWORD_VERSION ||
+        !reader.read(max_keywords) || !reader.read(state.config.min_score) ||
+        !reader.read(use_tfidf) || !reader.read(use_position_weight) ||
+        !reader.read(state.table.documents) || !reader.read(trained) ||
+        !reader.read(num_terms) || num_terms > payload.size()) {
+        return corrupted();
+    }
+    state.config.max_keywords = max_keywords;
+    state.config.use_tfidf = use_tfidf != 0;
+    state.config.use_position_weight = use_position_weight != 0;
+    state.trained = trained != 0;
+    
+    const uint8_t* in = payload.data() + reader.offset();
+    const uint8_t* end = payload.data() + payload.size();
+    std::string term;
+    state.table.document_frequency.reserve(num_terms);
+    for (uint64_t i = 0; i < num_terms; ++i) {
+        uint32_t shared = 0;
+        uint32_t suffix = 0;
+        uint32_t df = 0;
+        if (!get_varint(in, end, shared) || shared > term.size() ||
+            !get_varint(in, end, suffix) || static_cast<size_t>(end - in) < suffix) {
+            return corrupted();
         }
+        term.resize(shared);
+        term.append(reinterpret_cast<const char*>(in), suffix);
+        in += suffix;
+        if (!get_varint(in, end, df)) {
+            return corrupted();
+        }
+        uint32_t id = state.table.dictionary.intern(term);
+        state.table.grow(id);
+        state.table.document_frequency[id] = df;
+    }
+    if (in != end) {
+        return corrupted();
+    }
+    return state;
+}
+
+} // anonymous namespace
+
+Result<KeywordExtractor> KeywordExtractor::load(const std::string& path) {
+    auto bytes = read_checkpoint(fs::path(path));
+    if (!bytes) {
+        return std::unexpected(bytes.error());
+    }
+    
+    Result<KeywordState> state;
+    if (bytes->size() >= KEYWORD_LEGACY_HEADER.size() &&
+        std::memcmp(bytes->data(), KEYWORD_LEGACY_HEADER.data(), KEYWORD_LEGACY_HEADER.size()) == 0) {
+        state = load_legacy_keywords(path);
+    } else {
+        state = decode_keywords(*bytes);
+    }
+    if (!state) {
+        return std::unexpected(state.error());
     }
     
-    file.close();
+    KeywordExtractor extractor(state->config);
+    extractor.impl_->table = std::move(state->table);
+    extractor.impl_->trained = state->trained;
     return extractor;
 }
 
@@ -633,61 +2074,189 @@ Result<KeywordExtractor> KeywordExtractor::load(const std::string& path) {
 // QueryRewriter Implementation
 // ============================================================================
 
+namespace {
+
+/// Aho-Corasick automaton over term ids. Patterns are synonym source
+/// phrases; feeding a query's ids one at a time reports every phrase that
+/// ends at the current token, so a scan is linear in the query length.
+class SynonymAutomaton {
+public:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    /// Node reached by phrase, created as needed; links need compile()
+    uint32_t insert(std::span<const uint32_t> phrase) {
+        uint32_t node = 0;
+        for (uint32_t term : phrase) {
+            uint32_t next = child(node, term);
+            if (next == NONE) {
+                next = static_cast<uint32_t>(nodes_.size());
+                nodes_.emplace_back();
+                edges_.emplace(edge_key(node, term), next);
+                nodes_[node].children.emplace_back(term, next);
+            }
+            node = next;
+        }
+        return node;
+    }
+
+    [[nodiscard]] uint32_t pattern(uint32_t node) const { return nodes_[node].pattern; }
+    void set_pattern(uint32_t node, uint32_t pattern) { nodes_[node].pattern = pattern; }
+
+    /// Breadth-first failure links (longest proper suffix that is also a
+    /// trie path) and output links (nearest suffix that ends a pattern)
+    void compile() {
+        std::deque<uint32_t> queue;
+        for (auto [term, node] : nodes_[0].children) {
+            nodes_[node].fail = 0;
+            nodes_[node].output = NONE;
+            queue.push_back(node);
+        }
+        while (!queue.empty()) {
+            uint32_t node = queue.front();
+            queue.pop_front();
+            for (auto [term, next] : nodes_[node].children) {
+                uint32_t fail = nodes_[node].fail;
+                while (fail != 0 && child(fail, term) == NONE) {
+                    fail = nodes_[fail].fail;
+                }
+                uint32_t target = child(fail, term);
+                fail = (target != NONE && target != next) ? target : 0;
+                nodes_[next].fail = fail;
+                nodes_[next].output = nodes_[fail].pattern != NONE ? fail : nodes_[fail].output;
+                queue.push_back(next);
+            }
+        }
+    }
+
+    /// State after consuming term
+    [[nodiscard]] uint32_t step(uint32_t state, uint32_t term) const {
+        while (true) {
+            uint32_t next = child(state, term);
+            if (next != NONE) return next;
+            if (state == 0) return 0;
+            state = nodes_[state].fail;
+        }
+    }
+
+    /// Call on_match(pattern) for each phrase ending in state, longest first
+    template<typename OnMatch>
+    void matches(uint32_t state, OnMatch&& on_match) const {
+        uint32_t node = nodes_[state].pattern != NONE ? state : nodes_[state].output;
+        for (; node != NONE; node = nodes_[node].output) {
+            on_match(nodes_[node].pattern);
+        }
+    }
+
+private:
+    struct Node {
+        std::vector<std::pair<uint32_t, uint32_t>> children;   // (term, node)
+        uint32_t fail = 0;
+        uint32_t output = NONE;
+        uint32_t pattern = NONE;
+    };
+
+    static uint64_t edge_key(uint32_t node, uint32_t term) {
+        return (static_cast<uint64_t>(node) << 32) | term;
+    }
+
+    [[nodiscard]] uint32_t child(uint32_t node, uint32_t term) const {
+        auto it = edges_.find(edge_key(node, term));
+        return it != edges_.end() ? it->second : NONE;
+    }
+
+    std::vector<Node> nodes_{1};
+    std::unordered_map<uint64_t, uint32_t> edges_;
+};
+
+} // anonymous namespace
+
 struct QueryRewriter::Impl {
     RewriteConfig config;
-    std::unordered_map<std::string, std::vector<std::string>> synonyms;
+    // Every raw token is kept; only lowercasing is applied
+    Tokenizer tokenizer{TokenizerOptions{.lowercase = true, .remove_stop_words = false,
+                                          .stem = false, .min_length = 0}};
+    TermDictionary dictionary;
+    SynonymAutomaton automaton;
+    std::vector<std::vector<std::vector<uint32_t>>> expansions;    // By pattern: synonym phrases as term ids
     
     Impl(const RewriteConfig& cfg) : config(cfg) {}
     
-    Result<std::string> rewrite(const std::string& query) const {
-        auto tokens = tokenize(query);
-        if (tokens.empty()) {
-            return query;
-        }
-        
-        std::vector<std::string> result_tokens;
-        result_tokens.reserve(tokens.size() * 2);
-        
+    /// Walk the query once, calling on_token for each token and
+    /// on_synonym(term id) for the terms of each synonym of every source
+    /// phrase that ends at that token
+    template<typename OnToken, typename OnSynonym>
+    void scan(const TokenBuffer& tokens, OnToken&& on_token, OnSynonym&& on_synonym) const {
+        uint32_t state = 0;
         for (const auto& token : tokens) {
-            std::string lower_token = to_lower(token);
-            result_tokens.push_back(token);
-            
-            // Add stemmed version
-            if (config.add_stemmed_terms) {
-                std::string stemmed = stem(lower_token);
-                if (stemmed != lower_token && stemmed.length() >= 2) {
-                    result_tokens.push_back(stemmed);
-                }
-            }
+            on_token(token);
+            if (!config.expand_synonyms) continue;
             
-            // Expand synonyms
-            if (config.expand_synonyms) {
-                auto it = synonyms.find(lower_token);
-                if (it != synonyms.end()) {
-                    size_t count = 0;
-                    for (const auto& syn : it->second) {
-                        if (count >= config.max_expansions) break;
-                        result_tokens.push_back(syn);
-                        count++;
+            auto id = dictionary.find(token.text);
+            state = id ? automaton.step(state, *id) : 0;
+            automaton.matches(state, [&](uint32_t pattern) {
+                const auto& synonyms = expansions[pattern];
+                size_t count = std::min(synonyms.size(), config.max_expansions);
+                for (size_t i = 0; i < count; ++i) {
+                    for (uint32_t term : synonyms[i]) {
+                        on_synonym(term);
                     }
                 }
-            }
+            });
         }
-        
-        // Join tokens back into a string
-        std::string result;
-        for (size_t i = 0; i < result_tokens.size(); ++i) {
-            if (i > 0) result += " ";
-            result += result_tokens[i];
+    }
+    
+    Result<std::string> rewrite(const std::string& query) const {
+        TokenBuffer& tokens = scratch_tokens();
+        tokenizer.tokenize(query, tokens);
+        if (tokens.empty()) {
+            return query;
         }
         
+        std::string result;
+        result.reserve(query.size() * 2);
+        auto append = [&](std::string_view word) {
+            if (!result.empty()) result += ' ';
+            result += word;
+        };
+        scan(tokens,
+            [&](const Token& token) {
+                append(token.raw);
+                // Add stemmed version
+                if (config.add_stemmed_terms) {
+                    std::string_view stemmed = Tokenizer::stem(token.text);
+                    if (stemmed != token.text && stemmed.length() >= 2) {
+                        append(stemmed);
+                    }
+                }
+            },
+            [&](uint32_t term) { append(dictionary.term(term)); });
         return result;
     }
     
+    Result<std::vector<WeightedTerm>> expand(const std::string& query) const {
+        TokenBuffer& tokens = scratch_tokens();
+        tokenizer.tokenize(query, tokens);
+        
+        std::vector<WeightedTerm> terms;
+        auto add = [&](std::string_view term, float weight) {
+            for (auto& existing : terms) {
+                if (existing.term == term) {
+                    existing.weight += weight;
+                    return;
+                }
+            }
+            terms.push_back(WeightedTerm{std::string(term), weight});
+        };
+        scan(tokens,
+            [&](const Token& token) { add(token.text, 1.0f); },
+            [&](uint32_t term) { add(dictionary.term(term), config.synonym_weight); });
+        return terms;
+    }
+    
     Result<void> add_synonym(const std::string& term, const std::vector<std::string>& syns) {
-        std::string lower_term = to_lower(term);
-        synonyms[lower_term] = syns;
-        return {};
+        auto added = insert(term, syns);
+        automaton.compile();
+        return added;
     }
     
     Result<void> load_synonyms(const std::string& path) {
@@ -700,22 +2269,67 @@ struct QueryRewriter::Impl {
         while (std::getline(file, line)) {
             if (line.empty() || line[0] == '#') continue;
             
-            std::istringstream iss(line);
             std::string term;
-            if (!(iss >> term)) continue;
-            
             std::vector<std::string> syns;
-            std::string syn;
-            while (iss >> syn) {
-                syns.push_back(to_lower(syn));
+            if (size_t arrow = line.find("=>"); arrow != std::string::npos) {
+                term = line.substr(0, arrow);
+                std::istringstream targets(line.substr(arrow + 2));
+                std::string syn;
+                while (std::getline(targets, syn, ',')) {
+                    syns.push_back(std::move(syn));
+                }
+            } else {
+                std::istringstream iss(line);
+                if (!(iss >> term)) continue;
+                std::string syn;
+                while (iss >> syn) {
+                    syns.push_back(std::move(syn));
+                }
             }
             
             if (!syns.empty()) {
-                synonyms[to_lower(term)] = syns;
+                (void)insert(term, syns);   // A source with no terms is skipped
+            }
+        }
+        
+        automaton.compile();
+        return {};
+    }
+    
+private:
+    /// Tokens of text as term ids, interning new ones
+    std::vector<uint32_t> intern_phrase(std::string_view text) {
+        TokenBuffer& tokens = scratch_tokens();
+        tokenizer.tokenize(text, tokens);
+        std::vector<uint32_t> ids;
+        ids.reserve(tokens.size());
+        for (const auto& token : tokens) {
+            ids.push_back(dictionary.intern(token.text));
+        }
+        return ids;
+    }
+    
+    /// Add a source phrase to the trie; the caller compiles
+    Result<void> insert(std::string_view term, const std::vector<std::string>& syns) {
+        auto phrase = intern_phrase(term);
+        std::vector<std::vector<uint32_t>> targets;
+        for (const auto& syn : syns) {
+            if (auto ids = intern_phrase(syn); !ids.empty()) {
+                targets.push_back(std::move(ids));
             }
         }
+        if (phrase.empty()) {
+            return std::unexpected(Error(ErrorCode::InvalidInput, "Synonym source has no terms"));
+        }
         
-        file.close();
+        uint32_t node = automaton.insert(phrase);
+        uint32_t pattern = automaton.pattern(node);
+        if (pattern == SynonymAutomaton::NONE) {
+            pattern = static_cast<uint32_t>(expansions.size());
+            expansions.emplace_back();
+            automaton.set_pattern(node, pattern);
+        }
+        expansions[pattern] = std::move(targets);
         return {};
     }
 };
@@ -729,6 +2343,10 @@ Result<std::string> QueryRewriter::rewrite(const std::string& query) const {
     return impl_->rewrite(query);
 }
 
+Result<std::vector<WeightedTerm>> QueryRewriter::expand(const std::string& query) const {
+    return impl_->expand(query);
+}
+
 Result<void> QueryRewriter::add_synonym(const std::string& term, const std::vector<std::string>& synonyms) {
     return impl_->add_synonym(term, synonyms);
 }
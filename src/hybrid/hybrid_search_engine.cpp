@@ -4,10 +4,11 @@
 
 #include "vdb/hybrid_search.hpp"
 #include "vdb/logging.hpp"
+#include "vdb/thread_pool.hpp"
 #include <algorithm>
+#include <array>
 #include <cmath>
-#include <unordered_map>
-#include <unordered_set>
+#include <span>
 
 namespace vdb {
 namespace hybrid {
@@ -16,214 +17,293 @@ namespace hybrid {
 // HybridSearchEngine Implementation
 // ============================================================================
 
+namespace {
+
+enum Retriever : size_t { VECTOR = 0, LEXICAL = 1, SPARSE = 2, NUM_RETRIEVERS = 3 };
+
+/// One document in the union of the result lists. Ranks are 1-based
+/// positions in each list; 0 means the list did not return the document.
+struct FusionCandidate {
+    VectorId id;
+    std::array<uint32_t, NUM_RETRIEVERS> ranks{};
+    std::array<float, NUM_RETRIEVERS> scores{};
+    float combined_score = 0.0f;
+};
+
+/// Per-list statistics the score-based fusion methods normalize by
+struct FusionLists {
+    std::array<size_t, NUM_RETRIEVERS> sizes{};
+    std::array<float, NUM_RETRIEVERS> max_scores{};   // 1 when a list has no positive score
+};
+
+/// Merge the lists by id into rank arrays. Sorting (id, list, rank) hits
+/// keeps this allocation-light and never copies metadata or matched terms.
+std::vector<FusionCandidate> collect_candidates(std::span<const QueryResult> vector_results,
+                                                std::span<const BM25Result> lexical_results,
+                                                std::span<const SparseResult> sparse_results,
+                                                FusionLists& lists) {
+    struct Hit {
+        VectorId id;
+        Retriever list;
+        uint32_t rank;
+        float score;
+    };
+    std::vector<Hit> hits;
+    hits.reserve(vector_results.size() + lexical_results.size() + sparse_results.size());
+    auto add = [&](const auto& results, Retriever list) {
+        float max_score = 0.0f;
+        for (size_t i = 0; i < results.size(); ++i) {
+            hits.push_back(Hit{results[i].id, list, static_cast<uint32_t>(i + 1), results[i].score});
+            max_score = std::max(max_score, results[i].score);
+        }
+        lists.sizes[list] = results.size();
+        lists.max_scores[list] = max_score == 0.0f ? 1.0f : max_score;
+    };
+    add(vector_results, VECTOR);
+    add(lexical_results, LEXICAL);
+    add(sparse_results, SPARSE);
+
+    std::sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) {
+        if (a.id != b.id) return a.id < b.id;
+        return a.list != b.list ? a.list < b.list : a.rank < b.rank;
+    });
+
+    std::vector<FusionCandidate> candidates;
+    candidates.reserve(hits.size());
+    for (const auto& hit : hits) {
+        if (candidates.empty() || candidates.back().id != hit.id) {
+            candidates.push_back(FusionCandidate{hit.id});
+        }
+        // A list that repeats an id keeps its best rank
+        auto& candidate = candidates.back();
+        if (candidate.ranks[hit.list] == 0) {
+            candidate.ranks[hit.list] = hit.rank;
+            candidate.scores[hit.list] = hit.score;
+        }
+    }
+    return candidates;
+}
+
+} // anonymous namespace
+
 struct HybridSearchEngine::Impl {
     HybridSearchConfig config;
     
     Impl(const HybridSearchConfig& cfg) : config(cfg) {}
     
     Result<std::vector<HybridResult>> combine(
-        const std::vector<QueryResult>& vector_results,
-        const std::vector<BM25Result>& lexical_results,
+        std::span<const QueryResult> vector_results,
+        std::span<const BM25Result> lexical_results,
+        std::span<const SparseResult> sparse_results,
         size_t k
     ) const {
-        if (vector_results.empty() && lexical_results.empty()) {
-            return std::vector<HybridResult>();
+        auto top = fuse(vector_results, lexical_results, sparse_results, k);
+        
+        std::vector<HybridResult> results;
+        results.reserve(top.size());
+        for (const auto& candidate : top) {
+            HybridResult hr = make_result(candidate);
+            if (candidate.ranks[VECTOR] > 0) {
+                hr.metadata = vector_results[candidate.ranks[VECTOR] - 1].metadata;
+            }
+            if (candidate.ranks[LEXICAL] > 0) {
+                hr.matched_keywords = lexical_results[candidate.ranks[LEXICAL] - 1].matched_terms;
+            }
+            results.push_back(std::move(hr));
         }
+        return results;
+    }
+    
+    /// Vector retrieval runs on the calling thread (it usually includes
+    /// query encoding, the slower half) while BM25 and sparse retrieval run
+    /// on the shared pool, or inline once the vector half is done if no
+    /// worker has picked them up
+    template<typename VectorSearch>
+    Result<std::vector<HybridResult>> search(
+        VectorDatabase& db,
+        const BM25Engine& bm25,
+        std::string_view query,
+        const HybridQueryOptions& options,
+        VectorSearch&& vector_search
+    ) const {
+        size_t depth = std::max(options.candidates, options.k);
+        QueryOptions vector_options = options.vector_options;
+        vector_options.k = depth;
+        vector_options.include_metadata = false;
+        std::string text(query);
         
-        // Create result map indexed by document ID
-        std::unordered_map<VectorId, HybridResult> result_map;
+        std::optional<decltype(vector_search(vector_options))> vector_slot;
+        std::optional<decltype(bm25.search(text, depth, options.min_lexical_score))> lexical_slot;
+        Result<std::vector<SparseResult>> sparse_results = std::vector<SparseResult>();
+        global_thread_pool().cooperative_for(options.sparse_query ? 3 : 2, [&](size_t retriever) {
+            switch (retriever) {
+                case VECTOR:
+                    vector_slot.emplace(vector_search(vector_options));
+                    break;
+                case LEXICAL:
+                    lexical_slot.emplace(bm25.search(text, depth, options.min_lexical_score));
+                    break;
+                default:
+                    sparse_results = db.query_sparse(*options.sparse_query, depth);
+                    break;
+            }
+        });
+        auto vector_results = std::move(*vector_slot);
+        auto lexical_results = std::move(*lexical_slot);
         
-        // Process vector results
-        for (size_t i = 0; i < vector_results.size(); ++i) {
-            const auto& vr = vector_results[i];
-            auto& hr = result_map[vr.id];
-            hr.id = vr.id;
-            hr.vector_score = vr.score;
-            hr.lexical_score = 0.0f;
-            hr.metadata = vr.metadata;
+        if (!vector_results) {
+            return std::unexpected(vector_results.error());
+        }
+        if (!sparse_results) {
+            return std::unexpected(sparse_results.error());
         }
+        // A query made only of stop words still has a vector ranking
+        if (!lexical_results) {
+            if (lexical_results.error().code != ErrorCode::InvalidInput) {
+                return std::unexpected(lexical_results.error());
+            }
+            lexical_results = std::vector<BM25Result>();
+        }
+        
+        auto top = fuse(*vector_results, *lexical_results, *sparse_results, options.k);
         
-        // Process lexical results
-        for (size_t i = 0; i < lexical_results.size(); ++i) {
-            const auto& lr = lexical_results[i];
-            auto& hr = result_map[lr.id];
-            hr.id = lr.id;
-            hr.lexical_score = lr.score;
-            hr.matched_keywords = lr.matched_terms;
+        std::vector<HybridResult> results;
+        results.reserve(top.size());
+        for (const auto& candidate : top) {
+            HybridResult hr = make_result(candidate);
+            if (options.include_metadata) {
+                hr.metadata = db.get_metadata(candidate.id);
+            }
+            if (candidate.ranks[LEXICAL] > 0) {
+                hr.matched_keywords = std::move((*lexical_results)[candidate.ranks[LEXICAL] - 1].matched_terms);
+            }
+            results.push_back(std::move(hr));
         }
+        return results;
+    }
+    
+private:
+    static HybridResult make_result(const FusionCandidate& candidate) {
+        HybridResult hr;
+        hr.id = candidate.id;
+        hr.combined_score = candidate.combined_score;
+        hr.vector_score = candidate.scores[VECTOR];
+        hr.lexical_score = candidate.scores[LEXICAL];
+        hr.sparse_score = candidate.scores[SPARSE];
+        return hr;
+    }
+    
+    /// Score the union of the lists and keep the best k, highest first
+    /// (ties broken by id)
+    std::vector<FusionCandidate> fuse(
+        std::span<const QueryResult> vector_results,
+        std::span<const BM25Result> lexical_results,
+        std::span<const SparseResult> sparse_results,
+        size_t k
+    ) const {
+        FusionLists lists;
+        auto candidates = collect_candidates(vector_results, lexical_results, sparse_results, lists);
         
-        // Apply fusion method
         switch (config.fusion) {
             case FusionMethod::RRF:
-                apply_rrf_fusion(vector_results, lexical_results, result_map);
+                apply_rrf_fusion(candidates);
                 break;
             case FusionMethod::WeightedSum:
-                apply_weighted_sum_fusion(result_map);
+                apply_weighted_sum_fusion(lists, candidates);
                 break;
             case FusionMethod::CombSUM:
-                apply_combsum_fusion(vector_results, lexical_results, result_map);
+                apply_combsum_fusion(lists, candidates);
                 break;
             case FusionMethod::CombMNZ:
-                apply_combmnz_fusion(vector_results, lexical_results, result_map);
+                apply_combmnz_fusion(lists, candidates);
                 break;
             case FusionMethod::Borda:
-                apply_borda_fusion(vector_results, lexical_results, result_map);
+                apply_borda_fusion(lists, candidates);
                 break;
         }
         
-        // Convert to vector and sort
-        std::vector<HybridResult> results;
-        results.reserve(result_map.size());
-        for (auto& [id, hr] : result_map) {
-            results.push_back(std::move(hr));
-        }
-        
-        std::sort(results.begin(), results.end());
-        
-        // Return top k
-        if (results.size() > k) {
-            results.resize(k);
-        }
-        
-        return results;
+        auto better = [](const FusionCandidate& a, const FusionCandidate& b) {
+            return a.combined_score != b.combined_score ? a.combined_score > b.combined_score
+                                                        : a.id < b.id;
+        };
+        size_t keep = std::min(k, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(keep),
+                          candidates.end(), better);
+        candidates.resize(keep);
+        return candidates;
     }
     
-private:
-    void apply_rrf_fusion(
-        const std::vector<QueryResult>& vector_results,
-        const std::vector<BM25Result>& lexical_results,
-        std::unordered_map<VectorId, HybridResult>& result_map
-    ) const {
-        // Create rank maps
-        std::unordered_map<VectorId, size_t> vector_ranks;
-        std::unordered_map<VectorId, size_t> lexical_ranks;
-        
-        for (size_t i = 0; i < vector_results.size(); ++i) {
-            vector_ranks[vector_results[i].id] = i + 1;
-        }
-        
-        for (size_t i = 0; i < lexical_results.size(); ++i) {
-            lexical_ranks[lexical_results[i].id] = i + 1;
-        }
-        
-        // Calculate RRF scores
-        for (auto& [id, hr] : result_map) {
+    void apply_rrf_fusion(std::vector<FusionCandidate>& candidates) const {
+        for (auto& candidate : candidates) {
             float rrf_score = 0.0f;
-            
-            if (vector_ranks.count(id)) {
-                rrf_score += 1.0f / (config.rrf_k + vector_ranks[id]);
-            }
-            
-            if (lexical_ranks.count(id)) {
-                rrf_score += 1.0f / (config.rrf_k + lexical_ranks[id]);
+            for (uint32_t rank : candidate.ranks) {
+                if (rank > 0) {
+                    rrf_score += 1.0f / (config.rrf_k + rank);
+                }
             }
-            
-            hr.combined_score = rrf_score;
+            candidate.combined_score = rrf_score;
         }
     }
     
     void apply_weighted_sum_fusion(
-        std::unordered_map<VectorId, HybridResult>& result_map
+        const FusionLists& lists,
+        std::vector<FusionCandidate>& candidates
     ) const {
-        // Normalize scores to [0, 1]
-        float max_vector_score = 0.0f;
-        float max_lexical_score = 0.0f;
-        
-        for (const auto& [id, hr] : result_map) {
-            max_vector_score = std::max(max_vector_score, hr.vector_score);
-            max_lexical_score = std::max(max_lexical_score, hr.lexical_score);
-        }
-        
-        // Avoid division by zero
-        if (max_vector_score == 0.0f) max_vector_score = 1.0f;
-        if (max_lexical_score == 0.0f) max_lexical_score = 1.0f;
-        
-        // Calculate weighted sum
-        for (auto& [id, hr] : result_map) {
-            float norm_vector = hr.vector_score / max_vector_score;
-            float norm_lexical = hr.lexical_score / max_lexical_score;
-            hr.combined_score = config.vector_weight * norm_vector + 
-                              config.lexical_weight * norm_lexical;
+        const std::array<float, NUM_RETRIEVERS> weights = {
+            config.vector_weight, config.lexical_weight, config.sparse_weight
+        };
+        for (auto& candidate : candidates) {
+            float score = 0.0f;
+            for (size_t list = 0; list < NUM_RETRIEVERS; ++list) {
+                score += weights[list] * (candidate.scores[list] / lists.max_scores[list]);
+            }
+            candidate.combined_score = score;
         }
     }
     
     void apply_combsum_fusion(
-        const std::vector<QueryResult>& vector_results,
-        const std::vector<BM25Result>& lexical_results,
-        std::unordered_map<VectorId, HybridResult>& result_map
+        const FusionLists& lists,
+        std::vector<FusionCandidate>& candidates
     ) const {
-        // Normalize scores
-        float max_vector_score = 0.0f;
-        float max_lexical_score = 0.0f;
-        
-        for (const auto& vr : vector_results) {
-            max_vector_score = std::max(max_vector_score, vr.score);
-        }
-        
-        for (const auto& lr : lexical_results) {
-            max_lexical_score = std::max(max_lexical_score, lr.score);
-        }
-        
-        if (max_vector_score == 0.0f) max_vector_score = 1.0f;
-        if (max_lexical_score == 0.0f) max_lexical_score = 1.0f;
-        
         // Sum normalized scores
-        for (auto& [id, hr] : result_map) {
-            hr.combined_score = (hr.vector_score / max_vector_score) + 
-                              (hr.lexical_score / max_lexical_score);
+        for (auto& candidate : candidates) {
+            float score = 0.0f;
+            for (size_t list = 0; list < NUM_RETRIEVERS; ++list) {
+                score += candidate.scores[list] / lists.max_scores[list];
+            }
+            candidate.combined_score = score;
         }
     }
     
     void apply_combmnz_fusion(
-        const std::vector<QueryResult>& vector_results,
-        const std::vector<BM25Result>& lexical_results,
-        std::unordered_map<VectorId, HybridResult>& result_map
+        const FusionLists& lists,
+        std::vector<FusionCandidate>& candidates
     ) const {
         // First apply CombSUM
-        apply_combsum_fusion(vector_results, lexical_results, result_map);
+        apply_combsum_fusion(lists, candidates);
         
         // Then multiply by number of systems that returned the document
-        for (auto& [id, hr] : result_map) {
+        for (auto& candidate : candidates) {
             size_t num_systems = 0;
-            if (hr.vector_score > 0.0f) num_systems++;
-            if (hr.lexical_score > 0.0f) num_systems++;
-            hr.combined_score *= num_systems;
+            for (float score : candidate.scores) {
+                if (score > 0.0f) num_systems++;
+            }
+            candidate.combined_score *= num_systems;
         }
     }
     
     void apply_borda_fusion(
-        const std::vector<QueryResult>& vector_results,
-        const std::vector<BM25Result>& lexical_results,
-        std::unordered_map<VectorId, HybridResult>& result_map
+        const FusionLists& lists,
+        std::vector<FusionCandidate>& candidates
     ) const {
-        size_t n_vector = vector_results.size();
-        size_t n_lexical = lexical_results.size();
-        
-        // Create rank maps
-        std::unordered_map<VectorId, size_t> vector_ranks;
-        std::unordered_map<VectorId, size_t> lexical_ranks;
-        
-        for (size_t i = 0; i < vector_results.size(); ++i) {
-            vector_ranks[vector_results[i].id] = i;
-        }
-        
-        for (size_t i = 0; i < lexical_results.size(); ++i) {
-            lexical_ranks[lexical_results[i].id] = i;
-        }
-        
-        // Calculate Borda count
-        for (auto& [id, hr] : result_map) {
+        for (auto& candidate : candidates) {
             float borda_score = 0.0f;
-            
-            if (vector_ranks.count(id)) {
-                borda_score += (n_vector - vector_ranks[id]);
-            }
-            
-            if (lexical_ranks.count(id)) {
-                borda_score += (n_lexical - lexical_ranks[id]);
+            for (size_t list = 0; list < NUM_RETRIEVERS; ++list) {
+                if (candidate.ranks[list] > 0) {
+                    borda_score += (lists.sizes[list] - (candidate.ranks[list] - 1));
+                }
             }
-            
-            hr.combined_score = borda_score;
+            candidate.combined_score = borda_score;
         }
     }
 };
@@ -243,7 +323,39 @@ Result<std::vector<HybridResult>> HybridSearchEngine::combine(
     const std::vector<BM25Result>& lexical_results,
     size_t k
 ) const {
-    return impl_->combine(vector_results, lexical_results, k);
+    return impl_->combine(vector_results, lexical_results, {}, k);
+}
+
+Result<std::vector<HybridResult>> HybridSearchEngine::combine(
+    const std::vector<QueryResult>& vector_results,
+    const std::vector<BM25Result>& lexical_results,
+    const std::vector<SparseResult>& sparse_results,
+    size_t k
+) const {
+    return impl_->combine(vector_results, lexical_results, sparse_results, k);
+}
+
+Result<std::vector<HybridResult>> HybridSearchEngine::search(
+    VectorDatabase& db,
+    const BM25Engine& bm25,
+    std::string_view query,
+    const HybridQueryOptions& options
+) const {
+    return impl_->search(db, bm25, query, options, [&](const QueryOptions& vector_options) {
+        return db.query_text(query, vector_options);
+    });
+}
+
+Result<std::vector<HybridResult>> HybridSearchEngine::search(
+    VectorDatabase& db,
+    const BM25Engine& bm25,
+    std::string_view query,
+    VectorView embedding,
+    const HybridQueryOptions& options
+) const {
+    return impl_->search(db, bm25, query, options, [&](const QueryOptions& vector_options) {
+        return db.query_vector(embedding, vector_options);
+    });
 }
 
 // Static fusion method implementations
@@ -0,0 +1,467 @@
+// ============================================================================
+// VectorDB - Sparse Vector Index Implementation
+// ============================================================================
+
+#include "vdb/hybrid/sparse_index.hpp"
+#include "vdb/hybrid/postings.hpp"
+#include "vdb/checkpoint.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace vdb {
+namespace hybrid {
+
+namespace {
+
+// ============================================================================
+// Posting Lists
+// ============================================================================
+
+struct WeightBlock {
+    uint32_t last_doc = 0;
+    float max_weight = 0.0f;
+};
+
+/// Postings for one term, sorted by dense document number
+struct WeightPostingList {
+    std::vector<uint32_t> docs;
+    std::vector<float> weights;
+    std::vector<WeightBlock> blocks;        // One per POSTING_BLOCK_SIZE postings
+    float max_weight = 0.0f;
+
+    void append(uint32_t doc, float weight) {
+        if (docs.size() % POSTING_BLOCK_SIZE == 0) {
+            blocks.emplace_back();
+        }
+        docs.push_back(doc);
+        weights.push_back(weight);
+        blocks.back().last_doc = doc;
+        blocks.back().max_weight = std::max(blocks.back().max_weight, weight);
+        max_weight = std::max(max_weight, weight);
+    }
+};
+
+struct WeightScorer {
+    double query_weight;
+
+    [[nodiscard]] double score(const WeightPostingList& list, size_t pos) const {
+        return query_weight * list.weights[pos];
+    }
+
+    [[nodiscard]] double bound(const WeightBlock& block) const {
+        return query_weight * block.max_weight;
+    }
+};
+
+using WeightCursor = BlockCursor<WeightPostingList, WeightScorer>;
+
+/// Sorted (term, weight) pairs with duplicate terms summed and zeros dropped
+Result<std::vector<std::pair<uint32_t, float>>> normalize(const SparseVector& vector) {
+    if (vector.terms.size() != vector.weights.size()) {
+        return std::unexpected(Error(ErrorCode::InvalidInput,
+            "Sparse vector terms and weights differ in length"));
+    }
+    std::vector<std::pair<uint32_t, float>> entries;
+    entries.reserve(vector.terms.size());
+    for (size_t i = 0; i < vector.terms.size(); ++i) {
+        float weight = vector.weights[i];
+        if (!std::isfinite(weight) || weight < 0.0f) {
+            return std::unexpected(Error(ErrorCode::InvalidInput,
+                "Sparse vector weights must be finite and non-negative"));
+        }
+        entries.emplace_back(vector.terms[i], weight);
+    }
+    std::sort(entries.begin(), entries.end());
+
+    size_t out = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (out > 0 && entries[out - 1].first == entries[i].first) {
+            entries[out - 1].second += entries[i].second;
+        } else {
+            entries[out++] = entries[i];
+        }
+    }
+    entries.resize(out);
+    std::erase_if(entries, [](const auto& entry) { return entry.second == 0.0f; });
+    return entries;
+}
+
+// ============================================================================
+// Encoding
+// ============================================================================
+//
+//   header    magic, version, num_docs, doc_ids[num_docs] (u64), num_lists
+//   lists     sorted by term: term, df, then per block: last_doc,
+//             max_weight, gap width, bit-packed doc gaps, raw f32 weights
+
+constexpr uint64_t SPARSE_MAGIC = 0x3153525053424456ULL;  // "VDBSPRS1"
+constexpr uint32_t SPARSE_VERSION = 1;
+
+} // anonymous namespace
+
+// ============================================================================
+// SparseIndex Implementation
+// ============================================================================
+
+struct SparseIndex::Impl {
+    mutable std::shared_mutex mutex;
+    std::vector<VectorId> doc_ids;                      // By document number
+    std::vector<uint64_t> deleted;                      // One bit per document
+    std::unordered_map<VectorId, uint32_t> documents;   // Live ids only
+    std::unordered_map<uint32_t, uint32_t> list_ids;    // Term id -> index into postings
+    std::vector<uint32_t> list_terms;                   // By list: term id
+    std::vector<WeightPostingList> postings;
+    std::atomic<uint64_t> generation{0};
+
+    [[nodiscard]] bool is_deleted(uint32_t doc) const {
+        return (deleted[doc / 64] >> (doc % 64)) & 1;
+    }
+
+    [[nodiscard]] const WeightPostingList* find(uint32_t term) const {
+        auto it = list_ids.find(term);
+        return it != list_ids.end() ? &postings[it->second] : nullptr;
+    }
+
+    WeightPostingList& list_for(uint32_t term) {
+        auto [it, inserted] = list_ids.try_emplace(term, static_cast<uint32_t>(postings.size()));
+        if (inserted) {
+            list_terms.push_back(term);
+            postings.emplace_back();
+        }
+        return postings[it->second];
+    }
+
+    Result<void> add(VectorId id, const SparseVector& vector) {
+        auto entries = normalize(vector);
+        if (!entries) {
+            return std::unexpected(entries.error());
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (documents.count(id)) {
+            return std::unexpected(Error(ErrorCode::InvalidData, "Sparse vector already exists"));
+        }
+        if (doc_ids.size() >= NO_MORE_DOCS) {
+            return std::unexpected(Error(ErrorCode::IndexFull, "Sparse index is full"));
+        }
+
+        auto doc = static_cast<uint32_t>(doc_ids.size());
+        doc_ids.push_back(id);
+        if (deleted.size() * 64 <= doc) {
+            deleted.push_back(0);
+        }
+        documents.emplace(id, doc);
+        for (const auto& [term, weight] : *entries) {
+            list_for(term).append(doc, weight);
+        }
+        generation.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+
+    Result<void> remove(VectorId id) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = documents.find(id);
+        if (it == documents.end()) {
+            return std::unexpected(Error(ErrorCode::VectorNotFound,
+                "Sparse vector not found: " + std::to_string(id)));
+        }
+        uint32_t doc = it->second;
+        deleted[doc / 64] |= uint64_t{1} << (doc % 64);
+        documents.erase(it);
+        generation.fetch_add(1, std::memory_order_relaxed);
+
+        if (doc_ids.size() - documents.size() > std::max<size_t>(documents.size(), 64)) {
+            compact_locked();
+        }
+        return {};
+    }
+
+    /// Renumber live documents densely and rebuild postings without the
+    /// deleted ones; order is preserved, so lists stay sorted
+    void compact_locked() {
+        std::vector<uint32_t> renumber(doc_ids.size(), NO_MORE_DOCS);
+        std::vector<VectorId> live_ids;
+        live_ids.reserve(documents.size());
+        for (uint32_t doc = 0; doc < doc_ids.size(); ++doc) {
+            if (!is_deleted(doc)) {
+                renumber[doc] = static_cast<uint32_t>(live_ids.size());
+                live_ids.push_back(doc_ids[doc]);
+            }
+        }
+
+        for (auto& list : postings) {
+            WeightPostingList rebuilt;
+            for (size_t i = 0; i < list.docs.size(); ++i) {
+                uint32_t doc = renumber[list.docs[i]];
+                if (doc != NO_MORE_DOCS) {
+                    rebuilt.append(doc, list.weights[i]);
+                }
+            }
+            list = std::move(rebuilt);
+        }
+
+        doc_ids = std::move(live_ids);
+        deleted.assign((doc_ids.size() + 63) / 64, 0);
+        for (uint32_t doc = 0; doc < doc_ids.size(); ++doc) {
+            documents[doc_ids[doc]] = doc;
+        }
+    }
+
+    Result<std::vector<SparseResult>> search(const SparseVector& query, size_t k,
+                                             float min_score) const {
+        auto entries = normalize(query);
+        if (!entries) {
+            return std::unexpected(entries.error());
+        }
+        if (k == 0 || entries->empty()) {
+            return std::vector<SparseResult>();
+        }
+
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        std::vector<WeightCursor> cursors;
+        for (const auto& [term, weight] : *entries) {
+            const WeightPostingList* list = find(term);
+            if (list && !list->docs.empty()) {
+                cursors.push_back(WeightCursor{list, WeightScorer{weight},
+                                               weight * static_cast<double>(list->max_weight)});
+            }
+        }
+
+        TopK top{k, min_score, {}};
+        top.entries.reserve(k + 1);
+        max_score_top_k(cursors, 0, top, [&](uint32_t doc) { return is_deleted(doc); });
+
+        std::vector<SparseResult> results;
+        results.reserve(top.entries.size());
+        for (const auto& [score, key] : top.take_sorted()) {
+            results.push_back(SparseResult{doc_ids[static_cast<uint32_t>(key)],
+                                           static_cast<float>(score)});
+        }
+        return results;
+    }
+
+    std::vector<uint8_t> serialize() const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+
+        std::vector<uint32_t> renumber(doc_ids.size(), NO_MORE_DOCS);
+        std::vector<uint8_t> out;
+        put_raw(out, SPARSE_MAGIC);
+        put_raw(out, SPARSE_VERSION);
+        put_raw(out, static_cast<uint64_t>(documents.size()));
+        uint32_t next = 0;
+        for (uint32_t doc = 0; doc < doc_ids.size(); ++doc) {
+            if (!is_deleted(doc)) {
+                renumber[doc] = next++;
+                put_raw(out, static_cast<uint64_t>(doc_ids[doc]));
+            }
+        }
+
+        size_t count_offset = out.size();
+        put_raw(out, uint64_t{0});
+        uint64_t num_lists = 0;
+
+        std::vector<uint32_t> docs;
+        std::vector<float> weights;
+        std::vector<uint32_t> gaps;
+        std::vector<uint32_t> order(postings.size());
+        for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(),
+            [&](uint32_t a, uint32_t b) { return list_terms[a] < list_terms[b]; });
+
+        for (uint32_t index : order) {
+            const auto& list = postings[index];
+            docs.clear();
+            weights.clear();
+            for (size_t i = 0; i < list.docs.size(); ++i) {
+                if (renumber[list.docs[i]] != NO_MORE_DOCS) {
+                    docs.push_back(renumber[list.docs[i]]);
+                    weights.push_back(list.weights[i]);
+                }
+            }
+            if (docs.empty()) continue;
+
+            num_lists++;
+            put_raw(out, list_terms[index]);
+            put_raw(out, static_cast<uint32_t>(docs.size()));
+            uint32_t previous = 0;
+            for (size_t begin = 0; begin < docs.size(); begin += POSTING_BLOCK_SIZE) {
+                size_t end = std::min(docs.size(), begin + POSTING_BLOCK_SIZE);
+                gaps.clear();
+                float max_weight = 0.0f;
+                uint32_t max_gap = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    gaps.push_back(docs[i] - previous);
+                    max_gap = std::max(max_gap, gaps.back());
+                    max_weight = std::max(max_weight, weights[i]);
+                    previous = docs[i];
+                }
+                uint8_t gap_width = bit_width(max_gap);
+                put_raw(out, docs[end - 1]);
+                put_raw(out, max_weight);
+                put_raw(out, gap_width);
+                pack_bits(out, gaps, gap_width);
+                const auto* bytes = reinterpret_cast<const uint8_t*>(weights.data() + begin);
+                out.insert(out.end(), bytes, bytes + (end - begin) * sizeof(float));
+            }
+        }
+        std::memcpy(out.data() + count_offset, &num_lists, sizeof(num_lists));
+        return out;
+    }
+
+    /// Fill an empty index from serialize() output
+    Result<void> deserialize(std::span<const uint8_t> data) {
+        auto corrupted = [] {
+            return std::unexpected(Error(ErrorCode::IndexCorrupted, "Invalid sparse index"));
+        };
+
+        size_t offset = 0;
+        uint64_t magic = 0;
+        uint32_t version = 0;
+        uint64_t num_docs = 0;
+        if (!get_raw(data, offset, magic) || magic != SPARSE_MAGIC ||
+            !get_raw(data, offset, version) || version != SPARSE_VERSION ||
+            !get_raw(data, offset, num_docs) || num_docs >= NO_MORE_DOCS ||
+            num_docs > (data.size() - offset) / sizeof(uint64_t)) {
+            return corrupted();
+        }
+
+        doc_ids.resize(num_docs);
+        for (uint64_t doc = 0; doc < num_docs; ++doc) {
+            uint64_t id = 0;
+            (void)get_raw(data, offset, id);
+            doc_ids[doc] = static_cast<VectorId>(id);
+            if (!documents.emplace(doc_ids[doc], static_cast<uint32_t>(doc)).second) {
+                return corrupted();
+            }
+        }
+        deleted.assign((num_docs + 63) / 64, 0);
+
+        uint64_t num_lists = 0;
+        if (!get_raw(data, offset, num_lists)) {
+            return corrupted();
+        }
+        std::vector<uint32_t> gaps;
+        for (uint64_t l = 0; l < num_lists; ++l) {
+            uint32_t term = 0;
+            uint32_t df = 0;
+            if (!get_raw(data, offset, term) || !get_raw(data, offset, df) ||
+                df == 0 || df > num_docs || list_ids.count(term)) {
+                return corrupted();
+            }
+            auto& list = list_for(term);
+
+            uint64_t previous = 0;
+            for (size_t begin = 0; begin < df; begin += POSTING_BLOCK_SIZE) {
+                size_t count = std::min<size_t>(df - begin, POSTING_BLOCK_SIZE);
+                WeightBlock block;
+                uint8_t gap_width = 0;
+                if (!get_raw(data, offset, block.last_doc) ||
+                    !get_raw(data, offset, block.max_weight) ||
+                    !get_raw(data, offset, gap_width) || gap_width > 32 ||
+                    data.size() - offset < packed_bytes(count, gap_width) + count * sizeof(float)) {
+                    return corrupted();
+                }
+                gaps.resize(count);
+                unpack_bits(data.data() + offset, count, gap_width, gaps.data());
+                offset += packed_bytes(count, gap_width);
+
+                for (size_t i = 0; i < count; ++i) {
+                    uint64_t doc = previous + gaps[i];
+                    float weight = 0.0f;
+                    std::memcpy(&weight, data.data() + offset, sizeof(weight));
+                    offset += sizeof(weight);
+                    if (doc >= num_docs || (begin + i > 0 && gaps[i] == 0) ||
+                        !std::isfinite(weight) || weight <= 0.0f || weight > block.max_weight) {
+                        return corrupted();
+                    }
+                    list.append(static_cast<uint32_t>(doc), weight);
+                    previous = doc;
+                }
+                if (list.blocks.back().last_doc != block.last_doc) {
+                    return corrupted();
+                }
+            }
+        }
+        return {};
+    }
+};
+
+SparseIndex::SparseIndex() : impl_(std::make_unique<Impl>()) {}
+
+SparseIndex::~SparseIndex() = default;
+
+SparseIndex::SparseIndex(SparseIndex&&) noexcept = default;
+
+SparseIndex& SparseIndex::operator=(SparseIndex&&) noexcept = default;
+
+Result<void> SparseIndex::add(VectorId id, const SparseVector& vector) {
+    return impl_->add(id, vector);
+}
+
+Result<void> SparseIndex::remove(VectorId id) {
+    return impl_->remove(id);
+}
+
+bool SparseIndex::contains(VectorId id) const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    return impl_->documents.count(id) > 0;
+}
+
+Result<std::vector<SparseResult>> SparseIndex::search(const SparseVector& query,
+                                                      size_t k,
+                                                      float min_score) const {
+    return impl_->search(query, k, min_score);
+}
+
+void SparseIndex::compact() {
+    std::unique_lock<std::shared_mutex> lock(impl_->mutex);
+    if (impl_->documents.size() != impl_->doc_ids.size()) {
+        impl_->compact_locked();
+        impl_->generation.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+size_t SparseIndex::size() const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    return impl_->documents.size();
+}
+
+uint64_t SparseIndex::generation() const {
+    return impl_->generation.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Persistence
+// ============================================================================
+
+std::vector<uint8_t> SparseIndex::serialize() const {
+    return impl_->serialize();
+}
+
+Result<SparseIndex> SparseIndex::deserialize(std::span<const uint8_t> data) {
+    SparseIndex index;
+    auto result = index.impl_->deserialize(data);
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+    return index;
+}
+
+Result<void> SparseIndex::save(const fs::path& path) const {
+    return write_checkpoint(path, serialize());
+}
+
+Result<SparseIndex> SparseIndex::load(const fs::path& path) {
+    auto data = read_checkpoint(path);
+    if (!data) {
+        return std::unexpected(data.error());
+    }
+    return deserialize(*data);
+}
+
+} // namespace hybrid
+} // namespace vdb
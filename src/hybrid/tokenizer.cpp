@@ -0,0 +1,252 @@
+// ============================================================================
+// VectorDB - Text Tokenizer Implementation
+// ============================================================================
+
+#include "vdb/hybrid/tokenizer.hpp"
+#include <array>
+#include <bit>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+namespace vdb {
+namespace hybrid {
+
+namespace {
+
+// ============================================================================
+// Byte Classification
+// ============================================================================
+
+constexpr std::array<bool, 256> make_token_table() {
+    std::array<bool, 256> table{};
+    for (int c = '0'; c <= '9'; ++c) table[c] = true;
+    for (int c = 'a'; c <= 'z'; ++c) table[c] = true;
+    for (int c = 'A'; c <= 'Z'; ++c) table[c] = true;
+    table['-'] = true;
+    table['_'] = true;
+    return table;
+}
+
+constexpr auto TOKEN_CHARS = make_token_table();
+
+/// Set one bit per token character (letters, digits, '-', '_'); bits past
+/// the end of text stay clear
+void classify(std::string_view text, std::vector<uint64_t>& bits) {
+    const auto* data = reinterpret_cast<const uint8_t*>(text.data());
+    size_t n = text.size();
+    bits.assign((n + 63) / 64, 0);
+
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i before_0 = _mm256_set1_epi8('0' - 1);
+    const __m256i after_9 = _mm256_set1_epi8('9' + 1);
+    const __m256i before_a = _mm256_set1_epi8('a' - 1);
+    const __m256i after_z = _mm256_set1_epi8('z' + 1);
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i dash = _mm256_set1_epi8('-');
+    const __m256i underscore = _mm256_set1_epi8('_');
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        // Bytes >= 0x80 are negative as signed chars, so they fail every range
+        __m256i folded = _mm256_or_si256(v, case_bit);
+        __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(folded, before_a),
+                                         _mm256_cmpgt_epi8(after_z, folded));
+        __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, before_0),
+                                         _mm256_cmpgt_epi8(after_9, v));
+        __m256i extra = _mm256_or_si256(_mm256_cmpeq_epi8(v, dash),
+                                        _mm256_cmpeq_epi8(v, underscore));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_or_si256(alpha, digit), extra)));
+        bits[i / 64] |= static_cast<uint64_t>(mask) << (i % 64);
+    }
+#endif
+    for (; i < n; ++i) {
+        if (TOKEN_CHARS[data[i]]) {
+            bits[i / 64] |= uint64_t{1} << (i % 64);
+        }
+    }
+}
+
+/// First index >= from whose bit equals `set`, or n
+size_t next_bit(const std::vector<uint64_t>& bits, size_t from, bool set, size_t n) {
+    if (from >= n) return n;
+    size_t w = from / 64;
+    uint64_t word = (set ? bits[w] : ~bits[w]) & (~uint64_t{0} << (from % 64));
+    while (word == 0) {
+        if (++w >= bits.size()) return n;
+        word = set ? bits[w] : ~bits[w];
+    }
+    return std::min(n, w * 64 + static_cast<size_t>(std::countr_zero(word)));
+}
+
+void lowercase_ascii(const char* in, char* out, size_t n) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i before_A = _mm256_set1_epi8('A' - 1);
+    const __m256i after_Z = _mm256_set1_epi8('Z' + 1);
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, before_A),
+                                         _mm256_cmpgt_epi8(after_Z, v));
+        v = _mm256_or_si256(v, _mm256_and_si256(upper, case_bit));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+    }
+#endif
+    for (; i < n; ++i) {
+        char c = in[i];
+        out[i] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+    }
+}
+
+// ============================================================================
+// Stop Words (perfect hash, built at compile time)
+// ============================================================================
+
+constexpr std::array<std::string_view, 29> STOP_WORDS = {
+    "a", "an", "and", "are", "as", "at", "be", "by", "for", "from",
+    "has", "he", "in", "is", "it", "its", "of", "on", "that", "the",
+    "to", "was", "were", "will", "with", "this", "but", "they", "have"
+};
+
+constexpr size_t STOP_TABLE_SIZE = 128;
+
+constexpr uint32_t stop_hash(std::string_view word, uint32_t seed) {
+    uint32_t hash = seed;
+    for (char c : word) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return (hash ^ (hash >> 16)) % STOP_TABLE_SIZE;
+}
+
+constexpr uint32_t find_stop_seed() {
+    for (uint32_t seed = 2166136261u;; ++seed) {
+        std::array<bool, STOP_TABLE_SIZE> used{};
+        bool collision = false;
+        for (auto word : STOP_WORDS) {
+            uint32_t slot = stop_hash(word, seed);
+            collision = collision || used[slot];
+            used[slot] = true;
+        }
+        if (!collision) return seed;
+    }
+}
+
+constexpr uint32_t STOP_SEED = find_stop_seed();
+
+constexpr std::array<std::string_view, STOP_TABLE_SIZE> make_stop_table() {
+    std::array<std::string_view, STOP_TABLE_SIZE> table{};
+    for (auto word : STOP_WORDS) {
+        table[stop_hash(word, STOP_SEED)] = word;
+    }
+    return table;
+}
+
+constexpr auto STOP_TABLE = make_stop_table();
+
+constexpr size_t MAX_STOP_WORD_LENGTH = [] {
+    size_t longest = 0;
+    for (auto word : STOP_WORDS) longest = std::max(longest, word.size());
+    return longest;
+}();
+
+} // anonymous namespace
+
+// ============================================================================
+// Tokenizer
+// ============================================================================
+
+void Tokenizer::tokenize(std::string_view text, TokenBuffer& buffer) const {
+    buffer.tokens_.clear();
+    classify(text, buffer.token_bits_);
+
+    std::string_view normalized = text;
+    if (options_.lowercase) {
+        buffer.lowered_.resize(text.size());
+        lowercase_ascii(text.data(), buffer.lowered_.data(), text.size());
+        normalized = std::string_view(buffer.lowered_.data(), text.size());
+    }
+
+    const auto& bits = buffer.token_bits_;
+    uint32_t position = 0;
+    for (size_t begin = next_bit(bits, 0, true, text.size()); begin < text.size();
+         begin = next_bit(bits, begin, true, text.size())) {
+        size_t end = next_bit(bits, begin, false, text.size());
+        std::string_view term = normalized.substr(begin, end - begin);
+        std::string_view raw = text.substr(begin, end - begin);
+        uint32_t index = position++;
+        begin = end;
+
+        if (auto kept = normalize(term)) {
+            buffer.tokens_.push_back(Token{*kept, raw, index});
+        }
+    }
+}
+
+std::optional<std::string_view> Tokenizer::normalize(std::string_view term) const {
+    if (term.size() < options_.min_length) return std::nullopt;
+    if (options_.remove_stop_words && is_stop_word(term)) return std::nullopt;
+    return options_.stem ? stem(term) : term;
+}
+
+std::string_view Tokenizer::stem(std::string_view word) {
+    if (word.size() <= 3) {
+        return word;
+    }
+    if (word.ends_with("ing")) {
+        return word.substr(0, word.size() - 3);
+    }
+    if (word.ends_with("ed")) {
+        return word.substr(0, word.size() - 2);
+    }
+    if (word.back() == 's' && !word.ends_with("ss")) {
+        return word.substr(0, word.size() - 1);
+    }
+    return word;
+}
+
+bool Tokenizer::is_stop_word(std::string_view word) {
+    if (word.empty() || word.size() > MAX_STOP_WORD_LENGTH) {
+        return false;
+    }
+    return STOP_TABLE[stop_hash(word, STOP_SEED)] == word;
+}
+
+std::string Tokenizer::lowercase(std::string_view text) {
+    std::string result(text.size(), '\0');
+    lowercase_ascii(text.data(), result.data(), text.size());
+    return result;
+}
+
+// ============================================================================
+// Term Dictionary
+// ============================================================================
+
+uint32_t TermDictionary::intern(std::string_view term) {
+    auto it = ids_.find(term);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    auto id = static_cast<uint32_t>(terms_.size());
+    terms_.emplace_back(term);
+    ids_.emplace(terms_.back(), id);
+    return id;
+}
+
+std::optional<uint32_t> TermDictionary::find(std::string_view term) const {
+    auto it = ids_.find(term);
+    if (it == ids_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void TermDictionary::clear() {
+    ids_.clear();
+    terms_.clear();
+}
+
+} // namespace hybrid
+} // namespace vdb
@@ -3,15 +3,24 @@
 // ============================================================================
 
 #include "vdb/index.hpp"
+#include "vdb/checkpoint.hpp"
 #include <queue>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <fstream>
 #include <unordered_set>
 #include <mutex>
 
 namespace vdb {
 
+namespace {
+
+// Expansions between deadline checks; one expansion is up to 2M distances
+constexpr size_t DEADLINE_CHECK_INTERVAL = 8;
+
+}  // anonymous namespace
+
 // ============================================================================
 // HNSW Index
 // ============================================================================
@@ -88,7 +97,9 @@ Result<void> HnswIndex::add(VectorId id, VectorView vector) {
     node.id = id;
     node.level = level;
     node.connections.resize(level + 1);
-    node.vector = Vector(std::vector<Scalar>(vector.begin(), vector.end()));
+    auto data = std::make_shared_for_overwrite<Scalar[]>(vector.dim());
+    std::copy(vector.begin(), vector.end(), data.get());
+    node.vector = std::move(data);
     
     size_t node_index = nodes_.size();
     nodes_.push_back(std::move(node));
@@ -163,7 +174,9 @@ std::vector<VectorId> HnswIndex::search_layer(
     VectorView query,
     VectorId entry_point,
     size_t ef,
-    int layer
+    int layer,
+    const std::function<bool(VectorId)>* filter,
+    SearchBudget* budget
 ) const {
     // Priority queue: (distance, id) - min-heap for candidates
     using DistId = std::pair<Distance, VectorId>;
@@ -172,17 +185,34 @@ std::vector<VectorId> HnswIndex::search_layer(
     
     std::unordered_set<VectorId> visited;
     
+    // With a filter, rejected nodes are still traversed but never returned
+    auto accepts = [filter](VectorId id) { return filter == nullptr || (*filter)(id); };
+    auto worst = [&results, ef]() {
+        return results.size() < ef ? std::numeric_limits<Distance>::max() : results.top().first;
+    };
+    
     Distance entry_dist = distance_to_node(query, entry_point);
     candidates.emplace(entry_dist, entry_point);
-    results.emplace(entry_dist, entry_point);
+    if (accepts(entry_point)) {
+        results.emplace(entry_dist, entry_point);
+    }
     visited.insert(entry_point);
     
-    while (!candidates.empty()) {
+    size_t expansions = 0;
+    size_t heap_ops = 2;  // Entry point pushes
+    bool out_of_budget = budget && !budget->charge();
+    
+    while (!candidates.empty() && !out_of_budget) {
+        if (budget && expansions++ % DEADLINE_CHECK_INTERVAL == 0 && !budget->check_deadline()) {
+            break;
+        }
+        
         auto [dist, current] = candidates.top();
         candidates.pop();
+        heap_ops++;
         
         // Stop if current is further than worst result
-        if (results.size() >= ef && dist > results.top().first) {
+        if (dist > worst()) {
             break;
         }
         
@@ -207,19 +237,32 @@ std::vector<VectorId> HnswIndex::search_layer(
             if (neighbor_idx >= nodes_.size()) continue;
             if (nodes_[neighbor_idx].deleted) continue;
             
+            if (budget && !budget->charge()) {
+                out_of_budget = true;
+                break;
+            }
             Distance neighbor_dist = distance_to_node(query, neighbor_id);
             
-            if (results.size() < ef || neighbor_dist < results.top().first) {
+            if (neighbor_dist < worst()) {
                 candidates.emplace(neighbor_dist, neighbor_id);
+                heap_ops++;
+                if (!accepts(neighbor_id)) continue;
                 results.emplace(neighbor_dist, neighbor_id);
+                heap_ops++;
                 
                 if (results.size() > ef) {
                     results.pop();
+                    heap_ops++;
                 }
             }
         }
     }
     
+    if (budget) {
+        budget->nodes_visited += visited.size();
+        budget->heap_operations += heap_ops;
+    }
+    
     // Extract results, filtering out deleted nodes
     std::vector<VectorId> result_ids;
     result_ids.reserve(results.size());
@@ -274,7 +317,7 @@ Distance HnswIndex::distance_to_node(VectorView query, VectorId node_id) const {
         return std::numeric_limits<Distance>::max();
     }
     
-    return compute_distance(query, nodes_[idx].vector.view(), config_.metric);
+    return compute_distance(query, nodes_[idx].view(config_.dimension), config_.metric);
 }
 
 void HnswIndex::connect_nodes(VectorId from, VectorId to, int layer) {
@@ -303,14 +346,15 @@ void HnswIndex::connect_nodes(VectorId from, VectorId to, int layer) {
         // Keep closest ones
         std::sort(connections.begin(), connections.end(),
             [this, &node](VectorId a, VectorId b) {
-                return distance_to_node(node.vector.view(), a) < 
-                       distance_to_node(node.vector.view(), b);
+                return distance_to_node(node.view(config_.dimension), a) < 
+                       distance_to_node(node.view(config_.dimension), b);
             });
         connections.resize(max_connections);
     }
 }
 
-SearchResults HnswIndex::search(VectorView query, size_t k) const {
+SearchResults HnswIndex::search(VectorView query, size_t k, SearchBudget* budget,
+                                size_t ef_search) const {
     if (query.dim() != config_.dimension) {
         return {};
     }
@@ -322,17 +366,21 @@ SearchResults HnswIndex::search(VectorView query, size_t k) const {
     }
     
     VectorId current = entry_point_;
+    if (budget) {
+        budget->levels_descended += static_cast<size_t>(max_level_);
+    }
     
     // Traverse from top level to level 1
     for (int lv = max_level_; lv > 0; --lv) {
-        auto neighbors = search_layer(query, current, 1, lv);
+        auto neighbors = search_layer(query, current, 1, lv, nullptr, budget);
         if (!neighbors.empty()) {
             current = neighbors[0];
         }
     }
     
-    // Search at level 0 with ef_search
-    auto candidates = search_layer(query, current, config_.ef_search, 0);
+    // Search at level 0; ef never drops below k so k results can be returned
+    size_t ef = ef_search > 0 ? ef_search : config_.ef_search;
+    auto candidates = search_layer(query, current, std::max(ef, k), 0, nullptr, budget);
     
     // Convert to SearchResults
     SearchResults results;
@@ -350,22 +398,44 @@ SearchResults HnswIndex::search(VectorView query, size_t k) const {
 SearchResults HnswIndex::search_filtered(
     VectorView query,
     size_t k,
-    std::function<bool(VectorId)> filter
+    std::function<bool(VectorId)> filter,
+    SearchBudget* budget,
+    size_t ef_search
 ) const {
-    // Search with larger ef to account for filtering
-    size_t ef_multiplier = 3;
-    auto candidates = search(query, k * ef_multiplier);
+    if (query.dim() != config_.dimension) {
+        return {};
+    }
     
-    SearchResults filtered;
-    filtered.reserve(k);
+    std::shared_lock<std::shared_mutex> lock(mutex_);
     
-    for (const auto& result : candidates) {
-        if (filter(result.id)) {
-            filtered.push_back(result);
-            if (filtered.size() >= k) break;
+    if (element_count_ == 0) {
+        return {};
+    }
+    
+    VectorId current = entry_point_;
+    if (budget) {
+        budget->levels_descended += static_cast<size_t>(max_level_);
+    }
+    
+    // Upper layers route unfiltered; only level 0 restricts the result set
+    for (int lv = max_level_; lv > 0; --lv) {
+        auto neighbors = search_layer(query, current, 1, lv, nullptr, budget);
+        if (!neighbors.empty()) {
+            current = neighbors[0];
         }
     }
     
+    size_t ef = ef_search > 0 ? ef_search : config_.ef_search;
+    auto candidates = search_layer(query, current, std::max(ef, k), 0, &filter, budget);
+    
+    SearchResults filtered;
+    filtered.reserve(std::min(k, candidates.size()));
+    
+    for (size_t i = 0; i < std::min(k, candidates.size()); ++i) {
+        VectorId id = candidates[i];
+        filtered.push_back({id, distance_to_node(query, id), 0.0f});
+    }
+    
     return filtered;
 }
 
@@ -403,6 +473,18 @@ std::optional<Vector> HnswIndex::get_vector(VectorId id) const {
         return std::nullopt;
     }
     
+    const Scalar* data = nodes_[it->second].vector.get();
+    return Vector(std::vector<Scalar>(data, data + config_.dimension));
+}
+
+std::shared_ptr<const Scalar[]> HnswIndex::vector_data(VectorId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    
+    auto it = id_to_index_.find(id);
+    if (it == id_to_index_.end()) {
+        return nullptr;
+    }
+    
     return nodes_[it->second].vector;
 }
 
@@ -435,6 +517,7 @@ IndexStats HnswIndex::stats() const {
 }
 
 void HnswIndex::set_ef_search(size_t ef) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
     config_.ef_search = ef;
 }
 
@@ -458,130 +541,207 @@ void HnswIndex::optimize() {
     // TODO: Implement optimization (compact memory, rebalance graph)
 }
 
-Result<void> HnswIndex::save(std::string_view path) const {
+// ============================================================================
+// HNSW Persistence
+// ============================================================================
+
+namespace {
+
+constexpr uint32_t HNSW_INDEX_MAGIC = 0x564442;  // "VDB"
+constexpr uint32_t HNSW_INDEX_VERSION = 3;       // Version 3 adds per-node deleted flag
+
+// Append-only little helper for building the serialized index
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    template<typename T>
+    void write(const T& value) {
+        write_bytes(&value, sizeof(T));
+    }
+
+    void write_bytes(const void* data, size_t size) {
+        if (size == 0) return;
+        size_t offset = out_.size();
+        out_.resize(offset + size);
+        std::memcpy(out_.data() + offset, data, size);
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+Error truncated_index_error() {
+    return Error{ErrorCode::IndexCorrupted, "Index data truncated"};
+}
+
+}  // anonymous namespace
+
+std::vector<uint8_t> HnswIndex::serialize() const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
     
-    std::ofstream file(std::string(path), std::ios::binary);
-    if (!file) {
-        return std::unexpected(Error{ErrorCode::IoError, "Failed to open file for writing"});
-    }
+    std::vector<uint8_t> data;
+    data.reserve(64 + nodes_.size() * (config_.dimension * sizeof(Scalar) +
+                                        (config_.M * 2 + 4) * sizeof(VectorId)));
+    ByteWriter out(data);
     
     // Write header
-    uint32_t magic = 0x564442; // "VDB"
-    uint32_t version = 2;  // Version 2 includes additional config fields
-    file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
-    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(HNSW_INDEX_MAGIC);
+    out.write(HNSW_INDEX_VERSION);
     
     // Write config
-    file.write(reinterpret_cast<const char*>(&config_.dimension), sizeof(config_.dimension));
-    file.write(reinterpret_cast<const char*>(&config_.M), sizeof(config_.M));
-    file.write(reinterpret_cast<const char*>(&config_.metric), sizeof(config_.metric));
-    file.write(reinterpret_cast<const char*>(&config_.max_elements), sizeof(config_.max_elements));
-    file.write(reinterpret_cast<const char*>(&config_.ef_construction), sizeof(config_.ef_construction));
-    file.write(reinterpret_cast<const char*>(&config_.ef_search), sizeof(config_.ef_search));
-    file.write(reinterpret_cast<const char*>(&config_.seed), sizeof(config_.seed));
+    out.write(config_.dimension);
+    out.write(config_.M);
+    out.write(config_.metric);
+    out.write(config_.max_elements);
+    out.write(config_.ef_construction);
+    out.write(config_.ef_search);
+    out.write(config_.seed);
     
     // Write state
-    file.write(reinterpret_cast<const char*>(&element_count_), sizeof(element_count_));
-    file.write(reinterpret_cast<const char*>(&max_level_), sizeof(max_level_));
-    file.write(reinterpret_cast<const char*>(&entry_point_), sizeof(entry_point_));
+    out.write(element_count_);
+    out.write(max_level_);
+    out.write(entry_point_);
     
     // Write nodes
     uint64_t node_count = nodes_.size();
-    file.write(reinterpret_cast<const char*>(&node_count), sizeof(node_count));
+    out.write(node_count);
     
     for (const auto& node : nodes_) {
-        file.write(reinterpret_cast<const char*>(&node.id), sizeof(node.id));
-        file.write(reinterpret_cast<const char*>(&node.level), sizeof(node.level));
+        out.write(node.id);
+        out.write(node.level);
+        out.write(static_cast<uint8_t>(node.deleted ? 1 : 0));
         
         // Write vector
-        file.write(reinterpret_cast<const char*>(node.vector.data()), 
-                   node.vector.dim() * sizeof(Scalar));
+        out.write_bytes(node.vector.get(), config_.dimension * sizeof(Scalar));
         
         // Write connections
         for (int lv = 0; lv <= node.level; ++lv) {
             uint32_t conn_count = static_cast<uint32_t>(node.connections[lv].size());
-            file.write(reinterpret_cast<const char*>(&conn_count), sizeof(conn_count));
-            file.write(reinterpret_cast<const char*>(node.connections[lv].data()),
-                       conn_count * sizeof(VectorId));
+            out.write(conn_count);
+            out.write_bytes(node.connections[lv].data(), conn_count * sizeof(VectorId));
         }
     }
     
-    return {};
+    return data;
 }
 
-Result<HnswIndex> HnswIndex::load(std::string_view path) {
-    std::ifstream file(std::string(path), std::ios::binary);
-    if (!file) {
-        return std::unexpected(Error{ErrorCode::IoError, "Failed to open file for reading"});
-    }
+Result<HnswIndex> HnswIndex::deserialize(std::span<const uint8_t> data) {
+    ByteReader in(data);
     
     // Read header
     uint32_t magic, version;
-    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
-    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!in.read(magic) || !in.read(version)) {
+        return std::unexpected(truncated_index_error());
+    }
     
-    if (magic != 0x564442) {
+    if (magic != HNSW_INDEX_MAGIC) {
         return std::unexpected(Error{ErrorCode::IndexCorrupted, "Invalid file format"});
     }
     
-    if (version != 1 && version != 2) {
+    if (version < 1 || version > HNSW_INDEX_VERSION) {
         return std::unexpected(Error{ErrorCode::IndexCorrupted, 
             "Unsupported file version: " + std::to_string(version)});
     }
     
     HnswConfig config;
-    file.read(reinterpret_cast<char*>(&config.dimension), sizeof(config.dimension));
-    file.read(reinterpret_cast<char*>(&config.M), sizeof(config.M));
-    file.read(reinterpret_cast<char*>(&config.metric), sizeof(config.metric));
+    if (!in.read(config.dimension) || !in.read(config.M) || !in.read(config.metric)) {
+        return std::unexpected(truncated_index_error());
+    }
     
     // Version 2 includes additional configuration fields
     if (version >= 2) {
-        file.read(reinterpret_cast<char*>(&config.max_elements), sizeof(config.max_elements));
-        file.read(reinterpret_cast<char*>(&config.ef_construction), sizeof(config.ef_construction));
-        file.read(reinterpret_cast<char*>(&config.ef_search), sizeof(config.ef_search));
-        file.read(reinterpret_cast<char*>(&config.seed), sizeof(config.seed));
+        if (!in.read(config.max_elements) || !in.read(config.ef_construction) ||
+            !in.read(config.ef_search) || !in.read(config.seed)) {
+            return std::unexpected(truncated_index_error());
+        }
     }
     // Version 1 files will use default values for these fields
     
-    HnswIndex index(config);
+    if (config.dimension == 0 || config.M == 0) {
+        return std::unexpected(Error{ErrorCode::IndexCorrupted, "Invalid index configuration"});
+    }
     
-    file.read(reinterpret_cast<char*>(&index.element_count_), sizeof(index.element_count_));
-    file.read(reinterpret_cast<char*>(&index.max_level_), sizeof(index.max_level_));
-    file.read(reinterpret_cast<char*>(&index.entry_point_), sizeof(index.entry_point_));
+    HnswIndex index(config);
     
     uint64_t node_count;
-    file.read(reinterpret_cast<char*>(&node_count), sizeof(node_count));
+    if (!in.read(index.element_count_) || !in.read(index.max_level_) ||
+        !in.read(index.entry_point_) || !in.read(node_count)) {
+        return std::unexpected(truncated_index_error());
+    }
     
+    const size_t vector_bytes = config.dimension * sizeof(Scalar);
+    if (node_count > in.remaining() / vector_bytes) {
+        return std::unexpected(truncated_index_error());
+    }
     index.nodes_.reserve(node_count);
     
     for (uint64_t i = 0; i < node_count; ++i) {
         Node node;
-        file.read(reinterpret_cast<char*>(&node.id), sizeof(node.id));
-        file.read(reinterpret_cast<char*>(&node.level), sizeof(node.level));
+        if (!in.read(node.id) || !in.read(node.level) || node.level < 0) {
+            return std::unexpected(truncated_index_error());
+        }
+        
+        if (version >= 3) {
+            uint8_t deleted;
+            if (!in.read(deleted)) {
+                return std::unexpected(truncated_index_error());
+            }
+            node.deleted = deleted != 0;
+        }
         
         // Read vector
-        node.vector.resize(config.dimension);
-        file.read(reinterpret_cast<char*>(node.vector.data()),
-                  config.dimension * sizeof(Scalar));
+        auto vec = std::make_shared_for_overwrite<Scalar[]>(config.dimension);
+        if (!in.read_bytes(vec.get(), vector_bytes)) {
+            return std::unexpected(truncated_index_error());
+        }
+        node.vector = std::move(vec);
         
         // Read connections
         node.connections.resize(node.level + 1);
         for (int lv = 0; lv <= node.level; ++lv) {
             uint32_t conn_count;
-            file.read(reinterpret_cast<char*>(&conn_count), sizeof(conn_count));
+            if (!in.read(conn_count) || conn_count > in.remaining() / sizeof(VectorId)) {
+                return std::unexpected(truncated_index_error());
+            }
             node.connections[lv].resize(conn_count);
-            file.read(reinterpret_cast<char*>(node.connections[lv].data()),
-                      conn_count * sizeof(VectorId));
+            if (!in.read_bytes(node.connections[lv].data(), conn_count * sizeof(VectorId))) {
+                return std::unexpected(truncated_index_error());
+            }
         }
         
-        index.id_to_index_[node.id] = index.nodes_.size();
+        if (!node.deleted) {
+            index.id_to_index_[node.id] = index.nodes_.size();
+        }
         index.nodes_.push_back(std::move(node));
     }
     
     return index;
 }
 
+Result<void> HnswIndex::save(std::string_view path) const {
+    return write_checkpoint(fs::path(path), serialize());
+}
+
+Result<HnswIndex> HnswIndex::load(std::string_view path) {
+    // Try the latest checkpoint, then the one it replaced
+    std::optional<Error> first_error;
+    for (const fs::path& candidate : {fs::path(path), previous_checkpoint_path(path)}) {
+        auto bytes = read_checkpoint(candidate);
+        if (!bytes) {
+            if (!first_error) first_error = bytes.error();
+            continue;
+        }
+        
+        auto index = deserialize(*bytes);
+        if (index) {
+            return index;
+        }
+        if (!first_error) first_error = index.error();
+    }
+    return std::unexpected(*first_error);
+}
+
 // ============================================================================
 // Flat Index (Brute Force)
 // ============================================================================
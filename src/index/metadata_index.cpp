@@ -7,12 +7,20 @@
 #include <algorithm>
 #include <fstream>
 #include <iterator>
+#include <memory>
 
 namespace vdb
 {
     namespace index
     {
 
+        namespace
+        {
+            // Files with this header store roaring-encoded postings; older
+            // files start with the index count and list every ID
+            constexpr uint64_t METADATA_INDEX_MAGIC = 0x32584449424456; // "VDBIDX2"
+        }
+
         MetadataIndex::MetadataIndex() = default;
         MetadataIndex::~MetadataIndex() = default;
 
@@ -48,14 +56,14 @@ namespace vdb
                 if (value.empty())
                     continue;
 
-                idx.postings[value].insert(id);
+                idx.postings[value].add(id);
 
                 if (idx.is_numeric)
                 {
                     try
                     {
                         double num_val = std::stod(value);
-                        idx.numeric_index[num_val].insert(id);
+                        idx.numeric_index[num_val].add(id);
                     }
                     catch (...)
                     {
@@ -87,7 +95,7 @@ namespace vdb
                 auto it = idx.postings.find(value);
                 if (it != idx.postings.end())
                 {
-                    it->second.erase(id);
+                    it->second.remove(id);
                     if (it->second.empty())
                     {
                         idx.postings.erase(it);
@@ -102,7 +110,7 @@ namespace vdb
                         auto num_it = idx.numeric_index.find(num_val);
                         if (num_it != idx.numeric_index.end())
                         {
-                            num_it->second.erase(id);
+                            num_it->second.remove(id);
                             if (num_it->second.empty())
                             {
                                 idx.numeric_index.erase(num_it);
@@ -118,7 +126,7 @@ namespace vdb
             return {};
         }
 
-        std::set<VectorId> MetadataIndex::query(const FilterCondition &condition) const
+        RoaringBitmap MetadataIndex::query(const FilterCondition &condition) const
         {
             if (!has_index(condition.field))
             {
@@ -145,6 +153,8 @@ namespace vdb
                     {
                     }
                 }
+                if (!idx.is_numeric)
+                    return query_lexical_range(condition.field, std::nullopt, condition.value, true, false);
                 break;
 
             case FilterOp::LessOrEqual:
@@ -160,6 +170,8 @@ namespace vdb
                     {
                     }
                 }
+                if (!idx.is_numeric)
+                    return query_lexical_range(condition.field, std::nullopt, condition.value, true, true);
                 break;
 
             case FilterOp::GreaterThan:
@@ -175,6 +187,8 @@ namespace vdb
                     {
                     }
                 }
+                if (!idx.is_numeric)
+                    return query_lexical_range(condition.field, condition.value, std::nullopt, false, true);
                 break;
 
             case FilterOp::GreaterOrEqual:
@@ -190,6 +204,8 @@ namespace vdb
                     {
                     }
                 }
+                if (!idx.is_numeric)
+                    return query_lexical_range(condition.field, condition.value, std::nullopt, true, true);
                 break;
 
             case FilterOp::Range:
@@ -205,15 +221,22 @@ namespace vdb
                     {
                     }
                 }
+                // Non-numeric fields (e.g. ISO dates) compare lexicographically;
+                // an empty bound is open
+                if (!idx.is_numeric)
+                    return query_lexical_range(
+                        condition.field,
+                        condition.value.empty() ? std::nullopt : std::optional<std::string>(condition.value),
+                        condition.value2.empty() ? std::nullopt : std::optional<std::string>(condition.value2),
+                        true, true);
                 break;
 
             case FilterOp::In:
             {
-                std::set<VectorId> result;
+                RoaringBitmap result;
                 for (const auto &val : condition.values)
                 {
-                    auto ids = query_exact(condition.field, val);
-                    result.insert(ids.begin(), ids.end());
+                    result |= query_exact(condition.field, val);
                 }
                 return result;
             }
@@ -225,36 +248,41 @@ namespace vdb
             return {};
         }
 
-        std::set<VectorId> MetadataIndex::query_and(
+        RoaringBitmap MetadataIndex::query_and(
             const std::vector<FilterCondition> &conditions) const
         {
             if (conditions.empty())
                 return {};
 
-            std::set<VectorId> result = query(conditions[0]);
+            std::vector<RoaringBitmap> sets;
+            sets.reserve(conditions.size());
+            for (const auto &cond : conditions)
+            {
+                sets.push_back(query(cond));
+            }
+
+            // Intersect smallest first so later steps touch fewer containers
+            std::sort(sets.begin(), sets.end(),
+                      [](const RoaringBitmap &a, const RoaringBitmap &b)
+                      { return a.cardinality() < b.cardinality(); });
 
-            for (size_t i = 1; i < conditions.size(); ++i)
+            RoaringBitmap result = std::move(sets[0]);
+            for (size_t i = 1; i < sets.size() && !result.empty(); ++i)
             {
-                std::set<VectorId> next = query(conditions[i]);
-                std::set<VectorId> intersection;
-                std::set_intersection(result.begin(), result.end(),
-                                      next.begin(), next.end(),
-                                      std::inserter(intersection, intersection.begin()));
-                result = std::move(intersection);
+                result &= sets[i];
             }
 
             return result;
         }
 
-        std::set<VectorId> MetadataIndex::query_or(
+        RoaringBitmap MetadataIndex::query_or(
             const std::vector<FilterCondition> &conditions) const
         {
-            std::set<VectorId> result;
+            RoaringBitmap result;
 
             for (const auto &cond : conditions)
             {
-                auto ids = query(cond);
-                result.insert(ids.begin(), ids.end());
+                result |= query(cond);
             }
 
             return result;
@@ -263,11 +291,11 @@ namespace vdb
         std::function<bool(VectorId)> MetadataIndex::create_filter(
             const std::vector<FilterCondition> &conditions) const
         {
-            auto valid_ids = query_and(conditions);
+            auto valid_ids = std::make_shared<const RoaringBitmap>(query_and(conditions));
 
             return [valid_ids](VectorId id)
             {
-                return valid_ids.find(id) != valid_ids.end();
+                return valid_ids->contains(id);
             };
         }
 
@@ -289,7 +317,7 @@ namespace vdb
             return "";
         }
 
-        std::set<VectorId> MetadataIndex::query_exact(const std::string &field,
+        RoaringBitmap MetadataIndex::query_exact(const std::string &field,
                                                       const std::string &value) const
         {
             auto it = indices_.find(field);
@@ -303,14 +331,14 @@ namespace vdb
             return posting_it->second;
         }
 
-        std::set<VectorId> MetadataIndex::query_range(const std::string &field,
+        RoaringBitmap MetadataIndex::query_range(const std::string &field,
                                                       double min_val, double max_val, bool min_inclusive, bool max_inclusive) const
         {
             auto it = indices_.find(field);
             if (it == indices_.end() || !it->second.is_numeric)
                 return {};
 
-            std::set<VectorId> result;
+            RoaringBitmap result;
 
             auto lower = min_inclusive ? it->second.numeric_index.lower_bound(min_val) : it->second.numeric_index.upper_bound(min_val);
 
@@ -318,12 +346,85 @@ namespace vdb
 
             for (auto iter = lower; iter != upper; ++iter)
             {
-                result.insert(iter->second.begin(), iter->second.end());
+                result |= iter->second;
             }
 
             return result;
         }
 
+        RoaringBitmap MetadataIndex::query_lexical_range(const std::string &field,
+                                                              const std::optional<std::string> &min_val,
+                                                              const std::optional<std::string> &max_val,
+                                                              bool min_inclusive, bool max_inclusive) const
+        {
+            auto it = indices_.find(field);
+            if (it == indices_.end())
+                return {};
+
+            // Distinct values are few compared to IDs, so a key scan is cheap
+            RoaringBitmap result;
+            for (const auto &[value, ids] : it->second.postings)
+            {
+                if (min_val && (min_inclusive ? value < *min_val : value <= *min_val))
+                    continue;
+                if (max_val && (max_inclusive ? value > *max_val : value >= *max_val))
+                    continue;
+                result |= ids;
+            }
+
+            return result;
+        }
+
+        std::vector<std::string> MetadataIndex::values(const std::string &field) const
+        {
+            auto it = indices_.find(field);
+            if (it == indices_.end())
+                return {};
+
+            std::vector<std::string> result;
+            result.reserve(it->second.postings.size());
+            for (const auto &[value, ids] : it->second.postings)
+            {
+                result.push_back(value);
+            }
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+        size_t MetadataIndex::count(const std::string &field, const std::string &value) const
+        {
+            auto it = indices_.find(field);
+            if (it == indices_.end())
+                return 0;
+
+            auto posting_it = it->second.postings.find(value);
+            return posting_it != it->second.postings.end() ? posting_it->second.cardinality() : 0;
+        }
+
+        void MetadataIndex::clear()
+        {
+            for (auto &[field, idx] : indices_)
+            {
+                idx.postings.clear();
+                idx.numeric_index.clear();
+            }
+        }
+
+        void MetadataIndex::optimize()
+        {
+            for (auto &[field, idx] : indices_)
+            {
+                for (auto &[value, ids] : idx.postings)
+                {
+                    ids.run_optimize();
+                }
+                for (auto &[value, ids] : idx.numeric_index)
+                {
+                    ids.run_optimize();
+                }
+            }
+        }
+
         size_t MetadataIndex::size(const std::string &field) const
         {
             auto it = indices_.find(field);
@@ -337,7 +438,7 @@ namespace vdb
             {
                 for (const auto &[value, ids] : idx.postings)
                 {
-                    total += ids.size();
+                    total += ids.cardinality();
                 }
             }
             return total;
@@ -351,11 +452,11 @@ namespace vdb
                 usage += field.size();
                 for (const auto &[value, ids] : idx.postings)
                 {
-                    usage += value.size() + ids.size() * sizeof(VectorId);
+                    usage += value.size() + ids.memory_usage();
                 }
-                if (idx.is_numeric)
+                for (const auto &[value, ids] : idx.numeric_index)
                 {
-                    usage += idx.numeric_index.size() * (sizeof(double) + sizeof(void *));
+                    usage += sizeof(double) + ids.memory_usage();
                 }
             }
             return usage;
@@ -369,6 +470,7 @@ namespace vdb
                 return std::unexpected(Error{ErrorCode::IoError, "Failed to open file"});
             }
 
+            file.write(reinterpret_cast<const char *>(&METADATA_INDEX_MAGIC), sizeof(METADATA_INDEX_MAGIC));
             size_t num_indices = indices_.size();
             file.write(reinterpret_cast<const char *>(&num_indices), sizeof(size_t));
 
@@ -388,15 +490,18 @@ namespace vdb
                     file.write(reinterpret_cast<const char *>(&value_len), sizeof(size_t));
                     file.write(value.data(), value_len);
 
-                    size_t num_ids = ids.size();
-                    file.write(reinterpret_cast<const char *>(&num_ids), sizeof(size_t));
-                    for (VectorId id : ids)
-                    {
-                        file.write(reinterpret_cast<const char *>(&id), sizeof(VectorId));
-                    }
+                    std::vector<uint8_t> bytes;
+                    ids.serialize(bytes);
+                    size_t num_bytes = bytes.size();
+                    file.write(reinterpret_cast<const char *>(&num_bytes), sizeof(size_t));
+                    file.write(reinterpret_cast<const char *>(bytes.data()), num_bytes);
                 }
             }
 
+            if (!file)
+            {
+                return std::unexpected(Error{ErrorCode::IoError, "Failed to write metadata index"});
+            }
             return {};
         }
 
@@ -408,10 +513,24 @@ namespace vdb
                 return std::unexpected(Error{ErrorCode::IoError, "Failed to open file"});
             }
 
+            auto corrupted = []
+            {
+                return std::unexpected(Error{ErrorCode::IndexCorrupted, "Invalid metadata index file"});
+            };
+            file.seekg(0, std::ios::end);
+            auto file_size = static_cast<size_t>(file.tellg());
+            file.seekg(0);
+
             MetadataIndex idx;
 
-            size_t num_indices;
-            file.read(reinterpret_cast<char *>(&num_indices), sizeof(size_t));
+            uint64_t magic = 0;
+            file.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+            bool roaring = magic == METADATA_INDEX_MAGIC;
+            size_t num_indices = static_cast<size_t>(magic);
+            if (roaring)
+            {
+                file.read(reinterpret_cast<char *>(&num_indices), sizeof(size_t));
+            }
 
             for (size_t i = 0; i < num_indices; ++i)
             {
@@ -435,17 +554,39 @@ namespace vdb
                     std::string value(value_len, ' ');
                     file.read(&value[0], value_len);
 
-                    size_t num_ids;
-                    file.read(reinterpret_cast<char *>(&num_ids), sizeof(size_t));
-
-                    std::set<VectorId> ids;
-                    for (size_t k = 0; k < num_ids; ++k)
+                    RoaringBitmap ids;
+                    if (roaring)
                     {
-                        VectorId id;
-                        file.read(reinterpret_cast<char *>(&id), sizeof(VectorId));
-                        ids.insert(id);
+                        size_t num_bytes = 0;
+                        file.read(reinterpret_cast<char *>(&num_bytes), sizeof(size_t));
+                        if (!file || num_bytes > file_size)
+                        {
+                            return corrupted();
+                        }
+                        std::vector<uint8_t> bytes(num_bytes);
+                        file.read(reinterpret_cast<char *>(bytes.data()), num_bytes);
+                        size_t offset = 0;
+                        auto restored = RoaringBitmap::deserialize(bytes, offset);
+                        if (!file || !restored || offset != bytes.size())
+                        {
+                            return corrupted();
+                        }
+                        ids = std::move(*restored);
                     }
+                    else
+                    {
+                        size_t num_ids;
+                        file.read(reinterpret_cast<char *>(&num_ids), sizeof(size_t));
+                        if (!file || num_ids > file_size / sizeof(VectorId))
+                        {
+                            return corrupted();
+                        }
 
+                        std::vector<VectorId> id_list(num_ids);
+                        file.read(reinterpret_cast<char *>(id_list.data()), num_ids * sizeof(VectorId));
+                        ids = RoaringBitmap::from_ids(id_list);
+                    }
+                    ids.run_optimize();
                     inv_idx.postings[value] = std::move(ids);
 
                     if (inv_idx.is_numeric)
@@ -0,0 +1,145 @@
+// ============================================================================
+// VectorDB - Columnar Numeric Filter Implementation
+// AVX2 compare-and-mask over float columns into bitmap words
+// ============================================================================
+
+#include "vdb/index/numeric_columns.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+namespace vdb {
+namespace index {
+
+namespace {
+
+constexpr float MISSING = std::numeric_limits<float>::quiet_NaN();
+
+const std::optional<float>& field_value(const Metadata& metadata, MarketField field) {
+    switch (field) {
+        case MarketField::GoldPrice: return metadata.gold_price;
+        case MarketField::SilverPrice: return metadata.silver_price;
+        case MarketField::Gsr: return metadata.gsr;
+        case MarketField::Dxy: return metadata.dxy;
+        case MarketField::Vix: return metadata.vix;
+        default: return metadata.yield_10y;
+    }
+}
+
+/// Bit mask of the 64 rows starting at `values` that satisfy the predicate
+uint64_t match_word(const float* values, const NumericPredicate& predicate) {
+    uint64_t word = 0;
+
+#if defined(__AVX2__)
+    const __m256 lo = _mm256_set1_ps(predicate.value);
+    const __m256 hi = _mm256_set1_ps(predicate.value2);
+
+    for (size_t block = 0; block < 8; ++block) {
+        __m256 v = _mm256_loadu_ps(values + block * 8);
+        __m256 mask;
+        // Ordered, quiet compares: NaN (missing) is false for every op
+        switch (predicate.op) {
+            case NumericOp::Less:           mask = _mm256_cmp_ps(v, lo, _CMP_LT_OQ); break;
+            case NumericOp::LessOrEqual:    mask = _mm256_cmp_ps(v, lo, _CMP_LE_OQ); break;
+            case NumericOp::Greater:        mask = _mm256_cmp_ps(v, lo, _CMP_GT_OQ); break;
+            case NumericOp::GreaterOrEqual: mask = _mm256_cmp_ps(v, lo, _CMP_GE_OQ); break;
+            default:
+                mask = _mm256_and_ps(_mm256_cmp_ps(v, lo, _CMP_GE_OQ),
+                                     _mm256_cmp_ps(v, hi, _CMP_LE_OQ));
+                break;
+        }
+        word |= static_cast<uint64_t>(_mm256_movemask_ps(mask)) << (block * 8);
+    }
+#else
+    for (size_t i = 0; i < 64; ++i) {
+        float v = values[i];
+        bool match;
+        switch (predicate.op) {
+            case NumericOp::Less:           match = v < predicate.value; break;
+            case NumericOp::LessOrEqual:    match = v <= predicate.value; break;
+            case NumericOp::Greater:        match = v > predicate.value; break;
+            case NumericOp::GreaterOrEqual: match = v >= predicate.value; break;
+            default: match = v >= predicate.value && v <= predicate.value2; break;
+        }
+        word |= static_cast<uint64_t>(match) << i;
+    }
+#endif
+
+    return word;
+}
+
+}  // anonymous namespace
+
+// ============================================================================
+// Mutation
+// ============================================================================
+
+void NumericColumns::grow(size_t min_rows) {
+    if (min_rows <= rows_) return;
+
+    // Geometric growth, kept a multiple of 64 so scans work in whole words
+    size_t target = std::max(min_rows, rows_ * 2);
+    target = (target + 63) / 64 * 64;
+    for (auto& column : columns_) {
+        column.resize(target, MISSING);
+    }
+    rows_ = target;
+}
+
+void NumericColumns::set(VectorId id, const Metadata& metadata) {
+    grow(static_cast<size_t>(id) + 1);
+    for (size_t f = 0; f < MARKET_FIELD_COUNT; ++f) {
+        const auto& value = field_value(metadata, static_cast<MarketField>(f));
+        columns_[f][id] = value.value_or(MISSING);
+    }
+}
+
+void NumericColumns::erase(VectorId id) {
+    if (id >= rows_) return;
+    for (auto& column : columns_) {
+        column[id] = MISSING;
+    }
+}
+
+void NumericColumns::clear() {
+    for (auto& column : columns_) {
+        column.clear();
+    }
+    rows_ = 0;
+}
+
+// ============================================================================
+// Evaluation
+// ============================================================================
+
+RoaringBitmap NumericColumns::evaluate(std::span<const NumericPredicate> predicates) const {
+    if (predicates.empty() || rows_ == 0) {
+        return {};
+    }
+
+    std::vector<uint64_t> words(rows_ / 64, ~uint64_t{0});
+    for (const auto& predicate : predicates) {
+        const float* column = columns_[static_cast<size_t>(predicate.field)].data();
+        for (size_t w = 0; w < words.size(); ++w) {
+            if (words[w] != 0) {
+                words[w] &= match_word(column + w * 64, predicate);
+            }
+        }
+    }
+
+    return RoaringBitmap::from_words(words);
+}
+
+size_t NumericColumns::memory_usage() const {
+    size_t total = 0;
+    for (const auto& column : columns_) {
+        total += column.capacity() * sizeof(float);
+    }
+    return total;
+}
+
+}} // namespace vdb::index
@@ -0,0 +1,684 @@
+// ============================================================================
+// VectorDB - Compressed Bitmap Implementation
+// Container algebra with AVX2 word kernels for dense chunks
+// ============================================================================
+
+#include "vdb/index/roaring_bitmap.hpp"
+#include "vdb/checkpoint.hpp"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+namespace vdb {
+namespace index {
+
+namespace {
+
+using Container = RoaringBitmap::Container;
+using ArrayContainer = RoaringBitmap::ArrayContainer;
+using BitmapContainer = RoaringBitmap::BitmapContainer;
+using RunContainer = RoaringBitmap::RunContainer;
+using Run = RoaringBitmap::Run;
+
+constexpr size_t ARRAY_MAX = RoaringBitmap::ARRAY_MAX;
+constexpr size_t BITMAP_WORDS = RoaringBitmap::BITMAP_WORDS;
+
+enum class ContainerKind : uint8_t { Array = 0, Bitmap = 1, Run = 2 };
+
+// ============================================================================
+// Word Kernels
+// ============================================================================
+
+enum class WordOp { And, Or, AndNot };
+
+/// out = a <op> b over a full chunk; returns the resulting cardinality
+uint32_t combine_words(const uint64_t* a, const uint64_t* b, uint64_t* out, WordOp op) {
+#if defined(__AVX2__)
+    for (size_t i = 0; i < BITMAP_WORDS; i += 4) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i vr;
+        switch (op) {
+            case WordOp::And:    vr = _mm256_and_si256(va, vb); break;
+            case WordOp::Or:     vr = _mm256_or_si256(va, vb); break;
+            case WordOp::AndNot: vr = _mm256_andnot_si256(vb, va); break;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), vr);
+    }
+#else
+    for (size_t i = 0; i < BITMAP_WORDS; ++i) {
+        switch (op) {
+            case WordOp::And:    out[i] = a[i] & b[i]; break;
+            case WordOp::Or:     out[i] = a[i] | b[i]; break;
+            case WordOp::AndNot: out[i] = a[i] & ~b[i]; break;
+        }
+    }
+#endif
+
+    uint32_t cardinality = 0;
+    for (size_t i = 0; i < BITMAP_WORDS; ++i) {
+        cardinality += static_cast<uint32_t>(std::popcount(out[i]));
+    }
+    return cardinality;
+}
+
+// ============================================================================
+// Container Helpers
+// ============================================================================
+
+bool bitmap_test(const BitmapContainer& c, uint16_t v) {
+    return (c.words[v >> 6] >> (v & 63)) & 1;
+}
+
+void bitmap_set(BitmapContainer& c, uint16_t v) {
+    c.words[v >> 6] |= uint64_t{1} << (v & 63);
+}
+
+bool container_contains(const Container& container, uint16_t v) {
+    if (const auto* array = std::get_if<ArrayContainer>(&container)) {
+        return std::binary_search(array->values.begin(), array->values.end(), v);
+    }
+    if (const auto* bitmap = std::get_if<BitmapContainer>(&container)) {
+        return bitmap_test(*bitmap, v);
+    }
+    const auto& runs = std::get<RunContainer>(container).runs;
+    auto it = std::upper_bound(runs.begin(), runs.end(), v,
+        [](uint16_t value, const Run& run) { return value < run.start; });
+    if (it == runs.begin()) return false;
+    --it;
+    return uint32_t(v) <= uint32_t(it->start) + it->length;
+}
+
+uint32_t container_cardinality(const Container& container) {
+    if (const auto* array = std::get_if<ArrayContainer>(&container)) {
+        return static_cast<uint32_t>(array->values.size());
+    }
+    if (const auto* bitmap = std::get_if<BitmapContainer>(&container)) {
+        return bitmap->cardinality;
+    }
+    uint32_t total = 0;
+    for (const Run& run : std::get<RunContainer>(container).runs) {
+        total += uint32_t(run.length) + 1;
+    }
+    return total;
+}
+
+size_t container_bytes(const Container& container) {
+    if (const auto* array = std::get_if<ArrayContainer>(&container)) {
+        return array->values.capacity() * sizeof(uint16_t);
+    }
+    if (const auto* bitmap = std::get_if<BitmapContainer>(&container)) {
+        return bitmap->words.capacity() * sizeof(uint64_t);
+    }
+    return std::get<RunContainer>(container).runs.capacity() * sizeof(Run);
+}
+
+BitmapContainer to_bitmap(const Container& container) {
+    if (const auto* bitmap = std::get_if<BitmapContainer>(&container)) {
+        return *bitmap;
+    }
+    BitmapContainer result;
+    if (const auto* array = std::get_if<ArrayContainer>(&container)) {
+        for (uint16_t v : array->values) bitmap_set(result, v);
+    } else {
+        for (const Run& run : std::get<RunContainer>(container).runs) {
+            for (uint32_t v = run.start; v <= uint32_t(run.start) + run.length; ++v) {
+                bitmap_set(result, static_cast<uint16_t>(v));
+            }
+        }
+    }
+    result.cardinality = container_cardinality(container);
+    return result;
+}
+
+/// Sparse bitmaps are demoted to sorted arrays
+Container normalize(BitmapContainer&& bitmap) {
+    if (bitmap.cardinality > ARRAY_MAX) {
+        return std::move(bitmap);
+    }
+    ArrayContainer array;
+    array.values.reserve(bitmap.cardinality);
+    for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+        uint64_t word = bitmap.words[w];
+        while (word != 0) {
+            array.values.push_back(static_cast<uint16_t>(w * 64 + std::countr_zero(word)));
+            word &= word - 1;
+        }
+    }
+    return array;
+}
+
+/// Dense arrays are promoted to bitmaps
+Container normalize(ArrayContainer&& array) {
+    if (array.values.size() <= ARRAY_MAX) {
+        return std::move(array);
+    }
+    return to_bitmap(Container{std::move(array)});
+}
+
+size_t count_runs(const Container& container) {
+    size_t runs = 0;
+    int64_t previous = -2;
+    auto visit = [&](uint16_t v) {
+        if (int64_t(v) != previous + 1) runs++;
+        previous = v;
+    };
+    if (const auto* array = std::get_if<ArrayContainer>(&container)) {
+        for (uint16_t v : array->values) visit(v);
+    } else if (const auto* bitmap = std::get_if<BitmapContainer>(&container)) {
+        // A run starts at every set bit whose predecessor is clear
+        uint64_t carry = 0;
+        for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+            uint64_t word = bitmap->words[w];
+            uint64_t starts = word & ~((word << 1) | carry);
+            runs += static_cast<size_t>(std::popcount(starts));
+            carry = word >> 63;
+        }
+    } else {
+        runs = std::get<RunContainer>(container).runs.size();
+    }
+    return runs;
+}
+
+RunContainer to_runs(const Container& container) {
+    RunContainer result;
+    auto push = [&](uint16_t v) {
+        if (!result.runs.empty()) {
+            Run& last = result.runs.back();
+            if (uint32_t(last.start) + last.length + 1 == v) {
+                last.length++;
+                return;
+            }
+        }
+        result.runs.push_back(Run{v, 0});
+    };
+    if (const auto* array = std::get_if<ArrayContainer>(&container)) {
+        for (uint16_t v : array->values) push(v);
+    } else if (const auto* bitmap = std::get_if<BitmapContainer>(&container)) {
+        for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+            uint64_t word = bitmap->words[w];
+            while (word != 0) {
+                push(static_cast<uint16_t>(w * 64 + std::countr_zero(word)));
+                word &= word - 1;
+            }
+        }
+    } else {
+        result = std::get<RunContainer>(container);
+    }
+    return result;
+}
+
+// ============================================================================
+// Container Algebra
+// ============================================================================
+
+Container container_and(const Container& a, const Container& b) {
+    const auto* array_a = std::get_if<ArrayContainer>(&a);
+    const auto* array_b = std::get_if<ArrayContainer>(&b);
+
+    if (array_a && array_b) {
+        ArrayContainer result;
+        std::set_intersection(array_a->values.begin(), array_a->values.end(),
+                              array_b->values.begin(), array_b->values.end(),
+                              std::back_inserter(result.values));
+        return result;
+    }
+    if (array_a || array_b) {
+        // Probe the other container with each array value
+        const ArrayContainer& array = array_a ? *array_a : *array_b;
+        const Container& other = array_a ? b : a;
+        ArrayContainer result;
+        for (uint16_t v : array.values) {
+            if (container_contains(other, v)) result.values.push_back(v);
+        }
+        return result;
+    }
+
+    BitmapContainer lhs = to_bitmap(a);
+    BitmapContainer rhs = to_bitmap(b);
+    lhs.cardinality = combine_words(lhs.words.data(), rhs.words.data(), lhs.words.data(),
+                                    WordOp::And);
+    return normalize(std::move(lhs));
+}
+
+Container container_or(const Container& a, const Container& b) {
+    const auto* array_a = std::get_if<ArrayContainer>(&a);
+    const auto* array_b = std::get_if<ArrayContainer>(&b);
+
+    if (array_a && array_b && array_a->values.size() + array_b->values.size() <= ARRAY_MAX) {
+        ArrayContainer result;
+        std::set_union(array_a->values.begin(), array_a->values.end(),
+                       array_b->values.begin(), array_b->values.end(),
+                       std::back_inserter(result.values));
+        return result;
+    }
+
+    BitmapContainer lhs = to_bitmap(a);
+    if (array_b) {
+        for (uint16_t v : array_b->values) {
+            if (!bitmap_test(lhs, v)) {
+                bitmap_set(lhs, v);
+                lhs.cardinality++;
+            }
+        }
+        return normalize(std::move(lhs));
+    }
+
+    BitmapContainer rhs = to_bitmap(b);
+    lhs.cardinality = combine_words(lhs.words.data(), rhs.words.data(), lhs.words.data(),
+                                    WordOp::Or);
+    return normalize(std::move(lhs));
+}
+
+Container container_andnot(const Container& a, const Container& b) {
+    if (const auto* array_a = std::get_if<ArrayContainer>(&a)) {
+        ArrayContainer result;
+        if (const auto* array_b = std::get_if<ArrayContainer>(&b)) {
+            std::set_difference(array_a->values.begin(), array_a->values.end(),
+                                array_b->values.begin(), array_b->values.end(),
+                                std::back_inserter(result.values));
+        } else {
+            for (uint16_t v : array_a->values) {
+                if (!container_contains(b, v)) result.values.push_back(v);
+            }
+        }
+        return result;
+    }
+
+    BitmapContainer lhs = to_bitmap(a);
+    if (const auto* array_b = std::get_if<ArrayContainer>(&b)) {
+        for (uint16_t v : array_b->values) {
+            if (bitmap_test(lhs, v)) {
+                lhs.words[v >> 6] &= ~(uint64_t{1} << (v & 63));
+                lhs.cardinality--;
+            }
+        }
+        return normalize(std::move(lhs));
+    }
+
+    BitmapContainer rhs = to_bitmap(b);
+    lhs.cardinality = combine_words(lhs.words.data(), rhs.words.data(), lhs.words.data(),
+                                    WordOp::AndNot);
+    return normalize(std::move(lhs));
+}
+
+}  // anonymous namespace
+
+// ============================================================================
+// Construction & Mutation
+// ============================================================================
+
+RoaringBitmap RoaringBitmap::from_ids(std::span<const VectorId> ids) {
+    std::vector<VectorId> sorted(ids.begin(), ids.end());
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    RoaringBitmap result;
+    size_t i = 0;
+    while (i < sorted.size()) {
+        uint64_t key = sorted[i] >> 16;
+        ArrayContainer array;
+        while (i < sorted.size() && (sorted[i] >> 16) == key) {
+            array.values.push_back(static_cast<uint16_t>(sorted[i] & 0xFFFF));
+            ++i;
+        }
+        result.keys_.push_back(key);
+        result.containers_.push_back(normalize(std::move(array)));
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::from_words(std::span<const uint64_t> words) {
+    RoaringBitmap result;
+    for (size_t first = 0; first < words.size(); first += BITMAP_WORDS) {
+        size_t count = std::min(BITMAP_WORDS, words.size() - first);
+
+        BitmapContainer bitmap;
+        std::copy_n(words.begin() + first, count, bitmap.words.begin());
+        for (size_t w = 0; w < count; ++w) {
+            bitmap.cardinality += static_cast<uint32_t>(std::popcount(bitmap.words[w]));
+        }
+        if (bitmap.cardinality == 0) continue;
+
+        result.keys_.push_back(first / BITMAP_WORDS);
+        result.containers_.push_back(normalize(std::move(bitmap)));
+    }
+    return result;
+}
+
+size_t RoaringBitmap::find_key(uint64_t key) const {
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+    if (it != keys_.end() && *it == key) {
+        return static_cast<size_t>(it - keys_.begin());
+    }
+    return keys_.size();
+}
+
+void RoaringBitmap::add(VectorId id) {
+    const uint64_t key = id >> 16;
+    const auto low = static_cast<uint16_t>(id & 0xFFFF);
+
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+    size_t pos = static_cast<size_t>(it - keys_.begin());
+    if (it == keys_.end() || *it != key) {
+        keys_.insert(it, key);
+        containers_.insert(containers_.begin() + pos, ArrayContainer{{low}});
+        return;
+    }
+
+    Container& container = containers_[pos];
+    if (std::holds_alternative<RunContainer>(container)) {
+        if (container_contains(container, low)) return;
+        container = normalize(to_bitmap(container));
+    }
+
+    if (auto* array = std::get_if<ArrayContainer>(&container)) {
+        auto at = std::lower_bound(array->values.begin(), array->values.end(), low);
+        if (at != array->values.end() && *at == low) return;
+        array->values.insert(at, low);
+        if (array->values.size() > ARRAY_MAX) {
+            container = to_bitmap(container);
+        }
+    } else {
+        auto& bitmap = std::get<BitmapContainer>(container);
+        if (!bitmap_test(bitmap, low)) {
+            bitmap_set(bitmap, low);
+            bitmap.cardinality++;
+        }
+    }
+}
+
+bool RoaringBitmap::remove(VectorId id) {
+    size_t pos = find_key(id >> 16);
+    if (pos == keys_.size()) return false;
+
+    const auto low = static_cast<uint16_t>(id & 0xFFFF);
+    Container& container = containers_[pos];
+    if (!container_contains(container, low)) return false;
+
+    if (std::holds_alternative<RunContainer>(container)) {
+        container = to_bitmap(container);
+    }
+
+    if (auto* array = std::get_if<ArrayContainer>(&container)) {
+        array->values.erase(std::lower_bound(array->values.begin(), array->values.end(), low));
+    } else {
+        auto& bitmap = std::get<BitmapContainer>(container);
+        bitmap.words[low >> 6] &= ~(uint64_t{1} << (low & 63));
+        bitmap.cardinality--;
+        container = normalize(std::move(bitmap));
+    }
+
+    if (container_cardinality(container) == 0) {
+        keys_.erase(keys_.begin() + pos);
+        containers_.erase(containers_.begin() + pos);
+    }
+    return true;
+}
+
+void RoaringBitmap::clear() {
+    keys_.clear();
+    containers_.clear();
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+bool RoaringBitmap::contains(VectorId id) const {
+    size_t pos = find_key(id >> 16);
+    if (pos == keys_.size()) return false;
+    return container_contains(containers_[pos], static_cast<uint16_t>(id & 0xFFFF));
+}
+
+uint64_t RoaringBitmap::cardinality() const {
+    uint64_t total = 0;
+    for (const auto& container : containers_) {
+        total += container_cardinality(container);
+    }
+    return total;
+}
+
+std::vector<VectorId> RoaringBitmap::to_vector() const {
+    std::vector<VectorId> result;
+    result.reserve(cardinality());
+    for_each([&result](VectorId id) { result.push_back(id); });
+    return result;
+}
+
+// ============================================================================
+// Set Algebra
+// ============================================================================
+
+RoaringBitmap RoaringBitmap::operator&(const RoaringBitmap& other) const {
+    RoaringBitmap result;
+    size_t i = 0, j = 0;
+    while (i < keys_.size() && j < other.keys_.size()) {
+        if (keys_[i] < other.keys_[j]) {
+            ++i;
+        } else if (keys_[i] > other.keys_[j]) {
+            ++j;
+        } else {
+            Container merged = container_and(containers_[i], other.containers_[j]);
+            if (container_cardinality(merged) > 0) {
+                result.keys_.push_back(keys_[i]);
+                result.containers_.push_back(std::move(merged));
+            }
+            ++i;
+            ++j;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::operator|(const RoaringBitmap& other) const {
+    RoaringBitmap result;
+    result.keys_.reserve(keys_.size() + other.keys_.size());
+    result.containers_.reserve(keys_.size() + other.keys_.size());
+
+    size_t i = 0, j = 0;
+    while (i < keys_.size() || j < other.keys_.size()) {
+        if (j == other.keys_.size() || (i < keys_.size() && keys_[i] < other.keys_[j])) {
+            result.keys_.push_back(keys_[i]);
+            result.containers_.push_back(containers_[i]);
+            ++i;
+        } else if (i == keys_.size() || other.keys_[j] < keys_[i]) {
+            result.keys_.push_back(other.keys_[j]);
+            result.containers_.push_back(other.containers_[j]);
+            ++j;
+        } else {
+            result.keys_.push_back(keys_[i]);
+            result.containers_.push_back(container_or(containers_[i], other.containers_[j]));
+            ++i;
+            ++j;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::operator-(const RoaringBitmap& other) const {
+    RoaringBitmap result;
+    size_t j = 0;
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        while (j < other.keys_.size() && other.keys_[j] < keys_[i]) ++j;
+
+        if (j < other.keys_.size() && other.keys_[j] == keys_[i]) {
+            Container remaining = container_andnot(containers_[i], other.containers_[j]);
+            if (container_cardinality(remaining) > 0) {
+                result.keys_.push_back(keys_[i]);
+                result.containers_.push_back(std::move(remaining));
+            }
+        } else {
+            result.keys_.push_back(keys_[i]);
+            result.containers_.push_back(containers_[i]);
+        }
+    }
+    return result;
+}
+
+RoaringBitmap& RoaringBitmap::operator&=(const RoaringBitmap& other) {
+    *this = *this & other;
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator|=(const RoaringBitmap& other) {
+    *this = *this | other;
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator-=(const RoaringBitmap& other) {
+    *this = *this - other;
+    return *this;
+}
+
+bool RoaringBitmap::operator==(const RoaringBitmap& other) const {
+    if (keys_ != other.keys_) return false;
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        if (container_cardinality(containers_[i]) != container_cardinality(other.containers_[i])) {
+            return false;
+        }
+        // Compare through the representation-independent intersection
+        if (container_cardinality(container_and(containers_[i], other.containers_[i])) !=
+            container_cardinality(containers_[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Maintenance
+// ============================================================================
+
+void RoaringBitmap::run_optimize() {
+    for (auto& container : containers_) {
+        size_t run_bytes = count_runs(container) * sizeof(Run);
+        size_t current_bytes = std::holds_alternative<ArrayContainer>(container)
+            ? container_cardinality(container) * sizeof(uint16_t)
+            : std::holds_alternative<BitmapContainer>(container)
+                ? BITMAP_WORDS * sizeof(uint64_t)
+                : run_bytes;
+        if (run_bytes < current_bytes) {
+            container = to_runs(container);
+        }
+    }
+}
+
+size_t RoaringBitmap::memory_usage() const {
+    size_t total = keys_.capacity() * sizeof(uint64_t) + containers_.capacity() * sizeof(Container);
+    for (const auto& container : containers_) {
+        total += container_bytes(container);
+    }
+    return total;
+}
+
+// ============================================================================
+// Serialization
+// ============================================================================
+
+void RoaringBitmap::serialize(std::vector<uint8_t>& out) const {
+    put_raw<uint64_t>(out, keys_.size());
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        put_raw<uint64_t>(out, keys_[i]);
+        const Container& container = containers_[i];
+
+        if (const auto* array = std::get_if<ArrayContainer>(&container)) {
+            put_raw<uint8_t>(out, static_cast<uint8_t>(ContainerKind::Array));
+            put_raw<uint32_t>(out, static_cast<uint32_t>(array->values.size()));
+            for (uint16_t v : array->values) put_raw<uint16_t>(out, v);
+        } else if (const auto* bitmap = std::get_if<BitmapContainer>(&container)) {
+            put_raw<uint8_t>(out, static_cast<uint8_t>(ContainerKind::Bitmap));
+            put_raw<uint32_t>(out, bitmap->cardinality);
+            for (uint64_t word : bitmap->words) put_raw<uint64_t>(out, word);
+        } else {
+            const auto& runs = std::get<RunContainer>(container).runs;
+            put_raw<uint8_t>(out, static_cast<uint8_t>(ContainerKind::Run));
+            put_raw<uint32_t>(out, static_cast<uint32_t>(runs.size()));
+            for (const Run& run : runs) {
+                put_raw<uint16_t>(out, run.start);
+                put_raw<uint16_t>(out, run.length);
+            }
+        }
+    }
+}
+
+Result<RoaringBitmap> RoaringBitmap::deserialize(std::span<const uint8_t> data, size_t& offset) {
+    auto corrupted = [] {
+        return std::unexpected(Error{ErrorCode::IndexCorrupted, "Truncated or invalid bitmap"});
+    };
+
+    auto remaining = [&] { return offset <= data.size() ? data.size() - offset : 0; };
+
+    uint64_t count = 0;
+    if (!get_raw(data, offset, count)) return corrupted();
+
+    RoaringBitmap result;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t key = 0;
+        uint8_t kind = 0;
+        uint32_t n = 0;
+        if (!get_raw(data, offset, key) || !get_raw(data, offset, kind) || !get_raw(data, offset, n)) {
+            return corrupted();
+        }
+        if (!result.keys_.empty() && key <= result.keys_.back()) return corrupted();
+
+        switch (static_cast<ContainerKind>(kind)) {
+            case ContainerKind::Array: {
+                if (n == 0 || n > ARRAY_MAX || n > remaining() / sizeof(uint16_t)) return corrupted();
+                ArrayContainer array;
+                array.values.resize(n);
+                for (auto& v : array.values) {
+                    if (!get_raw(data, offset, v)) return corrupted();
+                }
+                // Strictly increasing: duplicates would inflate cardinality
+                if (std::adjacent_find(array.values.begin(), array.values.end(),
+                                       std::greater_equal<uint16_t>()) != array.values.end()) {
+                    return corrupted();
+                }
+                result.containers_.push_back(std::move(array));
+                break;
+            }
+            case ContainerKind::Bitmap: {
+                BitmapContainer bitmap;
+                for (auto& word : bitmap.words) {
+                    if (!get_raw(data, offset, word)) return corrupted();
+                }
+                bitmap.cardinality = 0;
+                for (uint64_t word : bitmap.words) {
+                    bitmap.cardinality += static_cast<uint32_t>(std::popcount(word));
+                }
+                if (bitmap.cardinality != n || n == 0) return corrupted();
+                result.containers_.push_back(std::move(bitmap));
+                break;
+            }
+            case ContainerKind::Run: {
+                // Disjoint runs over 16-bit values: at most one per other value
+                if (n == 0 || n > RUN_MAX || n > remaining() / (2 * sizeof(uint16_t))) return corrupted();
+                RunContainer runs;
+                runs.runs.resize(n);
+                int32_t previous_end = -1;
+                for (auto& run : runs.runs) {
+                    if (!get_raw(data, offset, run.start) || !get_raw(data, offset, run.length)) {
+                        return corrupted();
+                    }
+                    if (uint32_t(run.start) + run.length > 0xFFFF) return corrupted();
+                    // Sorted and non-overlapping
+                    if (int32_t(run.start) <= previous_end) return corrupted();
+                    previous_end = int32_t(run.start) + run.length;
+                }
+                result.containers_.push_back(std::move(runs));
+                break;
+            }
+            default:
+                return corrupted();
+        }
+        result.keys_.push_back(key);
+    }
+    return result;
+}
+
+}} // namespace vdb::index
@@ -0,0 +1,299 @@
+// ============================================================================
+// VectorDB - Query Result Cache Implementation
+// Epoch-tagged LRU keyed on SQ8-quantized query vectors
+// ============================================================================
+
+#include "vdb/database.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+
+namespace vdb {
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = FNV_OFFSET) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/// Accumulates option fields into a hash; optionals hash a presence byte
+class OptionsHasher {
+public:
+    template<typename T>
+    void add(const T& value) {
+        hash_ = fnv1a(&value, sizeof(T), hash_);
+    }
+
+    void add(const std::string& value) {
+        add(value.size());
+        hash_ = fnv1a(value.data(), value.size(), hash_);
+    }
+
+    template<typename T>
+    void add(const std::optional<T>& value) {
+        add(static_cast<uint8_t>(value.has_value()));
+        if (value) add(*value);
+    }
+
+    [[nodiscard]] uint64_t value() const { return hash_; }
+
+private:
+    uint64_t hash_ = FNV_OFFSET;
+};
+
+size_t metadata_bytes(const Metadata& meta) {
+    return sizeof(Metadata) + meta.date.size() + meta.source_file.size() + meta.asset.size() +
+           meta.bias.size() + meta.content_hash.size() + meta.extra_json.size();
+}
+
+}  // anonymous namespace
+
+// ============================================================================
+// Options Hash
+// ============================================================================
+
+uint64_t query_options_hash(const QueryOptions& options) {
+    OptionsHasher hasher;
+    hasher.add(options.k);
+    hasher.add(options.ef_search);
+    hasher.add(options.type_filter);
+    hasher.add(options.date_filter);
+    hasher.add(options.date_from);
+    hasher.add(options.date_to);
+    hasher.add(options.asset_filter);
+    hasher.add(options.bias_filter);
+    hasher.add(options.include_metadata);
+    hasher.add(options.deduplicate_by_date);
+    hasher.add(options.force_plan);
+    // Budgets and profile targets are not hashed: only complete results
+    // are ever cached, and profiling does not change them
+
+    // Predicates are ANDed, so their order must not change the key
+    auto predicates = options.numeric_filters;
+    std::sort(predicates.begin(), predicates.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.field, a.op, a.value, a.value2) <
+               std::tie(b.field, b.op, b.value, b.value2);
+    });
+    hasher.add(predicates.size());
+    for (const auto& p : predicates) {
+        hasher.add(p.field);
+        hasher.add(p.op);
+        hasher.add(p.value);
+        hasher.add(p.op == index::NumericOp::Between ? p.value2 : 0.0f);
+    }
+
+    return hasher.value();
+}
+
+// ============================================================================
+// QueryResultCache
+// ============================================================================
+
+QueryResultCache::QueryResultCache(const QueryCacheConfig& config, DistanceMetric metric)
+    : config_(config)
+    , metric_(metric)
+{}
+
+std::vector<int8_t> QueryResultCache::quantize(VectorView query) const {
+    if (!config_.quantize_key) {
+        return {};
+    }
+
+    // Symmetric SQ8 against the query's own max magnitude, so tiny float
+    // noise from re-embedding the same text maps to the same codes
+    float max_abs = 0.0f;
+    for (Scalar v : query) max_abs = std::max(max_abs, std::abs(v));
+    const float scale = max_abs > 0.0f ? 127.0f / max_abs : 0.0f;
+
+    std::vector<int8_t> codes(query.size());
+    for (size_t i = 0; i < query.size(); ++i) {
+        codes[i] = static_cast<int8_t>(std::lround(query[i] * scale));
+    }
+
+    // The codes alone make v and 2v the same key. That is right for cosine,
+    // but L2 and dot product rank differently with magnitude, so append the
+    // max magnitude itself as an exponent plus an 8-bit mantissa
+    if (metric_ != DistanceMetric::Cosine) {
+        int exponent = 0;
+        float mantissa = std::frexp(max_abs, &exponent);  // [0.5, 1) or 0
+        codes.push_back(static_cast<int8_t>(std::clamp(exponent, -128, 127)));
+        codes.push_back(static_cast<int8_t>(std::lround(mantissa * 254.0f) - 127));
+    }
+    return codes;
+}
+
+uint64_t QueryResultCache::key_for(VectorView query, const std::vector<int8_t>& codes,
+                                   uint64_t options_hash) const {
+    uint64_t hash = config_.quantize_key
+        ? fnv1a(codes.data(), codes.size())
+        : fnv1a(query.data(), query.size() * sizeof(Scalar));
+    return fnv1a(&options_hash, sizeof(options_hash), hash);
+}
+
+bool QueryResultCache::same_query(const Entry& entry, VectorView query,
+                                  const std::vector<int8_t>& codes) const {
+    if (config_.quantize_key) {
+        return entry.codes == codes;
+    }
+    return entry.query.size() == query.size() &&
+           std::memcmp(entry.query.data(), query.data(), query.size() * sizeof(Scalar)) == 0;
+}
+
+float QueryResultCache::similarity(VectorView query, VectorView cached) const {
+    if (metric_ == DistanceMetric::Cosine) {
+        return query.cosine_similarity(cached);
+    }
+
+    // Scale-sensitive metrics: 1 - |a - b|^2 / (2 |a| |b|). Equals the cosine
+    // for equal norms and falls off as the magnitudes diverge
+    float norms = std::sqrt(query.dot(query) * cached.dot(cached));
+    if (norms <= 0.0f) {
+        return 0.0f;
+    }
+    float distance = query.euclidean_distance(cached);
+    return 1.0f - distance * distance / (2.0f * norms);
+}
+
+std::optional<QueryResults> QueryResultCache::lookup(
+    VectorView query, uint64_t options_hash, uint64_t epoch
+) {
+    auto codes = quantize(query);
+    uint64_t key = key_for(query, codes, options_hash);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto serve = [&](EntryList::iterator it) {
+        lru_.splice(lru_.begin(), lru_, it);
+        stats_.saved_ns += it->latency_ns;
+        return it->results;
+    };
+
+    auto [first, last] = entries_.equal_range(key);
+    for (auto found = first; found != last; ++found) {
+        auto it = found->second;
+        if (it->options_hash != options_hash || !same_query(*it, query, codes)) {
+            continue;  // Hash collision
+        }
+        if (it->epoch != epoch) {
+            erase(it);
+            stats_.invalidations++;
+            break;
+        }
+        stats_.hits++;
+        return serve(it);
+    }
+
+    if (config_.similarity_threshold > 0.0f) {
+        // Near-duplicate scan over the most recent entries only, so the
+        // mutex is held for a bounded time; stale entries found along the
+        // way are dropped
+        EntryList::iterator best = lru_.end();
+        float best_similarity = config_.similarity_threshold;
+        size_t scanned = 0;
+        for (auto it = lru_.begin(); it != lru_.end() && scanned < config_.similarity_scan_limit;) {
+            auto current = it++;
+            ++scanned;
+            if (current->epoch != epoch) {
+                erase(current);
+                stats_.invalidations++;
+                continue;
+            }
+            if (current->options_hash != options_hash || current->query.size() != query.size()) {
+                continue;
+            }
+            float score = similarity(query, current->query.view());
+            if (score >= best_similarity) {
+                best_similarity = score;
+                best = current;
+            }
+        }
+        if (best != lru_.end()) {
+            stats_.near_hits++;
+            return serve(best);
+        }
+    }
+
+    stats_.misses++;
+    return std::nullopt;
+}
+
+void QueryResultCache::insert(VectorView query, uint64_t options_hash, uint64_t epoch,
+                              const QueryResults& results, uint64_t latency_ns) {
+    Entry entry;
+    entry.codes = quantize(query);
+    entry.key = key_for(query, entry.codes, options_hash);
+    entry.options_hash = options_hash;
+    entry.epoch = epoch;
+    entry.query = Vector(std::vector<Scalar>(query.begin(), query.end()));
+    entry.results = results;
+    entry.latency_ns = latency_ns;
+
+    entry.bytes = sizeof(Entry) + entry.codes.size() + query.size() * sizeof(Scalar) +
+                  results.size() * sizeof(QueryResult);
+    for (const auto& result : results) {
+        if (result.metadata) entry.bytes += metadata_bytes(*result.metadata);
+    }
+    if (entry.bytes > config_.max_bytes) {
+        return;  // Would evict everything and still not fit
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Replace an existing entry for the same query
+    auto [first, last] = entries_.equal_range(entry.key);
+    for (auto found = first; found != last; ++found) {
+        if (found->second->options_hash == options_hash &&
+            same_query(*found->second, query, entry.codes)) {
+            erase(found->second);
+            break;
+        }
+    }
+
+    while (!lru_.empty() && bytes_ + entry.bytes > config_.max_bytes) {
+        erase(std::prev(lru_.end()));
+        stats_.evictions++;
+    }
+
+    bytes_ += entry.bytes;
+    uint64_t key = entry.key;
+    lru_.push_front(std::move(entry));
+    entries_.emplace(key, lru_.begin());
+}
+
+void QueryResultCache::erase(EntryList::iterator it) {
+    auto [first, last] = entries_.equal_range(it->key);
+    for (auto found = first; found != last; ++found) {
+        if (found->second == it) {
+            entries_.erase(found);
+            break;
+        }
+    }
+    bytes_ -= it->bytes;
+    lru_.erase(it);
+}
+
+void QueryResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    entries_.clear();
+    bytes_ = 0;
+}
+
+QueryCacheStats QueryResultCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    QueryCacheStats result = stats_;
+    result.entries = lru_.size();
+    result.bytes = bytes_;
+    return result;
+}
+
+} // namespace vdb
@@ -0,0 +1,272 @@
+// ============================================================================
+// VectorDB - Crash-Safe Checkpoint Implementation
+// Write-to-temp + fsync + rename, with CRC-32C verified footers
+// ============================================================================
+
+#include "vdb/checkpoint.hpp"
+#include <array>
+#include <cstring>
+#include <fstream>
+
+#if defined(__SSE4_2__)
+    #include <nmmintrin.h>
+#endif
+
+#ifdef VDB_PLATFORM_WINDOWS
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace vdb {
+
+// ============================================================================
+// CRC-32C
+// ============================================================================
+
+#if !defined(__SSE4_2__)
+namespace {
+
+constexpr uint32_t CRC32C_POLY = 0x82F63B78;  // Reflected Castagnoli polynomial
+
+constexpr std::array<uint32_t, 256> make_crc32c_table() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            c = (c & 1) ? (c >> 1) ^ CRC32C_POLY : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+constexpr auto CRC32C_TABLE = make_crc32c_table();
+
+}  // anonymous namespace
+#endif
+
+uint32_t crc32c(std::span<const uint8_t> data, uint32_t crc) {
+    const uint8_t* p = data.data();
+    size_t n = data.size();
+    crc = ~crc;
+
+#if defined(__SSE4_2__)
+    uint64_t crc64 = crc;
+    while (n >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        p += 8;
+        n -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+    while (n-- > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+#else
+    while (n-- > 0) {
+        crc = CRC32C_TABLE[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+#endif
+
+    return ~crc;
+}
+
+// ============================================================================
+// Atomic File Replacement
+// ============================================================================
+
+fs::path previous_checkpoint_path(const fs::path& path) {
+    fs::path prev = path;
+    prev += ".prev";
+    return prev;
+}
+
+namespace {
+
+fs::path temp_checkpoint_path(const fs::path& path) {
+    fs::path tmp = path;
+    tmp += ".tmp";
+    return tmp;
+}
+
+Error io_error(const std::string& what, const fs::path& path) {
+    return Error{ErrorCode::IoError, what + ": " + path.string()};
+}
+
+#ifdef VDB_PLATFORM_WINDOWS
+
+Result<void> write_durable(const fs::path& path, std::span<const std::span<const uint8_t>> parts) {
+    HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr,
+                                CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return std::unexpected(io_error("Failed to create file", path));
+    }
+
+    for (const auto& part : parts) {
+        size_t written = 0;
+        while (written < part.size()) {
+            DWORD chunk = static_cast<DWORD>(std::min<size_t>(part.size() - written, 1u << 30));
+            DWORD n = 0;
+            if (!WriteFile(handle, part.data() + written, chunk, &n, nullptr)) {
+                CloseHandle(handle);
+                return std::unexpected(io_error("Failed to write file", path));
+            }
+            written += n;
+        }
+    }
+
+    bool flushed = FlushFileBuffers(handle);
+    CloseHandle(handle);
+    if (!flushed) {
+        return std::unexpected(io_error("Failed to flush file", path));
+    }
+    return {};
+}
+
+void sync_directory(const fs::path&) {
+    // NTFS journals renames; there is no directory handle to flush
+}
+
+#else
+
+Result<void> write_durable(const fs::path& path, std::span<const std::span<const uint8_t>> parts) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return std::unexpected(io_error("Failed to create file", path));
+    }
+
+    for (const auto& part : parts) {
+        size_t written = 0;
+        while (written < part.size()) {
+            ssize_t n = ::write(fd, part.data() + written, part.size() - written);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                ::close(fd);
+                return std::unexpected(io_error("Failed to write file", path));
+            }
+            written += static_cast<size_t>(n);
+        }
+    }
+
+    if (::fsync(fd) != 0) {
+        ::close(fd);
+        return std::unexpected(io_error("Failed to fsync file", path));
+    }
+    ::close(fd);
+    return {};
+}
+
+void sync_directory(const fs::path& dir) {
+    // Make the rename itself durable
+    int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+#endif
+
+Result<void> replace_file(const fs::path& path,
+                          std::span<const std::span<const uint8_t>> parts,
+                          bool keep_previous) {
+    fs::path tmp = temp_checkpoint_path(path);
+
+    auto written = write_durable(tmp, parts);
+    if (!written) {
+        std::error_code ec;
+        fs::remove(tmp, ec);
+        return written;
+    }
+
+    std::error_code ec;
+    if (keep_previous && fs::exists(path, ec)) {
+        fs::rename(path, previous_checkpoint_path(path), ec);
+        if (ec) {
+            fs::remove(tmp, ec);
+            return std::unexpected(io_error("Failed to retain previous checkpoint", path));
+        }
+    }
+
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        return std::unexpected(io_error("Failed to rename checkpoint into place", path));
+    }
+
+    sync_directory(path.parent_path());
+    return {};
+}
+
+}  // anonymous namespace
+
+Result<void> write_file_atomic(const fs::path& path, std::span<const uint8_t> data,
+                               bool keep_previous) {
+    const std::span<const uint8_t> parts[] = {data};
+    return replace_file(path, parts, keep_previous);
+}
+
+Result<void> write_checkpoint(const fs::path& path, std::span<const uint8_t> payload) {
+    CheckpointFooter footer{};
+    footer.payload_size = payload.size();
+    footer.checksum = crc32c(payload);
+    footer.version = CheckpointFooter::CURRENT_VERSION;
+    footer.magic = CheckpointFooter::MAGIC;
+
+    const std::span<const uint8_t> parts[] = {
+        payload,
+        {reinterpret_cast<const uint8_t*>(&footer), sizeof(footer)}
+    };
+    return replace_file(path, parts, true);
+}
+
+// ============================================================================
+// Verified Read
+// ============================================================================
+
+Result<std::vector<uint8_t>> read_checkpoint(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return std::unexpected(Error{ErrorCode::IoError, "Failed to open file for reading"});
+    }
+
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+
+    std::vector<uint8_t> data(static_cast<size_t>(size));
+    if (!file.read(reinterpret_cast<char*>(data.data()), size)) {
+        return std::unexpected(io_error("Failed to read file", path));
+    }
+
+    if (data.size() < CheckpointFooter::SIZE) {
+        return data;  // Legacy file without footer
+    }
+
+    CheckpointFooter footer;
+    std::memcpy(&footer, data.data() + data.size() - CheckpointFooter::SIZE, sizeof(footer));
+    if (footer.magic != CheckpointFooter::MAGIC) {
+        return data;  // Legacy file without footer
+    }
+
+    if (footer.version != CheckpointFooter::CURRENT_VERSION ||
+        footer.payload_size != data.size() - CheckpointFooter::SIZE) {
+        return std::unexpected(Error{ErrorCode::IndexCorrupted,
+            "Checkpoint footer mismatch: " + path.string()});
+    }
+
+    data.resize(footer.payload_size);
+    if (crc32c(data) != footer.checksum) {
+        return std::unexpected(Error{ErrorCode::IndexCorrupted,
+            "Checkpoint checksum mismatch: " + path.string()});
+    }
+
+    return data;
+}
+
+} // namespace vdb
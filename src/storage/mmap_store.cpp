@@ -4,6 +4,8 @@
 // ============================================================================
 
 #include "vdb/storage.hpp"
+#include "vdb/checkpoint.hpp"
+#include "vdb/thread_pool.hpp"
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include <cstring>
@@ -21,12 +23,74 @@
     #include <sys/stat.h>
     #include <fcntl.h>
     #include <unistd.h>
+    #include <cerrno>
+#endif
+
+#ifdef HAVE_LIBURING
+    #include <liburing.h>
 #endif
 
 namespace vdb {
 
 using json = nlohmann::json;
 
+namespace {
+
+// Dedicated pool for blocking preads so I/O never starves compute workers.
+// Its threads mostly sleep in pread, so it is sized for I/O depth rather
+// than cores, and its tasks never wait on other pool work.
+ThreadPool& io_thread_pool() {
+    static ThreadPool pool(std::max<size_t>(8, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+#ifdef HAVE_LIBURING
+constexpr unsigned IO_URING_DEPTH = 256;
+
+struct RingHolder {
+    io_uring ring{};
+    bool ok = false;
+    RingHolder() { ok = io_uring_queue_init(IO_URING_DEPTH, &ring, 0) == 0; }
+    ~RingHolder() { if (ok) io_uring_queue_exit(&ring); }
+    
+    void reset() {
+        if (ok) io_uring_queue_exit(&ring);
+        ok = io_uring_queue_init(IO_URING_DEPTH, &ring, 0) == 0;
+    }
+};
+
+RingHolder& ring_holder() {
+    thread_local RingHolder holder;
+    return holder;
+}
+
+// One ring per thread, created on first use; null if the kernel refuses
+io_uring* thread_ring() {
+    RingHolder& holder = ring_holder();
+    return holder.ok ? &holder.ring : nullptr;
+}
+
+// Replace this thread's ring after a failure; SQEs that were queued but
+// never submitted are dropped with the old ring instead of being picked
+// up (with dangling destinations) by the next batch
+void reset_thread_ring() {
+    ring_holder().reset();
+}
+#endif
+
+#ifndef VDB_PLATFORM_WINDOWS
+int populate_flag(const MmapOptions& options) {
+#ifdef MAP_POPULATE
+    return options.populate ? MAP_POPULATE : 0;
+#else
+    (void)options;
+    return 0;
+#endif
+}
+#endif
+
+}  // anonymous namespace
+
 // ============================================================================
 // Memory-Mapped File - Platform-specific implementations
 // ============================================================================
@@ -41,6 +105,10 @@ MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept
     , capacity_(other.capacity_)
     , path_(std::move(other.path_))
     , writable_(other.writable_)
+    , options_(other.options_)
+    , locked_offset_(other.locked_offset_)
+    , locked_bytes_(other.locked_bytes_)
+    , prefetch_(std::move(other.prefetch_))
 #ifdef VDB_PLATFORM_WINDOWS
     , file_handle_(other.file_handle_)
     , mapping_handle_(other.mapping_handle_)
@@ -52,6 +120,7 @@ MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept
     other.size_ = 0;
     other.capacity_ = 0;
     other.writable_ = false;
+    other.locked_bytes_ = 0;
 #ifdef VDB_PLATFORM_WINDOWS
     other.file_handle_ = INVALID_HANDLE_VALUE;
     other.mapping_handle_ = nullptr;
@@ -68,6 +137,10 @@ MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept
         capacity_ = other.capacity_;
         path_ = std::move(other.path_);
         writable_ = other.writable_;
+        options_ = other.options_;
+        locked_offset_ = other.locked_offset_;
+        locked_bytes_ = other.locked_bytes_;
+        prefetch_ = std::move(other.prefetch_);
 #ifdef VDB_PLATFORM_WINDOWS
         file_handle_ = other.file_handle_;
         mapping_handle_ = other.mapping_handle_;
@@ -81,6 +154,7 @@ MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept
         other.size_ = 0;
         other.capacity_ = 0;
         other.writable_ = false;
+        other.locked_bytes_ = 0;
     }
     return *this;
 }
@@ -88,6 +162,10 @@ MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept
 void MemoryMappedFile::unmap() {
     if (data_ == nullptr) return;
     
+    // The warmup thread reads through the mapping
+    wait_prefetch();
+    locked_bytes_ = 0;  // Unmapping releases page locks
+    
 #ifdef VDB_PLATFORM_WINDOWS
     FlushViewOfFile(data_, 0);
     UnmapViewOfFile(data_);
@@ -122,10 +200,11 @@ void MemoryMappedFile::close() {
     capacity_ = 0;
 }
 
-Result<void> MemoryMappedFile::open_read(const fs::path& path) {
+Result<void> MemoryMappedFile::open_read(const fs::path& path, const MmapOptions& options) {
     close();
     path_ = path;
     writable_ = false;
+    options_ = options;
     
     if (!fs::exists(path)) {
         return std::unexpected(Error{ErrorCode::IoError, "File does not exist: " + path.string()});
@@ -190,7 +269,7 @@ Result<void> MemoryMappedFile::open_read(const fs::path& path) {
         nullptr,
         size_,
         PROT_READ,
-        MAP_PRIVATE,
+        MAP_PRIVATE | populate_flag(options_),
         fd_,
         0
     ));
@@ -201,18 +280,20 @@ Result<void> MemoryMappedFile::open_read(const fs::path& path) {
         fd_ = -1;
         return std::unexpected(Error{ErrorCode::IoError, "Failed to mmap file"});
     }
-    
-    // Advise kernel for sequential access
-    madvise(data_, size_, MADV_SEQUENTIAL);
 #endif
     
+    apply_options();
+    if (options_.prefetch) {
+        prefetch_async();
+    }
     return {};
 }
 
-Result<void> MemoryMappedFile::open_readwrite(const fs::path& path) {
+Result<void> MemoryMappedFile::open_readwrite(const fs::path& path, const MmapOptions& options) {
     close();
     path_ = path;
     writable_ = true;
+    options_ = options;
     
     if (!fs::exists(path)) {
         return std::unexpected(Error{ErrorCode::IoError, "File does not exist: " + path.string()});
@@ -277,7 +358,7 @@ Result<void> MemoryMappedFile::open_readwrite(const fs::path& path) {
         nullptr,
         size_,
         PROT_READ | PROT_WRITE,
-        MAP_SHARED,
+        MAP_SHARED | populate_flag(options_),
         fd_,
         0
     ));
@@ -288,17 +369,21 @@ Result<void> MemoryMappedFile::open_readwrite(const fs::path& path) {
         fd_ = -1;
         return std::unexpected(Error{ErrorCode::IoError, "Failed to mmap file for read-write"});
     }
-    
-    madvise(data_, size_, MADV_SEQUENTIAL);
 #endif
     
+    apply_options();
+    if (options_.prefetch) {
+        prefetch_async();
+    }
     return {};
 }
 
-Result<void> MemoryMappedFile::open_write(const fs::path& path, size_t initial_size) {
+Result<void> MemoryMappedFile::open_write(const fs::path& path, size_t initial_size,
+                                          const MmapOptions& options) {
     close();
     path_ = path;
     writable_ = true;
+    options_ = options;
     capacity_ = initial_size;
     size_ = initial_size;  // FIX: Set size to match capacity for newly created files
     
@@ -377,7 +462,7 @@ Result<void> MemoryMappedFile::open_write(const fs::path& path, size_t initial_s
         nullptr,
         initial_size,
         PROT_READ | PROT_WRITE,
-        MAP_SHARED,
+        MAP_SHARED | populate_flag(options_),
         fd_,
         0
     ));
@@ -390,6 +475,7 @@ Result<void> MemoryMappedFile::open_write(const fs::path& path, size_t initial_s
     }
 #endif
     
+    apply_options();
     return {};
 }
 
@@ -406,6 +492,9 @@ Result<void> MemoryMappedFile::resize(size_t new_size) {
     constexpr size_t page_size = 4096;
     new_size = (new_size + page_size - 1) & ~(page_size - 1);
     
+    // Remapping invalidates the region a warmup may still be reading
+    wait_prefetch();
+    
 #ifdef VDB_PLATFORM_WINDOWS
     // Unmap current view
     FlushViewOfFile(data_, 0);
@@ -458,7 +547,7 @@ Result<void> MemoryMappedFile::resize(size_t new_size) {
         nullptr,
         new_size,
         PROT_READ | PROT_WRITE,
-        MAP_SHARED,
+        MAP_SHARED | populate_flag(options_),
         fd_,
         0
     ));
@@ -474,6 +563,10 @@ Result<void> MemoryMappedFile::resize(size_t new_size) {
     // Without this, all subsequent bounds checks in get_slot_ptr() would fail
     // because they compare against size(), causing "Failed to get slot pointer" errors
     size_ = new_size;
+    
+    // Advice and page locks do not survive a remap
+    locked_bytes_ = 0;
+    apply_options();
     return {};
 }
 
@@ -498,6 +591,329 @@ Result<void> MemoryMappedFile::sync() {
     return {};
 }
 
+Result<void> MemoryMappedFile::read_at(size_t offset, void* dest, size_t length) const {
+    if (offset > size_ || length > size_ - offset) {
+        return std::unexpected(Error{ErrorCode::IoError, "Read beyond end of file"});
+    }
+    
+    auto* out = static_cast<uint8_t*>(dest);
+    size_t done = 0;
+    
+#ifdef VDB_PLATFORM_WINDOWS
+    while (done < length) {
+        OVERLAPPED overlapped{};
+        uint64_t pos = offset + done;
+        overlapped.Offset = static_cast<DWORD>(pos & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(pos >> 32);
+        DWORD n = 0;
+        if (!ReadFile(file_handle_, out + done, static_cast<DWORD>(length - done), &n, &overlapped) || n == 0) {
+            return std::unexpected(Error{ErrorCode::IoError, "ReadFile failed"});
+        }
+        done += n;
+    }
+#else
+    while (done < length) {
+        ssize_t n = pread(fd_, out + done, length - done, static_cast<off_t>(offset + done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            return std::unexpected(Error{ErrorCode::IoError, "pread failed"});
+        }
+        done += static_cast<size_t>(n);
+    }
+#endif
+    
+    return {};
+}
+
+Result<void> MemoryMappedFile::read_many(
+    std::span<const ReadRequest> requests,
+    const std::function<void(size_t)>& on_complete
+) const {
+    if (requests.empty()) {
+        return {};
+    }
+    
+    bool failed = false;
+    size_t first = 0;  // requests below this index were served by io_uring
+    
+#ifdef HAVE_LIBURING
+    if (io_uring* ring = thread_ring(); ring != nullptr && fd_ >= 0) {
+        // Every SQE the kernel accepted is reaped before leaving: the
+        // destinations belong to the caller, and a leftover CQE would be
+        // misattributed by the next batch on this thread's ring. The ring
+        // consumes SQEs in order, so [submitted, next) are queued but not
+        // yet handed to the kernel.
+        size_t next = 0;
+        size_t submitted = 0;
+        size_t reaped = 0;
+        bool ring_failed = false;
+        
+        while (reaped < submitted || (!ring_failed && next < requests.size())) {
+            if (!ring_failed) {
+                // Queue as many reads as the ring has room for
+                while (next < requests.size()) {
+                    io_uring_sqe* sqe = io_uring_get_sqe(ring);
+                    if (sqe == nullptr) break;
+                    
+                    const ReadRequest& req = requests[next];
+                    io_uring_prep_read(sqe, fd_, req.dest, static_cast<unsigned>(req.length), req.offset);
+                    sqe->user_data = next;
+                    ++next;
+                }
+                
+                if (submitted < next) {
+                    int ret;
+                    do {
+                        ret = io_uring_submit(ring);
+                    } while (ret == -EINTR);
+                    
+                    if (ret > 0) {
+                        submitted += static_cast<size_t>(ret);
+                    } else if (reaped == submitted || (ret < 0 && ret != -EAGAIN && ret != -EBUSY)) {
+                        // EAGAIN/EBUSY with reads in flight clear up once
+                        // those are reaped; anything else ends the ring path
+                        ring_failed = true;
+                    }
+                }
+            }
+            
+            if (reaped == submitted) {
+                continue;
+            }
+            
+            io_uring_cqe* cqe = nullptr;
+            int ret;
+            do {
+                ret = io_uring_wait_cqe(ring, &cqe);
+            } while (ret == -EINTR);
+            if (ret < 0) {
+                if (ring_failed) {
+                    // Cannot even drain; tearing the ring down is the only
+                    // way left to have the kernel cancel what it holds
+                    break;
+                }
+                ring_failed = true;
+                continue;
+            }
+            
+            unsigned head;
+            unsigned seen = 0;
+            io_uring_for_each_cqe(ring, head, cqe) {
+                size_t index = static_cast<size_t>(cqe->user_data);
+                const ReadRequest& req = requests[index];
+                
+                // Short reads are rare (EOF races); finish them synchronously
+                bool ok = cqe->res == static_cast<int>(req.length) ||
+                          (cqe->res >= 0 && read_at(req.offset, req.dest, req.length).has_value());
+                if (ok) {
+                    on_complete(index);
+                } else {
+                    failed = true;
+                }
+                ++seen;
+            }
+            io_uring_cq_advance(ring, seen);
+            reaped += seen;
+        }
+        
+        if (!ring_failed) {
+            if (failed) {
+                return std::unexpected(Error{ErrorCode::IoError, "One or more batched reads failed"});
+            }
+            return {};
+        }
+        
+        reset_thread_ring();
+        if (reaped < submitted) {
+            return std::unexpected(Error{ErrorCode::IoError, "io_uring batch could not be drained"});
+        }
+        first = submitted;
+    }
+#endif
+    
+    // Fallback: blocking preads on the I/O pool, completions handed back here
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    std::vector<size_t> done;
+    size_t failures = 0;
+    
+    for (size_t i = first; i < requests.size(); ++i) {
+        (void)io_thread_pool().submit([&, i] {
+            const ReadRequest& req = requests[i];
+            bool ok = read_at(req.offset, req.dest, req.length).has_value();
+            // Notify under the lock: the waiter may return (destroying the
+            // condition variable) as soon as it sees the last completion
+            std::lock_guard<std::mutex> guard(done_mutex);
+            if (ok) {
+                done.push_back(i);
+            } else {
+                failures++;
+            }
+            done_cv.notify_one();
+        });
+    }
+    
+    std::vector<size_t> ready;
+    size_t handled = first;
+    while (handled < requests.size()) {
+        {
+            std::unique_lock<std::mutex> guard(done_mutex);
+            done_cv.wait(guard, [&] { return !done.empty() || handled + failures == requests.size(); });
+            ready.swap(done);
+            handled += failures;
+            failed = failed || failures > 0;
+            failures = 0;
+        }
+        
+        for (size_t index : ready) {
+            on_complete(index);
+        }
+        handled += ready.size();
+        ready.clear();
+    }
+    
+    if (failed) {
+        return std::unexpected(Error{ErrorCode::IoError, "One or more batched reads failed"});
+    }
+    return {};
+}
+
+// ============================================================================
+// Memory-Mapped File - Paging controls
+// ============================================================================
+
+void MemoryMappedFile::apply_options() {
+    if (data_ == nullptr) return;
+    
+    (void)advise(options_.access);
+    
+#if !defined(VDB_PLATFORM_WINDOWS) && defined(MADV_HUGEPAGE)
+    // Only shmem/tmpfs-backed files get huge pages; for regular files the
+    // kernel accepts the advice on a MAP_SHARED mapping and ignores it
+    if (options_.huge_pages) {
+        madvise(data_, capacity_, MADV_HUGEPAGE);
+    }
+#endif
+    
+    if (options_.lock_bytes > 0) {
+        // Best effort: RLIMIT_MEMLOCK commonly forbids large locks
+        (void)lock(0, options_.lock_bytes);
+    }
+}
+
+Result<void> MemoryMappedFile::advise(MmapAccessPattern pattern) {
+    if (data_ == nullptr) {
+        return {};
+    }
+    
+#ifndef VDB_PLATFORM_WINDOWS
+    int advice = MADV_NORMAL;
+    switch (pattern) {
+        case MmapAccessPattern::Normal:     advice = MADV_NORMAL; break;
+        case MmapAccessPattern::Random:     advice = MADV_RANDOM; break;
+        case MmapAccessPattern::Sequential: advice = MADV_SEQUENTIAL; break;
+    }
+    if (madvise(data_, capacity_, advice) != 0) {
+        return std::unexpected(Error{ErrorCode::IoError, "madvise failed"});
+    }
+#else
+    (void)pattern;  // No equivalent hint for mapped views
+#endif
+    
+    options_.access = pattern;
+    return {};
+}
+
+Result<void> MemoryMappedFile::lock(size_t offset, size_t length) {
+    if (data_ == nullptr || offset >= size_) {
+        return std::unexpected(Error{ErrorCode::InvalidState, "Lock range outside mapping"});
+    }
+    
+    length = std::min(length, size_ - offset);
+    
+    // Pin the new range first so a failed lock keeps the old one pinned
+#ifdef VDB_PLATFORM_WINDOWS
+    if (!VirtualLock(data_ + offset, length)) {
+        return std::unexpected(Error{ErrorCode::IoError, "VirtualLock failed"});
+    }
+#else
+    if (mlock(data_ + offset, length) != 0) {
+        return std::unexpected(Error{ErrorCode::IoError, "mlock failed (check RLIMIT_MEMLOCK)"});
+    }
+#endif
+    
+    // Page locks don't nest: release only the old pages outside the new range
+    if (locked_bytes_ > 0) {
+        constexpr size_t page_size = 4096;
+        size_t begin = offset & ~(page_size - 1);
+        size_t end = (offset + length + page_size - 1) & ~(page_size - 1);
+        size_t old_end = locked_offset_ + locked_bytes_;
+        if (locked_offset_ < begin) {
+            unlock_range(locked_offset_, std::min(old_end, begin) - locked_offset_);
+        }
+        if (old_end > end) {
+            size_t from = std::max(locked_offset_, end);
+            unlock_range(from, old_end - from);
+        }
+    }
+    
+    locked_offset_ = offset;
+    locked_bytes_ = length;
+    return {};
+}
+
+void MemoryMappedFile::unlock() {
+    if (data_ == nullptr || locked_bytes_ == 0) return;
+    
+    unlock_range(locked_offset_, locked_bytes_);
+    locked_bytes_ = 0;
+}
+
+void MemoryMappedFile::unlock_range(size_t offset, size_t length) {
+#ifdef VDB_PLATFORM_WINDOWS
+    VirtualUnlock(data_ + offset, length);
+#else
+    munlock(data_ + offset, length);
+#endif
+}
+
+void MemoryMappedFile::prefetch_async(size_t offset, size_t length) {
+    if (data_ == nullptr || offset >= size_) return;
+    
+    wait_prefetch();
+    length = std::min(length, size_ - offset);
+    
+    // Align the start down to a page boundary as madvise requires
+    constexpr size_t page_size = 4096;
+    size_t aligned = offset & ~(page_size - 1);
+    const uint8_t* base = data_ + aligned;
+    size_t span = length + (offset - aligned);
+    
+    prefetch_ = std::async(std::launch::async, [base, span] {
+#ifndef VDB_PLATFORM_WINDOWS
+        madvise(const_cast<uint8_t*>(base), span, MADV_WILLNEED);
+#endif
+        // Touch one byte per page so the range is resident, not just queued
+        uint8_t sink = 0;
+        for (size_t i = 0; i < span; i += page_size) {
+            sink ^= *static_cast<const volatile uint8_t*>(base + i);
+        }
+        (void)sink;
+    });
+}
+
+void MemoryMappedFile::wait_prefetch() {
+    if (prefetch_.valid()) {
+        prefetch_.wait();
+        prefetch_ = {};
+    }
+}
+
+bool MemoryMappedFile::prefetch_pending() const {
+    return prefetch_.valid() &&
+           prefetch_.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
 // ============================================================================
 // Vector Store - Memory-mapped vector storage with slot management
 // ============================================================================
@@ -524,7 +940,13 @@ static_assert(sizeof(VectorFileHeader) == VectorFileHeader::SIZE,
 VectorStore::VectorStore(const VectorStoreConfig& config)
     : config_(config)
     , vector_size_bytes_(config.dimension * sizeof(Scalar))
-{}
+{
+    if (config.hot_budget_bytes > 0 || config.cold_cache_bytes > 0) {
+        tier_cache_ = std::make_unique<TieredVectorCache>(
+            config.dimension, config.hot_budget_bytes,
+            config.cold_cache_bytes, config.promote_threshold);
+    }
+}
 
 VectorStore::~VectorStore() {
     sync();
@@ -537,6 +959,7 @@ VectorStore::VectorStore(VectorStore&& other) noexcept
     , free_slots_(std::move(other.free_slots_))
     , capacity_(other.capacity_)
     , vector_size_bytes_(other.vector_size_bytes_)
+    , tier_cache_(std::move(other.tier_cache_))
 {
     other.capacity_ = 0;
 }
@@ -550,6 +973,7 @@ VectorStore& VectorStore::operator=(VectorStore&& other) noexcept {
         free_slots_ = std::move(other.free_slots_);
         capacity_ = other.capacity_;
         vector_size_bytes_ = other.vector_size_bytes_;
+        tier_cache_ = std::move(other.tier_cache_);
         other.capacity_ = 0;
     }
     return *this;
@@ -566,7 +990,7 @@ Result<void> VectorStore::init() {
         // calls init() internally (creating files with open_write), then if the
         // user calls init() again, it finds existing files and used to reopen
         // them read-only.
-        auto result = vectors_file_.open_readwrite(vectors_path);
+        auto result = vectors_file_.open_readwrite(vectors_path, config_.mmap);
         if (!result) return std::unexpected(result.error());
         
         // Validate header
@@ -604,7 +1028,7 @@ Result<void> VectorStore::init() {
         capacity_ = config_.initial_capacity;
         size_t initial_file_size = VectorFileHeader::SIZE + capacity_ * vector_size_bytes_;
         
-        auto result = vectors_file_.open_write(vectors_path, initial_file_size);
+        auto result = vectors_file_.open_write(vectors_path, initial_file_size, config_.mmap);
         if (!result) return std::unexpected(result.error());
         
         // Write header - CRITICAL: Null check before dereferencing
@@ -758,6 +1182,98 @@ std::optional<VectorView> VectorStore::get(VectorId id) const {
     return VectorView(data, config_.dimension);
 }
 
+bool VectorStore::read(VectorId id, std::span<Scalar> out) const {
+    if (out.size() < config_.dimension) {
+        return false;
+    }
+    
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    
+    auto it = id_to_offset_.find(id);
+    if (it == id_to_offset_.end()) {
+        return false;
+    }
+    
+    if (!tier_cache_) {
+        const Scalar* data = get_slot_ptr(it->second);
+        if (data == nullptr) {
+            return false;
+        }
+        std::memcpy(out.data(), data, vector_size_bytes_);
+        return true;
+    }
+    
+    if (tier_cache_->lookup(id, out)) {
+        return true;
+    }
+    
+    // Cold read: explicit pread keeps cold data out of the mapped working set
+    size_t offset = VectorFileHeader::SIZE + it->second * vector_size_bytes_;
+    if (!vectors_file_.read_at(offset, out.data(), vector_size_bytes_)) {
+        return false;
+    }
+    tier_cache_->insert(id, out.first(config_.dimension));
+    return true;
+}
+
+Result<size_t> VectorStore::get_many(
+    std::span<const VectorId> ids,
+    const FetchCallback& callback
+) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    
+    const Dim dim = config_.dimension;
+    std::vector<Scalar> scratch(tier_cache_ ? dim : 0);
+    std::vector<VectorId> pending_ids;
+    std::vector<size_t> pending_offsets;
+    size_t delivered = 0;
+    
+    for (VectorId id : ids) {
+        auto it = id_to_offset_.find(id);
+        if (it == id_to_offset_.end()) {
+            continue;
+        }
+        
+        // Cached vectors are handed out before any I/O is issued
+        if (tier_cache_ && tier_cache_->lookup(id, scratch)) {
+            callback(id, VectorView(scratch.data(), dim));
+            delivered++;
+            continue;
+        }
+        
+        pending_ids.push_back(id);
+        pending_offsets.push_back(VectorFileHeader::SIZE + it->second * vector_size_bytes_);
+    }
+    
+    if (pending_ids.empty()) {
+        return delivered;
+    }
+    
+    std::vector<Scalar> buffer(pending_ids.size() * dim);
+    std::vector<ReadRequest> requests(pending_ids.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i] = ReadRequest{pending_offsets[i], vector_size_bytes_, buffer.data() + i * dim};
+    }
+    
+    auto result = vectors_file_.read_many(requests, [&](size_t i) {
+        std::span<const Scalar> data(buffer.data() + i * dim, dim);
+        if (tier_cache_) {
+            tier_cache_->insert(pending_ids[i], data);
+        }
+        callback(pending_ids[i], VectorView(data.data(), dim));
+        delivered++;
+    });
+    
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+    return delivered;
+}
+
+TierStats VectorStore::tier_stats() const {
+    return tier_cache_ ? tier_cache_->stats() : TierStats{};
+}
+
 bool VectorStore::contains(VectorId id) const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
     return id_to_offset_.contains(id);
@@ -773,6 +1289,9 @@ Result<void> VectorStore::remove(VectorId id) {
     
     // Add slot to free list
     free_slots_.push_back(it->second);
+    if (tier_cache_) {
+        tier_cache_->erase(id);
+    }
     
     // Remove from index
     id_to_offset_.erase(it);
@@ -798,6 +1317,8 @@ std::vector<VectorId> VectorStore::all_ids() const {
 }
 
 Result<void> VectorStore::sync() {
+    // Excludes a concurrent resize remapping the file mid-msync
+    std::shared_lock<std::shared_mutex> lock(mutex_);
     return vectors_file_.sync();
 }
 
@@ -842,16 +1363,51 @@ Result<void> VectorStore::compact() {
     return {};
 }
 
+void VectorStore::warmup() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    // A pass already in flight covers the file; starting another would
+    // wait for it here, stalling every reader behind the unique lock
+    if (vectors_file_.prefetch_pending()) return;
+    vectors_file_.prefetch_async();
+}
+
 size_t VectorStore::memory_usage() const {
     size_t index_memory = id_to_offset_.size() * (sizeof(VectorId) + sizeof(size_t));
     size_t file_memory = capacity_ * vector_size_bytes_;
-    return index_memory + file_memory;
+    size_t tier_memory = tier_cache_ ? tier_cache_->memory_usage() : 0;
+    return index_memory + file_memory + tier_memory;
 }
 
 // ============================================================================
 // Metadata Store
 // ============================================================================
 
+namespace {
+
+json metadata_to_json(const Metadata& meta) {
+    json j;
+    j["id"] = meta.id;
+    j["type"] = static_cast<int>(meta.type);
+    j["date"] = meta.date;
+    j["source_file"] = meta.source_file;
+    j["asset"] = meta.asset;
+    j["bias"] = meta.bias;
+    
+    if (meta.gold_price) j["gold_price"] = *meta.gold_price;
+    if (meta.silver_price) j["silver_price"] = *meta.silver_price;
+    if (meta.gsr) j["gsr"] = *meta.gsr;
+    if (meta.dxy) j["dxy"] = *meta.dxy;
+    if (meta.vix) j["vix"] = *meta.vix;
+    if (meta.yield_10y) j["yield_10y"] = *meta.yield_10y;
+    
+    j["content_hash"] = meta.content_hash;
+    j["created_at"] = meta.created_at;
+    j["updated_at"] = meta.updated_at;
+    return j;
+}
+
+}  // anonymous namespace
+
 MetadataStore::MetadataStore(const fs::path& path)
     : path_(path)
 {}
@@ -910,12 +1466,17 @@ Result<void> MetadataStore::load() {
 Result<void> MetadataStore::add(const Metadata& meta) {
     metadata_[meta.id] = meta;
     dirty_ = true;
+    ++generation_;
+    if (syncing_) {
+        appended_.push_back(meta.id);
+    }
     return append_to_file(meta);
 }
 
 Result<void> MetadataStore::update(const Metadata& meta) {
     metadata_[meta.id] = meta;
     dirty_ = true;
+    ++generation_;
     // Full rewrite on sync
     return {};
 }
@@ -970,42 +1531,66 @@ std::vector<Metadata> MetadataStore::find_by_asset(std::string_view asset) const
 Result<void> MetadataStore::remove(VectorId id) {
     metadata_.erase(id);
     dirty_ = true;
+    ++generation_;
     return {};
 }
 
 Result<void> MetadataStore::sync() {
-    if (!dirty_) return {};
-    
-    // Rewrite entire file
-    std::ofstream file(path_);
-    if (!file) {
-        return std::unexpected(Error{ErrorCode::IoError, "Failed to open metadata file for writing"});
+    auto snapshot = snapshot_for_sync();
+    auto written = write_snapshot(snapshot);
+    auto finished = finish_sync(snapshot, written.has_value());
+    return written ? finished : written;
+}
+
+MetadataStore::SyncSnapshot MetadataStore::snapshot_for_sync() {
+    SyncSnapshot snapshot;
+    snapshot.generation = generation_;
+    snapshot.dirty = dirty_;
+    if (!dirty_) {
+        return snapshot;
     }
     
     for (const auto& [_, meta] : metadata_) {
-        json j;
-        j["id"] = meta.id;
-        j["type"] = static_cast<int>(meta.type);
-        j["date"] = meta.date;
-        j["source_file"] = meta.source_file;
-        j["asset"] = meta.asset;
-        j["bias"] = meta.bias;
-        
-        if (meta.gold_price) j["gold_price"] = *meta.gold_price;
-        if (meta.silver_price) j["silver_price"] = *meta.silver_price;
-        if (meta.gsr) j["gsr"] = *meta.gsr;
-        if (meta.dxy) j["dxy"] = *meta.dxy;
-        if (meta.vix) j["vix"] = *meta.vix;
-        if (meta.yield_10y) j["yield_10y"] = *meta.yield_10y;
-        
-        j["content_hash"] = meta.content_hash;
-        j["created_at"] = meta.created_at;
-        j["updated_at"] = meta.updated_at;
-        
-        file << j.dump() << "\n";
+        snapshot.bytes += metadata_to_json(meta).dump();
+        snapshot.bytes += '\n';
+    }
+    syncing_ = true;
+    appended_.clear();
+    return snapshot;
+}
+
+Result<void> MetadataStore::write_snapshot(const SyncSnapshot& snapshot) const {
+    if (!snapshot.dirty) {
+        return {};
     }
+    // Rewrite entire file to a temp copy and atomically swap it in
+    return write_file_atomic(path_, std::span<const uint8_t>(
+        reinterpret_cast<const uint8_t*>(snapshot.bytes.data()), snapshot.bytes.size()));
+}
+
+Result<void> MetadataStore::finish_sync(const SyncSnapshot& snapshot, bool written) {
+    syncing_ = false;
+    std::vector<VectorId> appended = std::move(appended_);
+    appended_.clear();
+    if (!snapshot.dirty || !written) {
+        // The old file, with any appends, is still in place
+        return {};
+    }
+    
+    // The append stream still refers to the replaced file
+    if (append_stream_.is_open()) {
+        append_stream_.close();
+    }
+    dirty_ = generation_ != snapshot.generation;
     
-    dirty_ = false;
+    for (VectorId id : appended) {
+        auto it = metadata_.find(id);
+        if (it == metadata_.end()) continue;
+        if (auto result = append_to_file(it->second); !result) {
+            dirty_ = true;
+            return result;
+        }
+    }
     return {};
 }
 
@@ -1018,23 +1603,7 @@ Result<void> MetadataStore::append_to_file(const Metadata& meta) {
         return std::unexpected(Error{ErrorCode::IoError, "Failed to open metadata file for append"});
     }
     
-    json j;
-    j["id"] = meta.id;
-    j["type"] = static_cast<int>(meta.type);
-    j["date"] = meta.date;
-    j["source_file"] = meta.source_file;
-    j["asset"] = meta.asset;
-    j["bias"] = meta.bias;
-    
-    if (meta.gold_price) j["gold_price"] = *meta.gold_price;
-    if (meta.silver_price) j["silver_price"] = *meta.silver_price;
-    if (meta.gsr) j["gsr"] = *meta.gsr;
-    
-    j["content_hash"] = meta.content_hash;
-    j["created_at"] = meta.created_at;
-    j["updated_at"] = meta.updated_at;
-    
-    append_stream_ << j.dump() << "\n";
+    append_stream_ << metadata_to_json(meta).dump() << "\n";
     append_stream_.flush();
     
     return {};
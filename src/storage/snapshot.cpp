@@ -0,0 +1,193 @@
+// ============================================================================
+// VectorDB - Copy-on-Write Snapshot Implementation
+// ============================================================================
+
+#include "vdb/snapshot.hpp"
+#include "vdb/distance.hpp"
+#include <algorithm>
+#include <fstream>
+#include <queue>
+#include <nlohmann/json.hpp>
+
+namespace vdb {
+
+using json = nlohmann::json;
+
+// ============================================================================
+// CowRecordTable
+// ============================================================================
+
+CowRecordTable::Page& CowRecordTable::writable_page(size_t page_index) {
+    if (page_index >= pages_.size()) {
+        pages_.resize(page_index + 1);
+    }
+
+    auto& page = pages_[page_index];
+    if (!page) {
+        page = std::make_shared<Page>();
+    } else if (page.use_count() > 1) {
+        // Shared with a snapshot: copy before mutating
+        page = std::make_shared<Page>(*page);
+    }
+    return *page;
+}
+
+void CowRecordTable::put(VectorId id, SnapshotRecord record) {
+    auto& slot = writable_page(id / RECORDS_PER_PAGE)[id % RECORDS_PER_PAGE];
+    if (slot.empty() && !record.empty()) {
+        count_++;
+    } else if (!slot.empty() && record.empty()) {
+        count_--;
+    }
+    slot = std::move(record);
+}
+
+void CowRecordTable::erase(VectorId id) {
+    if (find(id) == nullptr) {
+        return;
+    }
+    put(id, SnapshotRecord{});
+}
+
+const SnapshotRecord* CowRecordTable::find(VectorId id) const {
+    size_t page_index = id / RECORDS_PER_PAGE;
+    if (page_index >= pages_.size() || !pages_[page_index]) {
+        return nullptr;
+    }
+
+    const auto& slot = (*pages_[page_index])[id % RECORDS_PER_PAGE];
+    return slot.empty() ? nullptr : &slot;
+}
+
+void CowRecordTable::for_each(
+    const std::function<void(VectorId, const SnapshotRecord&)>& fn
+) const {
+    for (size_t p = 0; p < pages_.size(); ++p) {
+        if (!pages_[p]) continue;
+
+        const Page& page = *pages_[p];
+        for (size_t i = 0; i < RECORDS_PER_PAGE; ++i) {
+            if (!page[i].empty()) {
+                fn(static_cast<VectorId>(p * RECORDS_PER_PAGE + i), page[i]);
+            }
+        }
+    }
+}
+
+void CowRecordTable::clear() {
+    pages_.clear();
+    count_ = 0;
+}
+
+// ============================================================================
+// DatabaseSnapshot
+// ============================================================================
+
+DatabaseSnapshot::DatabaseSnapshot(CowRecordTable records, uint64_t epoch,
+                                   Dim dimension, DistanceMetric metric)
+    : records_(std::move(records))
+    , epoch_(epoch)
+    , created_at_(now_timestamp())
+    , dimension_(dimension)
+    , metric_(metric)
+{}
+
+std::vector<VectorId> DatabaseSnapshot::ids() const {
+    std::vector<VectorId> result;
+    result.reserve(records_.size());
+    records_.for_each([&result](VectorId id, const SnapshotRecord&) {
+        result.push_back(id);
+    });
+    return result;
+}
+
+std::optional<Metadata> DatabaseSnapshot::get_metadata(VectorId id) const {
+    const SnapshotRecord* record = records_.find(id);
+    if (record == nullptr) {
+        return std::nullopt;
+    }
+    return *record->metadata;
+}
+
+std::optional<VectorView> DatabaseSnapshot::get_vector(VectorId id) const {
+    const SnapshotRecord* record = records_.find(id);
+    if (record == nullptr || !record->vector) {
+        return std::nullopt;
+    }
+    return VectorView(record->vector.get(), dimension_);
+}
+
+void DatabaseSnapshot::for_each(
+    const std::function<void(const Metadata&, VectorView)>& fn
+) const {
+    records_.for_each([this, &fn](VectorId, const SnapshotRecord& record) {
+        VectorView view = record.vector
+            ? VectorView(record.vector.get(), dimension_)
+            : VectorView();
+        fn(*record.metadata, view);
+    });
+}
+
+SearchResults DatabaseSnapshot::search(VectorView query, size_t k) const {
+    if (query.dim() != dimension_ || k == 0) {
+        return {};
+    }
+
+    // Max-heap of the k best so far
+    std::priority_queue<std::pair<Distance, VectorId>> heap;
+
+    records_.for_each([&](VectorId id, const SnapshotRecord& record) {
+        if (!record.vector) return;
+
+        Distance dist = compute_distance(query, VectorView(record.vector.get(), dimension_), metric_);
+        if (heap.size() < k) {
+            heap.emplace(dist, id);
+        } else if (dist < heap.top().first) {
+            heap.pop();
+            heap.emplace(dist, id);
+        }
+    });
+
+    SearchResults results(heap.size());
+    for (size_t i = results.size(); i-- > 0;) {
+        auto [dist, id] = heap.top();
+        heap.pop();
+        results[i] = {id, dist, 1.0f - dist};
+    }
+    return results;
+}
+
+Result<void> DatabaseSnapshot::export_training_data(const fs::path& output_path) const {
+    std::ofstream file(output_path);
+    if (!file) {
+        return std::unexpected(Error{ErrorCode::IoError, "Failed to create output file"});
+    }
+
+    records_.for_each([&file](VectorId, const SnapshotRecord& record) {
+        const Metadata& meta = *record.metadata;
+
+        json entry;
+        entry["id"] = meta.id;
+        entry["type"] = std::string(document_type_name(meta.type));
+        entry["date"] = meta.date;
+        entry["source"] = meta.source_file;
+        entry["asset"] = meta.asset;
+        entry["bias"] = meta.bias;
+
+        if (meta.gold_price) entry["gold_price"] = *meta.gold_price;
+        if (meta.silver_price) entry["silver_price"] = *meta.silver_price;
+        if (meta.gsr) entry["gsr"] = *meta.gsr;
+        if (meta.dxy) entry["dxy"] = *meta.dxy;
+        if (meta.vix) entry["vix"] = *meta.vix;
+        if (meta.yield_10y) entry["yield_10y"] = *meta.yield_10y;
+
+        file << entry.dump() << "\n";
+    });
+
+    if (!file) {
+        return std::unexpected(Error{ErrorCode::IoError, "Failed to write output file"});
+    }
+    return {};
+}
+
+} // namespace vdb
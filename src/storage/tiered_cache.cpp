@@ -0,0 +1,184 @@
+// ============================================================================
+// VectorDB - Tiered Vector Cache Implementation
+// Segmented LRU: cold probation segment + hot protected arena
+// ============================================================================
+
+#include "vdb/storage.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace vdb {
+
+TieredVectorCache::TieredVectorCache(Dim dimension, size_t hot_budget_bytes,
+                                     size_t cold_budget_bytes, uint32_t promote_threshold)
+    : dimension_(dimension)
+    , hot_slots_(dimension > 0 ? hot_budget_bytes / (dimension * sizeof(Scalar)) : 0)
+    , cold_slots_(dimension > 0 ? cold_budget_bytes / (dimension * sizeof(Scalar)) : 0)
+    , promote_threshold_(std::max<uint32_t>(promote_threshold, 1))
+{
+    // Arenas are allocated up front so the budget is a hard bound
+    hot_arena_.resize(hot_slots_ * dimension_);
+    cold_arena_.resize(cold_slots_ * dimension_);
+
+    hot_free_.reserve(hot_slots_);
+    for (size_t i = hot_slots_; i-- > 0;) hot_free_.push_back(i);
+    cold_free_.reserve(cold_slots_);
+    for (size_t i = cold_slots_; i-- > 0;) cold_free_.push_back(i);
+
+    entries_.reserve(hot_slots_ + cold_slots_);
+}
+
+Scalar* TieredVectorCache::slot_ptr(bool hot, size_t slot) {
+    return (hot ? hot_arena_.data() : cold_arena_.data()) + slot * dimension_;
+}
+
+size_t TieredVectorCache::take_slot(bool hot) {
+    auto& free_list = hot ? hot_free_ : cold_free_;
+    size_t slot = free_list.back();
+    free_list.pop_back();
+    return slot;
+}
+
+void TieredVectorCache::release_slot(bool hot, size_t slot) {
+    (hot ? hot_free_ : cold_free_).push_back(slot);
+}
+
+bool TieredVectorCache::lookup(VectorId id, std::span<Scalar> out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto found = entries_.find(id);
+    if (found == entries_.end()) {
+        stats_.misses++;
+        return false;
+    }
+
+    auto it = found->second;
+    std::memcpy(out.data(), slot_ptr(it->hot, it->slot), dimension_ * sizeof(Scalar));
+    it->hits++;
+
+    if (it->hot) {
+        stats_.hot_hits++;
+        hot_lru_.splice(hot_lru_.begin(), hot_lru_, it);
+    } else {
+        stats_.cold_hits++;
+        if (it->hits >= promote_threshold_ && hot_slots_ > 0) {
+            promote(it);
+        } else {
+            cold_lru_.splice(cold_lru_.begin(), cold_lru_, it);
+        }
+    }
+    return true;
+}
+
+void TieredVectorCache::insert(VectorId id, std::span<const Scalar> data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (entries_.contains(id)) {
+        return;  // Another reader filled it after the same miss
+    }
+
+    // Without a cold segment, the hot arena acts as a plain LRU
+    bool hot = cold_slots_ == 0;
+    size_t capacity = hot ? hot_slots_ : cold_slots_;
+    if (capacity == 0) {
+        return;
+    }
+
+    auto& lru = hot ? hot_lru_ : cold_lru_;
+    if (lru.size() >= capacity) {
+        if (hot) {
+            Entry victim = hot_lru_.back();
+            hot_lru_.pop_back();
+            entries_.erase(victim.id);
+            release_slot(true, victim.slot);
+            stats_.evictions++;
+        } else {
+            evict_cold();
+        }
+    }
+
+    size_t slot = take_slot(hot);
+    std::memcpy(slot_ptr(hot, slot), data.data(), dimension_ * sizeof(Scalar));
+    lru.push_front(Entry{id, slot, 0, hot});
+    entries_[id] = lru.begin();
+}
+
+void TieredVectorCache::evict_cold() {
+    Entry victim = cold_lru_.back();
+    cold_lru_.pop_back();
+    entries_.erase(victim.id);
+    release_slot(false, victim.slot);
+    stats_.evictions++;
+}
+
+void TieredVectorCache::promote(EntryList::iterator it) {
+    // Hot segment full: demote its LRU tail into the slot being vacated
+    if (hot_lru_.size() >= hot_slots_) {
+        auto demoted = std::prev(hot_lru_.end());
+
+        std::vector<Scalar> scratch(slot_ptr(true, demoted->slot),
+                                    slot_ptr(true, demoted->slot) + dimension_);
+        std::memcpy(slot_ptr(true, demoted->slot), slot_ptr(false, it->slot),
+                    dimension_ * sizeof(Scalar));
+        std::memcpy(slot_ptr(false, it->slot), scratch.data(), dimension_ * sizeof(Scalar));
+        std::swap(demoted->slot, it->slot);
+
+        demoted->hot = false;
+        demoted->hits = 0;
+        cold_lru_.splice(cold_lru_.begin(), hot_lru_, demoted);
+        stats_.demotions++;
+    } else {
+        size_t slot = take_slot(true);
+        std::memcpy(slot_ptr(true, slot), slot_ptr(false, it->slot), dimension_ * sizeof(Scalar));
+        release_slot(false, it->slot);
+        it->slot = slot;
+    }
+
+    it->hot = true;
+    hot_lru_.splice(hot_lru_.begin(), cold_lru_, it);
+    stats_.promotions++;
+}
+
+void TieredVectorCache::erase(VectorId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto found = entries_.find(id);
+    if (found == entries_.end()) {
+        return;
+    }
+
+    auto it = found->second;
+    release_slot(it->hot, it->slot);
+    (it->hot ? hot_lru_ : cold_lru_).erase(it);
+    entries_.erase(found);
+}
+
+void TieredVectorCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto& entry : hot_lru_) release_slot(true, entry.slot);
+    for (const auto& entry : cold_lru_) release_slot(false, entry.slot);
+    hot_lru_.clear();
+    cold_lru_.clear();
+    entries_.clear();
+}
+
+TierStats TieredVectorCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    TierStats result = stats_;
+    result.hot_count = hot_lru_.size();
+    result.cold_count = cold_lru_.size();
+    return result;
+}
+
+size_t TieredVectorCache::memory_usage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t arenas = (hot_arena_.size() + cold_arena_.size()) * sizeof(Scalar);
+    size_t bookkeeping = entries_.size() * (sizeof(Entry) + 2 * sizeof(void*) +
+                                            sizeof(VectorId) + sizeof(EntryList::iterator));
+    return arenas + bookkeeping;
+}
+
+} // namespace vdb
@@ -3,8 +3,16 @@
 // ============================================================================
 
 #include "vdb/hybrid_search.hpp"
+#include "vdb/hybrid/tokenizer.hpp"
+#include "vdb/adapters/data_adapter.hpp"
+#include "vdb/checkpoint.hpp"
 #include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
 
 using namespace vdb::hybrid;
 
@@ -93,6 +101,214 @@ TEST_F(BM25Test, SearchResultsSortedByScore) {
     }
 }
 
+TEST_F(BM25Test, PrunedTopKMatchesExhaustiveRanking) {
+    BM25Engine engine(config_);
+
+    // Skewed vocabulary so a few terms have long, multi-block posting lists
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (vdb::VectorId id = 1; id <= 3000; ++id) {
+        std::string text;
+        size_t length = 5 + rng() % 40;
+        for (size_t i = 0; i < length; ++i) {
+            auto word = static_cast<size_t>(std::pow(unit(rng), 3.0) * 300);
+            text += "term" + std::to_string(word) + "x ";
+        }
+        ASSERT_TRUE(engine.add_document(id, text));
+    }
+    for (vdb::VectorId id = 1; id <= 3000; id += 7) {
+        ASSERT_TRUE(engine.remove_document(id));
+    }
+
+    for (const char* query : {"term0x term1x", "term0x term2x term150x", "term3x term3x term40x",
+                              "term1x term5x term9x term77x term250x"}) {
+        // k >= matching documents never fills the heap, so nothing is pruned
+        auto exhaustive = engine.search(query, engine.document_count(), 0.0f);
+        auto pruned = engine.search(query, 10, 0.0f);
+        ASSERT_TRUE(exhaustive.has_value());
+        ASSERT_TRUE(pruned.has_value());
+        ASSERT_EQ(pruned->size(), 10u) << query;
+
+        for (size_t i = 0; i < pruned->size(); ++i) {
+            EXPECT_EQ((*pruned)[i].id, (*exhaustive)[i].id) << query << " rank " << i;
+            EXPECT_FLOAT_EQ((*pruned)[i].score, (*exhaustive)[i].score) << query << " rank " << i;
+        }
+
+        float cutoff = (*exhaustive)[20].score;
+        auto thresholded = engine.search(query, engine.document_count(), cutoff);
+        ASSERT_TRUE(thresholded.has_value());
+        for (const auto& result : *thresholded) {
+            EXPECT_GE(result.score, cutoff);
+        }
+        EXPECT_GE(thresholded->size(), 21u);
+    }
+}
+
+TEST_F(BM25Test, LoadRejectsDocumentFrequencyAboveDocumentCount) {
+    const std::string test_file = "test_bm25_bad_df.dat";
+    BM25Engine engine(config_);
+    ASSERT_TRUE(engine.add_document(1, "gold silver"));
+    ASSERT_TRUE(engine.add_document(2, "gold copper"));
+    ASSERT_TRUE(engine.save(test_file));
+
+    // 54-byte header, then an id and a length per document; the first
+    // dictionary entry's df follows its blob offset and length
+    auto bytes = vdb::read_checkpoint(test_file);
+    ASSERT_TRUE(bytes.has_value());
+    size_t df_offset = 54 + 2 * (sizeof(uint64_t) + sizeof(uint32_t)) + 2 * sizeof(uint32_t);
+    uint32_t df = 0;
+    std::memcpy(&df, bytes->data() + df_offset, sizeof(df));
+    ASSERT_TRUE(df == 1 || df == 2);
+
+    // Re-checksummed, so only the decoder's own checks can catch it
+    df = std::numeric_limits<uint32_t>::max();
+    std::memcpy(bytes->data() + df_offset, &df, sizeof(df));
+    ASSERT_TRUE(vdb::write_checkpoint(test_file, *bytes));
+    auto loaded = BM25Engine::load(test_file);
+    ASSERT_FALSE(loaded.has_value());
+    EXPECT_EQ(loaded.error().code, vdb::ErrorCode::IndexCorrupted);
+
+    std::filesystem::remove(test_file);
+}
+
+TEST_F(BM25Test, LoadRejectsUnderstatedBlockBounds) {
+    const std::string test_file = "test_bm25_bad_block.dat";
+    BM25Engine engine(config_);
+    ASSERT_TRUE(engine.add_document(1, "gold gold silver"));
+    ASSERT_TRUE(engine.add_document(2, "gold copper"));
+    ASSERT_TRUE(engine.save(test_file));
+
+    // Header ends with num_docs, num_terms, total_terms; the norms and
+    // 20-byte dictionary entries follow, then the term blob and postings
+    auto bytes = vdb::read_checkpoint(test_file);
+    ASSERT_TRUE(bytes.has_value());
+    auto read_u64 = [&](size_t offset) {
+        uint64_t value = 0;
+        std::memcpy(&value, bytes->data() + offset, sizeof(value));
+        return value;
+    };
+    size_t num_terms = read_u64(54 - 2 * sizeof(uint64_t));
+    size_t entries = 54 + 2 * (sizeof(uint64_t) + sizeof(uint32_t));
+    size_t blob = entries + num_terms * 20;
+    size_t postings = blob + sizeof(uint64_t) + read_u64(blob) + sizeof(uint64_t);
+
+    // First block of the first list: last_doc, then max_tf
+    size_t max_tf_offset = postings + read_u64(entries + 3 * sizeof(uint32_t)) + sizeof(uint32_t);
+    uint32_t max_tf = 0;
+    std::memcpy(&max_tf, bytes->data() + max_tf_offset, sizeof(max_tf));
+    ASSERT_GE(max_tf, 1u);
+
+    max_tf = 0;
+    std::memcpy(bytes->data() + max_tf_offset, &max_tf, sizeof(max_tf));
+    ASSERT_TRUE(vdb::write_checkpoint(test_file, *bytes));
+    auto loaded = BM25Engine::load(test_file);
+    ASSERT_FALSE(loaded.has_value());
+    EXPECT_EQ(loaded.error().code, vdb::ErrorCode::IndexCorrupted);
+
+    std::filesystem::remove(test_file);
+}
+
+TEST_F(BM25Test, ParallelShardsMatchSequentialScoring) {
+    BM25Config config = config_;
+    config.delta_segment_docs = 500;
+    BM25Engine sequential(config);
+    config.search_shards = 4;
+    config.min_shard_docs = 100;
+    BM25Engine sharded(config);
+
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (vdb::VectorId id = 1; id <= 4000; ++id) {
+        std::string text;
+        size_t length = 5 + rng() % 30;
+        for (size_t i = 0; i < length; ++i) {
+            auto word = static_cast<size_t>(std::pow(unit(rng), 3.0) * 200);
+            text += "term" + std::to_string(word) + "x ";
+        }
+        ASSERT_TRUE(sequential.add_document(id, text));
+        ASSERT_TRUE(sharded.add_document(id, text));
+    }
+    for (vdb::VectorId id = 3; id <= 4000; id += 11) {
+        ASSERT_TRUE(sequential.remove_document(id));
+        ASSERT_TRUE(sharded.remove_document(id));
+    }
+
+    for (const char* query : {"term0x term1x", "term2x term3x term90x", "term150x", "term1x term5x term7x term40x"}) {
+        for (size_t k : {1u, 10u, 100u}) {
+            auto expected = sequential.search(query, k, 0.0f);
+            auto actual = sharded.search(query, k, 0.0f);
+            ASSERT_TRUE(expected.has_value());
+            ASSERT_TRUE(actual.has_value());
+            ASSERT_EQ(actual->size(), expected->size()) << query;
+            for (size_t i = 0; i < actual->size(); ++i) {
+                EXPECT_EQ((*actual)[i].id, (*expected)[i].id) << query << " rank " << i;
+                EXPECT_EQ((*actual)[i].score, (*expected)[i].score) << query << " rank " << i;
+            }
+        }
+    }
+}
+
+TEST_F(BM25Test, RepeatedQueryTermsWeighAndReport) {
+    BM25Engine engine(config_);
+    ASSERT_TRUE(engine.add_document(1, "gold gold gold silver"));
+    ASSERT_TRUE(engine.add_document(2, "silver silver silver gold"));
+    ASSERT_TRUE(engine.add_document(3, "copper mining output"));
+
+    auto results = engine.search("silver silver gold", 10, 0.0f);
+    ASSERT_TRUE(results.has_value());
+    ASSERT_EQ(results->size(), 2u);
+    EXPECT_EQ((*results)[0].id, 2u);
+    EXPECT_EQ((*results)[0].matched_terms,
+              (std::vector<std::string>{"silver", "silver", "gold"}));
+}
+
+TEST_F(BM25Test, PhraseAndProximityReorderCandidates) {
+    BM25Config config = config_;
+    config.use_stemming = false;
+    BM25Engine plain(config);
+    config.store_positions = true;
+    BM25Engine positional(config);
+
+    // Same terms and lengths, so BM25 alone ties them
+    const std::vector<std::pair<vdb::VectorId, std::string>> docs = {
+        {1, "cut forecasts rise while analysts expect rate"},
+        {2, "rate futures cut forecasts while analysts expect"},
+        {3, "rate cut forecasts rise while analysts expect"},
+        {4, "copper output slows as smelters expect demand"},
+    };
+    for (const auto& [id, text] : docs) {
+        ASSERT_TRUE(plain.add_document(id, text));
+        ASSERT_TRUE(positional.add_document(id, text));
+    }
+
+    auto bag = plain.search("rate cut", 10);
+    ASSERT_TRUE(bag.has_value());
+    ASSERT_EQ(bag->size(), 3u);
+    EXPECT_FLOAT_EQ((*bag)[0].score, (*bag)[2].score);
+    EXPECT_EQ((*bag)[0].id, 1u);
+
+    // Exact phrase, then one token apart, then far apart and reversed
+    auto ranked = positional.search("rate cut", 10);
+    ASSERT_TRUE(ranked.has_value());
+    ASSERT_EQ(ranked->size(), 3u);
+    EXPECT_EQ((*ranked)[0].id, 3u);
+    EXPECT_EQ((*ranked)[1].id, 2u);
+    EXPECT_EQ((*ranked)[2].id, 1u);
+    EXPECT_GT((*ranked)[1].score, (*ranked)[2].score);
+    EXPECT_GT((*ranked)[2].score, (*bag)[2].score - 1e-6f);
+
+    // Single-term queries skip the positional pass entirely
+    auto single = positional.search("rate", 10);
+    auto single_plain = plain.search("rate", 10);
+    ASSERT_TRUE(single.has_value());
+    ASSERT_TRUE(single_plain.has_value());
+    ASSERT_EQ(single->size(), single_plain->size());
+    for (size_t i = 0; i < single->size(); ++i) {
+        EXPECT_EQ((*single)[i].id, (*single_plain)[i].id);
+        EXPECT_EQ((*single)[i].score, (*single_plain)[i].score);
+    }
+}
+
 // ============================================================================
 // Stemming Tests
 // ============================================================================
@@ -202,6 +418,57 @@ TEST_F(BM25Test, UpdateDocument) {
     EXPECT_TRUE(!results.has_value() || results->empty());
 }
 
+TEST_F(BM25Test, SegmentsMergeWithoutChangingRanking) {
+    BM25Config config = config_;
+    config.delta_segment_docs = 16;
+    BM25Engine segmented(config);
+    BM25Engine reference(config_);
+
+    std::mt19937 rng(11);
+    for (vdb::VectorId id = 1; id <= 500; ++id) {
+        std::string text;
+        size_t length = 3 + rng() % 20;
+        for (size_t i = 0; i < length; ++i) {
+            text += "tok" + std::to_string(rng() % (1 + rng() % 100)) + "x ";
+        }
+        ASSERT_TRUE(segmented.add_document(id, text));
+        if (id % 5 != 0) {
+            ASSERT_TRUE(reference.add_document(id, text));
+        }
+    }
+    for (vdb::VectorId id = 5; id <= 500; id += 5) {
+        ASSERT_TRUE(segmented.remove_document(id));
+    }
+    EXPECT_GT(segmented.segment_count(), 1u);
+    EXPECT_LT(segmented.segment_count(), 12u);  // Geometric merging
+    EXPECT_EQ(segmented.document_count(), reference.document_count());
+    EXPECT_EQ(segmented.term_count(), reference.term_count());
+
+    auto expect_same = [&](const BM25Engine& engine) {
+        for (const char* query : {"tok0x tok1x", "tok2x tok50x tok7x", "tok3x tok3x"}) {
+            auto expected = reference.search(query, 15);
+            auto actual = engine.search(query, 15);
+            ASSERT_TRUE(expected.has_value());
+            ASSERT_TRUE(actual.has_value());
+            ASSERT_EQ(actual->size(), expected->size()) << query;
+            for (size_t i = 0; i < actual->size(); ++i) {
+                EXPECT_EQ((*actual)[i].id, (*expected)[i].id) << query << " rank " << i;
+                EXPECT_FLOAT_EQ((*actual)[i].score, (*expected)[i].score);
+            }
+        }
+    };
+    expect_same(segmented);
+
+    segmented.compact();
+    EXPECT_EQ(segmented.segment_count(), 1u);
+    expect_same(segmented);
+
+    // Removal after a merge still finds the relocated document
+    ASSERT_TRUE(segmented.remove_document(1));
+    ASSERT_TRUE(reference.remove_document(1));
+    expect_same(segmented);
+}
+
 // ============================================================================
 // Persistence Tests
 // ============================================================================
@@ -241,3 +508,456 @@ TEST_F(BM25Test, SaveAndLoad) {
     // Clean up
     std::filesystem::remove(test_file);
 }
+
+TEST_F(BM25Test, SegmentRoundTripPreservesRanking) {
+    const std::string test_file = "test_bm25_segment.dat";
+
+    BM25Config config = config_;
+    config.store_content = true;
+    BM25Engine engine(config);
+    std::mt19937 rng(7);
+    for (vdb::VectorId id = 1; id <= 600; ++id) {
+        std::string text;
+        size_t length = 3 + rng() % 30;
+        for (size_t i = 0; i < length; ++i) {
+            text += "word" + std::to_string(rng() % (1 + rng() % 200)) + "x ";
+        }
+        ASSERT_TRUE(engine.add_document(id, text));
+    }
+    ASSERT_TRUE(engine.remove_document(10));
+    ASSERT_TRUE(engine.update_document(20, "word1x word1x word2x"));
+    ASSERT_TRUE(engine.save(test_file));
+
+    auto loaded = BM25Engine::load(test_file);
+    ASSERT_TRUE(loaded.has_value()) << loaded.error().message;
+    EXPECT_EQ(loaded->document_count(), engine.document_count());
+    EXPECT_EQ(loaded->term_count(), engine.term_count());
+    EXPECT_FLOAT_EQ(loaded->average_document_length(), engine.average_document_length());
+
+    for (const char* query : {"word0x word1x", "word3x word150x word7x", "word2x"}) {
+        auto expected = engine.search(query, 25);
+        auto actual = loaded->search(query, 25);
+        ASSERT_TRUE(expected.has_value());
+        ASSERT_TRUE(actual.has_value());
+        ASSERT_EQ(actual->size(), expected->size()) << query;
+        for (size_t i = 0; i < actual->size(); ++i) {
+            EXPECT_EQ((*actual)[i].id, (*expected)[i].id) << query << " rank " << i;
+            EXPECT_FLOAT_EQ((*actual)[i].score, (*expected)[i].score) << query << " rank " << i;
+            EXPECT_EQ((*actual)[i].matched_terms, (*expected)[i].matched_terms);
+        }
+    }
+
+    // Loaded documents carry no term lists; removal must still find them
+    ASSERT_TRUE(loaded->remove_document(20));
+    auto results = loaded->search("word2x", 600);
+    ASSERT_TRUE(results.has_value());
+    for (const auto& r : *results) {
+        EXPECT_NE(r.id, 20u);
+    }
+
+    // A flipped byte fails the checksum instead of loading garbage
+    {
+        std::fstream file(test_file, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(64);
+        file.put('\xFF');
+    }
+    EXPECT_FALSE(BM25Engine::load(test_file).has_value());
+
+    std::filesystem::remove(test_file);
+}
+
+TEST_F(BM25Test, PositionsSurviveMergeAndSave) {
+    const std::string test_file = "test_bm25_positions.dat";
+
+    BM25Config config = config_;
+    config.store_positions = true;
+    config.delta_segment_docs = 32;
+    BM25Engine engine(config);
+    std::mt19937 rng(9);
+    for (vdb::VectorId id = 1; id <= 400; ++id) {
+        std::string text;
+        size_t length = 3 + rng() % 30;
+        for (size_t i = 0; i < length; ++i) {
+            text += "word" + std::to_string(rng() % 40) + "x ";
+        }
+        ASSERT_TRUE(engine.add_document(id, text));
+    }
+    ASSERT_TRUE(engine.remove_document(5));
+    EXPECT_GT(engine.segment_count(), 1u);
+    ASSERT_TRUE(engine.save(test_file));
+    auto loaded = BM25Engine::load(test_file);
+    ASSERT_TRUE(loaded.has_value()) << loaded.error().message;
+    engine.compact();
+
+    for (const char* query : {"word1x word2x", "word3x word4x word5x"}) {
+        auto merged = engine.search(query, 20);
+        auto restored = loaded->search(query, 20);
+        ASSERT_TRUE(merged.has_value());
+        ASSERT_TRUE(restored.has_value());
+        ASSERT_EQ(restored->size(), merged->size());
+        for (size_t i = 0; i < merged->size(); ++i) {
+            EXPECT_EQ((*restored)[i].id, (*merged)[i].id) << query << " rank " << i;
+            EXPECT_FLOAT_EQ((*restored)[i].score, (*merged)[i].score) << query << " rank " << i;
+        }
+    }
+
+    std::filesystem::remove(test_file);
+}
+
+TEST_F(BM25Test, LoadsLegacyTextFormat) {
+    const std::string test_file = "test_bm25_legacy.dat";
+    {
+        std::ofstream file(test_file);
+        file << "BM25_ENGINE_V1\nk1=1.5\nb=0.75\nmin_term_length=2\nuse_stemming=1\n"
+             << "case_sensitive=0\nDOCUMENTS_START\n"
+             << "1\t3\tGold prices surge\n2\t3\tSilver follows gold\nDOCUMENTS_END\n";
+    }
+
+    auto loaded = BM25Engine::load(test_file);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->document_count(), 2u);
+    auto results = loaded->search("silver", 10);
+    ASSERT_TRUE(results.has_value());
+    ASSERT_EQ(results->size(), 1u);
+    EXPECT_EQ((*results)[0].id, 2u);
+
+    std::filesystem::remove(test_file);
+}
+
+// ============================================================================
+// Query Rewriter Tests
+// ============================================================================
+
+TEST(QueryRewriterTest, MultiWordSynonymsExpandInOnePass) {
+    QueryRewriter rewriter;
+    ASSERT_TRUE(rewriter.add_synonym("fed funds", {"federal funds rate"}));
+    ASSERT_TRUE(rewriter.add_synonym("funds", {"capital"}));
+    ASSERT_TRUE(rewriter.add_synonym("Gold", {"bullion", "xau"}));
+    EXPECT_FALSE(rewriter.add_synonym("  ", {"nothing"}));
+
+    auto rewritten = rewriter.rewrite("Fed funds and gold");
+    ASSERT_TRUE(rewritten.has_value());
+    EXPECT_EQ(*rewritten, "Fed funds fund federal funds rate capital and gold bullion xau");
+
+    auto expanded = rewriter.expand("Fed funds and gold");
+    ASSERT_TRUE(expanded.has_value());
+    std::map<std::string, float> weights;
+    for (const auto& term : *expanded) {
+        weights[term.term] = term.weight;
+    }
+    EXPECT_EQ(weights, (std::map<std::string, float>{
+        {"fed", 1.0f}, {"funds", 1.5f}, {"federal", 0.5f}, {"rate", 0.5f}, {"capital", 0.5f},
+        {"and", 1.0f}, {"gold", 1.0f}, {"bullion", 0.5f}, {"xau", 0.5f}}));
+
+    // A phrase only matches contiguously
+    auto split = rewriter.expand("fed raises funds");
+    ASSERT_TRUE(split.has_value());
+    for (const auto& term : *split) {
+        EXPECT_NE(term.term, "federal");
+    }
+}
+
+TEST(QueryRewriterTest, LoadsPhraseSynonymFile) {
+    const std::string test_file = "test_synonyms.txt";
+    {
+        std::ofstream file(test_file);
+        file << "# comment\n"
+             << "gold bullion xau\n"
+             << "fed funds => federal funds rate, overnight rate\n";
+    }
+    QueryRewriter rewriter;
+    ASSERT_TRUE(rewriter.load_synonyms(test_file));
+    auto rewritten = rewriter.rewrite("fed funds gold");
+    ASSERT_TRUE(rewritten.has_value());
+    EXPECT_EQ(*rewritten, "fed funds fund federal funds rate overnight rate gold bullion xau");
+    std::filesystem::remove(test_file);
+}
+
+TEST_F(BM25Test, ExpandedTermsFeedScoringDirectly) {
+    BM25Engine engine(config_);
+    ASSERT_TRUE(engine.add_document(1, "federal funds rate rises again"));
+    ASSERT_TRUE(engine.add_document(2, "bullion demand climbs"));
+    ASSERT_TRUE(engine.add_document(3, "copper output slows"));
+    ASSERT_TRUE(engine.add_document(4, "gold gold gold silver"));
+    ASSERT_TRUE(engine.add_document(5, "silver silver silver gold"));
+
+    // A weight behaves like repeating the term in the query
+    std::vector<WeightedTerm> weighted = {{"Silver", 2.0f}, {"gold", 1.0f}};
+    auto by_weight = engine.search(weighted, 10);
+    auto by_repeat = engine.search("silver silver gold", 10);
+    ASSERT_TRUE(by_weight.has_value());
+    ASSERT_TRUE(by_repeat.has_value());
+    ASSERT_EQ(by_weight->size(), by_repeat->size());
+    for (size_t i = 0; i < by_weight->size(); ++i) {
+        EXPECT_EQ((*by_weight)[i].id, (*by_repeat)[i].id);
+        EXPECT_FLOAT_EQ((*by_weight)[i].score, (*by_repeat)[i].score);
+    }
+
+    QueryRewriter rewriter;
+    ASSERT_TRUE(rewriter.add_synonym("fed funds", {"federal funds rate"}));
+    ASSERT_TRUE(rewriter.add_synonym("gold", {"bullion"}));
+    auto expanded = rewriter.expand("the fed funds outlook for gold");
+    ASSERT_TRUE(expanded.has_value());
+    auto results = engine.search(*expanded, 10);
+    ASSERT_TRUE(results.has_value());
+    std::vector<vdb::VectorId> ids;
+    for (const auto& r : *results) ids.push_back(r.id);
+    EXPECT_NE(std::find(ids.begin(), ids.end(), 1u), ids.end());
+    EXPECT_NE(std::find(ids.begin(), ids.end(), 2u), ids.end());
+    EXPECT_EQ(std::find(ids.begin(), ids.end(), 3u), ids.end());
+
+    std::vector<WeightedTerm> negative = {{"gold", -1.0f}};
+    EXPECT_FALSE(engine.search(negative, 10).has_value());
+    std::vector<WeightedTerm> stop_words = {{"the", 1.0f}};
+    EXPECT_FALSE(engine.search(stop_words, 10).has_value());
+}
+
+// ============================================================================
+// Keyword Extractor Tests
+// ============================================================================
+
+namespace {
+
+std::vector<std::string> keyword_corpus(size_t count) {
+    const std::vector<std::string> words = {
+        "gold", "silver", "inflation", "yields", "dollar", "central", "bank",
+        "demand", "supply", "miners", "rally", "selloff", "copper", "futures"};
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<size_t> pick(0, words.size() - 1);
+    std::vector<std::string> corpus;
+    for (size_t d = 0; d < count; ++d) {
+        std::string text;
+        for (size_t w = 0; w < 12; ++w) {
+            text += words[pick(rng)] + " ";
+        }
+        corpus.push_back(std::move(text));
+    }
+    return corpus;
+}
+
+} // namespace
+
+TEST(KeywordExtractorTest, StreamedParallelTrainingMatchesInMemory) {
+    auto corpus = keyword_corpus(2000);
+
+    KeywordConfig sequential_config;
+    sequential_config.train_threads = 1;
+    KeywordExtractor sequential(sequential_config);
+    ASSERT_TRUE(sequential.train(corpus));
+
+    KeywordConfig parallel_config;
+    parallel_config.train_threads = 4;
+    parallel_config.train_batch_docs = 16;
+    KeywordExtractor streamed(parallel_config);
+    ASSERT_TRUE(streamed.train(document_source(corpus.begin(), corpus.end())));
+    KeywordExtractor in_memory(parallel_config);
+    ASSERT_TRUE(in_memory.train(corpus));
+
+    EXPECT_EQ(streamed.document_count(), 2000u);
+    EXPECT_EQ(in_memory.document_count(), 2000u);
+    for (const char* term : {"gold", "copper", "futures", "missing"}) {
+        EXPECT_EQ(streamed.document_frequency(term), sequential.document_frequency(term)) << term;
+        EXPECT_EQ(in_memory.document_frequency(term), sequential.document_frequency(term)) << term;
+    }
+
+    auto expected = sequential.extract("Gold miners rally while copper futures slide");
+    auto actual = streamed.extract("Gold miners rally while copper futures slide");
+    ASSERT_TRUE(expected.has_value());
+    ASSERT_TRUE(actual.has_value());
+    ASSERT_EQ(actual->size(), expected->size());
+    for (size_t i = 0; i < actual->size(); ++i) {
+        EXPECT_EQ((*actual)[i].term, (*expected)[i].term);
+        EXPECT_FLOAT_EQ((*actual)[i].score, (*expected)[i].score);
+    }
+
+    // A failing source leaves the earlier statistics in place
+    size_t served = 0;
+    DocumentSource failing = [&]() -> vdb::Result<std::optional<std::string>> {
+        if (served++ < 100) return std::string("unrelated words here");
+        return std::unexpected(vdb::Error(vdb::ErrorCode::IoError, "archive unavailable"));
+    };
+    EXPECT_FALSE(streamed.train(failing));
+    EXPECT_EQ(streamed.document_count(), 2000u);
+    EXPECT_EQ(streamed.document_frequency("unrelated"), 0u);
+}
+
+TEST(KeywordExtractorTest, UpdatesIncrementallyAndSavesBinaryTable) {
+    auto corpus = keyword_corpus(600);
+    std::vector<std::string> first(corpus.begin(), corpus.begin() + 400);
+
+    KeywordConfig config;
+    config.train_threads = 2;
+    config.train_batch_docs = 32;
+    KeywordExtractor full(config);
+    ASSERT_TRUE(full.train(corpus));
+
+    KeywordExtractor incremental(config);
+    ASSERT_TRUE(incremental.train(first));
+    ASSERT_TRUE(incremental.update(document_source(corpus.begin() + 400, corpus.end())));
+    EXPECT_EQ(incremental.document_count(), full.document_count());
+    for (const char* term : {"gold", "dollar", "selloff"}) {
+        EXPECT_EQ(incremental.document_frequency(term), full.document_frequency(term)) << term;
+    }
+
+    const std::string path = "test_keywords.bin";
+    ASSERT_TRUE(incremental.save(path));
+    auto loaded = KeywordExtractor::load(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->document_count(), 600u);
+    for (const char* term : {"gold", "dollar", "selloff"}) {
+        EXPECT_EQ(loaded->document_frequency(term), full.document_frequency(term)) << term;
+    }
+
+    // Loaded statistics keep growing with later archive files
+    ASSERT_TRUE(loaded->update(std::vector<std::string>{"gold platinum"}));
+    EXPECT_EQ(loaded->document_count(), 601u);
+    EXPECT_EQ(loaded->document_frequency("gold"), full.document_frequency("gold") + 1);
+    EXPECT_EQ(loaded->document_frequency("platinum"), 1u);
+    std::filesystem::remove(path);
+
+    // Text tables from earlier releases still load
+    {
+        std::ofstream file(path);
+        file << "KEYWORD_EXTRACTOR_V1\n"
+             << "max_keywords=5\n"
+             << "total_documents=10\n"
+             << "trained=1\n"
+             << "DOCUMENT_FREQUENCY_START\n"
+             << "gold\t4\n"
+             << "DOCUMENT_FREQUENCY_END\n";
+    }
+    auto legacy = KeywordExtractor::load(path);
+    ASSERT_TRUE(legacy.has_value());
+    EXPECT_EQ(legacy->document_count(), 10u);
+    EXPECT_EQ(legacy->document_frequency("gold"), 4u);
+    std::filesystem::remove(path);
+}
+
+TEST(KeywordExtractorTest, TrainsFromStreamedAdapterChunks) {
+    auto dir = std::filesystem::temp_directory_path() / "vdb_keyword_stream";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    auto write = [&](const char* name, const char* content) {
+        std::ofstream(dir / name) << content;
+        return dir / name;
+    };
+    auto metals = write("metals.csv", "note\ngold rallies\ncopper slides\n");
+    auto energy = write("energy.csv", "note\ncrude gold spread\n");
+    auto empty = write("empty.csv", "");
+
+    // One row per chunk, files in the order given
+    vdb::adapters::ChunkConfig chunking;
+    chunking.max_chunk_size = 1;
+    vdb::adapters::DataAdapterManager manager;
+    auto stream = manager.stream_chunks({metals, energy}, chunking);
+    std::vector<std::string> chunks;
+    while (true) {
+        auto next = stream();
+        ASSERT_TRUE(next.has_value()) << next.error().message;
+        if (!*next) break;
+        chunks.push_back(std::move(**next));
+    }
+    ASSERT_EQ(chunks.size(), 3u);
+    EXPECT_NE(chunks[0].find("gold rallies"), std::string::npos);
+    EXPECT_NE(chunks[2].find("crude gold spread"), std::string::npos);
+
+    KeywordConfig config;
+    config.train_threads = 2;
+    config.train_batch_docs = 1;
+    KeywordExtractor streamed(config);
+    ASSERT_TRUE(streamed.train(manager.stream_chunks({metals, energy}, chunking)));
+    KeywordExtractor in_memory(config);
+    ASSERT_TRUE(in_memory.train(chunks));
+    EXPECT_EQ(streamed.document_count(), 3u);
+    for (const char* term : {"gold", "copper", "crude", "note"}) {
+        EXPECT_EQ(streamed.document_frequency(term), in_memory.document_frequency(term)) << term;
+    }
+    EXPECT_EQ(streamed.document_frequency("gold"), 2u);
+
+    // A file that fails to parse ends the stream with its error, after the
+    // chunks before it, and training keeps its earlier statistics
+    auto failing = manager.stream_chunks({metals, empty, energy}, chunking);
+    ASSERT_TRUE(failing().has_value());
+    ASSERT_TRUE(failing().has_value());
+    auto error = failing();
+    ASSERT_FALSE(error.has_value());
+    EXPECT_EQ(error.error().code, vdb::ErrorCode::InvalidData);
+
+    EXPECT_FALSE(streamed.train(manager.stream_chunks({metals, empty, energy}, chunking)));
+    EXPECT_FALSE(streamed.update(manager.stream_chunks({dir / "missing.csv"}, chunking)));
+    EXPECT_EQ(streamed.document_count(), 3u);
+    EXPECT_EQ(streamed.document_frequency("gold"), 2u);
+    std::filesystem::remove_all(dir);
+}
+
+// ============================================================================
+// Tokenizer Tests
+// ============================================================================
+
+TEST(TokenizerTest, VectorizedSplitMatchesScalarRules) {
+    // Long enough to cross several 32-byte lanes; includes UTF-8 bytes,
+    // which are separators, and tokens straddling lane boundaries
+    std::string text;
+    std::vector<std::string> expected;
+    std::mt19937 rng(7);
+    const std::string alphabet = "abcXYZ019-_ .,;\t\xc3\xa9!";
+    std::string current;
+    for (int i = 0; i < 2000; ++i) {
+        char c = alphabet[rng() % alphabet.size()];
+        text += c;
+        bool token_char = std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_';
+        if (token_char) {
+            current += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        } else if (!current.empty()) {
+            expected.push_back(current);
+            current.clear();
+        }
+    }
+    if (!current.empty()) expected.push_back(current);
+
+    Tokenizer tokenizer(TokenizerOptions{.lowercase = true, .remove_stop_words = false,
+                                         .stem = false, .min_length = 0});
+    TokenBuffer tokens;
+    tokenizer.tokenize(text, tokens);
+    ASSERT_EQ(tokens.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(tokens[i].text, expected[i]);
+        EXPECT_EQ(tokens[i].position, i);
+        EXPECT_EQ(tokens[i].raw.size(), expected[i].size());
+    }
+}
+
+TEST(TokenizerTest, FiltersStemsAndReportsRawPositions) {
+    Tokenizer tokenizer(TokenizerOptions{.lowercase = true, .remove_stop_words = true,
+                                         .stem = true, .min_length = 2});
+    TokenBuffer tokens;
+    tokenizer.tokenize("The Running dogs jumped, a class of x-rays", tokens);
+
+    std::vector<std::string_view> terms;
+    std::vector<uint32_t> positions;
+    for (const auto& token : tokens) {
+        terms.push_back(token.text);
+        positions.push_back(token.position);
+    }
+    EXPECT_EQ(terms, (std::vector<std::string_view>{"runn", "dog", "jump", "class", "x-ray"}));
+    EXPECT_EQ(positions, (std::vector<uint32_t>{1, 2, 3, 5, 7}));
+    EXPECT_EQ(tokens[0].raw, "Running");
+
+    for (std::string_view word : {"a", "the", "with", "have", "its"}) {
+        EXPECT_TRUE(Tokenizer::is_stop_word(word)) << word;
+    }
+    for (std::string_view word : {"", "th", "theme", "search", "wit"}) {
+        EXPECT_FALSE(Tokenizer::is_stop_word(word)) << word;
+    }
+}
+
+TEST(TokenizerTest, TermDictionaryAssignsDenseIds) {
+    TermDictionary dictionary;
+    EXPECT_EQ(dictionary.intern("alpha"), 0u);
+    EXPECT_EQ(dictionary.intern("beta"), 1u);
+    EXPECT_EQ(dictionary.intern("alpha"), 0u);
+    EXPECT_EQ(dictionary.find("beta"), 1u);
+    EXPECT_FALSE(dictionary.find("gamma").has_value());
+    EXPECT_EQ(dictionary.term(1), "beta");
+    EXPECT_EQ(dictionary.size(), 2u);
+}
@@ -5,7 +5,9 @@
 
 #include <gtest/gtest.h>
 #include "vdb/index.hpp"
+#include "vdb/hybrid_search.hpp"
 #include "vdb/storage.hpp"
+#include "vdb/thread_pool.hpp"
 #include <thread>
 #include <vector>
 #include <random>
@@ -213,5 +215,115 @@ TEST_F(ConcurrentStressTest, ConcurrentVectorStoreResize) {
     std::cout << "Adds: " << add_count << ", Gets: " << get_count << std::endl;
 }
 
+TEST(BoundedExecutorTest, RunsByPriorityAndRefusesWhenFull) {
+    std::vector<int> order;
+    std::mutex order_mutex;
+    std::promise<void> started;
+    std::promise<void> release;
+    auto gate = release.get_future().share();
+    {
+        BoundedExecutor executor(1, 3);
+        ASSERT_TRUE(executor.try_submit([&] {
+            started.set_value();
+            gate.wait();
+        }));
+        started.get_future().wait();  // The single worker is now busy
+        
+        auto record = [&](int value) {
+            return [&, value] {
+                std::lock_guard<std::mutex> lock(order_mutex);
+                order.push_back(value);
+            };
+        };
+        EXPECT_TRUE(executor.try_submit(record(1), TaskPriority::Low));
+        EXPECT_TRUE(executor.try_submit(record(2), TaskPriority::High));
+        EXPECT_TRUE(executor.try_submit(record(3), TaskPriority::High));
+        EXPECT_FALSE(executor.try_submit(record(4), TaskPriority::High));
+        EXPECT_EQ(executor.pending(), 3u);
+        
+        release.set_value();
+    }  // Destructor drains the queue
+    
+    EXPECT_EQ(order, (std::vector<int>{2, 3, 1}));
+}
+
+TEST(ThreadPoolTest, CooperativeForNestsInsidePoolTasks) {
+    // Every worker blocks in an outer cooperative_for whose items run inner
+    // ones on the same pool; parallel_for would deadlock here
+    ThreadPool pool(2);
+    std::atomic<size_t> inner_runs{0};
+    std::vector<std::future<void>> outer;
+    for (int t = 0; t < 4; ++t) {
+        outer.push_back(pool.submit([&] {
+            pool.cooperative_for(3, [&](size_t) {
+                pool.cooperative_for(5, [&](size_t) { inner_runs++; });
+            });
+        }));
+    }
+    for (auto& task : outer) {
+        task.get();
+    }
+    EXPECT_EQ(inner_runs.load(), 4u * 3u * 5u);
+
+    // Index 0 stays on the caller, and exceptions reach it
+    auto caller = std::this_thread::get_id();
+    std::thread::id first;
+    EXPECT_THROW(pool.cooperative_for(4, [&](size_t i) {
+        if (i == 0) first = std::this_thread::get_id();
+        if (i == 2) throw std::runtime_error("shard failed");
+    }), std::runtime_error);
+    EXPECT_EQ(first, caller);
+}
+
+TEST(BM25ConcurrencyTest, SearchesRunAlongsideWriters) {
+    hybrid::BM25Config config;
+    config.delta_segment_docs = 64;
+    hybrid::BM25Engine engine(config);
+    for (VectorId id = 0; id < 500; ++id) {
+        ASSERT_TRUE(engine.add_document(id, "gold silver report " + std::to_string(id % 17)));
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> searches{0};
+    std::atomic<size_t> failures{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                auto results = engine.search("gold copper", 10);
+                if (!results || results->empty()) {
+                    failures++;
+                }
+                searches++;
+            }
+        });
+    }
+
+    // Writer: ingest, update and remove while readers run
+    for (VectorId id = 500; id < 3000; ++id) {
+        ASSERT_TRUE(engine.add_document(id, "copper gold mining " + std::to_string(id)));
+        if (id % 3 == 0) {
+            ASSERT_TRUE(engine.remove_document(id - 400));
+        }
+        if (id % 7 == 0) {
+            ASSERT_TRUE(engine.update_document(id - 1, "gold gold copper update"));
+        }
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_GT(searches.load(), 0u);
+    EXPECT_EQ(failures.load(), 0u);
+    EXPECT_EQ(engine.document_count(), 2167u);  // 3000 added, less removals, plus re-adds by update
+
+    auto results = engine.search("update", 5000);
+    ASSERT_TRUE(results.has_value());
+    for (const auto& result : *results) {
+        EXPECT_EQ(result.matched_terms, std::vector<std::string>{"update"});
+    }
+}
+
 } // namespace test
 } // namespace vdb
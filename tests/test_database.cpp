@@ -0,0 +1,733 @@
+// ============================================================================
+// VectorDB Tests - VectorDatabase
+// ============================================================================
+
+#include <gtest/gtest.h>
+#include "vdb/database.hpp"
+#include "vdb/checkpoint.hpp"
+#include <filesystem>
+#include <random>
+#include <thread>
+
+namespace vdb::test
+{
+
+    namespace fs = std::filesystem;
+
+    class DatabaseTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            auto *test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+            test_dir_ = fs::temp_directory_path() / (std::string("vdb_db_test_") + test_info->name());
+            fs::remove_all(test_dir_);
+            fs::create_directories(test_dir_);
+
+            config_.path = test_dir_;
+            config_.dimension = 8;
+            config_.max_elements = 1000;
+            config_.hnsw_ef_construction = 50;
+        }
+
+        void TearDown() override
+        {
+            fs::remove_all(test_dir_);
+        }
+
+        std::vector<Scalar> random_vector(std::mt19937 &rng) const
+        {
+            std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+            std::vector<Scalar> v(config_.dimension);
+            for (auto &x : v)
+                x = dist(rng);
+            return v;
+        }
+
+        Metadata make_meta(const std::string &date, const std::string &asset = "GOLD") const
+        {
+            Metadata meta;
+            meta.type = DocumentType::Journal;
+            meta.date = date;
+            meta.asset = asset;
+            return meta;
+        }
+
+        fs::path test_dir_;
+        DatabaseConfig config_;
+    };
+
+    // ============================================================================
+    // Snapshot Tests
+    // ============================================================================
+
+    TEST_F(DatabaseTest, SnapshotIsolatedFromLaterWrites)
+    {
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(7);
+        auto v1 = random_vector(rng);
+        auto v2 = random_vector(rng);
+        auto id1 = db.add_vector(v1, make_meta("2025-01-01"));
+        auto id2 = db.add_vector(v2, make_meta("2025-01-02"));
+        ASSERT_TRUE(id1.has_value());
+        ASSERT_TRUE(id2.has_value());
+
+        SnapshotPtr snap = db.snapshot();
+        EXPECT_EQ(snap->size(), 2);
+
+        // Mutate after the snapshot
+        Metadata changed = make_meta("2030-12-31");
+        ASSERT_TRUE(db.update_metadata(*id1, changed).has_value());
+        ASSERT_TRUE(db.remove(*id2).has_value());
+        auto id3 = db.add_vector(random_vector(rng), make_meta("2025-01-03"));
+        ASSERT_TRUE(id3.has_value());
+
+        // Snapshot still sees the old state
+        EXPECT_EQ(snap->size(), 2);
+        EXPECT_EQ(snap->get_metadata(*id1)->date, "2025-01-01");
+        EXPECT_TRUE(snap->contains(*id2));
+        EXPECT_FALSE(snap->contains(*id3));
+
+        auto vec2 = snap->get_vector(*id2);
+        ASSERT_TRUE(vec2.has_value());
+        EXPECT_FLOAT_EQ((*vec2)[0], v2[0]);
+
+        // Live database sees the new state
+        EXPECT_EQ(db.get_metadata(*id1)->date, "2030-12-31");
+        EXPECT_GT(db.write_epoch(), snap->epoch());
+        EXPECT_EQ(db.snapshot()->size(), 2);
+    }
+
+    TEST_F(DatabaseTest, SnapshotExactSearch)
+    {
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(11);
+        std::vector<std::vector<Scalar>> vectors;
+        for (int i = 0; i < 300; ++i)
+        {
+            vectors.push_back(random_vector(rng));
+            ASSERT_TRUE(db.add_vector(vectors.back(), make_meta("2025-02-01")).has_value());
+        }
+
+        auto snap = db.snapshot();
+        auto results = snap->search(vectors[42], 5);
+        ASSERT_EQ(results.size(), 5);
+        EXPECT_EQ(results[0].id, 43); // IDs start at 1
+        EXPECT_NEAR(results[0].distance, 0.0f, 1e-5f);
+        for (size_t i = 1; i < results.size(); ++i)
+        {
+            EXPECT_LE(results[i - 1].distance, results[i].distance);
+        }
+    }
+
+    TEST_F(DatabaseTest, ExportDoesNotBlockWriters)
+    {
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(3);
+        for (int i = 0; i < 100; ++i)
+        {
+            ASSERT_TRUE(db.add_vector(random_vector(rng), make_meta("2025-03-01")).has_value());
+        }
+
+        auto snap = db.snapshot();
+
+        // Writes proceed while the snapshot is alive
+        for (int i = 0; i < 50; ++i)
+        {
+            ASSERT_TRUE(db.add_vector(random_vector(rng), make_meta("2025-03-02")).has_value());
+        }
+
+        fs::path out = test_dir_ / "export.jsonl";
+        ASSERT_TRUE(snap->export_training_data(out).has_value());
+
+        std::ifstream file(out);
+        size_t lines = 0;
+        std::string line;
+        while (std::getline(file, line))
+            lines++;
+        EXPECT_EQ(lines, 100);
+    }
+
+    // ============================================================================
+    // Checkpoint Tests
+    // ============================================================================
+
+    TEST_F(DatabaseTest, BackgroundCheckpointPersistsWrites)
+    {
+        config_.auto_sync = false;
+        config_.sync_interval_ms = 20;
+
+        std::mt19937 rng(5);
+        auto v = random_vector(rng);
+        {
+            VectorDatabase db(config_);
+            ASSERT_TRUE(db.init().has_value());
+            for (int i = 0; i < 10; ++i)
+            {
+                ASSERT_TRUE(db.add_vector(i == 0 ? v : random_vector(rng), make_meta("2025-04-01")).has_value());
+            }
+
+            // Wait for the checkpointer to catch up
+            for (int i = 0; i < 200 && db.checkpoint_epoch() != db.write_epoch(); ++i)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            EXPECT_EQ(db.checkpoint_epoch(), db.write_epoch());
+            EXPECT_TRUE(read_checkpoint(test_dir_ / "index.hnsw").has_value());
+        }
+
+        VectorDatabase reopened(config_);
+        ASSERT_TRUE(reopened.init().has_value());
+        EXPECT_EQ(reopened.size(), 10);
+        auto results = reopened.snapshot()->search(v, 1);
+        ASSERT_EQ(results.size(), 1);
+        EXPECT_EQ(results[0].id, 1);
+    }
+
+    // ============================================================================
+    // Metadata Filter Tests
+    // ============================================================================
+
+    TEST_F(DatabaseTest, FiltersResolvedFromPostings)
+    {
+        config_.auto_sync = false;
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(19);
+        std::vector<Scalar> probe;
+        for (int i = 0; i < 60; ++i)
+        {
+            Metadata meta = make_meta("2025-05-" + std::string(i % 3 == 0 ? "01" : (i % 3 == 1 ? "02" : "03")),
+                                      i % 2 == 0 ? "GOLD" : "SILVER");
+            meta.bias = i % 4 == 0 ? "BULLISH" : "BEARISH";
+            auto v = random_vector(rng);
+            if (i == 0)
+                probe = v;
+            ASSERT_TRUE(db.add_vector(v, meta).has_value());
+        }
+
+        QueryOptions options;
+        options.k = 100;
+        options.asset_filter = "GOLD";
+        options.date_from = "2025-05-02";
+        options.bias_filter = "BULLISH";
+        auto results = db.query_vector(probe, options);
+        ASSERT_TRUE(results.has_value());
+        ASSERT_FALSE(results->empty());
+        for (const auto &r : *results)
+        {
+            ASSERT_TRUE(r.metadata.has_value());
+            EXPECT_EQ(r.metadata->asset, "GOLD");
+            EXPECT_GE(r.metadata->date, "2025-05-02");
+            EXPECT_EQ(r.metadata->bias, "BULLISH");
+        }
+
+        // No match short-circuits the search
+        options.asset_filter = "PLATINUM";
+        results = db.query_vector(probe, options);
+        ASSERT_TRUE(results.has_value());
+        EXPECT_TRUE(results->empty());
+
+        EXPECT_EQ(db.find_by_date("2025-05-01").size(), 20);
+        EXPECT_EQ(db.find_by_asset("SILVER").size(), 30);
+        EXPECT_EQ(db.count_by_type(DocumentType::Journal), 60);
+        EXPECT_EQ(db.all_dates(), (std::vector<std::string>{"2025-05-01", "2025-05-02", "2025-05-03"}));
+
+        // Postings follow updates and removals
+        Metadata moved = make_meta("2025-06-01", "SILVER");
+        ASSERT_TRUE(db.update_metadata(1, moved).has_value());
+        EXPECT_EQ(db.find_by_date("2025-05-01").size(), 19);
+        EXPECT_EQ(db.find_by_asset("SILVER").size(), 31);
+
+        ASSERT_TRUE(db.remove(1).has_value());
+        EXPECT_TRUE(db.find_by_date("2025-06-01").empty());
+        EXPECT_EQ(db.count_by_type(DocumentType::Journal), 59);
+    }
+
+    TEST_F(DatabaseTest, PlannerRecordsChosenPlan)
+    {
+        config_.auto_sync = false;
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(23);
+        std::vector<Scalar> probe;
+        for (int i = 0; i < 80; ++i)
+        {
+            auto v = random_vector(rng);
+            if (i == 3)
+                probe = v;
+            ASSERT_TRUE(db.add_vector(v, make_meta("2025-07-01", i % 4 == 3 ? "GOLD" : "SILVER")).has_value());
+        }
+
+        QueryOptions options;
+        options.k = 5;
+        auto unfiltered = db.query_vector(probe, options);
+        ASSERT_TRUE(unfiltered.has_value());
+        ASSERT_FALSE(unfiltered->empty());
+        EXPECT_EQ(unfiltered->front().plan, QueryPlan::Hnsw);
+
+        // A small candidate set is cheapest to scan exactly
+        options.asset_filter = "GOLD";
+        auto planned = db.query_vector(probe, options);
+        ASSERT_TRUE(planned.has_value());
+        ASSERT_EQ(planned->size(), 5u);
+        EXPECT_EQ(planned->front().plan, QueryPlan::ExactScan);
+        EXPECT_EQ(planned->front().id, 4u);
+
+        // Every plan agrees on the nearest match and honours the filter
+        for (QueryPlan plan : {QueryPlan::FilteredHnsw, QueryPlan::HnswPostFilter})
+        {
+            options.force_plan = plan;
+            auto forced = db.query_vector(probe, options);
+            ASSERT_TRUE(forced.has_value());
+            ASSERT_FALSE(forced->empty());
+            EXPECT_EQ(forced->front().id, 4u);
+            for (const auto &r : *forced)
+            {
+                EXPECT_EQ(r.metadata->asset, "GOLD");
+                EXPECT_TRUE(r.plan == QueryPlan::FilteredHnsw || r.plan == plan);
+            }
+        }
+    }
+
+    TEST_F(DatabaseTest, TieredExactScanReadsThroughVectorCache)
+    {
+        config_.auto_sync = false;
+        config_.cold_cache_bytes = 64 * 1024;
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(29);
+        std::vector<Scalar> probe;
+        for (int i = 0; i < 80; ++i)
+        {
+            auto v = random_vector(rng);
+            if (i == 3)
+                probe = v;
+            ASSERT_TRUE(db.add_vector(v, make_meta("2025-07-01", i % 4 == 3 ? "GOLD" : "SILVER")).has_value());
+        }
+
+        QueryOptions options;
+        options.k = 5;
+        options.asset_filter = "GOLD";
+        options.force_plan = QueryPlan::ExactScan;
+        auto first = db.query_vector(probe, options);
+        ASSERT_TRUE(first.has_value());
+        ASSERT_EQ(first->size(), 5u);
+        EXPECT_EQ(first->front().id, 4u);
+        EXPECT_NEAR(first->front().distance, 0.0f, 1e-5f);
+
+        auto stats = db.vector_tier_stats();
+        ASSERT_TRUE(stats.has_value());
+        EXPECT_EQ(stats->misses, 20u);
+
+        // The second scan is served from the tiers, with the same ranking
+        auto second = db.query_vector(probe, options);
+        ASSERT_TRUE(second.has_value());
+        ASSERT_EQ(second->size(), first->size());
+        for (size_t i = 0; i < first->size(); ++i)
+            EXPECT_EQ((*second)[i].id, (*first)[i].id);
+        stats = db.vector_tier_stats();
+        EXPECT_EQ(stats->misses, 20u);
+        EXPECT_EQ(stats->hot_hits + stats->cold_hits, 20u);
+
+        config_.cold_cache_bytes = 0;
+        EXPECT_FALSE(VectorDatabase(config_).vector_tier_stats().has_value());
+    }
+
+    TEST_F(DatabaseTest, NumericFiltersOnMarketFields)
+    {
+        config_.auto_sync = false;
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(29);
+        std::vector<Scalar> probe;
+        for (int i = 0; i < 40; ++i)
+        {
+            Metadata meta = make_meta("2025-08-01");
+            meta.vix = static_cast<float>(10 + i);
+            meta.dxy = static_cast<float>(95 + i % 15);
+            auto v = random_vector(rng);
+            if (i == 0)
+                probe = v;
+            ASSERT_TRUE(db.add_vector(v, meta).has_value());
+        }
+
+        QueryOptions options;
+        options.k = 40;
+        options.numeric_filters = {
+            index::NumericPredicate::greater(index::MarketField::Vix, 20.0f),
+            index::NumericPredicate::between(index::MarketField::Dxy, 100.0f, 105.0f),
+        };
+        auto results = db.query_vector(probe, options);
+        ASSERT_TRUE(results.has_value());
+        ASSERT_FALSE(results->empty());
+        for (const auto &r : *results)
+        {
+            ASSERT_TRUE(r.metadata.has_value());
+            EXPECT_GT(*r.metadata->vix, 20.0f);
+            EXPECT_GE(*r.metadata->dxy, 100.0f);
+            EXPECT_LE(*r.metadata->dxy, 105.0f);
+        }
+
+        // Combined with a posting filter that excludes everything
+        options.asset_filter = "SILVER";
+        results = db.query_vector(probe, options);
+        ASSERT_TRUE(results.has_value());
+        EXPECT_TRUE(results->empty());
+    }
+
+    TEST_F(DatabaseTest, QueryCacheServesRepeatsUntilWrite)
+    {
+        config_.auto_sync = false;
+        config_.query_cache.max_bytes = 1 << 20;
+        config_.query_cache.similarity_threshold = 0.999f;
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(31);
+        for (int i = 0; i < 20; ++i)
+        {
+            ASSERT_TRUE(db.add_vector(random_vector(rng), make_meta("2025-09-01")).has_value());
+        }
+
+        auto probe = random_vector(rng);
+        QueryOptions options;
+        options.k = 3;
+        auto first = db.query_vector(probe, options);
+        ASSERT_TRUE(first.has_value());
+        auto second = db.query_vector(probe, options);
+        ASSERT_TRUE(second.has_value());
+        ASSERT_EQ(first->size(), second->size());
+        EXPECT_EQ(first->front().id, second->front().id);
+
+        // Different options are a different key
+        options.k = 4;
+        ASSERT_TRUE(db.query_vector(probe, options).has_value());
+
+        // A slightly perturbed query is a near-duplicate
+        auto nudged = probe;
+        nudged[0] += 1e-4f;
+        options.k = 3;
+        ASSERT_TRUE(db.query_vector(nudged, options).has_value());
+
+        auto stats = db.query_cache_stats();
+        ASSERT_TRUE(stats.has_value());
+        EXPECT_EQ(stats->misses, 2u);
+        EXPECT_EQ(stats->hits + stats->near_hits, 2u);
+        EXPECT_GT(stats->bytes, 0u);
+
+        // Any write bumps the epoch and invalidates cached results
+        ASSERT_TRUE(db.add_vector(probe, make_meta("2025-09-02")).has_value());
+        auto after = db.query_vector(probe, options);
+        ASSERT_TRUE(after.has_value());
+        EXPECT_EQ(after->front().id, 21u);
+        EXPECT_GE(db.query_cache_stats()->invalidations, 1u);
+    }
+
+    TEST(QueryResultCacheTest, QueryScaleIsPartOfKeyUnlessCosine)
+    {
+        QueryCacheConfig config;
+        config.max_bytes = 1 << 20;
+        config.similarity_threshold = 0.999f;
+
+        std::mt19937 rng(37);
+        std::normal_distribution<float> dist;
+        std::vector<float> query(64);
+        for (auto &v : query)
+            v = dist(rng);
+        std::vector<float> doubled(query);
+        for (auto &v : doubled)
+            v *= 2.0f;
+
+        QueryResults results(1);
+        results[0].id = 7;
+
+        // Cosine ranks v and 2v identically, so they share an entry
+        QueryResultCache cosine(config, DistanceMetric::Cosine);
+        cosine.insert(query, 1, 0, results, 0);
+        EXPECT_TRUE(cosine.lookup(doubled, 1, 0).has_value());
+
+        // L2 and dot product do not: neither the key nor the near-duplicate
+        // scan may match a rescaled query
+        for (auto metric : {DistanceMetric::L2, DistanceMetric::DotProduct})
+        {
+            QueryResultCache cache(config, metric);
+            cache.insert(query, 1, 0, results, 0);
+            EXPECT_TRUE(cache.lookup(query, 1, 0).has_value());
+            EXPECT_FALSE(cache.lookup(doubled, 1, 0).has_value());
+            EXPECT_EQ(cache.stats().misses, 1u);
+        }
+    }
+
+    // ============================================================================
+    // Batch Tests
+    // ============================================================================
+
+    TEST_F(DatabaseTest, QueryBatchMatchesSingleQueries)
+    {
+        config_.auto_sync = false;
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(37);
+        std::vector<std::vector<Scalar>> stored;
+        BatchInsertRequest inserts;
+        for (int i = 0; i < 60; ++i)
+        {
+            stored.push_back(random_vector(rng));
+        }
+        for (int i = 0; i < 60; ++i)
+        {
+            inserts.push_back({stored[i], make_meta("2025-10-01", i % 5 == 0 ? "GOLD" : "SILVER")});
+        }
+
+        size_t progress_calls = 0;
+        BatchConfig batch;
+        batch.batch_size = 25;
+        batch.progress_callback = [&](size_t done, size_t total)
+        {
+            progress_calls++;
+            EXPECT_LE(done, total);
+        };
+        auto inserted = db.insert_batch(inserts, batch);
+        EXPECT_EQ(inserted.successful, 60u);
+        EXPECT_EQ(inserted.ids.size(), 60u);
+        EXPECT_EQ(progress_calls, 3u);
+
+        std::vector<std::vector<Scalar>> probes;
+        for (int i = 0; i < 20; ++i)
+        {
+            probes.push_back(random_vector(rng));
+        }
+        BatchQueryRequest queries;
+        for (size_t i = 0; i < probes.size(); ++i)
+        {
+            queries.push_back({probes[i], 3 + i % 3});
+        }
+
+        // Unfiltered (graph search) and filtered (exact scan in blocks)
+        for (bool filtered : {false, true})
+        {
+            QueryOptions options;
+            if (filtered)
+                options.asset_filter = "GOLD";
+
+            auto batched = db.query_batch(queries, options);
+            ASSERT_TRUE(batched.has_value());
+            ASSERT_EQ(batched->size(), queries.size());
+            for (size_t i = 0; i < queries.size(); ++i)
+            {
+                options.k = queries[i].k;
+                auto single = db.query_vector(probes[i], options);
+                ASSERT_TRUE(single.has_value());
+                ASSERT_EQ((*batched)[i].size(), single->size());
+                for (size_t r = 0; r < single->size(); ++r)
+                {
+                    EXPECT_EQ((*batched)[i][r].id, (*single)[r].id);
+                    EXPECT_EQ((*batched)[i][r].plan, (*single)[r].plan);
+                }
+            }
+        }
+
+        BatchQueryRequest bad = {{VectorView(probes[0].data(), 4), 3}};
+        EXPECT_FALSE(db.query_batch(bad).has_value());
+    }
+
+    TEST_F(DatabaseTest, InsertBatchTransactionalIsAllOrNothing)
+    {
+        config_.auto_sync = false;
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(41);
+        auto good = random_vector(rng);
+        std::vector<Scalar> short_vector(4, 0.5f);
+        BatchInsertRequest items = {
+            {good, make_meta("2025-10-02")},
+            {short_vector, make_meta("2025-10-02")},
+            {good, make_meta("2025-10-03")},
+        };
+
+        BatchConfig transactional;
+        transactional.transactional = true;
+        auto rejected = db.insert_batch(items, transactional);
+        EXPECT_EQ(rejected.successful, 0u);
+        EXPECT_EQ(rejected.failed, 3u);
+        EXPECT_EQ(db.size(), 0u);
+
+        // Without a transaction the valid items still land
+        auto partial = db.insert_batch(items);
+        EXPECT_EQ(partial.successful, 2u);
+        EXPECT_EQ(partial.failed, 1u);
+        ASSERT_EQ(partial.errors.size(), 1u);
+        EXPECT_NE(partial.errors[0].find("Item 1"), std::string::npos);
+        EXPECT_EQ(db.size(), 2u);
+        EXPECT_EQ(db.find_by_date("2025-10-03").size(), 1u);
+    }
+
+    // ============================================================================
+    // Async Tests
+    // ============================================================================
+
+    TEST_F(DatabaseTest, AsyncInsertAndQuery)
+    {
+        config_.auto_sync = false;
+        config_.async_threads = 2;
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(43);
+        std::vector<std::future<Result<VectorId>>> inserts;
+        std::vector<Scalar> probe;
+        for (int i = 0; i < 30; ++i)
+        {
+            // The buffer goes out of scope before the insert runs
+            auto v = random_vector(rng);
+            if (i == 7)
+                probe = v;
+            inserts.push_back(db.add_vector_async(v, make_meta("2025-11-01")));
+        }
+        for (auto &f : inserts)
+        {
+            auto id = f.get();
+            ASSERT_TRUE(id.has_value());
+        }
+        EXPECT_EQ(db.size(), 30u);
+
+        QueryOptions options;
+        options.k = 1;
+        auto result = db.query_vector_async(probe, options, TaskPriority::High).get();
+        ASSERT_TRUE(result.has_value());
+        ASSERT_EQ(result->size(), 1u);
+        auto expected = db.query_vector(probe, options);
+        ASSERT_TRUE(expected.has_value());
+        EXPECT_EQ(result->front().id, expected->front().id);
+
+        std::promise<Result<QueryResults>> delivered;
+        db.query_vector_async(probe, options, [&](Result<QueryResults> r)
+                              { delivered.set_value(std::move(r)); });
+        auto via_callback = delivered.get_future().get();
+        ASSERT_TRUE(via_callback.has_value());
+        EXPECT_EQ(via_callback->front().id, expected->front().id);
+
+        std::vector<Scalar> wrong(3, 0.0f);
+        auto rejected = db.query_vector_async(wrong).get();
+        EXPECT_FALSE(rejected.has_value());
+
+        // A throwing callback is contained; the worker keeps serving
+        std::promise<void> thrown;
+        db.query_vector_async(probe, options, [&](Result<QueryResults>)
+                              {
+            thrown.set_value();
+            throw std::runtime_error("callback failure"); });
+        thrown.get_future().get();
+        auto after = db.query_vector_async(probe, options).get();
+        ASSERT_TRUE(after.has_value());
+        EXPECT_EQ(after->front().id, expected->front().id);
+    }
+
+    TEST_F(DatabaseTest, QueryBudgetReturnsPartialResults)
+    {
+        config_.auto_sync = false;
+        config_.query_cache.max_bytes = 1 << 20;
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(47);
+        for (int i = 0; i < 200; ++i)
+        {
+            ASSERT_TRUE(db.add_vector(random_vector(rng), make_meta("2025-12-01")).has_value());
+        }
+        auto probe = random_vector(rng);
+
+        QueryOptions options;
+        options.k = 5;
+        auto complete = db.query_vector(probe, options);
+        ASSERT_TRUE(complete.has_value());
+        ASSERT_EQ(complete->size(), 5u);
+        EXPECT_FALSE(complete->front().partial);
+        EXPECT_EQ(db.budget_stats().budgeted_queries, 0u);
+
+        // A cached complete answer needs no budget
+        options.max_distance_computations = 3;
+        auto cached = db.query_vector(probe, options);
+        ASSERT_TRUE(cached.has_value());
+        EXPECT_FALSE(cached->front().partial);
+
+        // A tiny computation budget returns best-so-far results, uncached
+        probe = random_vector(rng);
+        auto limited = db.query_vector(probe, options);
+        ASSERT_TRUE(limited.has_value());
+        ASSERT_FALSE(limited->empty());
+        EXPECT_TRUE(limited->front().partial);
+
+        options.max_distance_computations = 0;
+        options.deadline = std::chrono::steady_clock::now() - std::chrono::milliseconds(1);
+        options.k = 6;
+        options.profile = std::make_shared<QueryProfile>();
+        auto late = db.query_vector(probe, options);
+        ASSERT_TRUE(late.has_value());
+        // An expired deadline may return nothing; the profile still reports it
+        EXPECT_TRUE(options.profile->partial);
+        for (const auto &result : *late)
+            EXPECT_TRUE(result.partial);
+
+        auto stats = db.budget_stats();
+        EXPECT_EQ(stats.budgeted_queries, 2u);
+        EXPECT_EQ(stats.computations_exceeded, 1u);
+        EXPECT_EQ(stats.deadline_exceeded, 1u);
+        EXPECT_EQ(db.query_cache_stats()->entries, 1u);
+    }
+
+    TEST_F(DatabaseTest, QueryProfileBreaksDownExecution)
+    {
+        config_.auto_sync = false;
+        config_.query_cache.max_bytes = 1 << 20;
+        VectorDatabase db(config_);
+        ASSERT_TRUE(db.init().has_value());
+
+        std::mt19937 rng(53);
+        for (int i = 0; i < 100; ++i)
+        {
+            ASSERT_TRUE(db.add_vector(random_vector(rng), make_meta("2025-12-02", i % 10 == 0 ? "GOLD" : "SILVER")).has_value());
+        }
+        auto probe = random_vector(rng);
+
+        QueryOptions options;
+        options.k = 4;
+        options.profile = std::make_shared<QueryProfile>();
+        auto results = db.query_vector(probe, options);
+        ASSERT_TRUE(results.has_value());
+
+        const QueryProfile &profile = *options.profile;
+        EXPECT_EQ(profile.plan, QueryPlan::Hnsw);
+        EXPECT_FALSE(profile.cache_hit);
+        EXPECT_EQ(profile.results, results->size());
+        EXPECT_GT(profile.nodes_visited, 0u);
+        EXPECT_GE(profile.distance_computations, profile.nodes_visited);
+        EXPECT_GT(profile.heap_operations, 0u);
+        EXPECT_GE(profile.total_ns, profile.search_ns);
+        EXPECT_NE(profile.to_string().find("distances computed"), std::string::npos);
+
+        // Profiling does not change the cache key
+        ASSERT_TRUE(db.query_vector(probe, options).has_value());
+        EXPECT_TRUE(options.profile->cache_hit);
+
+        options.asset_filter = "GOLD";
+        ASSERT_TRUE(db.query_vector(probe, options).has_value());
+        EXPECT_EQ(options.profile->candidates, 10u);
+        EXPECT_EQ(options.profile->plan, QueryPlan::ExactScan);
+        EXPECT_EQ(options.profile->nodes_visited, 10u);
+    }
+
+} // namespace vdb::test
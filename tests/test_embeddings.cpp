@@ -3,6 +3,11 @@
 // ============================================================================
 
 #include <gtest/gtest.h>
+#include "vdb/embeddings/embedding_cache.hpp"
+#include <filesystem>
+#ifdef HAVE_SQLITE3
+#include "vdb/storage/sqlite_store.hpp"
+#endif
 #ifdef VDB_USE_ONNX_RUNTIME
 #include "vdb/embeddings/onnx_runtime.hpp"
 #include "vdb/embeddings/text.hpp"
@@ -80,4 +85,89 @@ TEST(EmbeddingsTest, OnnxRuntimeNotAvailable) {
 }
 #endif
 
+// ============================================================================
+// Embedding Cache Tests
+// ============================================================================
+
+TEST(EmbeddingCacheTest, KeysSeparateModels) {
+    embeddings::EmbeddingCache cache;
+    std::vector<float> a = {1.0f, 2.0f, 3.0f};
+    cache.put("model-a", "gold breaks out", a);
+
+    auto hit = cache.get("model-a", "gold breaks out");
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(*hit, a);
+    EXPECT_FALSE(cache.get("model-b", "gold breaks out").has_value());
+    EXPECT_FALSE(cache.get("model-a", "gold breaks down").has_value());
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 2u);
+}
+
+TEST(EmbeddingCacheTest, ComputesOnceAndEvictsLru) {
+    embeddings::EmbeddingCacheConfig config;
+    config.max_entries = 2;
+    config.num_shards = 1;
+    embeddings::EmbeddingCache cache(config);
+
+    int calls = 0;
+    auto encode = [&calls](std::string_view text) -> Result<std::vector<float>> {
+        calls++;
+        return std::vector<float>{static_cast<float>(text.size())};
+    };
+
+    for (int i = 0; i < 3; ++i) {
+        auto embedding = cache.get_or_compute("m", "first", encode);
+        ASSERT_TRUE(embedding.has_value());
+        EXPECT_EQ((*embedding)[0], 5.0f);
+    }
+    EXPECT_EQ(calls, 1);
+
+    (void)cache.get_or_compute("m", "second", encode);
+    (void)cache.get("m", "first");  // Refresh, so "second" is the LRU entry
+    (void)cache.get_or_compute("m", "third", encode);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_TRUE(cache.get("m", "first").has_value());
+    EXPECT_FALSE(cache.get("m", "second").has_value());
+    EXPECT_EQ(cache.stats().evictions, 1u);
+}
+
+TEST(EmbeddingCacheTest, SaveLoadRoundTrip) {
+    auto path = std::filesystem::temp_directory_path() / "vdb_test_embedding.cache";
+    {
+        embeddings::EmbeddingCache cache;
+        cache.put("m", "alpha", std::vector<float>{0.5f, -0.25f});
+        cache.put("m", "beta", std::vector<float>{1.5f});
+        ASSERT_TRUE(cache.save(path).has_value());
+    }
+
+    embeddings::EmbeddingCache restored;
+    auto loaded = restored.load(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(*loaded, 2u);
+    EXPECT_EQ(restored.get("m", "alpha"), (std::vector<float>{0.5f, -0.25f}));
+    std::filesystem::remove(path);
+
+    EXPECT_FALSE(restored.load(path).has_value());
+}
+
+#ifdef HAVE_SQLITE3
+TEST(EmbeddingCacheTest, ReadsThroughSqliteStore) {
+    storage::SqliteStore store;
+    ASSERT_TRUE(store.init().has_value());
+
+    embeddings::EmbeddingCache cache;
+    cache.attach(&store);
+    cache.put("m", "persisted", std::vector<float>{4.0f, 2.0f});
+    cache.clear();
+
+    auto hit = cache.get("m", "persisted");
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(*hit, (std::vector<float>{4.0f, 2.0f}));
+    EXPECT_EQ(cache.stats().store_hits, 1u);
+    EXPECT_EQ(cache.size(), 1u);
+}
+#endif
+
 } // namespace vdb::test
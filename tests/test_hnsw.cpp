@@ -4,6 +4,7 @@
 
 #include <gtest/gtest.h>
 #include "vdb/index.hpp"
+#include "vdb/checkpoint.hpp"
 #include <random>
 #include <fstream>
 #include <filesystem>
@@ -356,4 +357,135 @@ namespace vdb::test
         std::filesystem::remove(temp_path);
     }
 
+    TEST_F(HNSWTest, SaveLoadPreservesDeletions)
+    {
+        HnswConfig config;
+        config.dimension = DIM;
+        config.max_elements = 100;
+        config.M = 8;
+
+        HnswIndex index(config);
+        for (size_t i = 0; i < 20; ++i)
+        {
+            ASSERT_TRUE(index.add(i + 1, vectors_[i]).has_value());
+        }
+        ASSERT_TRUE(index.remove(5).has_value());
+
+        auto loaded = HnswIndex::deserialize(index.serialize());
+        ASSERT_TRUE(loaded.has_value());
+        EXPECT_EQ(loaded->size(), 19);
+        EXPECT_FALSE(loaded->contains(5));
+
+        auto results = loaded->search(vectors_[4], 20);
+        for (const auto &r : results)
+        {
+            EXPECT_NE(r.id, 5);
+        }
+    }
+
+    TEST_F(HNSWTest, CorruptCheckpointFallsBackToPrevious)
+    {
+        HnswConfig config;
+        config.dimension = DIM;
+        config.max_elements = 100;
+        config.M = 8;
+
+        auto temp_path = std::filesystem::temp_directory_path() / "test_hnsw_checkpoint.bin";
+        std::filesystem::remove(temp_path);
+        std::filesystem::remove(previous_checkpoint_path(temp_path));
+
+        HnswIndex index(config);
+        for (size_t i = 0; i < 20; ++i)
+        {
+            ASSERT_TRUE(index.add(i + 1, vectors_[i]).has_value());
+        }
+        ASSERT_TRUE(index.save(temp_path.string()).has_value());
+
+        for (size_t i = 20; i < 30; ++i)
+        {
+            ASSERT_TRUE(index.add(i + 1, vectors_[i]).has_value());
+        }
+        ASSERT_TRUE(index.save(temp_path.string()).has_value());
+        EXPECT_TRUE(std::filesystem::exists(previous_checkpoint_path(temp_path)));
+
+        // Flip a byte inside the latest payload
+        {
+            std::fstream file(temp_path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(100);
+            char byte = 0x5A;
+            file.write(&byte, 1);
+        }
+        EXPECT_FALSE(read_checkpoint(temp_path).has_value());
+
+        auto load_result = HnswIndex::load(temp_path.string());
+        ASSERT_TRUE(load_result.has_value());
+        EXPECT_EQ(load_result->size(), 20);
+
+        std::filesystem::remove(temp_path);
+        std::filesystem::remove(previous_checkpoint_path(temp_path));
+    }
+
+    TEST_F(HNSWTest, BudgetStopsSearchEarly)
+    {
+        HnswConfig config;
+        config.dimension = DIM;
+        config.max_elements = NUM_VECTORS;
+        HnswIndex index(config);
+        for (size_t i = 0; i < 300; ++i)
+        {
+            ASSERT_TRUE(index.add(i + 1, vectors_[i]).has_value());
+        }
+
+        SearchBudget unlimited;
+        auto full = index.search(vectors_[5], 10, &unlimited);
+        EXPECT_EQ(full.size(), 10u);
+        EXPECT_FALSE(unlimited.exhausted());
+        EXPECT_GT(unlimited.distance_computations, 50u);
+
+        SearchBudget tight;
+        tight.max_distance_computations = 20;
+        auto partial = index.search(vectors_[5], 10, &tight);
+        EXPECT_TRUE(tight.computations_exceeded);
+        EXPECT_LE(tight.distance_computations, 21u);
+        EXPECT_FALSE(partial.empty());
+
+        SearchBudget expired;
+        expired.deadline = std::chrono::steady_clock::now() - std::chrono::milliseconds(1);
+        auto late = index.search_filtered(vectors_[5], 10, [](VectorId) { return true; }, &expired);
+        EXPECT_TRUE(expired.deadline_exceeded);
+        EXPECT_LT(late.size(), 10u);
+    }
+
+    TEST_F(HNSWTest, PerSearchEfLeavesConfigUntouched)
+    {
+        HnswConfig config;
+        config.dimension = DIM;
+        config.max_elements = NUM_VECTORS;
+        config.ef_search = 16;
+        HnswIndex index(config);
+        for (size_t i = 0; i < 300; ++i)
+        {
+            ASSERT_TRUE(index.add(i + 1, vectors_[i]).has_value());
+        }
+
+        SearchBudget narrow;
+        auto configured = index.search(vectors_[5], 10, &narrow);
+        SearchBudget wide;
+        auto widened = index.search(vectors_[5], 10, &wide, 200);
+        SearchBudget wide_filtered;
+        auto filtered = index.search_filtered(vectors_[5], 10, [](VectorId) { return true; },
+                                              &wide_filtered, 200);
+        EXPECT_EQ(configured.size(), 10u);
+        EXPECT_EQ(widened.size(), 10u);
+        EXPECT_EQ(filtered.size(), 10u);
+        EXPECT_GT(wide.distance_computations, narrow.distance_computations);
+        EXPECT_GT(wide_filtered.distance_computations, narrow.distance_computations);
+
+        // The override applied to those searches only
+        EXPECT_EQ(index.config().ef_search, 16u);
+        SearchBudget again;
+        (void)index.search(vectors_[5], 10, &again);
+        EXPECT_EQ(again.distance_computations, narrow.distance_computations);
+    }
+
 } // namespace vdb::test
@@ -5,7 +5,12 @@
 #include "vdb/hybrid_search.hpp"
 #include "vdb/core.hpp"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cmath>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <unordered_map>
 
 using namespace vdb;
 using namespace vdb::hybrid;
@@ -197,3 +202,295 @@ TEST_F(HybridSearchTest, BothResultsEmpty) {
     ASSERT_TRUE(results.has_value());
     EXPECT_TRUE(results->empty());
 }
+
+// ============================================================================
+// One-Shot Search Tests
+// ============================================================================
+
+TEST(HybridQueryTest, ConcurrentSearchMatchesSequentialCombine) {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "vdb_hybrid_query_test";
+    fs::remove_all(dir);
+
+    DatabaseConfig db_config;
+    db_config.path = dir;
+    db_config.dimension = 8;
+    db_config.max_elements = 100;
+    {
+        VectorDatabase db(db_config);
+        ASSERT_TRUE(db.init().has_value());
+
+        const std::vector<std::string> texts = {
+            "gold prices rally on inflation data",
+            "silver miners report record output",
+            "central bank holds interest rates",
+            "gold futures slip as dollar firms",
+            "oil inventories rise unexpectedly",
+            "equities climb while gold prices ease",
+        };
+        BM25Engine bm25;
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<float> query_vector;
+        for (size_t i = 0; i < texts.size(); ++i) {
+            std::vector<float> v(db_config.dimension);
+            for (auto& x : v) x = dist(rng);
+            if (i == 2) query_vector = v;
+
+            Metadata meta;
+            meta.type = DocumentType::Journal;
+            meta.date = "2025-01-0" + std::to_string(i + 1);
+            meta.asset = "GOLD";
+            auto id = db.add_vector(v, meta);
+            ASSERT_TRUE(id.has_value());
+            ASSERT_TRUE(bm25.add_document(*id, texts[i]).has_value());
+        }
+
+        HybridSearchEngine engine;
+        HybridQueryOptions options;
+        options.k = 4;
+        options.candidates = 6;
+        auto results = engine.search(db, bm25, "gold prices", VectorView(query_vector), options);
+        ASSERT_TRUE(results.has_value());
+
+        QueryOptions vector_options;
+        vector_options.k = 6;
+        auto vector_results = db.query_vector(VectorView(query_vector), vector_options);
+        auto lexical_results = bm25.search("gold prices", 6);
+        ASSERT_TRUE(vector_results.has_value());
+        ASSERT_TRUE(lexical_results.has_value());
+        auto expected = engine.combine(*vector_results, *lexical_results, 4);
+        ASSERT_TRUE(expected.has_value());
+
+        ASSERT_EQ(results->size(), expected->size());
+        for (size_t i = 0; i < results->size(); ++i) {
+            EXPECT_EQ((*results)[i].id, (*expected)[i].id);
+            EXPECT_FLOAT_EQ((*results)[i].combined_score, (*expected)[i].combined_score);
+            EXPECT_EQ((*results)[i].matched_keywords, (*expected)[i].matched_keywords);
+            ASSERT_TRUE((*results)[i].metadata.has_value());
+            EXPECT_EQ((*results)[i].metadata->id, (*results)[i].id);
+        }
+
+        // Only stop words: ranked by the vector side alone
+        auto vector_only = engine.search(db, bm25, "the and of", VectorView(query_vector), options);
+        ASSERT_TRUE(vector_only.has_value());
+        ASSERT_EQ(vector_only->size(), 4u);
+        EXPECT_EQ((*vector_only)[0].id, (*vector_results)[0].id);
+        EXPECT_EQ((*vector_only)[0].lexical_score, 0.0f);
+    }
+    fs::remove_all(dir);
+}
+
+TEST_F(HybridSearchTest, SparseThirdRetriever) {
+    std::vector<SparseResult> sparse_results = {
+        {5, 2.5f},
+        {2, 1.5f}
+    };
+
+    HybridSearchEngine engine;
+    auto results = engine.combine(vector_results_, lexical_results_, sparse_results, 10);
+    ASSERT_TRUE(results.has_value());
+    ASSERT_EQ(results->size(), 5u);
+
+    // Doc 2 is the only document all three retrievers return
+    EXPECT_EQ((*results)[0].id, 2u);
+    EXPECT_FLOAT_EQ((*results)[0].sparse_score, 1.5f);
+    EXPECT_FLOAT_EQ((*results)[0].combined_score, 1.0f / 62 + 1.0f / 61 + 1.0f / 62);
+    auto doc5 = std::find_if(results->begin(), results->end(),
+                             [](const HybridResult& r) { return r.id == 5; });
+    ASSERT_NE(doc5, results->end());
+    EXPECT_EQ(doc5->vector_score, 0.0f);
+    EXPECT_FLOAT_EQ(doc5->sparse_score, 2.5f);
+
+    // An empty sparse ranking leaves two-way fusion unchanged
+    auto two_way = engine.combine(vector_results_, lexical_results_, 10);
+    auto three_way = engine.combine(vector_results_, lexical_results_, {}, 10);
+    ASSERT_TRUE(two_way.has_value());
+    ASSERT_TRUE(three_way.has_value());
+    ASSERT_EQ(two_way->size(), three_way->size());
+    for (size_t i = 0; i < two_way->size(); ++i) {
+        EXPECT_EQ((*two_way)[i].id, (*three_way)[i].id);
+        EXPECT_EQ((*two_way)[i].combined_score, (*three_way)[i].combined_score);
+    }
+}
+
+// ============================================================================
+// Sparse Index Tests
+// ============================================================================
+
+namespace {
+
+SparseVector random_sparse(std::mt19937& rng, size_t nnz, uint32_t vocabulary) {
+    std::uniform_int_distribution<uint32_t> term(0, vocabulary - 1);
+    std::exponential_distribution<float> weight(1.0f);
+    SparseVector v;
+    for (size_t i = 0; i < nnz; ++i) {
+        v.terms.push_back(term(rng));
+        v.weights.push_back(weight(rng));
+    }
+    return v;
+}
+
+float dot(const SparseVector& a, const SparseVector& b) {
+    std::unordered_map<uint32_t, float> weights;
+    for (size_t i = 0; i < a.terms.size(); ++i) weights[a.terms[i]] += a.weights[i];
+    float score = 0.0f;
+    for (size_t i = 0; i < b.terms.size(); ++i) {
+        auto it = weights.find(b.terms[i]);
+        if (it != weights.end()) score += it->second * b.weights[i];
+    }
+    return score;
+}
+
+} // anonymous namespace
+
+TEST(SparseIndexTest, MaxScoreMatchesExhaustiveDotProduct) {
+    std::mt19937 rng(11);
+    SparseIndex index;
+    std::unordered_map<VectorId, SparseVector> documents;
+    for (VectorId id = 1; id <= 2000; ++id) {
+        documents[id] = random_sparse(rng, 24, 400);
+        ASSERT_TRUE(index.add(id, documents[id]).has_value());
+    }
+    for (VectorId id = 1; id <= 2000; id += 7) {
+        ASSERT_TRUE(index.remove(id).has_value());
+        documents.erase(id);
+    }
+    EXPECT_EQ(index.size(), documents.size());
+    EXPECT_FALSE(index.contains(8));
+
+    for (int q = 0; q < 20; ++q) {
+        SparseVector query = random_sparse(rng, 16, 400);
+        auto results = index.search(query, 10);
+        ASSERT_TRUE(results.has_value());
+
+        std::vector<float> expected;
+        for (const auto& [id, doc] : documents) {
+            float score = dot(query, doc);
+            if (score > 0.0f) expected.push_back(score);
+        }
+        std::sort(expected.rbegin(), expected.rend());
+        expected.resize(std::min<size_t>(expected.size(), 10));
+
+        ASSERT_EQ(results->size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_NEAR((*results)[i].score, expected[i], 1e-4f);
+            EXPECT_NEAR((*results)[i].score, dot(query, documents.at((*results)[i].id)), 1e-4f);
+        }
+    }
+
+    SparseVector invalid{{1, 2}, {0.5f}};
+    EXPECT_FALSE(index.add(5000, invalid).has_value());
+    EXPECT_FALSE(index.search(invalid).has_value());
+}
+
+TEST(SparseIndexTest, SerializeRoundTrip) {
+    std::mt19937 rng(5);
+    SparseIndex index;
+    for (VectorId id = 1; id <= 300; ++id) {
+        ASSERT_TRUE(index.add(id, random_sparse(rng, 12, 100)).has_value());
+    }
+    ASSERT_TRUE(index.remove(10).has_value());
+
+    auto bytes = index.serialize();
+    auto restored = SparseIndex::deserialize(bytes);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->size(), 299u);
+    EXPECT_FALSE(restored->contains(10));
+
+    SparseVector query = random_sparse(rng, 8, 100);
+    auto expected = index.search(query, 20);
+    auto actual = restored->search(query, 20);
+    ASSERT_TRUE(expected.has_value());
+    ASSERT_TRUE(actual.has_value());
+    ASSERT_EQ(actual->size(), expected->size());
+    for (size_t i = 0; i < actual->size(); ++i) {
+        EXPECT_EQ((*actual)[i].id, (*expected)[i].id);
+        EXPECT_EQ((*actual)[i].score, (*expected)[i].score);
+    }
+
+    bytes.resize(bytes.size() / 2);
+    EXPECT_FALSE(SparseIndex::deserialize(bytes).has_value());
+}
+
+TEST(SparseIndexTest, PersistsWithDatabase) {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "vdb_sparse_index_test";
+    fs::remove_all(dir);
+
+    DatabaseConfig db_config;
+    db_config.path = dir;
+    db_config.dimension = 4;
+    db_config.max_elements = 16;
+    std::vector<VectorId> ids;
+    {
+        VectorDatabase db(db_config);
+        ASSERT_TRUE(db.init().has_value());
+        for (int i = 0; i < 3; ++i) {
+            std::vector<float> v = {1.0f, float(i), 0.0f, 0.5f};
+            Metadata meta;
+            meta.type = DocumentType::Journal;
+            meta.date = "2025-02-0" + std::to_string(i + 1);
+            auto id = db.add_vector(v, meta);
+            ASSERT_TRUE(id.has_value());
+            ids.push_back(*id);
+            ASSERT_TRUE(db.add_sparse(*id, SparseVector{{7, uint32_t(100 + i)}, {float(i + 1), 1.0f}}).has_value());
+        }
+        EXPECT_FALSE(db.add_sparse(9999, SparseVector{{7}, {1.0f}}).has_value());
+        ASSERT_TRUE(db.remove(ids[0]).has_value());
+        ASSERT_TRUE(db.sync().has_value());
+    }
+    {
+        VectorDatabase db(db_config);
+        ASSERT_TRUE(db.init().has_value());
+        auto results = db.query_sparse(SparseVector{{7}, {1.0f}}, 10);
+        ASSERT_TRUE(results.has_value());
+        ASSERT_EQ(results->size(), 2u);
+        EXPECT_EQ((*results)[0].id, ids[2]);
+        EXPECT_FLOAT_EQ((*results)[0].score, 3.0f);
+        EXPECT_EQ((*results)[1].id, ids[1]);
+    }
+    fs::remove_all(dir);
+}
+
+TEST(SparseIndexTest, CheckpointerPersistsSparseOnlyWrites) {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "vdb_sparse_checkpoint_test";
+    fs::remove_all(dir);
+
+    DatabaseConfig db_config;
+    db_config.path = dir;
+    db_config.dimension = 4;
+    db_config.max_elements = 16;
+    db_config.auto_sync = false;
+    db_config.sync_interval_ms = 20;
+    {
+        VectorDatabase db(db_config);
+        ASSERT_TRUE(db.init().has_value());
+        Metadata meta;
+        meta.type = DocumentType::Journal;
+        meta.date = "2025-03-01";
+        auto id = db.add_vector(std::vector<float>{1.0f, 0.0f, 0.0f, 0.5f}, meta);
+        ASSERT_TRUE(id.has_value());
+        ASSERT_TRUE(db.sync().has_value());
+        uint64_t epoch = db.write_epoch();
+
+        // No dense write follows, so only the sparse generation marks this dirty
+        ASSERT_TRUE(db.add_sparse(*id, SparseVector{{3}, {2.0f}}).has_value());
+        EXPECT_EQ(db.write_epoch(), epoch);
+
+        // Read the checkpoint file while the database is still open, so
+        // the destructor's final sync cannot be what wrote it
+        std::optional<SparseIndex> saved;
+        for (int i = 0; i < 200; ++i) {
+            if (auto loaded = SparseIndex::load(dir / "index.sparse"); loaded && loaded->size() == 1) {
+                saved = std::move(*loaded);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ASSERT_TRUE(saved.has_value());
+        EXPECT_TRUE(saved->contains(*id));
+    }
+    fs::remove_all(dir);
+}
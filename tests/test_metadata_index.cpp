@@ -0,0 +1,250 @@
+// ============================================================================
+// VectorDB Tests - Metadata Index & Roaring Bitmap
+// ============================================================================
+
+#include <gtest/gtest.h>
+#include "vdb/index/metadata_index.hpp"
+#include "vdb/index/numeric_columns.hpp"
+#include "vdb/index/roaring_bitmap.hpp"
+#include <filesystem>
+#include <random>
+#include <set>
+
+namespace vdb::test {
+
+using index::RoaringBitmap;
+
+namespace {
+
+std::vector<VectorId> reference_ids(const std::set<VectorId>& ids) {
+    return {ids.begin(), ids.end()};
+}
+
+}  // anonymous namespace
+
+// ============================================================================
+// Roaring Bitmap
+// ============================================================================
+
+TEST(RoaringBitmapTest, AddRemoveContains) {
+    RoaringBitmap bitmap;
+    EXPECT_TRUE(bitmap.empty());
+
+    bitmap.add(5);
+    bitmap.add(70000);
+    bitmap.add(5);
+    EXPECT_EQ(bitmap.cardinality(), 2u);
+    EXPECT_TRUE(bitmap.contains(5));
+    EXPECT_TRUE(bitmap.contains(70000));
+    EXPECT_FALSE(bitmap.contains(6));
+
+    EXPECT_TRUE(bitmap.remove(5));
+    EXPECT_FALSE(bitmap.remove(5));
+    EXPECT_EQ(bitmap.to_vector(), std::vector<VectorId>{70000});
+}
+
+TEST(RoaringBitmapTest, DenseChunkConvertsBothWays) {
+    RoaringBitmap bitmap;
+    for (VectorId id = 0; id < 10000; ++id) bitmap.add(id * 2);
+    EXPECT_EQ(bitmap.cardinality(), 10000u);
+    // A full bitmap container is 8 KiB; an array of 10000 would be ~20 KiB
+    EXPECT_LT(bitmap.memory_usage(), 16 * 1024u);
+
+    for (VectorId id = 0; id < 9000; ++id) EXPECT_TRUE(bitmap.remove(id * 2));
+    EXPECT_EQ(bitmap.cardinality(), 1000u);
+    EXPECT_TRUE(bitmap.contains(19998));
+    EXPECT_FALSE(bitmap.contains(2));
+}
+
+TEST(RoaringBitmapTest, SetAlgebraMatchesStdSet) {
+    std::mt19937_64 gen(7);
+    // Mix sparse and dense chunks so every container pairing is exercised
+    std::uniform_int_distribution<VectorId> sparse(0, 1 << 20);
+    std::uniform_int_distribution<VectorId> dense(0, 20000);
+
+    std::set<VectorId> a_ref, b_ref;
+    for (int i = 0; i < 3000; ++i) a_ref.insert(sparse(gen));
+    for (int i = 0; i < 12000; ++i) a_ref.insert(dense(gen));
+    for (int i = 0; i < 3000; ++i) b_ref.insert(sparse(gen));
+    for (int i = 0; i < 8000; ++i) b_ref.insert(dense(gen));
+
+    auto a = RoaringBitmap::from_ids(reference_ids(a_ref));
+    auto b = RoaringBitmap::from_ids(reference_ids(b_ref));
+
+    std::vector<VectorId> expected;
+    std::set_intersection(a_ref.begin(), a_ref.end(), b_ref.begin(), b_ref.end(),
+                          std::back_inserter(expected));
+    EXPECT_EQ((a & b).to_vector(), expected);
+
+    expected.clear();
+    std::set_union(a_ref.begin(), a_ref.end(), b_ref.begin(), b_ref.end(),
+                   std::back_inserter(expected));
+    EXPECT_EQ((a | b).to_vector(), expected);
+
+    expected.clear();
+    std::set_difference(a_ref.begin(), a_ref.end(), b_ref.begin(), b_ref.end(),
+                        std::back_inserter(expected));
+    EXPECT_EQ((a - b).to_vector(), expected);
+}
+
+TEST(RoaringBitmapTest, RunOptimizeAndSerialize) {
+    RoaringBitmap bitmap;
+    for (VectorId id = 1; id <= 50000; ++id) bitmap.add(id);
+    bitmap.add(1'000'000);
+
+    size_t before = bitmap.memory_usage();
+    bitmap.run_optimize();
+    EXPECT_LT(bitmap.memory_usage(), before);
+    EXPECT_TRUE(bitmap.contains(25000));
+    EXPECT_FALSE(bitmap.contains(50001));
+
+    // Runs still support mutation
+    bitmap.add(60000);
+    EXPECT_TRUE(bitmap.remove(100));
+    EXPECT_EQ(bitmap.cardinality(), 50001u);
+
+    std::vector<uint8_t> bytes;
+    bitmap.serialize(bytes);
+    size_t offset = 0;
+    auto restored = RoaringBitmap::deserialize(bytes, offset);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(offset, bytes.size());
+    EXPECT_TRUE(*restored == bitmap);
+
+    bytes.resize(bytes.size() / 2);
+    offset = 0;
+    EXPECT_FALSE(RoaringBitmap::deserialize(bytes, offset).has_value());
+}
+
+TEST(RoaringBitmapTest, DeserializeRejectsMalformedContainers) {
+    // One container with key 0: kind (0 array, 2 run), count, then uint16 payload
+    auto encode = [](uint8_t kind, uint32_t n, std::initializer_list<uint16_t> payload) {
+        std::vector<uint8_t> bytes;
+        auto put = [&](const auto& value) {
+            const auto* raw = reinterpret_cast<const uint8_t*>(&value);
+            bytes.insert(bytes.end(), raw, raw + sizeof(value));
+        };
+        put(uint64_t{1});
+        put(uint64_t{0});
+        put(kind);
+        put(n);
+        for (uint16_t v : payload) put(v);
+        return bytes;
+    };
+    auto accepts = [](const std::vector<uint8_t>& bytes) {
+        size_t offset = 0;
+        return RoaringBitmap::deserialize(bytes, offset).has_value();
+    };
+
+    EXPECT_TRUE(accepts(encode(0, 3, {1, 5, 9})));
+    EXPECT_FALSE(accepts(encode(0, 3, {1, 5, 5})));          // Duplicate value
+    EXPECT_FALSE(accepts(encode(0, 3, {1, 9, 5})));          // Unsorted
+
+    EXPECT_TRUE(accepts(encode(2, 2, {10, 4, 20, 0})));      // [10,14] [20,20]
+    EXPECT_FALSE(accepts(encode(2, 2, {10, 4, 14, 2})));     // Overlapping
+    EXPECT_FALSE(accepts(encode(2, 2, {20, 0, 10, 4})));     // Unsorted
+
+    // Run count far beyond the bytes present (and the container limit)
+    // must be refused before anything is allocated
+    EXPECT_FALSE(accepts(encode(2, 0xFFFFFFFFu, {10, 4})));
+    EXPECT_FALSE(accepts(encode(2, 1000, {10, 4})));
+}
+
+// ============================================================================
+// Metadata Index
+// ============================================================================
+
+TEST(MetadataIndexTest, FilterUsesBitmapPostings) {
+    index::MetadataIndex idx;
+    ASSERT_TRUE(idx.create_index("date").has_value());
+    ASSERT_TRUE(idx.create_index("bias").has_value());
+
+    for (VectorId id = 1; id <= 100; ++id) {
+        Metadata meta;
+        meta.date = id <= 50 ? "2025-01-01" : "2025-01-02";
+        meta.bias = id % 2 == 0 ? "BULLISH" : "BEARISH";
+        ASSERT_TRUE(idx.insert(id, meta).has_value());
+    }
+
+    std::vector<index::FilterCondition> conditions = {
+        {"date", index::FilterOp::Equal, "2025-01-02", {}, {}},
+        {"bias", index::FilterOp::Equal, "BULLISH", {}, {}},
+    };
+    EXPECT_EQ(idx.query_and(conditions).cardinality(), 25u);
+    EXPECT_EQ(idx.query_or(conditions).cardinality(), 75u);
+
+    auto filter = idx.create_filter(conditions);
+    EXPECT_TRUE(filter(52));
+    EXPECT_FALSE(filter(51));
+    EXPECT_FALSE(filter(2));
+
+    EXPECT_EQ(idx.count("date", "2025-01-01"), 50u);
+    EXPECT_EQ(idx.total_entries(), 200u);
+}
+
+// ============================================================================
+// Numeric Columns
+// ============================================================================
+
+TEST(MetadataIndexTest, OptimizedPostingsSurviveSaveAndLoad) {
+    index::MetadataIndex idx;
+    ASSERT_TRUE(idx.create_index("asset").has_value());
+    for (VectorId id = 1; id <= 20000; ++id) {
+        Metadata meta;
+        meta.asset = id <= 15000 ? "GOLD" : "SILVER";
+        ASSERT_TRUE(idx.insert(id, meta).has_value());
+    }
+
+    // Consecutive IDs collapse into runs
+    size_t before = idx.memory_usage();
+    idx.optimize();
+    EXPECT_LT(idx.memory_usage(), before);
+    EXPECT_EQ(idx.count("asset", "GOLD"), 15000u);
+
+    auto path = std::filesystem::temp_directory_path() / "vdb_metadata_index_roundtrip.bin";
+    ASSERT_TRUE(idx.save(path.string()).has_value());
+    auto loaded = index::MetadataIndex::load(path.string());
+    ASSERT_TRUE(loaded.has_value());
+    index::FilterCondition silver{"asset", index::FilterOp::Equal, "SILVER", {}, {}};
+    EXPECT_TRUE(loaded->query(silver) == idx.query(silver));
+    EXPECT_EQ(loaded->count("asset", "GOLD"), 15000u);
+
+    // A truncated file is rejected rather than half-loaded
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    EXPECT_FALSE(index::MetadataIndex::load(path.string()).has_value());
+    std::filesystem::remove(path);
+}
+
+TEST(NumericColumnsTest, PredicatesMatchScalarReference) {
+    index::NumericColumns columns;
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> vix(10.0f, 40.0f);
+    std::uniform_real_distribution<float> dxy(95.0f, 110.0f);
+
+    std::vector<Metadata> rows(300);
+    for (VectorId id = 1; id < rows.size(); ++id) {
+        rows[id].vix = vix(gen);
+        if (id % 7 != 0) rows[id].dxy = dxy(gen);  // Some rows lack DXY
+        columns.set(id, rows[id]);
+    }
+    columns.erase(42);
+
+    std::vector<index::NumericPredicate> predicates = {
+        index::NumericPredicate::greater(index::MarketField::Vix, 20.0f),
+        index::NumericPredicate::between(index::MarketField::Dxy, 100.0f, 105.0f),
+    };
+    auto matched = columns.evaluate(predicates);
+
+    std::vector<VectorId> expected;
+    for (VectorId id = 1; id < rows.size(); ++id) {
+        if (id == 42 || !rows[id].dxy) continue;
+        if (*rows[id].vix > 20.0f && *rows[id].dxy >= 100.0f && *rows[id].dxy <= 105.0f) {
+            expected.push_back(id);
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+    EXPECT_EQ(matched.to_vector(), expected);
+    EXPECT_EQ(columns.rows() % 64, 0u);
+}
+
+}  // namespace vdb::test
@@ -5,6 +5,8 @@
 #include <gtest/gtest.h>
 #include "vdb/storage.hpp"
 #include <filesystem>
+#include <fstream>
+#include <map>
 #include <random>
 #include <thread>
 
@@ -167,4 +169,297 @@ namespace vdb::test
         }
     }
 
+    TEST_F(StorageTest, MetadataStoreSplitSyncKeepsConcurrentAppends)
+    {
+        fs::path meta_path = test_dir_ / "metadata.jsonl";
+        auto make = [](VectorId id, const std::string &asset)
+        {
+            Metadata meta;
+            meta.id = id;
+            meta.type = DocumentType::Journal;
+            meta.date = "2025-12-01";
+            meta.asset = asset;
+            return meta;
+        };
+
+        {
+            MetadataStore store(meta_path);
+            ASSERT_TRUE(store.init().has_value());
+            ASSERT_TRUE(store.add(make(1, "GOLD")).has_value());
+            ASSERT_TRUE(store.add(make(2, "GOLD")).has_value());
+
+            // Writes land between capture and finish, as with an unlocked file write
+            auto snapshot = store.snapshot_for_sync();
+            ASSERT_TRUE(store.add(make(3, "SILVER")).has_value());
+            ASSERT_TRUE(store.update(make(1, "COPPER")).has_value());
+            auto written = store.write_snapshot(snapshot);
+            ASSERT_TRUE(written.has_value());
+            ASSERT_TRUE(store.finish_sync(snapshot, true).has_value());
+            fs::copy_file(meta_path, test_dir_ / "after_split.jsonl");
+
+            // The update after capture left the store dirty
+            ASSERT_TRUE(store.sync().has_value());
+        }
+
+        // The append made during the write survived the rewrite
+        {
+            MetadataStore store(test_dir_ / "after_split.jsonl");
+            ASSERT_TRUE(store.init().has_value());
+            EXPECT_EQ(store.size(), 3);
+            ASSERT_TRUE(store.get(3).has_value());
+            EXPECT_EQ(store.get(3)->asset, "SILVER");
+            EXPECT_EQ(store.get(1)->asset, "GOLD");
+        }
+        {
+            MetadataStore store(meta_path);
+            ASSERT_TRUE(store.init().has_value());
+            EXPECT_EQ(store.size(), 3);
+            EXPECT_EQ(store.get(1)->asset, "COPPER");
+        }
+    }
+
+    // ============================================================================
+    // MemoryMappedFile Options Tests
+    // ============================================================================
+
+    TEST_F(StorageTest, MmapOptionsRoundTrip)
+    {
+        fs::path file_path = test_dir_ / "mapped.bin";
+
+        MmapOptions options;
+        options.access = MmapAccessPattern::Random;
+        options.populate = true;
+        options.huge_pages = true;
+        options.lock_bytes = 4096;
+
+        {
+            MemoryMappedFile file;
+            ASSERT_TRUE(file.open_write(file_path, 64 * 1024, options).has_value());
+            EXPECT_EQ(file.options().access, MmapAccessPattern::Random);
+            EXPECT_LE(file.locked_bytes(), 4096); // mlock may be denied by RLIMIT_MEMLOCK
+
+            for (size_t i = 0; i < file.size(); ++i)
+                file.data()[i] = static_cast<uint8_t>(i % 251);
+
+            // Growing the file re-applies the options to the new mapping
+            ASSERT_TRUE(file.resize(128 * 1024).has_value());
+            EXPECT_EQ(file.data()[1000], static_cast<uint8_t>(1000 % 251));
+            ASSERT_TRUE(file.sync().has_value());
+        }
+
+        options.lock_bytes = 0;
+        options.prefetch = true;
+
+        MemoryMappedFile file;
+        ASSERT_TRUE(file.open_read(file_path, options).has_value());
+        file.wait_prefetch();
+        EXPECT_EQ(file.data()[4097], static_cast<uint8_t>(4097 % 251));
+
+        ASSERT_TRUE(file.advise(MmapAccessPattern::Sequential).has_value());
+        EXPECT_EQ(file.options().access, MmapAccessPattern::Sequential);
+    }
+
+    TEST_F(StorageTest, MmapRelockKeepsOverlappingPagesPinned)
+    {
+        // Locked memory of the whole process in kB (-1 where unavailable)
+        auto locked_kb = []
+        {
+            std::ifstream status("/proc/self/status");
+            std::string line;
+            while (std::getline(status, line))
+                if (line.rfind("VmLck:", 0) == 0)
+                    return std::stol(line.substr(6));
+            return -1L;
+        };
+
+        MemoryMappedFile file;
+        ASSERT_TRUE(file.open_write(test_dir_ / "locked.bin", 64 * 1024).has_value());
+        long before = locked_kb();
+        if (!file.lock(0, 8192))
+            GTEST_SKIP() << "mlock denied by RLIMIT_MEMLOCK";
+        EXPECT_EQ(file.locked_bytes(), 8192u);
+
+        // The shared page stays pinned while the range moves
+        ASSERT_TRUE(file.lock(4096, 8192).has_value());
+        EXPECT_EQ(file.locked_bytes(), 8192u);
+        if (before >= 0)
+        {
+            EXPECT_EQ(locked_kb() - before, 8);
+        }
+
+        // A rejected range leaves the current one in place
+        EXPECT_FALSE(file.lock(file.size(), 4096).has_value());
+        EXPECT_EQ(file.locked_bytes(), 8192u);
+
+        file.unlock();
+        EXPECT_EQ(file.locked_bytes(), 0u);
+        if (before >= 0)
+        {
+            EXPECT_EQ(locked_kb(), before);
+        }
+    }
+
+    TEST_F(StorageTest, VectorStoreWarmup)
+    {
+        VectorStoreConfig config;
+        config.path = test_dir_;
+        config.dimension = 16;
+        config.initial_capacity = 100;
+        config.mmap.access = MmapAccessPattern::Random;
+        config.mmap.prefetch = true;
+
+        VectorStore store(config);
+        ASSERT_TRUE(store.init().has_value());
+
+        std::vector<float> vec(16, 0.5f);
+        ASSERT_TRUE(store.add(1, vec).has_value());
+
+        // Warmup runs concurrently with reads
+        store.warmup();
+        auto stored = store.get(1);
+        ASSERT_TRUE(stored.has_value());
+        EXPECT_FLOAT_EQ((*stored)[15], 0.5f);
+    }
+
+    // ============================================================================
+    // Tiered Cache Tests
+    // ============================================================================
+
+    TEST_F(StorageTest, TieredCachePromotesFrequentVectors)
+    {
+        constexpr Dim dim = 4;
+        constexpr size_t slot_bytes = dim * sizeof(Scalar);
+        TieredVectorCache cache(dim, 2 * slot_bytes, 2 * slot_bytes, 2);
+
+        std::vector<Scalar> out(dim);
+        auto vec = [](float v) { return std::vector<Scalar>(dim, v); };
+
+        EXPECT_FALSE(cache.lookup(1, out));
+        cache.insert(1, vec(1.0f));
+        cache.insert(2, vec(2.0f));
+
+        // Two hits promote ID 1 into the hot arena
+        ASSERT_TRUE(cache.lookup(1, out));
+        ASSERT_TRUE(cache.lookup(1, out));
+        EXPECT_FLOAT_EQ(out[0], 1.0f);
+
+        // Cold segment holds 2; inserting 3 and 4 evicts ID 2
+        cache.insert(3, vec(3.0f));
+        cache.insert(4, vec(4.0f));
+        EXPECT_FALSE(cache.lookup(2, out));
+
+        // The hot vector survives cold churn
+        ASSERT_TRUE(cache.lookup(1, out));
+        EXPECT_FLOAT_EQ(out[3], 1.0f);
+
+        auto stats = cache.stats();
+        EXPECT_EQ(stats.promotions, 1);
+        EXPECT_EQ(stats.hot_hits, 1);
+        EXPECT_EQ(stats.cold_hits, 2);
+        EXPECT_EQ(stats.misses, 2);
+        EXPECT_EQ(stats.evictions, 1);
+        EXPECT_EQ(stats.hot_count, 1);
+        EXPECT_EQ(stats.cold_count, 2);
+    }
+
+    TEST_F(StorageTest, TieredCacheDemotesWhenHotFull)
+    {
+        constexpr Dim dim = 2;
+        constexpr size_t slot_bytes = dim * sizeof(Scalar);
+        TieredVectorCache cache(dim, 1 * slot_bytes, 4 * slot_bytes, 1);
+
+        std::vector<Scalar> out(dim);
+        cache.insert(1, std::vector<Scalar>{1.0f, 1.5f});
+        cache.insert(2, std::vector<Scalar>{2.0f, 2.5f});
+
+        ASSERT_TRUE(cache.lookup(1, out)); // 1 -> hot
+        ASSERT_TRUE(cache.lookup(2, out)); // 2 -> hot, 1 demoted
+
+        auto stats = cache.stats();
+        EXPECT_EQ(stats.promotions, 2);
+        EXPECT_EQ(stats.demotions, 1);
+
+        // Data followed the entries across arenas
+        ASSERT_TRUE(cache.lookup(1, out));
+        EXPECT_FLOAT_EQ(out[1], 1.5f);
+        ASSERT_TRUE(cache.lookup(2, out));
+        EXPECT_FLOAT_EQ(out[1], 2.5f);
+    }
+
+    TEST_F(StorageTest, VectorStoreTieredRead)
+    {
+        VectorStoreConfig config;
+        config.path = test_dir_;
+        config.dimension = 8;
+        config.initial_capacity = 100;
+        config.hot_budget_bytes = 4 * 8 * sizeof(Scalar);
+        config.cold_cache_bytes = 8 * 8 * sizeof(Scalar);
+
+        VectorStore store(config);
+        ASSERT_TRUE(store.init().has_value());
+
+        for (VectorId id = 1; id <= 50; ++id)
+        {
+            std::vector<float> vec(8, static_cast<float>(id));
+            ASSERT_TRUE(store.add(id, vec).has_value());
+        }
+
+        std::vector<Scalar> out(8);
+        for (int round = 0; round < 5; ++round)
+        {
+            ASSERT_TRUE(store.read(7, out));
+            EXPECT_FLOAT_EQ(out[0], 7.0f);
+        }
+        for (VectorId id = 1; id <= 50; ++id)
+        {
+            ASSERT_TRUE(store.read(id, out));
+            EXPECT_FLOAT_EQ(out[7], static_cast<float>(id));
+        }
+
+        auto stats = store.tier_stats();
+        EXPECT_GT(stats.hot_hits, 0);
+        EXPECT_GT(stats.misses, 0);
+        EXPECT_LE(stats.hot_count, 4);
+        EXPECT_LE(stats.cold_count, 8);
+
+        // Removed vectors are dropped from the tiers
+        ASSERT_TRUE(store.remove(7).has_value());
+        EXPECT_FALSE(store.read(7, out));
+    }
+
+    TEST_F(StorageTest, VectorStoreGetMany)
+    {
+        VectorStoreConfig config;
+        config.path = test_dir_;
+        config.dimension = 8;
+        config.initial_capacity = 100;
+        config.cold_cache_bytes = 4 * 8 * sizeof(Scalar);
+
+        VectorStore store(config);
+        ASSERT_TRUE(store.init().has_value());
+
+        for (VectorId id = 1; id <= 40; ++id)
+        {
+            std::vector<float> vec(8, static_cast<float>(id));
+            ASSERT_TRUE(store.add(id, vec).has_value());
+        }
+
+        std::vector<Scalar> out(8);
+        ASSERT_TRUE(store.read(3, out)); // Cached before the batch
+
+        std::vector<VectorId> ids = {3, 10, 999, 25, 40, 1};
+        std::map<VectorId, float> seen;
+        auto result = store.get_many(ids, [&](VectorId id, VectorView v)
+                                     { seen[id] = v[7]; });
+
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(*result, 5); // Unknown ID 999 skipped
+        ASSERT_EQ(seen.size(), 5);
+        for (const auto &[id, value] : seen)
+        {
+            EXPECT_FLOAT_EQ(value, static_cast<float>(id));
+        }
+        EXPECT_GE(store.tier_stats().cold_hits, 1);
+    }
+
 } // namespace vdb::test